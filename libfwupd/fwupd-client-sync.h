@@ -46,6 +46,10 @@ fwupd_client_get_upgrades(FwupdClient *self,
 			  GCancellable *cancellable,
 			  GError **error) G_GNUC_WARN_UNUSED_RESULT;
 GPtrArray *
+fwupd_client_get_upgrades_all(FwupdClient *self,
+			      GCancellable *cancellable,
+			      GError **error) G_GNUC_WARN_UNUSED_RESULT;
+GPtrArray *
 fwupd_client_get_details(FwupdClient *self,
 			 const gchar *filename,
 			 GCancellable *cancellable,
@@ -57,6 +57,8 @@ typedef struct {
 	gboolean tainted;
 	gboolean interactive;
 	guint percentage;
+	guint64 throughput;
+	guint time_remaining;
 	guint32 battery_level;
 	guint32 battery_threshold;
 	GMutex idle_mutex; /* for @idle_id and @idle_sources */
@@ -117,6 +119,8 @@ enum {
 	PROP_ONLY_TRUSTED,
 	PROP_BATTERY_LEVEL,
 	PROP_BATTERY_THRESHOLD,
+	PROP_THROUGHPUT,
+	PROP_TIME_REMAINING,
 	PROP_LAST
 };
 
@@ -409,6 +413,26 @@ fwupd_client_set_percentage(FwupdClient *self, guint percentage)
 	fwupd_client_object_notify(self, "percentage");
 }
 
+static void
+fwupd_client_set_throughput(FwupdClient *self, guint64 throughput)
+{
+	FwupdClientPrivate *priv = GET_PRIVATE(self);
+	if (priv->throughput == throughput)
+		return;
+	priv->throughput = throughput;
+	fwupd_client_object_notify(self, "throughput");
+}
+
+static void
+fwupd_client_set_time_remaining(FwupdClient *self, guint time_remaining)
+{
+	FwupdClientPrivate *priv = GET_PRIVATE(self);
+	if (priv->time_remaining == time_remaining)
+		return;
+	priv->time_remaining = time_remaining;
+	fwupd_client_object_notify(self, "time-remaining");
+}
+
 static void
 fwupd_client_set_battery_level(FwupdClient *self, guint32 battery_level)
 {
@@ -468,6 +492,18 @@ fwupd_client_properties_changed_cb(GDBusProxy *proxy,
 		if (val != NULL)
 			fwupd_client_set_percentage(self, g_variant_get_uint32(val));
 	}
+	if (g_variant_dict_contains(dict, "Throughput")) {
+		g_autoptr(GVariant) val = NULL;
+		val = g_dbus_proxy_get_cached_property(proxy, "Throughput");
+		if (val != NULL)
+			fwupd_client_set_throughput(self, g_variant_get_uint64(val));
+	}
+	if (g_variant_dict_contains(dict, "TimeRemaining")) {
+		g_autoptr(GVariant) val = NULL;
+		val = g_dbus_proxy_get_cached_property(proxy, "TimeRemaining");
+		if (val != NULL)
+			fwupd_client_set_time_remaining(self, g_variant_get_uint32(val));
+	}
 	if (g_variant_dict_contains(dict, FWUPD_RESULT_KEY_BATTERY_LEVEL)) {
 		g_autoptr(GVariant) val = NULL;
 		val = g_dbus_proxy_get_cached_property(proxy, FWUPD_RESULT_KEY_BATTERY_LEVEL);
@@ -1109,6 +1145,7 @@ fwupd_client_fixup_dbus_error(GError *error)
 		error->domain = FWUPD_ERROR;
 		error->code = fwupd_error_from_string(name);
 	} else if (g_error_matches(error, G_DBUS_ERROR, G_DBUS_ERROR_SERVICE_UNKNOWN) ||
+		   g_error_matches(error, G_DBUS_ERROR, G_DBUS_ERROR_UNKNOWN_METHOD) ||
 		   g_error_matches(error, G_IO_ERROR, G_IO_ERROR_DBUS_ERROR)) {
 		error->domain = FWUPD_ERROR;
 		error->code = FWUPD_ERROR_NOT_SUPPORTED;
@@ -2249,6 +2286,91 @@ fwupd_client_get_upgrades_finish(FwupdClient *self, GAsyncResult *res, GError **
 	return g_task_propagate_pointer(G_TASK(res), error);
 }
 
+static void
+fwupd_client_get_upgrades_all_cb(GObject *source, GAsyncResult *res, gpointer user_data)
+{
+	g_autoptr(GTask) task = G_TASK(user_data);
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GVariant) val = NULL;
+
+	val = g_dbus_proxy_call_finish(G_DBUS_PROXY(source), res, &error);
+	if (val == NULL) {
+		fwupd_client_fixup_dbus_error(error);
+		g_task_return_error(task, g_steal_pointer(&error));
+		return;
+	}
+
+	/* success */
+	g_task_return_pointer(task,
+			      fwupd_device_array_from_variant(val),
+			      (GDestroyNotify)g_ptr_array_unref);
+}
+
+/**
+ * fwupd_client_get_upgrades_all_async:
+ * @self: a #FwupdClient
+ * @cancellable: (nullable): optional #GCancellable
+ * @callback: (scope async) (closure callback_data): the function to run on completion
+ * @callback_data: the data to pass to @callback
+ *
+ * Gets all the devices registered with the daemon, each with the upgrades available added as
+ * releases. This is much faster than calling [method@FwupdClient.get_upgrades_async] for each
+ * device, as only one D-Bus method call is required.
+ *
+ * If the daemon is too old to support this method then the error is set to
+ * %FWUPD_ERROR_NOT_SUPPORTED.
+ *
+ * You must have called [method@Client.connect_async] on @self before using
+ * this method.
+ *
+ * Since: 1.9.4
+ **/
+void
+fwupd_client_get_upgrades_all_async(FwupdClient *self,
+				    GCancellable *cancellable,
+				    GAsyncReadyCallback callback,
+				    gpointer callback_data)
+{
+	FwupdClientPrivate *priv = GET_PRIVATE(self);
+	g_autoptr(GTask) task = NULL;
+
+	g_return_if_fail(FWUPD_IS_CLIENT(self));
+	g_return_if_fail(cancellable == NULL || G_IS_CANCELLABLE(cancellable));
+	g_return_if_fail(priv->proxy != NULL);
+
+	/* call into daemon */
+	task = g_task_new(self, cancellable, callback, callback_data);
+	g_dbus_proxy_call(priv->proxy,
+			  "GetUpgradesAll",
+			  NULL,
+			  G_DBUS_CALL_FLAGS_NONE,
+			  FWUPD_CLIENT_DBUS_PROXY_TIMEOUT,
+			  cancellable,
+			  fwupd_client_get_upgrades_all_cb,
+			  g_steal_pointer(&task));
+}
+
+/**
+ * fwupd_client_get_upgrades_all_finish:
+ * @self: a #FwupdClient
+ * @res: (not nullable): the asynchronous result
+ * @error: (nullable): optional return location for an error
+ *
+ * Gets the result of [method@FwupdClient.get_upgrades_all_async].
+ *
+ * Returns: (element-type FwupdDevice) (transfer container): results
+ *
+ * Since: 1.9.4
+ **/
+GPtrArray *
+fwupd_client_get_upgrades_all_finish(FwupdClient *self, GAsyncResult *res, GError **error)
+{
+	g_return_val_if_fail(FWUPD_IS_CLIENT(self), NULL);
+	g_return_val_if_fail(g_task_is_valid(res, self), NULL);
+	g_return_val_if_fail(error == NULL || *error == NULL, NULL);
+	return g_task_propagate_pointer(G_TASK(res), error);
+}
+
 static void
 fwupd_client_modify_config_cb(GObject *source, GAsyncResult *res, gpointer user_data)
 {
@@ -3583,6 +3705,42 @@ fwupd_client_get_percentage(FwupdClient *self)
 	return priv->percentage;
 }
 
+/**
+ * fwupd_client_get_throughput:
+ * @self: a #FwupdClient
+ *
+ * Gets the last returned rate of data transfer to or from the device.
+ *
+ * Returns: bytes per second, or 0 for unknown.
+ *
+ * Since: 1.9.4
+ **/
+guint64
+fwupd_client_get_throughput(FwupdClient *self)
+{
+	FwupdClientPrivate *priv = GET_PRIVATE(self);
+	g_return_val_if_fail(FWUPD_IS_CLIENT(self), 0);
+	return priv->throughput;
+}
+
+/**
+ * fwupd_client_get_time_remaining:
+ * @self: a #FwupdClient
+ *
+ * Gets the last returned estimate of the time until the job completes.
+ *
+ * Returns: seconds, or 0 for unknown.
+ *
+ * Since: 1.9.4
+ **/
+guint
+fwupd_client_get_time_remaining(FwupdClient *self)
+{
+	FwupdClientPrivate *priv = GET_PRIVATE(self);
+	g_return_val_if_fail(FWUPD_IS_CLIENT(self), 0);
+	return priv->time_remaining;
+}
+
 /**
  * fwupd_client_get_daemon_version:
  * @self: a #FwupdClient
@@ -5941,6 +6099,12 @@ fwupd_client_get_property(GObject *object, guint prop_id, GValue *value, GParamS
 	case PROP_PERCENTAGE:
 		g_value_set_uint(value, priv->percentage);
 		break;
+	case PROP_THROUGHPUT:
+		g_value_set_uint64(value, priv->throughput);
+		break;
+	case PROP_TIME_REMAINING:
+		g_value_set_uint(value, priv->time_remaining);
+		break;
 	case PROP_DAEMON_VERSION:
 		g_value_set_string(value, priv->daemon_version);
 		break;
@@ -6214,6 +6378,38 @@ fwupd_client_class_init(FwupdClientClass *klass)
 				  G_PARAM_READWRITE | G_PARAM_STATIC_NAME);
 	g_object_class_install_property(object_class, PROP_PERCENTAGE, pspec);
 
+	/**
+	 * FwupdClient:throughput:
+	 *
+	 * The last-reported transfer rate of the daemon in bytes per second.
+	 *
+	 * Since: 1.9.4
+	 */
+	pspec = g_param_spec_uint64("throughput",
+				    NULL,
+				    NULL,
+				    0,
+				    G_MAXUINT64,
+				    0,
+				    G_PARAM_READABLE | G_PARAM_STATIC_NAME);
+	g_object_class_install_property(object_class, PROP_THROUGHPUT, pspec);
+
+	/**
+	 * FwupdClient:time-remaining:
+	 *
+	 * The last-reported estimate of seconds until the daemon job completes.
+	 *
+	 * Since: 1.9.4
+	 */
+	pspec = g_param_spec_uint("time-remaining",
+				  NULL,
+				  NULL,
+				  0,
+				  G_MAXUINT,
+				  0,
+				  G_PARAM_READABLE | G_PARAM_STATIC_NAME);
+	g_object_class_install_property(object_class, PROP_TIME_REMAINING, pspec);
+
 	/**
 	 * FwupdClient:daemon-version:
 	 *
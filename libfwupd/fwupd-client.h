@@ -148,6 +148,15 @@ fwupd_client_get_upgrades_finish(FwupdClient *self,
 				 GAsyncResult *res,
 				 GError **error) G_GNUC_WARN_UNUSED_RESULT;
 void
+fwupd_client_get_upgrades_all_async(FwupdClient *self,
+				    GCancellable *cancellable,
+				    GAsyncReadyCallback callback,
+				    gpointer callback_data);
+GPtrArray *
+fwupd_client_get_upgrades_all_finish(FwupdClient *self,
+				     GAsyncResult *res,
+				     GError **error) G_GNUC_WARN_UNUSED_RESULT;
+void
 fwupd_client_get_details_bytes_async(FwupdClient *self,
 				     GBytes *bytes,
 				     GCancellable *cancellable,
@@ -433,6 +442,10 @@ gboolean
 fwupd_client_get_daemon_interactive(FwupdClient *self);
 guint
 fwupd_client_get_percentage(FwupdClient *self);
+guint64
+fwupd_client_get_throughput(FwupdClient *self);
+guint
+fwupd_client_get_time_remaining(FwupdClient *self);
 const gchar *
 fwupd_client_get_daemon_version(FwupdClient *self);
 void
@@ -1053,7 +1053,7 @@ fwupd_unix_input_stream_from_bytes(GBytes *bytes, GError **error)
 #endif
 
 #ifdef HAVE_MEMFD_CREATE
-	fd = memfd_create("fwupd", MFD_CLOEXEC);
+	fd = memfd_create("fwupd", MFD_CLOEXEC | MFD_ALLOW_SEALING);
 #else
 	/* emulate in-memory file by an unlinked temporary file */
 	fd = g_mkstemp(tmp_file);
@@ -1089,6 +1089,17 @@ fwupd_unix_input_stream_from_bytes(GBytes *bytes, GError **error)
 			    rc);
 		return NULL;
 	}
+#if defined(HAVE_MEMFD_CREATE) && defined(F_ADD_SEALS)
+	/* the daemon can map the contents rather than copying if the contents cannot change */
+	if (fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE | F_SEAL_SEAL) < 0) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_INVALID_FILE,
+			    "failed to seal: %s",
+			    g_strerror(errno));
+		return NULL;
+	}
+#endif
 	if (lseek(fd, 0, SEEK_SET) < 0) {
 		g_set_error(error,
 			    FWUPD_ERROR,
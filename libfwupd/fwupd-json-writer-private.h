@@ -0,0 +1,53 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * SPDX-License-Identifier: LGPL-2.1+
+ */
+
+#pragma once
+
+#include <gio/gio.h>
+#include <json-glib/json-glib.h>
+
+G_BEGIN_DECLS
+
+typedef struct FwupdJsonWriter FwupdJsonWriter;
+
+FwupdJsonWriter *
+fwupd_json_writer_new(GOutputStream *stream);
+void
+fwupd_json_writer_free(FwupdJsonWriter *self);
+gboolean
+fwupd_json_writer_begin_object(FwupdJsonWriter *self, const gchar *member_name, GError **error);
+gboolean
+fwupd_json_writer_end_object(FwupdJsonWriter *self, GError **error);
+gboolean
+fwupd_json_writer_begin_array(FwupdJsonWriter *self, const gchar *member_name, GError **error);
+gboolean
+fwupd_json_writer_end_array(FwupdJsonWriter *self, GError **error);
+gboolean
+fwupd_json_writer_add_string(FwupdJsonWriter *self,
+			     const gchar *member_name,
+			     const gchar *value,
+			     GError **error);
+gboolean
+fwupd_json_writer_add_int(FwupdJsonWriter *self,
+			  const gchar *member_name,
+			  gint64 value,
+			  GError **error);
+gboolean
+fwupd_json_writer_add_boolean(FwupdJsonWriter *self,
+			      const gchar *member_name,
+			      gboolean value,
+			      GError **error);
+gboolean
+fwupd_json_writer_add_builder(FwupdJsonWriter *self,
+			      const gchar *member_name,
+			      JsonBuilder *builder,
+			      GError **error);
+gboolean
+fwupd_json_writer_finish(FwupdJsonWriter *self, GError **error);
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC(FwupdJsonWriter, fwupd_json_writer_free)
+
+G_END_DECLS
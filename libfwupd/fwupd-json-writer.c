@@ -0,0 +1,491 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * SPDX-License-Identifier: LGPL-2.1+
+ */
+
+#include "config.h"
+
+#include <string.h>
+
+#include "fwupd-error.h"
+#include "fwupd-json-writer-private.h"
+
+/**
+ * FwupdJsonWriter:
+ *
+ * A writer that streams pretty-printed JSON to a #GOutputStream.
+ *
+ * Objects and arrays are written as they are opened and closed, and each member is written to
+ * the stream as it is added. Values that are only available as a #JsonBuilder are walked rather
+ * than being generated as a string first. This means the memory used is bounded by the largest
+ * element rather than by the size of the complete document, and the output is identical to what
+ * #JsonGenerator would produce for the whole tree.
+ */
+
+#define FWUPD_JSON_WRITER_INDENT 2
+
+typedef struct {
+	JsonNodeType kind;
+	gboolean has_children;
+} FwupdJsonWriterContainer;
+
+struct FwupdJsonWriter {
+	GOutputStream *stream;
+	GArray *containers; /* element-type FwupdJsonWriterContainer */
+	gboolean has_root;
+};
+
+/**
+ * fwupd_json_writer_new:
+ * @stream: a #GOutputStream
+ *
+ * Creates a new JSON writer.
+ *
+ * Returns: (transfer full): a #FwupdJsonWriter
+ *
+ * Since: 1.9.4
+ **/
+FwupdJsonWriter *
+fwupd_json_writer_new(GOutputStream *stream)
+{
+	FwupdJsonWriter *self;
+
+	g_return_val_if_fail(G_IS_OUTPUT_STREAM(stream), NULL);
+
+	self = g_new0(FwupdJsonWriter, 1);
+	self->stream = g_object_ref(stream);
+	self->containers = g_array_new(FALSE, FALSE, sizeof(FwupdJsonWriterContainer));
+	return self;
+}
+
+/**
+ * fwupd_json_writer_free:
+ * @self: a #FwupdJsonWriter
+ *
+ * Frees a JSON writer. The output stream is not closed.
+ *
+ * Since: 1.9.4
+ **/
+void
+fwupd_json_writer_free(FwupdJsonWriter *self)
+{
+	g_return_if_fail(self != NULL);
+	g_object_unref(self->stream);
+	g_array_unref(self->containers);
+	g_free(self);
+}
+
+static gboolean
+fwupd_json_writer_write(FwupdJsonWriter *self, const gchar *str, GError **error)
+{
+	return g_output_stream_write_all(self->stream, str, strlen(str), NULL, NULL, error);
+}
+
+static gboolean
+fwupd_json_writer_write_newline(FwupdJsonWriter *self, GError **error)
+{
+	g_autofree gchar *str = g_strnfill(self->containers->len * FWUPD_JSON_WRITER_INDENT, ' ');
+	if (!fwupd_json_writer_write(self, "\n", error))
+		return FALSE;
+	return fwupd_json_writer_write(self, str, error);
+}
+
+/* write the separator, indent and member name that comes before any new value */
+static gboolean
+fwupd_json_writer_write_prefix(FwupdJsonWriter *self, const gchar *member_name, GError **error)
+{
+	FwupdJsonWriterContainer *parent;
+
+	/* the root value */
+	if (self->containers->len == 0) {
+		if (self->has_root) {
+			g_set_error_literal(error,
+					    FWUPD_ERROR,
+					    FWUPD_ERROR_INTERNAL,
+					    "JSON root value already written");
+			return FALSE;
+		}
+		if (member_name != NULL) {
+			g_set_error_literal(error,
+					    FWUPD_ERROR,
+					    FWUPD_ERROR_INTERNAL,
+					    "JSON root value cannot have a member name");
+			return FALSE;
+		}
+		self->has_root = TRUE;
+		return TRUE;
+	}
+
+	/* objects require a member name, arrays do not allow one */
+	parent = &g_array_index(self->containers,
+				FwupdJsonWriterContainer,
+				self->containers->len - 1);
+	if (parent->kind == JSON_NODE_OBJECT && member_name == NULL) {
+		g_set_error_literal(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_INTERNAL,
+				    "JSON object member requires a name");
+		return FALSE;
+	}
+	if (parent->kind == JSON_NODE_ARRAY && member_name != NULL) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_INTERNAL,
+			    "JSON array element cannot have a member name, got %s",
+			    member_name);
+		return FALSE;
+	}
+	if (parent->has_children) {
+		if (!fwupd_json_writer_write(self, ",", error))
+			return FALSE;
+	}
+	parent->has_children = TRUE;
+	if (!fwupd_json_writer_write_newline(self, error))
+		return FALSE;
+
+	/* escape the same way as values */
+	if (member_name != NULL) {
+		g_autoptr(JsonNode) json_node = json_node_alloc();
+		g_autofree gchar *str = NULL;
+		json_node_init_string(json_node, member_name);
+		str = json_to_string(json_node, FALSE);
+		if (!fwupd_json_writer_write(self, str, error))
+			return FALSE;
+		if (!fwupd_json_writer_write(self, " : ", error))
+			return FALSE;
+	}
+	return TRUE;
+}
+
+static gboolean
+fwupd_json_writer_begin(FwupdJsonWriter *self,
+			JsonNodeType kind,
+			const gchar *member_name,
+			GError **error)
+{
+	FwupdJsonWriterContainer container = {.kind = kind, .has_children = FALSE};
+
+	if (!fwupd_json_writer_write_prefix(self, member_name, error))
+		return FALSE;
+	if (!fwupd_json_writer_write(self, kind == JSON_NODE_OBJECT ? "{" : "[", error))
+		return FALSE;
+	g_array_append_val(self->containers, container);
+	return TRUE;
+}
+
+static gboolean
+fwupd_json_writer_end(FwupdJsonWriter *self, JsonNodeType kind, GError **error)
+{
+	FwupdJsonWriterContainer *container;
+
+	/* sanity check */
+	if (self->containers->len == 0) {
+		g_set_error_literal(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_INTERNAL,
+				    "no JSON object or array to end");
+		return FALSE;
+	}
+	container = &g_array_index(self->containers,
+				   FwupdJsonWriterContainer,
+				   self->containers->len - 1);
+	if (container->kind != kind) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_INTERNAL,
+			    "cannot end JSON %s, expected %s",
+			    json_node_type_get_name(kind),
+			    json_node_type_get_name(container->kind));
+		return FALSE;
+	}
+	g_array_set_size(self->containers, self->containers->len - 1);
+	if (!fwupd_json_writer_write_newline(self, error))
+		return FALSE;
+	return fwupd_json_writer_write(self, kind == JSON_NODE_OBJECT ? "}" : "]", error);
+}
+
+/**
+ * fwupd_json_writer_begin_object:
+ * @self: a #FwupdJsonWriter
+ * @member_name: (nullable): the member name if the parent is an object, e.g. `Devices`
+ * @error: (nullable): optional return location for an error
+ *
+ * Starts a JSON object, which must be ended using fwupd_json_writer_end_object().
+ *
+ * Returns: %TRUE for success
+ *
+ * Since: 1.9.4
+ **/
+gboolean
+fwupd_json_writer_begin_object(FwupdJsonWriter *self, const gchar *member_name, GError **error)
+{
+	g_return_val_if_fail(self != NULL, FALSE);
+	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+	return fwupd_json_writer_begin(self, JSON_NODE_OBJECT, member_name, error);
+}
+
+/**
+ * fwupd_json_writer_end_object:
+ * @self: a #FwupdJsonWriter
+ * @error: (nullable): optional return location for an error
+ *
+ * Ends the JSON object started with fwupd_json_writer_begin_object().
+ *
+ * Returns: %TRUE for success
+ *
+ * Since: 1.9.4
+ **/
+gboolean
+fwupd_json_writer_end_object(FwupdJsonWriter *self, GError **error)
+{
+	g_return_val_if_fail(self != NULL, FALSE);
+	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+	return fwupd_json_writer_end(self, JSON_NODE_OBJECT, error);
+}
+
+/**
+ * fwupd_json_writer_begin_array:
+ * @self: a #FwupdJsonWriter
+ * @member_name: (nullable): the member name if the parent is an object, e.g. `Devices`
+ * @error: (nullable): optional return location for an error
+ *
+ * Starts a JSON array, which must be ended using fwupd_json_writer_end_array().
+ *
+ * Returns: %TRUE for success
+ *
+ * Since: 1.9.4
+ **/
+gboolean
+fwupd_json_writer_begin_array(FwupdJsonWriter *self, const gchar *member_name, GError **error)
+{
+	g_return_val_if_fail(self != NULL, FALSE);
+	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+	return fwupd_json_writer_begin(self, JSON_NODE_ARRAY, member_name, error);
+}
+
+/**
+ * fwupd_json_writer_end_array:
+ * @self: a #FwupdJsonWriter
+ * @error: (nullable): optional return location for an error
+ *
+ * Ends the JSON array started with fwupd_json_writer_begin_array().
+ *
+ * Returns: %TRUE for success
+ *
+ * Since: 1.9.4
+ **/
+gboolean
+fwupd_json_writer_end_array(FwupdJsonWriter *self, GError **error)
+{
+	g_return_val_if_fail(self != NULL, FALSE);
+	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+	return fwupd_json_writer_end(self, JSON_NODE_ARRAY, error);
+}
+
+static gboolean
+fwupd_json_writer_add_value(FwupdJsonWriter *self,
+			    const gchar *member_name,
+			    JsonNode *json_node,
+			    GError **error)
+{
+	g_autofree gchar *str = json_to_string(json_node, FALSE);
+	if (!fwupd_json_writer_write_prefix(self, member_name, error))
+		return FALSE;
+	return fwupd_json_writer_write(self, str, error);
+}
+
+static gboolean
+fwupd_json_writer_add_node(FwupdJsonWriter *self,
+			   const gchar *member_name,
+			   JsonNode *json_node,
+			   GError **error)
+{
+	if (JSON_NODE_HOLDS_OBJECT(json_node)) {
+		JsonObject *json_object = json_node_get_object(json_node);
+		g_autoptr(GList) members = json_object_get_members(json_object);
+		if (!fwupd_json_writer_begin(self, JSON_NODE_OBJECT, member_name, error))
+			return FALSE;
+		for (GList *l = members; l != NULL; l = l->next) {
+			const gchar *name = l->data;
+			if (!fwupd_json_writer_add_node(self,
+							name,
+							json_object_get_member(json_object, name),
+							error))
+				return FALSE;
+		}
+		return fwupd_json_writer_end(self, JSON_NODE_OBJECT, error);
+	}
+	if (JSON_NODE_HOLDS_ARRAY(json_node)) {
+		JsonArray *json_array = json_node_get_array(json_node);
+		if (!fwupd_json_writer_begin(self, JSON_NODE_ARRAY, member_name, error))
+			return FALSE;
+		for (guint i = 0; i < json_array_get_length(json_array); i++) {
+			if (!fwupd_json_writer_add_node(self,
+							NULL,
+							json_array_get_element(json_array, i),
+							error))
+				return FALSE;
+		}
+		return fwupd_json_writer_end(self, JSON_NODE_ARRAY, error);
+	}
+	return fwupd_json_writer_add_value(self, member_name, json_node, error);
+}
+
+/**
+ * fwupd_json_writer_add_string:
+ * @self: a #FwupdJsonWriter
+ * @member_name: (nullable): the member name if the parent is an object, e.g. `Name`
+ * @value: (nullable): a string, or %NULL to write `null`
+ * @error: (nullable): optional return location for an error
+ *
+ * Writes a string value.
+ *
+ * Returns: %TRUE for success
+ *
+ * Since: 1.9.4
+ **/
+gboolean
+fwupd_json_writer_add_string(FwupdJsonWriter *self,
+			     const gchar *member_name,
+			     const gchar *value,
+			     GError **error)
+{
+	g_autoptr(JsonNode) json_node = json_node_alloc();
+
+	g_return_val_if_fail(self != NULL, FALSE);
+	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+
+	if (value != NULL)
+		json_node_init_string(json_node, value);
+	else
+		json_node_init_null(json_node);
+	return fwupd_json_writer_add_value(self, member_name, json_node, error);
+}
+
+/**
+ * fwupd_json_writer_add_int:
+ * @self: a #FwupdJsonWriter
+ * @member_name: (nullable): the member name if the parent is an object, e.g. `Index`
+ * @value: an integer
+ * @error: (nullable): optional return location for an error
+ *
+ * Writes an integer value.
+ *
+ * Returns: %TRUE for success
+ *
+ * Since: 1.9.4
+ **/
+gboolean
+fwupd_json_writer_add_int(FwupdJsonWriter *self,
+			  const gchar *member_name,
+			  gint64 value,
+			  GError **error)
+{
+	g_autoptr(JsonNode) json_node = json_node_alloc();
+
+	g_return_val_if_fail(self != NULL, FALSE);
+	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+
+	json_node_init_int(json_node, value);
+	return fwupd_json_writer_add_value(self, member_name, json_node, error);
+}
+
+/**
+ * fwupd_json_writer_add_boolean:
+ * @self: a #FwupdJsonWriter
+ * @member_name: (nullable): the member name if the parent is an object, e.g. `Enabled`
+ * @value: a boolean
+ * @error: (nullable): optional return location for an error
+ *
+ * Writes a boolean value.
+ *
+ * Returns: %TRUE for success
+ *
+ * Since: 1.9.4
+ **/
+gboolean
+fwupd_json_writer_add_boolean(FwupdJsonWriter *self,
+			      const gchar *member_name,
+			      gboolean value,
+			      GError **error)
+{
+	g_autoptr(JsonNode) json_node = json_node_alloc();
+
+	g_return_val_if_fail(self != NULL, FALSE);
+	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+
+	json_node_init_boolean(json_node, value);
+	return fwupd_json_writer_add_value(self, member_name, json_node, error);
+}
+
+/**
+ * fwupd_json_writer_add_builder:
+ * @self: a #FwupdJsonWriter
+ * @member_name: (nullable): the member name if the parent is an object, e.g. `Devices`
+ * @builder: a #JsonBuilder
+ * @error: (nullable): optional return location for an error
+ *
+ * Writes the value built using @builder, typically an object populated using something like
+ * fwupd_device_to_json(). Each member is written to the stream in turn, and nothing is written
+ * if @builder has no root value.
+ *
+ * The builder can be reset or freed as soon as this function returns.
+ *
+ * Returns: %TRUE for success
+ *
+ * Since: 1.9.4
+ **/
+gboolean
+fwupd_json_writer_add_builder(FwupdJsonWriter *self,
+			      const gchar *member_name,
+			      JsonBuilder *builder,
+			      GError **error)
+{
+	g_autoptr(JsonNode) json_root = NULL;
+
+	g_return_val_if_fail(self != NULL, FALSE);
+	g_return_val_if_fail(JSON_IS_BUILDER(builder), FALSE);
+	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+
+	/* nothing was built */
+	json_root = json_builder_get_root(builder);
+	if (json_root == NULL)
+		return TRUE;
+	return fwupd_json_writer_add_node(self, member_name, json_root, error);
+}
+
+/**
+ * fwupd_json_writer_finish:
+ * @self: a #FwupdJsonWriter
+ * @error: (nullable): optional return location for an error
+ *
+ * Checks that every object and array has been ended and flushes the output stream.
+ *
+ * Returns: %TRUE for success
+ *
+ * Since: 1.9.4
+ **/
+gboolean
+fwupd_json_writer_finish(FwupdJsonWriter *self, GError **error)
+{
+	g_return_val_if_fail(self != NULL, FALSE);
+	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+
+	if (self->containers->len > 0) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_INTERNAL,
+			    "%u JSON objects or arrays were not ended",
+			    self->containers->len);
+		return FALSE;
+	}
+	if (!self->has_root) {
+		g_set_error_literal(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_INTERNAL,
+				    "no JSON root value was written");
+		return FALSE;
+	}
+	return g_output_stream_flush(self->stream, NULL, error);
+}
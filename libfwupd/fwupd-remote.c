@@ -564,6 +564,18 @@ fwupd_remote_set_order_after(FwupdRemote *self, const gchar *order_after)
 		priv->order_after = g_strsplit_set(order_after, ",:;", -1);
 }
 
+/* the compression suffixes the daemon knows how to load, falling back to gzip */
+static const gchar *
+fwupd_remote_get_metadata_compression_suffix(const gchar *metadata_uri)
+{
+	const gchar *suffixes[] = {".xml.zst", ".xml.xz", ".xml.gz", NULL};
+	for (guint i = 0; suffixes[i] != NULL; i++) {
+		if (g_str_has_suffix(metadata_uri, suffixes[i]))
+			return suffixes[i];
+	}
+	return ".xml.gz";
+}
+
 /**
  * fwupd_remote_setup:
  * @self: a #FwupdRemote
@@ -595,6 +607,7 @@ fwupd_remote_setup(FwupdRemote *self, GError **error)
 
 	/* some validation for DOWNLOAD types */
 	if (priv->kind == FWUPD_REMOTE_KIND_DOWNLOAD) {
+		g_autofree gchar *basename_cache = NULL;
 		g_autofree gchar *filename_cache = NULL;
 
 		if (priv->remotes_dir == NULL) {
@@ -612,13 +625,11 @@ fwupd_remote_setup(FwupdRemote *self, GError **error)
 					    "metadata URI not set");
 			return FALSE;
 		}
-		if (g_str_has_suffix(priv->metadata_uri, ".xml.xz")) {
-			filename_cache =
-			    g_build_filename(priv->remotes_dir, priv->id, "metadata.xml.xz", NULL);
-		} else {
-			filename_cache =
-			    g_build_filename(priv->remotes_dir, priv->id, "metadata.xml.gz", NULL);
-		}
+		basename_cache = g_strdup_printf(
+		    "metadata%s",
+		    fwupd_remote_get_metadata_compression_suffix(priv->metadata_uri));
+		filename_cache =
+		    g_build_filename(priv->remotes_dir, priv->id, basename_cache, NULL);
 		fwupd_remote_set_filename_cache(self, filename_cache);
 	}
 
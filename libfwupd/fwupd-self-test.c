@@ -16,6 +16,7 @@
 #include "fwupd-device-private.h"
 #include "fwupd-enums.h"
 #include "fwupd-error.h"
+#include "fwupd-json-writer-private.h"
 #include "fwupd-plugin-private.h"
 #include "fwupd-release-private.h"
 #include "fwupd-remote-private.h"
@@ -487,6 +488,34 @@ fwupd_remote_nopath_func(void)
 			"https://s3.amazonaws.com/lvfsbucket/downloads/firmware.cab");
 }
 
+/* verify the cache filename follows the compression format of the metadata */
+static void
+fwupd_remote_zstd_func(void)
+{
+	gboolean ret;
+	g_autofree gchar *fn = NULL;
+	g_autofree gchar *directory = NULL;
+	g_autofree gchar *expected_metadata = NULL;
+	g_autoptr(FwupdRemote) remote = NULL;
+	g_autoptr(GError) error = NULL;
+
+	remote = fwupd_remote_new();
+	directory = g_build_filename(FWUPD_LOCALSTATEDIR, "lib", "fwupd", "remotes.d", NULL);
+	expected_metadata = g_build_filename(directory, "firmware-zstd", "metadata.xml.zst", NULL);
+	fwupd_remote_set_remotes_dir(remote, directory);
+	fn = g_test_build_filename(G_TEST_DIST, "tests", "firmware-zstd.conf", NULL);
+	ret = fwupd_remote_load_from_filename(remote, fn, NULL, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	ret = fwupd_remote_setup(remote, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_assert_cmpstr(fwupd_remote_get_metadata_uri_sig(remote),
+			==,
+			"https://cdn.fwupd.org/downloads/firmware.xml.zst.jcat");
+	g_assert_cmpstr(fwupd_remote_get_filename_cache(remote), ==, expected_metadata);
+}
+
 static void
 fwupd_remote_local_func(void)
 {
@@ -1482,6 +1511,141 @@ fwupd_security_attr_func(void)
 	g_assert_true(ret);
 }
 
+static void
+fwupd_json_writer_func(void)
+{
+	gboolean ret;
+	g_autofree gchar *json_expected = NULL;
+	g_autoptr(FwupdJsonWriter) writer = NULL;
+	g_autoptr(GBytes) blob = NULL;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GOutputStream) stream = g_memory_output_stream_new_resizable();
+	g_autoptr(JsonBuilder) builder = json_builder_new();
+	g_autoptr(JsonGenerator) json_generator = json_generator_new();
+	g_autoptr(JsonNode) json_root = NULL;
+
+	/* build the whole tree the old way */
+	json_builder_begin_object(builder);
+	json_builder_set_member_name(builder, "Devices");
+	json_builder_begin_array(builder);
+	for (guint i = 0; i < 2; i++) {
+		json_builder_begin_object(builder);
+		json_builder_set_member_name(builder, "Name");
+		json_builder_add_string_value(builder, "Foo \"Bar\"");
+		json_builder_set_member_name(builder, "Index");
+		json_builder_add_int_value(builder, i);
+		json_builder_set_member_name(builder, "Guids");
+		json_builder_begin_array(builder);
+		json_builder_add_string_value(builder, "2082b5e0-7a64-478a-b1b2-e3404fab6dad");
+		json_builder_end_array(builder);
+		json_builder_end_object(builder);
+	}
+	json_builder_end_array(builder);
+	json_builder_set_member_name(builder, "Releases");
+	json_builder_begin_array(builder);
+	json_builder_end_array(builder);
+	json_builder_end_object(builder);
+	json_root = json_builder_get_root(builder);
+	json_generator_set_pretty(json_generator, TRUE);
+	json_generator_set_root(json_generator, json_root);
+	json_expected = json_generator_to_data(json_generator, NULL);
+
+	/* stream each element in turn */
+	writer = fwupd_json_writer_new(stream);
+	ret = fwupd_json_writer_begin_object(writer, NULL, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	ret = fwupd_json_writer_begin_array(writer, "Devices", &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	for (guint i = 0; i < 2; i++) {
+		g_autoptr(JsonBuilder) builder_tmp = json_builder_new();
+
+		/* write each member in turn */
+		if (i == 1) {
+			ret = fwupd_json_writer_begin_object(writer, NULL, &error);
+			g_assert_no_error(error);
+			g_assert_true(ret);
+			ret = fwupd_json_writer_add_string(writer, "Name", "Foo \"Bar\"", &error);
+			g_assert_no_error(error);
+			g_assert_true(ret);
+			ret = fwupd_json_writer_add_int(writer, "Index", i, &error);
+			g_assert_no_error(error);
+			g_assert_true(ret);
+			ret = fwupd_json_writer_begin_array(writer, "Guids", &error);
+			g_assert_no_error(error);
+			g_assert_true(ret);
+			ret = fwupd_json_writer_add_string(writer,
+							   NULL,
+							   "2082b5e0-7a64-478a-b1b2-e3404fab6dad",
+							   &error);
+			g_assert_no_error(error);
+			g_assert_true(ret);
+			ret = fwupd_json_writer_end_array(writer, &error);
+			g_assert_no_error(error);
+			g_assert_true(ret);
+			ret = fwupd_json_writer_end_object(writer, &error);
+			g_assert_no_error(error);
+			g_assert_true(ret);
+			continue;
+		}
+
+		/* or walk an element that was built using a JsonBuilder */
+		json_builder_begin_object(builder_tmp);
+		json_builder_set_member_name(builder_tmp, "Name");
+		json_builder_add_string_value(builder_tmp, "Foo \"Bar\"");
+		json_builder_set_member_name(builder_tmp, "Index");
+		json_builder_add_int_value(builder_tmp, i);
+		json_builder_set_member_name(builder_tmp, "Guids");
+		json_builder_begin_array(builder_tmp);
+		json_builder_add_string_value(builder_tmp, "2082b5e0-7a64-478a-b1b2-e3404fab6dad");
+		json_builder_end_array(builder_tmp);
+		json_builder_end_object(builder_tmp);
+		ret = fwupd_json_writer_add_builder(writer, NULL, builder_tmp, &error);
+		g_assert_no_error(error);
+		g_assert_true(ret);
+	}
+
+	/* a member name is not allowed for array elements */
+	ret = fwupd_json_writer_begin_object(writer, "Device", &error);
+	g_assert_error(error, FWUPD_ERROR, FWUPD_ERROR_INTERNAL);
+	g_assert_false(ret);
+	g_clear_error(&error);
+
+	ret = fwupd_json_writer_end_array(writer, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	ret = fwupd_json_writer_begin_array(writer, "Releases", &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+
+	/* not yet ended */
+	ret = fwupd_json_writer_finish(writer, &error);
+	g_assert_error(error, FWUPD_ERROR, FWUPD_ERROR_INTERNAL);
+	g_assert_false(ret);
+	g_clear_error(&error);
+
+	ret = fwupd_json_writer_end_array(writer, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	ret = fwupd_json_writer_end_object(writer, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	ret = fwupd_json_writer_finish(writer, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+
+	/* identical to the generator output */
+	ret = g_output_stream_close(stream, NULL, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	blob = g_memory_output_stream_steal_as_bytes(G_MEMORY_OUTPUT_STREAM(stream));
+	g_assert_cmpint(g_bytes_get_size(blob), ==, strlen(json_expected));
+	g_assert_cmpint(memcmp(g_bytes_get_data(blob, NULL), json_expected, strlen(json_expected)),
+			==,
+			0);
+}
+
 static void
 fwupd_bios_settings_func(void)
 {
@@ -1648,9 +1812,11 @@ main(int argc, char **argv)
 	g_test_add_func("/fwupd/request", fwupd_request_func);
 	g_test_add_func("/fwupd/device", fwupd_device_func);
 	g_test_add_func("/fwupd/security-attr", fwupd_security_attr_func);
+	g_test_add_func("/fwupd/json-writer", fwupd_json_writer_func);
 	g_test_add_func("/fwupd/remote{download}", fwupd_remote_download_func);
 	g_test_add_func("/fwupd/remote{base-uri}", fwupd_remote_baseuri_func);
 	g_test_add_func("/fwupd/remote{no-path}", fwupd_remote_nopath_func);
+	g_test_add_func("/fwupd/remote{zstd}", fwupd_remote_zstd_func);
 	g_test_add_func("/fwupd/remote{local}", fwupd_remote_local_func);
 	g_test_add_func("/fwupd/remote{duplicate}", fwupd_remote_duplicate_func);
 	g_test_add_func("/fwupd/remote{auth}", fwupd_remote_auth_func);
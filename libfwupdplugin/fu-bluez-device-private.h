@@ -0,0 +1,18 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * SPDX-License-Identifier: LGPL-2.1+
+ */
+
+#pragma once
+
+#include "fu-bluez-device.h"
+
+gboolean
+fu_bluez_device_write_bytes_full(FuBluezDevice *self,
+				 const gchar *uuid,
+				 FuIOChannel *io_channel,
+				 gint32 mtu,
+				 GBytes *blob,
+				 FuProgress *progress,
+				 GError **error) G_GNUC_WARN_UNUSED_RESULT;
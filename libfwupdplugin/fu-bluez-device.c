@@ -10,7 +10,14 @@
 
 #include <string.h>
 
-#include "fu-bluez-device.h"
+#ifdef HAVE_GIO_UNIX
+#include <gio/gunixfdlist.h>
+#endif
+
+#include "fwupd-error.h"
+
+#include "fu-bluez-device-private.h"
+#include "fu-chunk.h"
 #include "fu-common.h"
 #include "fu-device-private.h"
 #include "fu-firmware-common.h"
@@ -18,6 +25,11 @@
 
 #define DEFAULT_PROXY_TIMEOUT 5000
 
+/* the default ATT MTU is 23 bytes, and each write needs 3 bytes of header */
+#define FU_BLUEZ_DEVICE_ATT_HEADER_SIZE	    3
+#define FU_BLUEZ_DEVICE_DEFAULT_PAYLOAD_SIZE 20
+#define FU_BLUEZ_DEVICE_ACQUIRE_TIMEOUT	    5000 /* ms */
+
 /**
  * FuBluezDevice:
  *
@@ -573,6 +585,232 @@ fu_bluez_device_notify_stop(FuBluezDevice *self, const gchar *uuid, GError **err
 	return TRUE;
 }
 
+static FuIOChannel *
+fu_bluez_device_method_acquire(FuBluezDevice *self,
+			       const gchar *method,
+			       const gchar *uuid,
+			       gint32 *mtu,
+			       GError **error)
+{
+#ifdef HAVE_GIO_UNIX
+	FuBluezDeviceUuidHelper *uuid_helper;
+	GVariant *opt_variant = NULL;
+	gint fd;
+	gint32 fd_id = 0;
+	guint16 mtu_tmp = 0;
+	g_autoptr(GUnixFDList) out_fd_list = NULL;
+	g_autoptr(GVariantBuilder) opt_builder = NULL;
+	g_autoptr(GVariant) val = NULL;
+
+	uuid_helper = fu_bluez_device_get_uuid_helper(self, uuid, error);
+	if (uuid_helper == NULL)
+		return NULL;
+	if (!fu_bluez_device_ensure_uuid_helper_proxy(uuid_helper, error))
+		return NULL;
+
+	/* no options are required */
+	opt_builder = g_variant_builder_new(G_VARIANT_TYPE("a{sv}"));
+	opt_variant = g_variant_new("a{sv}", opt_builder);
+
+	/* the method returns a file descriptor and the negotiated MTU */
+	val = g_dbus_proxy_call_with_unix_fd_list_sync(uuid_helper->proxy,
+						       method,
+						       g_variant_new("(@a{sv})", opt_variant),
+						       G_DBUS_CALL_FLAGS_NONE,
+						       -1,
+						       NULL, /* fd list */
+						       &out_fd_list,
+						       NULL,
+						       error);
+	if (val == NULL) {
+		g_prefix_error(error, "failed to call %s: ", method);
+		return NULL;
+	}
+	g_variant_get(val, "(hq)", &fd_id, &mtu_tmp);
+	if (out_fd_list == NULL || g_unix_fd_list_get_length(out_fd_list) <= fd_id) {
+		g_set_error(error,
+			    G_IO_ERROR,
+			    G_IO_ERROR_INVALID_DATA,
+			    "no file descriptor returned from %s",
+			    method);
+		return NULL;
+	}
+	fd = g_unix_fd_list_get(out_fd_list, fd_id, error);
+	if (fd < 0)
+		return NULL;
+	if (mtu != NULL)
+		*mtu = mtu_tmp;
+
+	/* success */
+	return fu_io_channel_unix_new(fd);
+#else
+	g_set_error_literal(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_NOT_SUPPORTED,
+			    "Not supported as <glib-unix.h> is unavailable");
+	return NULL;
+#endif
+}
+
+/**
+ * fu_bluez_device_write_acquire:
+ * @self: a #FuBluezDevice
+ * @uuid: the UUID, e.g. `00cde35c-7062-11eb-9439-0242ac130002`
+ * @mtu: (out) (nullable): the negotiated MTU
+ * @error: (nullable): optional return location for an error
+ *
+ * Acquires a file descriptor for writing to a UUID on the device using the `AcquireWrite`
+ * method, which avoids a D-Bus round trip for each packet.
+ *
+ * Each write to the returned channel is sent as a single *write without response*, and should
+ * be no larger than the negotiated MTU minus the 3 byte ATT header.
+ *
+ * Returns: (transfer full): a #FuIOChannel, or %NULL for error
+ *
+ * Since: 1.9.4
+ **/
+FuIOChannel *
+fu_bluez_device_write_acquire(FuBluezDevice *self,
+			      const gchar *uuid,
+			      gint32 *mtu,
+			      GError **error)
+{
+	g_return_val_if_fail(FU_IS_BLUEZ_DEVICE(self), NULL);
+	g_return_val_if_fail(uuid != NULL, NULL);
+	g_return_val_if_fail(error == NULL || *error == NULL, NULL);
+	return fu_bluez_device_method_acquire(self, "AcquireWrite", uuid, mtu, error);
+}
+
+/**
+ * fu_bluez_device_notify_acquire:
+ * @self: a #FuBluezDevice
+ * @uuid: the UUID, e.g. `00cde35c-7062-11eb-9439-0242ac130002`
+ * @mtu: (out) (nullable): the negotiated MTU
+ * @error: (nullable): optional return location for an error
+ *
+ * Acquires a file descriptor for receiving notifications from a UUID on the device using the
+ * `AcquireNotify` method. Notifications are then read from the returned channel rather than
+ * being delivered using the ::changed signal.
+ *
+ * Returns: (transfer full): a #FuIOChannel, or %NULL for error
+ *
+ * Since: 1.9.4
+ **/
+FuIOChannel *
+fu_bluez_device_notify_acquire(FuBluezDevice *self,
+			       const gchar *uuid,
+			       gint32 *mtu,
+			       GError **error)
+{
+	g_return_val_if_fail(FU_IS_BLUEZ_DEVICE(self), NULL);
+	g_return_val_if_fail(uuid != NULL, NULL);
+	g_return_val_if_fail(error == NULL || *error == NULL, NULL);
+	return fu_bluez_device_method_acquire(self, "AcquireNotify", uuid, mtu, error);
+}
+
+/* the largest write-without-response that fits in the negotiated MTU */
+static guint32
+fu_bluez_device_packet_size_for_mtu(gint32 mtu)
+{
+	if (mtu <= FU_BLUEZ_DEVICE_ATT_HEADER_SIZE + FU_BLUEZ_DEVICE_DEFAULT_PAYLOAD_SIZE)
+		return FU_BLUEZ_DEVICE_DEFAULT_PAYLOAD_SIZE;
+	return mtu - FU_BLUEZ_DEVICE_ATT_HEADER_SIZE;
+}
+
+/* if @io_channel is %NULL then each packet is sent using WriteValue */
+gboolean
+fu_bluez_device_write_bytes_full(FuBluezDevice *self,
+				 const gchar *uuid,
+				 FuIOChannel *io_channel,
+				 gint32 mtu,
+				 GBytes *blob,
+				 FuProgress *progress,
+				 GError **error)
+{
+	g_autoptr(GPtrArray) chunks = NULL;
+
+	g_return_val_if_fail(FU_IS_BLUEZ_DEVICE(self), FALSE);
+	g_return_val_if_fail(uuid != NULL, FALSE);
+	g_return_val_if_fail(blob != NULL, FALSE);
+	g_return_val_if_fail(FU_IS_PROGRESS(progress), FALSE);
+	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+
+	/* WriteValue does not use the MTU */
+	chunks = fu_chunk_array_new_from_bytes(blob,
+					       0x0,
+					       0x0,
+					       io_channel != NULL
+						   ? fu_bluez_device_packet_size_for_mtu(mtu)
+						   : FU_BLUEZ_DEVICE_DEFAULT_PAYLOAD_SIZE);
+	fu_progress_set_id(progress, G_STRLOC);
+	fu_progress_set_steps(progress, chunks->len);
+	for (guint i = 0; i < chunks->len; i++) {
+		FuChunk *chk = g_ptr_array_index(chunks, i);
+		if (io_channel != NULL) {
+			if (!fu_io_channel_write_raw(io_channel,
+						     fu_chunk_get_data(chk),
+						     fu_chunk_get_data_sz(chk),
+						     FU_BLUEZ_DEVICE_ACQUIRE_TIMEOUT,
+						     FU_IO_CHANNEL_FLAG_NONE,
+						     error)) {
+				g_prefix_error(error, "failed to write packet 0x%x: ", i);
+				return FALSE;
+			}
+		} else {
+			g_autoptr(GByteArray) buf = g_byte_array_new();
+			g_byte_array_append(buf, fu_chunk_get_data(chk), fu_chunk_get_data_sz(chk));
+			if (!fu_bluez_device_write(self, uuid, buf, error)) {
+				g_prefix_error(error, "failed to write packet 0x%x: ", i);
+				return FALSE;
+			}
+		}
+		fu_progress_step_done(progress);
+	}
+
+	/* success */
+	return TRUE;
+}
+
+/**
+ * fu_bluez_device_write_bytes:
+ * @self: a #FuBluezDevice
+ * @uuid: the UUID, e.g. `00cde35c-7062-11eb-9439-0242ac130002`
+ * @blob: data to write
+ * @progress: a #FuProgress
+ * @error: (nullable): optional return location for an error
+ *
+ * Streams a blob of data to a UUID on the device, split into packets as large as the negotiated
+ * MTU allows.
+ *
+ * If BlueZ supports `AcquireWrite` for the characteristic then the packets are written to the
+ * acquired file descriptor, otherwise each packet is sent using fu_bluez_device_write().
+ *
+ * Returns: %TRUE if all the data was written
+ *
+ * Since: 1.9.4
+ **/
+gboolean
+fu_bluez_device_write_bytes(FuBluezDevice *self,
+			    const gchar *uuid,
+			    GBytes *blob,
+			    FuProgress *progress,
+			    GError **error)
+{
+	gint32 mtu = 0;
+	g_autoptr(FuIOChannel) io_channel = NULL;
+	g_autoptr(GError) error_local = NULL;
+
+	g_return_val_if_fail(FU_IS_BLUEZ_DEVICE(self), FALSE);
+	g_return_val_if_fail(uuid != NULL, FALSE);
+	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+
+	/* try the fast path first */
+	io_channel = fu_bluez_device_write_acquire(self, uuid, &mtu, &error_local);
+	if (io_channel == NULL)
+		g_debug("falling back to WriteValue: %s", error_local->message);
+	return fu_bluez_device_write_bytes_full(self, uuid, io_channel, mtu, blob, progress, error);
+}
+
 static void
 fu_bluez_device_incorporate(FuDevice *self, FuDevice *donor)
 {
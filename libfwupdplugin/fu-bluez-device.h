@@ -7,6 +7,7 @@
 #pragma once
 
 #include "fu-device.h"
+#include "fu-io-channel.h"
 
 #define FU_TYPE_BLUEZ_DEVICE (fu_bluez_device_get_type())
 G_DECLARE_DERIVABLE_TYPE(FuBluezDevice, fu_bluez_device, FU, BLUEZ_DEVICE, FuDevice)
@@ -25,3 +26,19 @@ gboolean
 fu_bluez_device_notify_start(FuBluezDevice *self, const gchar *uuid, GError **error);
 gboolean
 fu_bluez_device_notify_stop(FuBluezDevice *self, const gchar *uuid, GError **error);
+FuIOChannel *
+fu_bluez_device_write_acquire(FuBluezDevice *self,
+			      const gchar *uuid,
+			      gint32 *mtu,
+			      GError **error) G_GNUC_WARN_UNUSED_RESULT;
+FuIOChannel *
+fu_bluez_device_notify_acquire(FuBluezDevice *self,
+			       const gchar *uuid,
+			       gint32 *mtu,
+			       GError **error) G_GNUC_WARN_UNUSED_RESULT;
+gboolean
+fu_bluez_device_write_bytes(FuBluezDevice *self,
+			    const gchar *uuid,
+			    GBytes *blob,
+			    FuProgress *progress,
+			    GError **error) G_GNUC_WARN_UNUSED_RESULT;
@@ -9,7 +9,11 @@
 #include "config.h"
 
 #ifdef HAVE_GIO_UNIX
+#include <fcntl.h>
 #include <gio/gunixinputstream.h>
+#include <glib/gstdio.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #endif
 
 #include "fwupd-error.h"
@@ -80,6 +84,43 @@ fu_bytes_get_contents(const gchar *filename, GError **error)
 	return g_bytes_new_take(data, len);
 }
 
+#ifdef HAVE_GIO_UNIX
+/* accessing a mapping after the file has been truncated raises SIGBUS, and writes change the
+ * data after it has been verified, so only map files that are sealed against all modification */
+static gboolean
+fu_bytes_fd_can_mmap(gint fd, gsize *size)
+{
+#ifdef F_GET_SEALS
+	struct stat st = {0x0};
+	gint seals;
+	const gint seals_required = F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE;
+
+	if (fstat(fd, &st) != 0)
+		return FALSE;
+	if (!S_ISREG(st.st_mode) || st.st_size <= 0)
+		return FALSE;
+	if ((guint64)st.st_size > G_MAXSIZE)
+		return FALSE;
+	seals = fcntl(fd, F_GET_SEALS);
+	if (seals < 0 || (seals & seals_required) != seals_required)
+		return FALSE;
+	*size = st.st_size;
+	return TRUE;
+#else
+	return FALSE;
+#endif
+}
+
+static GBytes *
+fu_bytes_new_mmap_fd(gint fd, GError **error)
+{
+	g_autoptr(GMappedFile) mapped_file = g_mapped_file_new_from_fd(fd, FALSE, error);
+	if (mapped_file == NULL)
+		return NULL;
+	return g_mapped_file_get_bytes(mapped_file);
+}
+#endif
+
 /**
  * fu_bytes_get_contents_fd:
  * @fd: a file descriptor
@@ -88,6 +129,9 @@ fu_bytes_get_contents(const gchar *filename, GError **error)
  *
  * Reads a blob from a specific file descriptor.
  *
+ * If the file descriptor is a memfd sealed against shrinking, growing and writing then the file
+ * is mapped into memory rather than being copied.
+ *
  * Note: this will close the fd when done
  *
  * Returns: (transfer full): a #GBytes, or %NULL
@@ -98,11 +142,30 @@ GBytes *
 fu_bytes_get_contents_fd(gint fd, gsize count, GError **error)
 {
 #ifdef HAVE_GIO_UNIX
+	gsize size = 0;
 	g_autoptr(GInputStream) stream = NULL;
 
 	g_return_val_if_fail(fd > 0, NULL);
 	g_return_val_if_fail(error == NULL || *error == NULL, NULL);
 
+	/* map the entire file if it was not already partially read */
+	if (fu_bytes_fd_can_mmap(fd, &size) && lseek(fd, 0, SEEK_CUR) == 0) {
+		g_autoptr(GBytes) blob = NULL;
+		if (size > count) {
+			g_set_error(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_INVALID_FILE,
+				    "cannot read from fd: 0x%x > 0x%x",
+				    (guint)size,
+				    (guint)count);
+			g_close(fd, NULL);
+			return NULL;
+		}
+		blob = fu_bytes_new_mmap_fd(fd, error);
+		g_close(fd, NULL);
+		return g_steal_pointer(&blob);
+	}
+
 	/* read the entire fd to a data blob */
 	stream = g_unix_input_stream_new(fd, TRUE);
 	return fu_bytes_get_contents_stream(stream, count, error);
@@ -423,3 +486,50 @@ fu_bytes_get_data_safe(GBytes *bytes, gsize *bufsz, GError **error)
 	}
 	return buf;
 }
+
+/* small enough that each block is still in the L1 cache for every checksum type */
+#define FU_BYTES_CHECKSUM_BLOCK_SIZE 0x4000
+
+/**
+ * fu_bytes_get_checksums:
+ * @bytes: data blob
+ * @csum_kinds: (array length=csum_kindsz): checksum types, e.g. %G_CHECKSUM_SHA256
+ * @csum_kindsz: number of elements in @csum_kinds
+ *
+ * Calculates several checksums of the data in a single pass, which is much faster than calling
+ * g_compute_checksum_for_bytes() for each type when the blob is larger than the CPU cache.
+ *
+ * Returns: (transfer container) (element-type utf8): checksums in the same order as @csum_kinds
+ *
+ * Since: 1.9.4
+ **/
+GPtrArray *
+fu_bytes_get_checksums(GBytes *bytes, const GChecksumType *csum_kinds, gsize csum_kindsz)
+{
+	const guint8 *buf;
+	gsize bufsz = 0;
+	g_autoptr(GPtrArray) csums = NULL;
+	g_autoptr(GPtrArray) checksums = g_ptr_array_new_with_free_func(g_free);
+
+	g_return_val_if_fail(bytes != NULL, NULL);
+	g_return_val_if_fail(csum_kinds != NULL || csum_kindsz == 0, NULL);
+
+	/* update every checksum with each block in turn */
+	csums = g_ptr_array_new_with_free_func((GDestroyNotify)g_checksum_free);
+	for (gsize i = 0; i < csum_kindsz; i++) {
+		GChecksum *csum = g_checksum_new(csum_kinds[i]);
+		g_return_val_if_fail(csum != NULL, NULL);
+		g_ptr_array_add(csums, csum);
+	}
+	buf = g_bytes_get_data(bytes, &bufsz);
+	for (gsize offset = 0; offset < bufsz; offset += FU_BYTES_CHECKSUM_BLOCK_SIZE) {
+		gsize blocksz = MIN(bufsz - offset, FU_BYTES_CHECKSUM_BLOCK_SIZE);
+		for (guint i = 0; i < csums->len; i++)
+			g_checksum_update(g_ptr_array_index(csums, i), buf + offset, blocksz);
+	}
+	for (guint i = 0; i < csums->len; i++) {
+		GChecksum *csum = g_ptr_array_index(csums, i);
+		g_ptr_array_add(checksums, g_strdup(g_checksum_get_string(csum)));
+	}
+	return g_steal_pointer(&checksums);
+}
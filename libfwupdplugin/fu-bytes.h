@@ -36,3 +36,5 @@ fu_bytes_pad(GBytes *bytes, gsize sz);
 GBytes *
 fu_bytes_new_offset(GBytes *bytes, gsize offset, gsize length, GError **error)
     G_GNUC_WARN_UNUSED_RESULT;
+GPtrArray *
+fu_bytes_get_checksums(GBytes *bytes, const GChecksumType *csum_kinds, gsize csum_kindsz);
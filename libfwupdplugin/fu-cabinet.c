@@ -15,6 +15,7 @@
 #include "fwupd-enums.h"
 #include "fwupd-error.h"
 
+#include "fu-bytes.h"
 #include "fu-cabinet.h"
 #include "fu-common.h"
 #include "fu-string.h"
@@ -1085,11 +1086,14 @@ fu_cabinet_parse(FuCabinet *self, GBytes *data, FuCabinetParseFlags flags, GErro
 
 	/* decompress and calculate container hashes */
 	if (data != NULL) {
+		GChecksumType checksum_types[] = {G_CHECKSUM_SHA1, G_CHECKSUM_SHA256};
+		g_autoptr(GPtrArray) checksums = NULL;
 		if (!fu_cabinet_decompress(self, data, error))
 			return FALSE;
-		self->container_checksum = g_compute_checksum_for_bytes(G_CHECKSUM_SHA1, data);
-		self->container_checksum_alt =
-		    g_compute_checksum_for_bytes(G_CHECKSUM_SHA256, data);
+		checksums =
+		    fu_bytes_get_checksums(data, checksum_types, G_N_ELEMENTS(checksum_types));
+		self->container_checksum = g_strdup(g_ptr_array_index(checksums, 0));
+		self->container_checksum_alt = g_strdup(g_ptr_array_index(checksums, 1));
 	}
 
 	/* build xmlb silo */
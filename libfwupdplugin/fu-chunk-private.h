@@ -15,3 +15,5 @@ void
 fu_chunk_export(FuChunk *self, FuFirmwareExportFlags flags, XbBuilderNode *bn);
 gboolean
 fu_chunk_build(FuChunk *self, XbNode *n, GError **error);
+gboolean
+fu_chunk_is_mutable(FuChunk *self);
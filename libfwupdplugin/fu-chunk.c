@@ -287,6 +287,13 @@ fu_chunk_bytes_new(GBytes *bytes)
 	return self;
 }
 
+gboolean
+fu_chunk_is_mutable(FuChunk *self)
+{
+	g_return_val_if_fail(FU_IS_CHUNK(self), FALSE);
+	return self->is_mutable;
+}
+
 void
 fu_chunk_export(FuChunk *self, FuFirmwareExportFlags flags, XbBuilderNode *bn)
 {
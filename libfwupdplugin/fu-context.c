@@ -8,6 +8,8 @@
 
 #include "config.h"
 
+#include "fwupd-common.h"
+
 #include "fu-bios-settings-private.h"
 #include "fu-config-private.h"
 #include "fu-context-private.h"
@@ -44,8 +46,13 @@ typedef struct {
 	FuBiosSettings *host_bios_settings;
 	gboolean loaded_hwinfo;
 	FuFirmware *fdt; /* optional */
+	GHashTable *guid_cache; /* instance-id:guid */
+	GMutex guid_cache_mutex;
 } FuContextPrivate;
 
+/* enough for every instance ID of every device on a large system */
+#define FU_CONTEXT_GUID_CACHE_SIZE_MAX 8192
+
 enum { SIGNAL_SECURITY_CHANGED, SIGNAL_LAST };
 
 enum {
@@ -747,6 +754,83 @@ fu_context_add_quirk_key(FuContext *self, const gchar *key)
 	fu_quirks_add_possible_key(priv->quirks, key);
 }
 
+/* the mutex must be held */
+static const gchar *
+fu_context_guid_cache_lookup(FuContext *self, const gchar *instance_id)
+{
+	FuContextPrivate *priv = GET_PRIVATE(self);
+	const gchar *guid = g_hash_table_lookup(priv->guid_cache, instance_id);
+	if (guid != NULL)
+		return guid;
+
+	/* this is not an LRU, but the working set is small and nearly always hits */
+	if (g_hash_table_size(priv->guid_cache) >= FU_CONTEXT_GUID_CACHE_SIZE_MAX) {
+		g_debug("GUID cache full, clearing");
+		g_hash_table_remove_all(priv->guid_cache);
+	}
+	guid = fwupd_guid_hash_string(instance_id);
+	g_hash_table_insert(priv->guid_cache, g_strdup(instance_id), (gpointer)guid);
+	return guid;
+}
+
+/**
+ * fu_context_get_guid_for_instance_id:
+ * @self: a #FuContext
+ * @instance_id: a device instance ID, e.g. `USB\VID_1234&PID_5678`
+ *
+ * Converts an instance ID to a GUID using fwupd_guid_hash_string(), remembering the result as
+ * the same instance IDs are hashed many times when adding devices and matching quirks.
+ *
+ * Returns: (transfer full): a GUID, or %NULL if @instance_id is empty
+ *
+ * Since: 1.9.4
+ **/
+gchar *
+fu_context_get_guid_for_instance_id(FuContext *self, const gchar *instance_id)
+{
+	FuContextPrivate *priv = GET_PRIVATE(self);
+	g_autoptr(GMutexLocker) locker = NULL;
+
+	g_return_val_if_fail(FU_IS_CONTEXT(self), NULL);
+
+	if (instance_id == NULL || instance_id[0] == '\0')
+		return NULL;
+	locker = g_mutex_locker_new(&priv->guid_cache_mutex);
+	return g_strdup(fu_context_guid_cache_lookup(self, instance_id));
+}
+
+/**
+ * fu_context_get_guids_for_instance_ids:
+ * @self: a #FuContext
+ * @instance_ids: (element-type utf8): device instance IDs
+ *
+ * Converts all the instance IDs of a device to GUIDs in one pass.
+ *
+ * Returns: (transfer container) (element-type utf8): GUIDs, in the same order as @instance_ids
+ *
+ * Since: 1.9.4
+ **/
+GPtrArray *
+fu_context_get_guids_for_instance_ids(FuContext *self, GPtrArray *instance_ids)
+{
+	FuContextPrivate *priv = GET_PRIVATE(self);
+	GPtrArray *guids;
+	g_autoptr(GMutexLocker) locker = NULL;
+
+	g_return_val_if_fail(FU_IS_CONTEXT(self), NULL);
+	g_return_val_if_fail(instance_ids != NULL, NULL);
+
+	guids = g_ptr_array_new_full(instance_ids->len, g_free);
+	locker = g_mutex_locker_new(&priv->guid_cache_mutex);
+	for (guint i = 0; i < instance_ids->len; i++) {
+		const gchar *instance_id = g_ptr_array_index(instance_ids, i);
+		if (instance_id == NULL || instance_id[0] == '\0')
+			continue;
+		g_ptr_array_add(guids, g_strdup(fu_context_guid_cache_lookup(self, instance_id)));
+	}
+	return guids;
+}
+
 /**
  * fu_context_lookup_quirk_by_id:
  * @self: a #FuContext
@@ -1390,6 +1474,8 @@ fu_context_finalize(GObject *object)
 	g_hash_table_unref(priv->firmware_gtypes);
 	g_ptr_array_unref(priv->udev_subsystems);
 	g_ptr_array_unref(priv->esp_volumes);
+	g_hash_table_unref(priv->guid_cache);
+	g_mutex_clear(&priv->guid_cache_mutex);
 
 	G_OBJECT_CLASS(fu_context_parent_class)->finalize(object);
 }
@@ -1522,6 +1608,8 @@ fu_context_init(FuContext *self)
 	priv->quirks = fu_quirks_new();
 	priv->host_bios_settings = fu_bios_settings_new();
 	priv->esp_volumes = g_ptr_array_new_with_free_func((GDestroyNotify)g_object_unref);
+	priv->guid_cache = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
+	g_mutex_init(&priv->guid_cache_mutex);
 }
 
 /**
@@ -109,6 +109,10 @@ fu_context_lookup_quirk_by_id_iter(FuContext *self,
 				   gpointer user_data);
 void
 fu_context_add_quirk_key(FuContext *self, const gchar *key);
+gchar *
+fu_context_get_guid_for_instance_id(FuContext *self, const gchar *instance_id);
+GPtrArray *
+fu_context_get_guids_for_instance_ids(FuContext *self, GPtrArray *instance_ids);
 void
 fu_context_security_changed(FuContext *self);
 
@@ -46,6 +46,8 @@ void
 fu_device_ensure_from_component(FuDevice *self, XbNode *component);
 void
 fu_device_convert_instance_ids(FuDevice *self);
+GPtrArray *
+fu_device_get_instance_id_guids(FuDevice *self);
 gchar *
 fu_device_get_guids_as_str(FuDevice *self);
 GPtrArray *
@@ -1561,6 +1561,34 @@ fu_device_has_parent_guid(FuDevice *self, const gchar *guid)
 	return FALSE;
 }
 
+/* uses the context GUID cache where possible */
+static gchar *
+fu_device_guid_hash_string(FuDevice *self, const gchar *str)
+{
+	FuDevicePrivate *priv = GET_PRIVATE(self);
+	if (priv->ctx == NULL)
+		return fwupd_guid_hash_string(str);
+	return fu_context_get_guid_for_instance_id(priv->ctx, str);
+}
+
+static GPtrArray *
+fu_device_guid_hash_strings(FuDevice *self, GPtrArray *instance_ids)
+{
+	FuDevicePrivate *priv = GET_PRIVATE(self);
+	GPtrArray *guids;
+
+	if (priv->ctx != NULL)
+		return fu_context_get_guids_for_instance_ids(priv->ctx, instance_ids);
+	guids = g_ptr_array_new_with_free_func(g_free);
+	for (guint i = 0; i < instance_ids->len; i++) {
+		const gchar *instance_id = g_ptr_array_index(instance_ids, i);
+		gchar *guid = fwupd_guid_hash_string(instance_id);
+		if (guid != NULL)
+			g_ptr_array_add(guids, guid);
+	}
+	return guids;
+}
+
 /**
  * fu_device_add_parent_guid:
  * @self: a #FuDevice
@@ -1587,7 +1615,7 @@ fu_device_add_parent_guid(FuDevice *self, const gchar *guid)
 
 	/* make valid */
 	if (!fwupd_guid_is_valid(guid)) {
-		g_autofree gchar *tmp = fwupd_guid_hash_string(guid);
+		g_autofree gchar *tmp = fu_device_guid_hash_string(self, guid);
 		if (fu_device_has_parent_guid(self, tmp))
 			return;
 		g_debug("using %s for %s", tmp, guid);
@@ -2156,7 +2184,7 @@ fu_device_has_guid(FuDevice *self, const gchar *guid)
 
 	/* make valid */
 	if (!fwupd_guid_is_valid(guid)) {
-		g_autofree gchar *tmp = fwupd_guid_hash_string(guid);
+		g_autofree gchar *tmp = fu_device_guid_hash_string(self, guid);
 		return fwupd_device_has_guid(FWUPD_DEVICE(self), tmp);
 	}
 
@@ -2219,7 +2247,7 @@ fu_device_add_instance_id_full(FuDevice *self,
 	 * calling fu_device_add_guid_safe() -- but we want the quirks to match
 	 * so the plugin is set, but not the LVFS metadata to match firmware
 	 * until we're sure the device isn't using _NO_AUTO_INSTANCE_IDS */
-	guid = fwupd_guid_hash_string(instance_id);
+	guid = fu_device_guid_hash_string(self, instance_id);
 	if (flags & FU_DEVICE_INSTANCE_FLAG_QUIRKS)
 		fu_device_add_guid_quirks(self, guid);
 	if (flags & FU_DEVICE_INSTANCE_FLAG_VISIBLE)
@@ -2325,7 +2353,7 @@ fu_device_add_counterpart_guid(FuDevice *self, const gchar *guid)
 
 	/* make valid */
 	if (!fwupd_guid_is_valid(guid)) {
-		g_autofree gchar *tmp = fwupd_guid_hash_string(guid);
+		g_autofree gchar *tmp = fu_device_guid_hash_string(self, guid);
 		fwupd_device_add_guid(FWUPD_DEVICE(self), tmp);
 		return;
 	}
@@ -3968,7 +3996,7 @@ fu_device_add_string(FuDevice *self, guint idt, GString *str)
 		g_string_append(str, tmp);
 	for (guint i = 0; i < priv->instance_id_quirks->len; i++) {
 		const gchar *instance_id = g_ptr_array_index(priv->instance_id_quirks, i);
-		g_autofree gchar *guid = fwupd_guid_hash_string(instance_id);
+		g_autofree gchar *guid = fu_device_guid_hash_string(self, instance_id);
 		g_autofree gchar *tmp2 = g_strdup_printf("%s ← %s", guid, instance_id);
 		fu_string_append(str, idt + 1, "Guid[quirks]", tmp2);
 	}
@@ -4893,6 +4921,24 @@ fu_device_set_progress(FuDevice *self, FuProgress *progress)
 	klass->set_progress(self, progress);
 }
 
+/**
+ * fu_device_get_instance_id_guids:
+ * @self: a #FuDevice
+ *
+ * Converts all the visible instance IDs of the device to GUIDs in one pass, using the context
+ * GUID cache where possible.
+ *
+ * Returns: (transfer container) (element-type utf8): GUIDs
+ *
+ * Since: 1.9.4
+ **/
+GPtrArray *
+fu_device_get_instance_id_guids(FuDevice *self)
+{
+	g_return_val_if_fail(FU_IS_DEVICE(self), NULL);
+	return fu_device_guid_hash_strings(self, fwupd_device_get_instance_ids(FWUPD_DEVICE(self)));
+}
+
 /**
  * fu_device_convert_instance_ids:
  * @self: a #FuDevice
@@ -4910,15 +4956,14 @@ fu_device_set_progress(FuDevice *self, FuProgress *progress)
 void
 fu_device_convert_instance_ids(FuDevice *self)
 {
-	GPtrArray *instance_ids;
+	g_autoptr(GPtrArray) guids = NULL;
 
 	/* OEM specific hardware */
 	if (fu_device_has_internal_flag(self, FU_DEVICE_INTERNAL_FLAG_NO_AUTO_INSTANCE_IDS))
 		return;
-	instance_ids = fwupd_device_get_instance_ids(FWUPD_DEVICE(self));
-	for (guint i = 0; i < instance_ids->len; i++) {
-		const gchar *instance_id = g_ptr_array_index(instance_ids, i);
-		g_autofree gchar *guid = fwupd_guid_hash_string(instance_id);
+	guids = fu_device_get_instance_id_guids(self);
+	for (guint i = 0; i < guids->len; i++) {
+		const gchar *guid = g_ptr_array_index(guids, i);
 		fwupd_device_add_guid(FWUPD_DEVICE(self), guid);
 	}
 }
@@ -5230,6 +5275,7 @@ fu_device_incorporate(FuDevice *self, FuDevice *donor)
 	GPtrArray *parent_physical_ids = fu_device_get_parent_physical_ids(donor);
 	GHashTableIter iter;
 	gpointer key, value;
+	g_autoptr(GPtrArray) guids = NULL;
 
 	g_return_if_fail(FU_IS_DEVICE(self));
 	g_return_if_fail(FU_IS_DEVICE(donor));
@@ -5301,9 +5347,9 @@ fu_device_incorporate(FuDevice *self, FuDevice *donor)
 		klass->incorporate(self, donor);
 
 	/* call the set_quirk_kv() vfunc for the superclassed object */
-	for (guint i = 0; i < instance_ids->len; i++) {
-		const gchar *instance_id = g_ptr_array_index(instance_ids, i);
-		g_autofree gchar *guid = fwupd_guid_hash_string(instance_id);
+	guids = fu_device_guid_hash_strings(self, instance_ids);
+	for (guint i = 0; i < guids->len; i++) {
+		const gchar *guid = g_ptr_array_index(guids, i);
 		fu_device_add_guid_quirks(self, guid);
 	}
 }
@@ -80,20 +80,20 @@ fu_efi_firmware_file_parse(FuFirmware *firmware,
 	guint32 size = 0x0;
 	const guint8 *buf = g_bytes_get_data(fw, &bufsz);
 	g_autofree gchar *guid_str = NULL;
-	g_autoptr(GByteArray) st = NULL;
+	const FuStructEfiFileView *st;
 	g_autoptr(GBytes) blob = NULL;
 
 	/* parse */
-	st = fu_struct_efi_file_parse(buf, bufsz, offset, error);
+	st = fu_struct_efi_file_view(buf, bufsz, offset, error);
 	if (st == NULL)
 		return FALSE;
-	priv->type = fu_struct_efi_file_get_type(st);
-	priv->attrib = fu_struct_efi_file_get_attrs(st);
-	guid_str =
-	    fwupd_guid_to_string(fu_struct_efi_file_get_name(st), FWUPD_GUID_FLAG_MIXED_ENDIAN);
+	priv->type = fu_struct_efi_file_view_get_type(st);
+	priv->attrib = fu_struct_efi_file_view_get_attrs(st);
+	guid_str = fwupd_guid_to_string(fu_struct_efi_file_view_get_name(st),
+					FWUPD_GUID_FLAG_MIXED_ENDIAN);
 	fu_firmware_set_id(firmware, guid_str);
-	size = fu_struct_efi_file_get_size(st);
-	if (size < st->len) {
+	size = fu_struct_efi_file_view_get_size(st);
+	if (size < FU_STRUCT_EFI_FILE_SIZE) {
 		g_set_error(error,
 			    FWUPD_ERROR,
 			    FWUPD_ERROR_INTERNAL,
@@ -107,23 +107,26 @@ fu_efi_firmware_file_parse(FuFirmware *firmware,
 		guint8 hdr_checksum_verify;
 		g_autoptr(GBytes) hdr_blob = NULL;
 
-		hdr_blob = fu_bytes_new_offset(fw, 0x0, st->len, error);
+		hdr_blob = fu_bytes_new_offset(fw, 0x0, FU_STRUCT_EFI_FILE_SIZE, error);
 		if (hdr_blob == NULL)
 			return FALSE;
 		hdr_checksum_verify = fu_efi_firmware_file_hdr_checksum8(hdr_blob);
-		if (hdr_checksum_verify != fu_struct_efi_file_get_hdr_checksum(st)) {
+		if (hdr_checksum_verify != fu_struct_efi_file_view_get_hdr_checksum(st)) {
 			g_set_error(error,
 				    FWUPD_ERROR,
 				    FWUPD_ERROR_INVALID_FILE,
 				    "checksum invalid, got %02x, expected %02x",
 				    hdr_checksum_verify,
-				    fu_struct_efi_file_get_hdr_checksum(st));
+				    fu_struct_efi_file_view_get_hdr_checksum(st));
 			return FALSE;
 		}
 	}
 
 	/* add simple blob */
-	blob = fu_bytes_new_offset(fw, st->len, size - st->len, error);
+	blob = fu_bytes_new_offset(fw,
+				   FU_STRUCT_EFI_FILE_SIZE,
+				   size - FU_STRUCT_EFI_FILE_SIZE,
+				   error);
 	if (blob == NULL)
 		return FALSE;
 
@@ -139,13 +142,13 @@ fu_efi_firmware_file_parse(FuFirmware *firmware,
 	if ((priv->attrib & FU_EFI_FILE_ATTRIB_CHECKSUM) > 0 &&
 	    (flags & FWUPD_INSTALL_FLAG_IGNORE_CHECKSUM) == 0) {
 		guint8 data_checksum_verify = 0x100 - fu_sum8_bytes(blob);
-		if (data_checksum_verify != fu_struct_efi_file_get_data_checksum(st)) {
+		if (data_checksum_verify != fu_struct_efi_file_view_get_data_checksum(st)) {
 			g_set_error(error,
 				    FWUPD_ERROR,
 				    FWUPD_ERROR_INVALID_FILE,
 				    "checksum invalid, got %02x, expected %02x",
 				    data_checksum_verify,
-				    fu_struct_efi_file_get_data_checksum(st));
+				    fu_struct_efi_file_view_get_data_checksum(st));
 			return FALSE;
 		}
 	}
@@ -25,6 +25,8 @@
 
 typedef struct {
 	guint8 type;
+	GBytes *blob_lzma; /* nullable, deferred until the images are required */
+	FwupdInstallFlags parse_flags;
 } FuEfiFirmwareSectionPrivate;
 
 G_DEFINE_TYPE_WITH_PRIVATE(FuEfiFirmwareSection, fu_efi_firmware_section, FU_TYPE_FIRMWARE)
@@ -60,13 +62,16 @@ fu_efi_firmware_section_parse(FuFirmware *firmware,
 	guint32 size;
 	const guint8 *buf = g_bytes_get_data(fw, &bufsz);
 	g_autoptr(GBytes) blob = NULL;
-	g_autoptr(GByteArray) st = NULL;
+	const FuStructEfiSectionView *st;
+
+	/* only set again if this section is compressed */
+	g_clear_pointer(&priv->blob_lzma, g_bytes_unref);
 
 	/* parse */
-	st = fu_struct_efi_section_parse(buf, bufsz, offset, error);
+	st = fu_struct_efi_section_view(buf, bufsz, offset, error);
 	if (st == NULL)
 		return FALSE;
-	size = fu_struct_efi_section_get_size(st);
+	size = fu_struct_efi_section_view_get_size(st);
 	if (size < FU_STRUCT_EFI_SECTION_SIZE) {
 		g_set_error(error,
 			    FWUPD_ERROR,
@@ -77,29 +82,34 @@ fu_efi_firmware_section_parse(FuFirmware *firmware,
 	}
 
 	/* name */
-	priv->type = fu_struct_efi_section_get_type(st);
+	priv->type = fu_struct_efi_section_view_get_type(st);
 	if (priv->type == FU_EFI_SECTION_TYPE_GUID_DEFINED) {
+		guint16 data_offset;
 		g_autofree gchar *guid_str = NULL;
-		g_autoptr(GByteArray) st_def = NULL;
-		st_def = fu_struct_efi_section_guid_defined_parse(buf, bufsz, st->len, error);
+		const FuStructEfiSectionGuidDefinedView *st_def;
+		st_def = fu_struct_efi_section_guid_defined_view(buf,
+								 bufsz,
+								 FU_STRUCT_EFI_SECTION_SIZE,
+								 error);
 		if (st_def == NULL)
 			return FALSE;
-		guid_str = fwupd_guid_to_string(fu_struct_efi_section_guid_defined_get_name(st_def),
-						FWUPD_GUID_FLAG_MIXED_ENDIAN);
+		guid_str =
+		    fwupd_guid_to_string(fu_struct_efi_section_guid_defined_view_get_name(st_def),
+					 FWUPD_GUID_FLAG_MIXED_ENDIAN);
 		fu_firmware_set_id(firmware, guid_str);
-		if (fu_struct_efi_section_guid_defined_get_offset(st_def) <
-		    FU_STRUCT_EFI_SECTION_SIZE) {
+		data_offset = fu_struct_efi_section_guid_defined_view_get_offset(st_def);
+		if (data_offset < FU_STRUCT_EFI_SECTION_SIZE) {
 			g_set_error(error,
 				    FWUPD_ERROR,
 				    FWUPD_ERROR_INTERNAL,
 				    "invalid section size, got 0x%x",
-				    (guint)fu_struct_efi_section_guid_defined_get_offset(st_def));
+				    (guint)data_offset);
 			return FALSE;
 		}
 	}
 
 	/* create blob */
-	offset += st->len;
+	offset += FU_STRUCT_EFI_SECTION_SIZE;
 	blob = fu_bytes_new_offset(fw, offset, size - offset, error);
 	if (blob == NULL)
 		return FALSE;
@@ -118,20 +128,34 @@ fu_efi_firmware_section_parse(FuFirmware *firmware,
 	} else if (priv->type == FU_EFI_SECTION_TYPE_GUID_DEFINED &&
 		   g_strcmp0(fu_firmware_get_id(firmware), FU_EFI_FIRMWARE_SECTION_LZMA_COMPRESS) ==
 		       0) {
-		g_autoptr(GBytes) blob_uncomp = NULL;
-
-		/* parse all sections */
-		blob_uncomp = fu_efi_firmware_decompress_lzma(blob, error);
-		if (blob_uncomp == NULL)
-			return FALSE;
-		if (!fu_efi_firmware_parse_sections(firmware, blob_uncomp, flags, error))
-			return FALSE;
+		/* decompressing is slow, so only parse the sections when required */
+		priv->blob_lzma = g_bytes_ref(blob);
+		priv->parse_flags = flags;
 	}
 
 	/* success */
 	return TRUE;
 }
 
+static gboolean
+fu_efi_firmware_section_ensure_images(FuFirmware *firmware, GError **error)
+{
+	FuEfiFirmwareSection *self = FU_EFI_FIRMWARE_SECTION(firmware);
+	FuEfiFirmwareSectionPrivate *priv = GET_PRIVATE(self);
+	g_autoptr(GBytes) blob_lzma = g_steal_pointer(&priv->blob_lzma);
+	g_autoptr(GBytes) blob_uncomp = NULL;
+
+	/* not compressed */
+	if (blob_lzma == NULL)
+		return TRUE;
+
+	/* parse all sections */
+	blob_uncomp = fu_efi_firmware_decompress_lzma(blob_lzma, error);
+	if (blob_uncomp == NULL)
+		return FALSE;
+	return fu_efi_firmware_parse_sections(firmware, blob_uncomp, priv->parse_flags, error);
+}
+
 static GByteArray *
 fu_efi_firmware_section_write(FuFirmware *firmware, GError **error)
 {
@@ -190,14 +214,27 @@ fu_efi_firmware_section_init(FuEfiFirmwareSection *self)
 	//	fu_firmware_set_alignment (FU_FIRMWARE (self), FU_FIRMWARE_ALIGNMENT_8);
 }
 
+static void
+fu_efi_firmware_section_finalize(GObject *object)
+{
+	FuEfiFirmwareSection *self = FU_EFI_FIRMWARE_SECTION(object);
+	FuEfiFirmwareSectionPrivate *priv = GET_PRIVATE(self);
+	if (priv->blob_lzma != NULL)
+		g_bytes_unref(priv->blob_lzma);
+	G_OBJECT_CLASS(fu_efi_firmware_section_parent_class)->finalize(object);
+}
+
 static void
 fu_efi_firmware_section_class_init(FuEfiFirmwareSectionClass *klass)
 {
+	GObjectClass *object_class = G_OBJECT_CLASS(klass);
 	FuFirmwareClass *klass_firmware = FU_FIRMWARE_CLASS(klass);
+	object_class->finalize = fu_efi_firmware_section_finalize;
 	klass_firmware->parse = fu_efi_firmware_section_parse;
 	klass_firmware->write = fu_efi_firmware_section_write;
 	klass_firmware->build = fu_efi_firmware_section_build;
 	klass_firmware->export = fu_efi_firmware_section_export;
+	klass_firmware->ensure_images = fu_efi_firmware_section_ensure_images;
 }
 
 /**
@@ -69,20 +69,20 @@ fu_efi_firmware_volume_parse(FuFirmware *firmware,
 	const guint8 *buf = g_bytes_get_data(fw, &bufsz);
 	g_autofree gchar *guid_str = NULL;
 	g_autoptr(GBytes) blob = NULL;
-	g_autoptr(GByteArray) st_hdr = NULL;
+	const FuStructEfiVolumeView *st_hdr;
 
 	/* parse */
-	st_hdr = fu_struct_efi_volume_parse(buf, bufsz, offset, error);
+	st_hdr = fu_struct_efi_volume_view(buf, bufsz, offset, error);
 	if (st_hdr == NULL)
 		return FALSE;
 
 	/* guid */
-	guid_str = fwupd_guid_to_string(fu_struct_efi_volume_get_guid(st_hdr),
+	guid_str = fwupd_guid_to_string(fu_struct_efi_volume_view_get_guid(st_hdr),
 					FWUPD_GUID_FLAG_MIXED_ENDIAN);
 	g_debug("volume GUID: %s [%s]", guid_str, fu_efi_guid_to_name(guid_str));
 
 	/* length */
-	fv_length = fu_struct_efi_volume_get_length(st_hdr);
+	fv_length = fu_struct_efi_volume_view_get_length(st_hdr);
 	if (fv_length == 0x0) {
 		g_set_error_literal(error,
 				    FWUPD_ERROR,
@@ -91,7 +91,7 @@ fu_efi_firmware_volume_parse(FuFirmware *firmware,
 		return FALSE;
 	}
 	fu_firmware_set_size(firmware, fv_length);
-	attrs = fu_struct_efi_volume_get_attrs(st_hdr);
+	attrs = fu_struct_efi_volume_view_get_attrs(st_hdr);
 	alignment = (attrs & 0x00ff0000) >> 16;
 	if (alignment > FU_FIRMWARE_ALIGNMENT_2G) {
 		g_set_error(error,
@@ -104,9 +104,9 @@ fu_efi_firmware_volume_parse(FuFirmware *firmware,
 	}
 	fu_firmware_set_alignment(firmware, alignment);
 	priv->attrs = attrs & 0xffff;
-	hdr_length = fu_struct_efi_volume_get_hdr_len(st_hdr);
-	if (hdr_length < st_hdr->len || hdr_length > fv_length || hdr_length > bufsz ||
-	    hdr_length % 2 != 0) {
+	hdr_length = fu_struct_efi_volume_view_get_hdr_len(st_hdr);
+	if (hdr_length < FU_STRUCT_EFI_VOLUME_SIZE || hdr_length > fv_length ||
+	    hdr_length > bufsz || hdr_length % 2 != 0) {
 		g_set_error(error,
 			    FWUPD_ERROR,
 			    FWUPD_ERROR_INTERNAL,
@@ -124,7 +124,7 @@ fu_efi_firmware_volume_parse(FuFirmware *firmware,
 				    FWUPD_ERROR_INVALID_FILE,
 				    "checksum invalid, got %02x, expected %02x",
 				    checksum_verify,
-				    fu_struct_efi_volume_get_checksum(st_hdr));
+				    fu_struct_efi_volume_view_get_checksum(st_hdr));
 			return FALSE;
 		}
 	}
@@ -149,17 +149,17 @@ fu_efi_firmware_volume_parse(FuFirmware *firmware,
 	}
 
 	/* skip the blockmap */
-	offset += st_hdr->len;
+	offset += FU_STRUCT_EFI_VOLUME_SIZE;
 	while (offset < bufsz) {
 		guint32 num_blocks;
 		guint32 length;
-		g_autoptr(GByteArray) st_blk = NULL;
-		st_blk = fu_struct_efi_volume_block_map_parse(buf, bufsz, offset, error);
+		const FuStructEfiVolumeBlockMapView *st_blk;
+		st_blk = fu_struct_efi_volume_block_map_view(buf, bufsz, offset, error);
 		if (st_blk == NULL)
 			return FALSE;
-		num_blocks = fu_struct_efi_volume_block_map_get_num_blocks(st_blk);
-		length = fu_struct_efi_volume_block_map_get_length(st_blk);
-		offset += st_blk->len;
+		num_blocks = fu_struct_efi_volume_block_map_view_get_num_blocks(st_blk);
+		length = fu_struct_efi_volume_block_map_view_get_length(st_blk);
+		offset += FU_STRUCT_EFI_VOLUME_BLOCK_MAP_SIZE;
 		if (num_blocks == 0x0 && length == 0x0)
 			break;
 		blockmap_sz += (gsize)num_blocks * (gsize)length;
@@ -33,7 +33,7 @@ enum EfiFileType {
     FfsPad = 0xF0,
 }
 
-#[derive(New, Validate, Parse)]
+#[derive(New, Validate, Parse, View)]
 struct EfiFile {
     name: Guid,
     hdr_checksum: u8,
@@ -64,18 +64,18 @@ enum EfiSectionType {
     MmDepex = 0x1C,
 }
 
-#[derive(New, Validate, Parse)]
+#[derive(New, Validate, Parse, View)]
 struct EfiSection {
     size: u24le,
     type: EfiSectionType,
 }
-#[derive(New, Validate, Parse)]
+#[derive(New, Validate, Parse, View)]
 struct EfiSectionGuidDefined {
     name: Guid,
     offset: u16le,
     attr: u16le,
 }
-#[derive(New, Validate, Parse)]
+#[derive(New, Validate, Parse, View)]
 struct EfiVolume {
     zero_vector: Guid,
     guid: Guid,
@@ -88,7 +88,7 @@ struct EfiVolume {
     reserved: u8,
     revision: u8: const=0x02,
 }
-#[derive(New, Validate, Parse)]
+#[derive(New, Validate, Parse, View)]
 struct EfiVolumeBlockMap {
     num_blocks: u32le,
     length: u32le,
@@ -35,6 +35,124 @@ fu_efivar_get_filename(const gchar *guid, const gchar *name)
 	return g_strdup_printf("%s/%s-%s", efivardir, name, guid);
 }
 
+/* the names and sizes of every variable, read in one pass of the efivars directory */
+typedef struct {
+	gchar *path;
+	GPtrArray *names; /* (element-type utf8): name-guid, in directory order */
+	guint64 total;
+	GFileMonitor *monitor;
+} FuEfivarSnapshot;
+
+static GMutex fu_efivar_snapshot_mutex;
+static FuEfivarSnapshot *fu_efivar_snapshot = NULL;
+
+static void
+fu_efivar_snapshot_free(FuEfivarSnapshot *snapshot)
+{
+	if (snapshot->monitor != NULL) {
+		g_file_monitor_cancel(snapshot->monitor);
+		g_object_unref(snapshot->monitor);
+	}
+	g_ptr_array_unref(snapshot->names);
+	g_free(snapshot->path);
+	g_free(snapshot);
+}
+
+static void
+fu_efivar_snapshot_invalidate(void)
+{
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&fu_efivar_snapshot_mutex);
+	g_clear_pointer(&fu_efivar_snapshot, fu_efivar_snapshot_free);
+}
+
+static void
+fu_efivar_snapshot_monitor_changed_cb(GFileMonitor *monitor,
+				      GFile *file,
+				      GFile *other_file,
+				      GFileMonitorEvent event_type,
+				      gpointer user_data)
+{
+	fu_efivar_snapshot_invalidate();
+}
+
+static FuEfivarSnapshot *
+fu_efivar_snapshot_new(const gchar *path, GError **error)
+{
+	FuEfivarSnapshot *snapshot;
+	g_autoptr(GError) error_local = NULL;
+	g_autoptr(GFile) file = g_file_new_for_path(path);
+	g_autoptr(GFileEnumerator) enumerator = NULL;
+	g_autoptr(GFileMonitor) monitor = NULL;
+	g_autoptr(GPtrArray) names = g_ptr_array_new_with_free_func(g_free);
+	guint64 total = 0;
+
+	/* watch before reading so that no change can be missed */
+	monitor = g_file_monitor_directory(file, G_FILE_MONITOR_NONE, NULL, &error_local);
+	if (monitor == NULL) {
+		g_debug("failed to watch %s: %s", path, error_local->message);
+		g_clear_error(&error_local);
+	}
+
+	/* the sizes come back with the names, so each variable is only looked at once */
+	enumerator = g_file_enumerate_children(file,
+					       G_FILE_ATTRIBUTE_STANDARD_NAME
+					       "," G_FILE_ATTRIBUTE_STANDARD_ALLOCATED_SIZE
+					       "," G_FILE_ATTRIBUTE_STANDARD_SIZE,
+					       G_FILE_QUERY_INFO_NOFOLLOW_SYMLINKS,
+					       NULL,
+					       error);
+	if (enumerator == NULL)
+		return NULL;
+	while (TRUE) {
+		guint64 sz;
+		g_autoptr(GFileInfo) info = NULL;
+
+		info = g_file_enumerator_next_file(enumerator, NULL, &error_local);
+		if (info == NULL) {
+			if (error_local != NULL) {
+				g_propagate_error(error, g_steal_pointer(&error_local));
+				return NULL;
+			}
+			break;
+		}
+		sz = g_file_info_get_attribute_uint64(info,
+						      G_FILE_ATTRIBUTE_STANDARD_ALLOCATED_SIZE);
+		if (sz == 0)
+			sz = g_file_info_get_attribute_uint64(info, G_FILE_ATTRIBUTE_STANDARD_SIZE);
+		total += sz;
+		g_ptr_array_add(names, g_strdup(g_file_info_get_name(info)));
+	}
+
+	/* success */
+	snapshot = g_new0(FuEfivarSnapshot, 1);
+	snapshot->path = g_strdup(path);
+	snapshot->names = g_steal_pointer(&names);
+	snapshot->total = total;
+	if (monitor != NULL) {
+		g_file_monitor_set_rate_limit(monitor, 0);
+		g_signal_connect(monitor,
+				 "changed",
+				 G_CALLBACK(fu_efivar_snapshot_monitor_changed_cb),
+				 NULL);
+		snapshot->monitor = g_steal_pointer(&monitor);
+	}
+	return snapshot;
+}
+
+/* the caller must hold fu_efivar_snapshot_mutex */
+static FuEfivarSnapshot *
+fu_efivar_snapshot_ensure(GError **error)
+{
+	g_autofree gchar *path = fu_efivar_get_path();
+
+	/* the sysfs directory is changed by the self tests */
+	if (fu_efivar_snapshot != NULL && g_strcmp0(fu_efivar_snapshot->path, path) == 0)
+		return fu_efivar_snapshot;
+	g_clear_pointer(&fu_efivar_snapshot, fu_efivar_snapshot_free);
+	fu_efivar_snapshot = fu_efivar_snapshot_new(path, error);
+	return fu_efivar_snapshot;
+}
+
 gboolean
 fu_efivar_supported_impl(GError **error)
 {
@@ -130,8 +248,8 @@ fu_efivar_set_immutable(const gchar *fn, gboolean value, gboolean *value_old, GE
 	return fu_efivar_set_immutable_fd(fd, value, value_old, error);
 }
 
-gboolean
-fu_efivar_delete_impl(const gchar *guid, const gchar *name, GError **error)
+static gboolean
+fu_efivar_delete_internal(const gchar *guid, const gchar *name, GError **error)
 {
 	g_autofree gchar *fn = NULL;
 	g_autoptr(GFile) file = NULL;
@@ -148,7 +266,15 @@ fu_efivar_delete_impl(const gchar *guid, const gchar *name, GError **error)
 }
 
 gboolean
-fu_efivar_delete_with_glob_impl(const gchar *guid, const gchar *name_glob, GError **error)
+fu_efivar_delete_impl(const gchar *guid, const gchar *name, GError **error)
+{
+	gboolean ret = fu_efivar_delete_internal(guid, name, error);
+	fu_efivar_snapshot_invalidate();
+	return ret;
+}
+
+static gboolean
+fu_efivar_delete_with_glob_internal(const gchar *guid, const gchar *name_glob, GError **error)
 {
 	const gchar *fn;
 	g_autofree gchar *nameguid_glob = NULL;
@@ -174,21 +300,29 @@ fu_efivar_delete_with_glob_impl(const gchar *guid, const gchar *name_glob, GErro
 	return TRUE;
 }
 
+gboolean
+fu_efivar_delete_with_glob_impl(const gchar *guid, const gchar *name_glob, GError **error)
+{
+	gboolean ret = fu_efivar_delete_with_glob_internal(guid, name_glob, error);
+	fu_efivar_snapshot_invalidate();
+	return ret;
+}
+
 static gboolean
 fu_efivar_exists_guid(const gchar *guid)
 {
-	const gchar *fn;
-	g_autofree gchar *efivardir = fu_efivar_get_path();
-	g_autoptr(GDir) dir = NULL;
+	FuEfivarSnapshot *snapshot;
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&fu_efivar_snapshot_mutex);
 
-	dir = g_dir_open(efivardir, 0, NULL);
-	if (dir == NULL)
+	snapshot = fu_efivar_snapshot_ensure(NULL);
+	if (snapshot == NULL)
 		return FALSE;
-	while ((fn = g_dir_read_name(dir)) != NULL) {
+	for (guint i = 0; i < snapshot->names->len; i++) {
+		const gchar *fn = g_ptr_array_index(snapshot->names, i);
 		if (g_str_has_suffix(fn, guid))
 			return TRUE;
 	}
-	return TRUE;
+	return FALSE;
 }
 
 gboolean
@@ -278,16 +412,16 @@ fu_efivar_get_data_impl(const gchar *guid,
 GPtrArray *
 fu_efivar_get_names_impl(const gchar *guid, GError **error)
 {
-	const gchar *name_guid;
-	g_autofree gchar *path = fu_efivar_get_path();
-	g_autoptr(GDir) dir = NULL;
+	FuEfivarSnapshot *snapshot;
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&fu_efivar_snapshot_mutex);
 	g_autoptr(GPtrArray) names = g_ptr_array_new_with_free_func(g_free);
 
 	/* find names with matching GUID */
-	dir = g_dir_open(path, 0, error);
-	if (dir == NULL)
+	snapshot = fu_efivar_snapshot_ensure(error);
+	if (snapshot == NULL)
 		return NULL;
-	while ((name_guid = g_dir_read_name(dir)) != NULL) {
+	for (guint i = 0; i < snapshot->names->len; i++) {
+		const gchar *name_guid = g_ptr_array_index(snapshot->names, i);
 		gsize name_guidsz = strlen(name_guid);
 		if (name_guidsz < 38)
 			continue;
@@ -325,10 +459,10 @@ fu_efivar_get_monitor_impl(const gchar *guid, const gchar *name, GError **error)
 guint64
 fu_efivar_space_used_impl(GError **error)
 {
-	const gchar *fn;
+	FuEfivarSnapshot *snapshot;
 	guint64 total = 0;
-	g_autoptr(GDir) dir = NULL;
 	g_autofree gchar *path = fu_efivar_get_path();
+	g_autoptr(GMutexLocker) locker = NULL;
 	g_autoptr(GFile) file_fs = g_file_new_for_path(path);
 	g_autoptr(GFileInfo) info_fs = NULL;
 	g_autoptr(GError) error_local = NULL;
@@ -347,42 +481,21 @@ fu_efivar_space_used_impl(GError **error)
 			return total;
 	}
 
-	/* stat each file */
-	dir = g_dir_open(path, 0, error);
-	if (dir == NULL)
+	/* add up the size of each file */
+	locker = g_mutex_locker_new(&fu_efivar_snapshot_mutex);
+	snapshot = fu_efivar_snapshot_ensure(error);
+	if (snapshot == NULL)
 		return G_MAXUINT64;
-	while ((fn = g_dir_read_name(dir)) != NULL) {
-		guint64 sz;
-		g_autofree gchar *pathfn = g_build_filename(path, fn, NULL);
-		g_autoptr(GFile) file = g_file_new_for_path(pathfn);
-		g_autoptr(GFileInfo) info = NULL;
-
-		info = g_file_query_info(file,
-					 G_FILE_ATTRIBUTE_STANDARD_ALLOCATED_SIZE
-					 "," G_FILE_ATTRIBUTE_STANDARD_SIZE,
-					 G_FILE_QUERY_INFO_NONE,
-					 NULL,
-					 error);
-		if (info == NULL)
-			return G_MAXUINT64;
-		sz = g_file_info_get_attribute_uint64(info,
-						      G_FILE_ATTRIBUTE_STANDARD_ALLOCATED_SIZE);
-		if (sz == 0)
-			sz = g_file_info_get_attribute_uint64(info, G_FILE_ATTRIBUTE_STANDARD_SIZE);
-		total += sz;
-	}
-
-	/* success */
-	return total;
+	return snapshot->total;
 }
 
-gboolean
-fu_efivar_set_data_impl(const gchar *guid,
-			const gchar *name,
-			const guint8 *data,
-			gsize sz,
-			guint32 attr,
-			GError **error)
+static gboolean
+fu_efivar_set_data_internal(const gchar *guid,
+			    const gchar *name,
+			    const guint8 *data,
+			    gsize sz,
+			    guint32 attr,
+			    GError **error)
 {
 	int fd;
 	int open_wflags;
@@ -439,3 +552,16 @@ fu_efivar_set_data_impl(const gchar *guid,
 	/* success */
 	return TRUE;
 }
+
+gboolean
+fu_efivar_set_data_impl(const gchar *guid,
+			const gchar *name,
+			const guint8 *data,
+			gsize sz,
+			guint32 attr,
+			GError **error)
+{
+	gboolean ret = fu_efivar_set_data_internal(guid, name, data, sz, attr, error);
+	fu_efivar_snapshot_invalidate();
+	return ret;
+}
@@ -8,13 +8,15 @@
 
 #include "config.h"
 
+#include <string.h>
+
 #include "fu-byte-array.h"
 #include "fu-bytes.h"
 #include "fu-common.h"
 #include "fu-crc.h"
 #include "fu-dump.h"
 #include "fu-fdt-firmware.h"
-#include "fu-fdt-image.h"
+#include "fu-fdt-image-private.h"
 #include "fu-fdt-struct.h"
 #include "fu-mem.h"
 
@@ -31,6 +33,8 @@
 
 typedef struct {
 	guint32 cpuid;
+	GBytes *dt_struct;  /* validated, but images not yet built */
+	GBytes *dt_strings; /* validated, but images not yet built */
 } FuFdtFirmwarePrivate;
 
 G_DEFINE_TYPE_WITH_PRIVATE(FuFdtFirmware, fu_fdt_firmware, FU_TYPE_FIRMWARE)
@@ -45,20 +49,26 @@ G_DEFINE_TYPE_WITH_PRIVATE(FuFdtFirmware, fu_fdt_firmware, FU_TYPE_FIRMWARE)
 #define FDT_LAST_COMP_VERSION 2
 #define FDT_DEPTH_MAX	      128
 
-static GString *
-fu_string_new_safe(const guint8 *buf, gsize bufsz, gsize offset, GError **error)
+/* gets the length of the string at @offset without copying it */
+static gboolean
+fu_fdt_firmware_strlen_safe(const guint8 *buf,
+			    gsize bufsz,
+			    gsize offset,
+			    gsize *len,
+			    GError **error)
 {
-	g_autoptr(GString) str = g_string_new(NULL);
-	for (gsize i = offset; i < bufsz; i++) {
-		if (buf[i] == '\0')
-			return g_steal_pointer(&str);
-		g_string_append_c(str, (gchar)buf[i]);
+	const guint8 *tmp = NULL;
+	if (offset < bufsz)
+		tmp = memchr(buf + offset, '\0', bufsz - offset);
+	if (tmp == NULL) {
+		g_set_error_literal(error,
+				    G_IO_ERROR,
+				    G_IO_ERROR_INVALID_DATA,
+				    "buffer not NULL terminated");
+		return FALSE;
 	}
-	g_set_error_literal(error,
-			    G_IO_ERROR,
-			    G_IO_ERROR_INVALID_DATA,
-			    "buffer not NULL terminated");
-	return NULL;
+	*len = tmp - (buf + offset);
+	return TRUE;
 }
 
 static void
@@ -145,19 +155,248 @@ fu_fdt_firmware_get_image_by_path(FuFdtFirmware *self, const gchar *path, GError
 	return FU_FDT_IMAGE(g_steal_pointer(&img_current));
 }
 
+/* finds the property by walking the tokens in the validated buffer, without building images */
+static gboolean
+fu_fdt_firmware_find_attr(FuFdtFirmware *self,
+			  const gchar *path,
+			  const gchar *key,
+			  gsize *attr_offset,
+			  gsize *attr_size,
+			  GError **error)
+{
+	FuFdtFirmwarePrivate *priv = GET_PRIVATE(self);
+	gsize bufsz = 0;
+	gsize offset = 0;
+	guint depth = 0;
+	guint matched = 0;
+	guint ncomps = 0;
+	const guint8 *buf = g_bytes_get_data(priv->dt_struct, &bufsz);
+	const gchar *strtab = g_bytes_get_data(priv->dt_strings, NULL);
+	const gchar *comps[FDT_DEPTH_MAX] = {NULL};
+	gsize compsz[FDT_DEPTH_MAX] = {0};
+
+	/* split the path without copying, where the root node is implicit */
+	for (const gchar *tmp = path; *tmp != '\0';) {
+		const gchar *sep;
+		if (*tmp == '/') {
+			tmp++;
+			continue;
+		}
+		if (ncomps >= FDT_DEPTH_MAX) {
+			g_set_error(error,
+				    G_IO_ERROR,
+				    G_IO_ERROR_INVALID_DATA,
+				    "path %s exceeded maximum depth",
+				    path);
+			return FALSE;
+		}
+		sep = strchr(tmp, '/');
+		comps[ncomps] = tmp;
+		compsz[ncomps] = sep != NULL ? (gsize)(sep - tmp) : strlen(tmp);
+		tmp += compsz[ncomps++];
+	}
+
+	/* the buffer, node names and strtab offsets were all checked when parsing */
+	while (offset < bufsz) {
+		guint32 token = 0;
+
+		offset = fu_common_align_up(offset, FU_FIRMWARE_ALIGNMENT_4);
+		if (!fu_memread_uint32_safe(buf, bufsz, offset, &token, G_BIG_ENDIAN, error))
+			return FALSE;
+		offset += sizeof(guint32);
+		if (token == FDT_END)
+			break;
+
+		/* all the parents match, so check this node, where depth 1 is the root */
+		if (token == FDT_BEGIN_NODE) {
+			const gchar *name = (const gchar *)buf + offset;
+			gsize namesz = strlen(name);
+			if (++depth == matched + 1) {
+				if (depth == 1 ||
+				    (matched <= ncomps && namesz == compsz[matched - 1] &&
+				     memcmp(name, comps[matched - 1], namesz) == 0))
+					matched = depth;
+			}
+			offset += namesz + 1;
+			continue;
+		}
+
+		/* the node we wanted has ended */
+		if (token == FDT_END_NODE) {
+			if (matched == depth) {
+				if (matched == ncomps + 1)
+					break;
+				matched--;
+			}
+			depth--;
+			continue;
+		}
+
+		/* only compare the key if this is the node we want */
+		if (token == FDT_PROP) {
+			const FuStructFdtPropView *st_prp;
+			guint32 prop_len;
+
+			st_prp = fu_struct_fdt_prop_view(buf, bufsz, offset, error);
+			if (st_prp == NULL)
+				return FALSE;
+			prop_len = fu_struct_fdt_prop_view_get_len(st_prp);
+			offset += FU_STRUCT_FDT_PROP_SIZE;
+			if (matched == depth && depth == ncomps + 1 &&
+			    g_strcmp0(strtab + fu_struct_fdt_prop_view_get_nameoff(st_prp), key) ==
+				0) {
+				*attr_offset = offset;
+				*attr_size = prop_len;
+				return TRUE;
+			}
+			offset += prop_len;
+			continue;
+		}
+	}
+
+	/* not found */
+	g_set_error(error, G_IO_ERROR, G_IO_ERROR_NOT_FOUND, "no data for %s in %s", key, path);
+	return FALSE;
+}
+
+/**
+ * fu_fdt_firmware_get_attr_by_path:
+ * @self: a #FuFdtFirmware
+ * @path: node path, e.g. `/images/firmware-1`, where `/` is the root node
+ * @key: string, e.g. `compatible`
+ * @error: (nullable): optional return location for an error
+ *
+ * Gets an attribute from a specific node. If the images have not been built then the parsed
+ * buffer is searched directly, which is much faster than fu_fdt_firmware_get_image_by_path().
+ *
+ * Returns: (transfer full): blob, or %NULL
+ *
+ * Since: 1.9.4
+ **/
+GBytes *
+fu_fdt_firmware_get_attr_by_path(FuFdtFirmware *self,
+				 const gchar *path,
+				 const gchar *key,
+				 GError **error)
+{
+	FuFdtFirmwarePrivate *priv = GET_PRIVATE(self);
+	g_auto(GStrv) paths = NULL;
+	g_autoptr(FuFirmware) img_current = NULL;
+
+	g_return_val_if_fail(FU_IS_FDT_FIRMWARE(self), NULL);
+	g_return_val_if_fail(path != NULL, NULL);
+	g_return_val_if_fail(key != NULL, NULL);
+	g_return_val_if_fail(error == NULL || *error == NULL, NULL);
+
+	/* images not yet built */
+	if (priv->dt_struct != NULL) {
+		gsize attr_offset = 0;
+		gsize attr_size = 0;
+		if (!fu_fdt_firmware_find_attr(self, path, key, &attr_offset, &attr_size, error))
+			return NULL;
+		return fu_bytes_new_offset(priv->dt_struct, attr_offset, attr_size, error);
+	}
+
+	/* use the images */
+	img_current = fu_firmware_get_image_by_id(FU_FIRMWARE(self), NULL, error);
+	if (img_current == NULL)
+		return NULL;
+	paths = g_strsplit(path, "/", -1);
+	for (guint i = 0; paths[i] != NULL; i++) {
+		g_autoptr(FuFirmware) img_tmp = NULL;
+		if (paths[i][0] == '\0')
+			continue;
+		img_tmp = fu_firmware_get_image_by_id(img_current, paths[i], error);
+		if (img_tmp == NULL)
+			return NULL;
+		g_set_object(&img_current, img_tmp);
+	}
+	return fu_fdt_image_get_attr(FU_FDT_IMAGE(img_current), key, error);
+}
+
+/**
+ * fu_fdt_firmware_get_attr_str:
+ * @self: a #FuFdtFirmware
+ * @path: node path, e.g. `/ibm,firmware-versions`, where `/` is the root node
+ * @key: string, e.g. `version`
+ * @error: (nullable): optional return location for an error
+ *
+ * Gets a string attribute from a specific node, using the parsed buffer directly if the images
+ * have not been built.
+ *
+ * Returns: (transfer full): string, or %NULL
+ *
+ * Since: 1.9.4
+ **/
+gchar *
+fu_fdt_firmware_get_attr_str(FuFdtFirmware *self,
+			     const gchar *path,
+			     const gchar *key,
+			     GError **error)
+{
+	g_autoptr(GBytes) blob = NULL;
+
+	g_return_val_if_fail(FU_IS_FDT_FIRMWARE(self), NULL);
+	g_return_val_if_fail(path != NULL, NULL);
+	g_return_val_if_fail(key != NULL, NULL);
+	g_return_val_if_fail(error == NULL || *error == NULL, NULL);
+
+	blob = fu_fdt_firmware_get_attr_by_path(self, path, key, error);
+	if (blob == NULL)
+		return NULL;
+	return fu_fdt_image_str_from_bytes(blob, key, error);
+}
+
+/**
+ * fu_fdt_firmware_get_attr_strlist:
+ * @self: a #FuFdtFirmware
+ * @path: node path, e.g. `/`, where `/` is the root node
+ * @key: string, e.g. `compatible`
+ * @error: (nullable): optional return location for an error
+ *
+ * Gets a stringlist attribute from a specific node, using the parsed buffer directly if the
+ * images have not been built.
+ *
+ * Returns: (transfer full): strings, or %NULL
+ *
+ * Since: 1.9.4
+ **/
+gchar **
+fu_fdt_firmware_get_attr_strlist(FuFdtFirmware *self,
+				 const gchar *path,
+				 const gchar *key,
+				 GError **error)
+{
+	g_autoptr(GBytes) blob = NULL;
+
+	g_return_val_if_fail(FU_IS_FDT_FIRMWARE(self), NULL);
+	g_return_val_if_fail(path != NULL, NULL);
+	g_return_val_if_fail(key != NULL, NULL);
+	g_return_val_if_fail(error == NULL || *error == NULL, NULL);
+
+	blob = fu_fdt_firmware_get_attr_by_path(self, path, key, error);
+	if (blob == NULL)
+		return NULL;
+	return fu_fdt_image_strlist_from_bytes(blob, key, error);
+}
+
+/* if @build_images is FALSE then the buffer is only validated, and nothing is allocated */
 static gboolean
-fu_fdt_firmware_parse_dt_struct(FuFdtFirmware *self, GBytes *fw, GBytes *strtab, GError **error)
+fu_fdt_firmware_parse_dt_struct(FuFdtFirmware *self,
+				GBytes *fw,
+				GBytes *strtab,
+				gboolean build_images,
+				GError **error)
 {
 	gsize bufsz = 0;
+	gsize strtabsz = 0;
 	gsize offset = 0;
 	guint depth = 0;
 	gboolean has_end = FALSE;
 	const guint8 *buf = g_bytes_get_data(fw, &bufsz);
+	const guint8 *strtabbuf = g_bytes_get_data(strtab, &strtabsz);
 	g_autoptr(FuFirmware) firmware_current = g_object_ref(FU_FIRMWARE(self));
 
-	/* debug */
-	fu_dump_bytes(G_LOG_DOMAIN, "dt_struct", fw);
-
 	/* parse */
 	while (offset < bufsz) {
 		guint32 token = 0;
@@ -166,7 +405,6 @@ fu_fdt_firmware_parse_dt_struct(FuFdtFirmware *self, GBytes *fw, GBytes *strtab,
 		offset = fu_common_align_up(offset, FU_FIRMWARE_ALIGNMENT_4);
 		if (!fu_memread_uint32_safe(buf, bufsz, offset, &token, G_BIG_ENDIAN, error))
 			return FALSE;
-		g_debug("token: 0x%x", token);
 		offset += sizeof(guint32);
 
 		/* nothing to do */
@@ -175,7 +413,7 @@ fu_fdt_firmware_parse_dt_struct(FuFdtFirmware *self, GBytes *fw, GBytes *strtab,
 
 		/* END */
 		if (token == FDT_END) {
-			if (firmware_current != FU_FIRMWARE(self)) {
+			if (depth != 0) {
 				g_set_error_literal(error,
 						    G_IO_ERROR,
 						    G_IO_ERROR_INVALID_DATA,
@@ -188,8 +426,7 @@ fu_fdt_firmware_parse_dt_struct(FuFdtFirmware *self, GBytes *fw, GBytes *strtab,
 
 		/* BEGIN NODE */
 		if (token == FDT_BEGIN_NODE) {
-			g_autoptr(GString) str = NULL;
-			g_autoptr(FuFirmware) image = NULL;
+			gsize namesz = 0;
 
 			/* sanity check */
 			if (depth++ > FDT_DEPTH_MAX) {
@@ -200,32 +437,34 @@ fu_fdt_firmware_parse_dt_struct(FuFdtFirmware *self, GBytes *fw, GBytes *strtab,
 					    (guint)FDT_DEPTH_MAX);
 				return FALSE;
 			}
-
-			str = fu_string_new_safe(buf, bufsz, offset, error);
-			if (str == NULL)
+			if (!fu_fdt_firmware_strlen_safe(buf, bufsz, offset, &namesz, error))
 				return FALSE;
-			offset += str->len + 1;
-			image = fu_fdt_image_new();
-			if (str->len > 0)
-				fu_firmware_set_id(image, str->str);
-			fu_firmware_set_offset(image, offset);
-			fu_firmware_add_image(firmware_current, image);
-			g_set_object(&firmware_current, image);
+			if (build_images) {
+				g_autoptr(FuFirmware) image = fu_fdt_image_new();
+				if (namesz > 0)
+					fu_firmware_set_id(image, (const gchar *)buf + offset);
+				fu_firmware_set_offset(image, offset + namesz + 1);
+				fu_firmware_add_image(firmware_current, image);
+				g_set_object(&firmware_current, image);
+			}
+			offset += namesz + 1;
 			continue;
 		}
 
 		/* END NODE */
 		if (token == FDT_END_NODE) {
-			if (firmware_current == FU_FIRMWARE(self)) {
+			if (depth == 0) {
 				g_set_error_literal(error,
 						    G_IO_ERROR,
 						    G_IO_ERROR_INVALID_DATA,
 						    "got END NODE with no node to end");
 				return FALSE;
 			}
-			g_set_object(&firmware_current, fu_firmware_get_parent(firmware_current));
-			if (depth > 0)
-				depth--;
+			if (build_images) {
+				g_set_object(&firmware_current,
+					     fu_firmware_get_parent(firmware_current));
+			}
+			depth--;
 			continue;
 		}
 
@@ -233,12 +472,11 @@ fu_fdt_firmware_parse_dt_struct(FuFdtFirmware *self, GBytes *fw, GBytes *strtab,
 		if (token == FDT_PROP) {
 			guint32 prop_len;
 			guint32 prop_nameoff;
-			g_autoptr(GBytes) blob = NULL;
-			g_autoptr(GString) str = NULL;
-			g_autoptr(GByteArray) st_prp = NULL;
+			gsize keysz = 0;
+			const FuStructFdtPropView *st_prp;
 
 			/* sanity check */
-			if (firmware_current == FU_FIRMWARE(self)) {
+			if (depth == 0) {
 				g_set_error_literal(error,
 						    G_IO_ERROR,
 						    G_IO_ERROR_INVALID_DATA,
@@ -247,26 +485,40 @@ fu_fdt_firmware_parse_dt_struct(FuFdtFirmware *self, GBytes *fw, GBytes *strtab,
 			}
 
 			/* parse */
-			st_prp = fu_struct_fdt_prop_parse(buf, bufsz, offset, error);
+			st_prp = fu_struct_fdt_prop_view(buf, bufsz, offset, error);
 			if (st_prp == NULL)
 				return FALSE;
-			prop_len = fu_struct_fdt_prop_get_len(st_prp);
-			prop_nameoff = fu_struct_fdt_prop_get_nameoff(st_prp);
-			offset += st_prp->len;
-
-			/* add property */
-			str = fu_string_new_safe(g_bytes_get_data(strtab, NULL),
-						 g_bytes_get_size(strtab),
-						 prop_nameoff,
-						 error);
-			if (str == NULL) {
+			prop_len = fu_struct_fdt_prop_view_get_len(st_prp);
+			prop_nameoff = fu_struct_fdt_prop_view_get_nameoff(st_prp);
+			offset += FU_STRUCT_FDT_PROP_SIZE;
+			if (!fu_fdt_firmware_strlen_safe(strtabbuf,
+							 strtabsz,
+							 prop_nameoff,
+							 &keysz,
+							 error)) {
 				g_prefix_error(error, "invalid strtab offset 0x%x: ", prop_nameoff);
 				return FALSE;
 			}
-			blob = fu_bytes_new_offset(fw, offset, prop_len, error);
-			if (blob == NULL)
+			if (prop_len > bufsz - offset) {
+				g_set_error(error,
+					    G_IO_ERROR,
+					    G_IO_ERROR_INVALID_DATA,
+					    "invalid property length 0x%x @0x%x",
+					    prop_len,
+					    (guint)offset);
 				return FALSE;
-			fu_fdt_image_set_attr(FU_FDT_IMAGE(firmware_current), str->str, blob);
+			}
+
+			/* add property */
+			if (build_images) {
+				g_autoptr(GBytes) blob = NULL;
+				blob = fu_bytes_new_offset(fw, offset, prop_len, error);
+				if (blob == NULL)
+					return FALSE;
+				fu_fdt_image_set_attr(FU_FDT_IMAGE(firmware_current),
+						      (const gchar *)strtabbuf + prop_nameoff,
+						      blob);
+			}
 			offset += prop_len;
 			continue;
 		}
@@ -294,6 +546,37 @@ fu_fdt_firmware_parse_dt_struct(FuFdtFirmware *self, GBytes *fw, GBytes *strtab,
 	return TRUE;
 }
 
+static gboolean
+fu_fdt_firmware_ensure_images(FuFirmware *firmware, GError **error)
+{
+	FuFdtFirmware *self = FU_FDT_FIRMWARE(firmware);
+	FuFdtFirmwarePrivate *priv = GET_PRIVATE(self);
+
+	/* no device tree struct */
+	if (priv->dt_struct == NULL)
+		return TRUE;
+
+	/* only build the images when they are modified or exported */
+	if (!fu_fdt_firmware_parse_dt_struct(self,
+					     priv->dt_struct,
+					     priv->dt_strings,
+					     TRUE,
+					     error)) {
+		g_autoptr(GPtrArray) imgs = fu_firmware_get_images(firmware);
+
+		/* keep the buffer so that attributes can still be read, but not a partial tree */
+		for (guint i = 0; i < imgs->len; i++) {
+			FuFirmware *img = g_ptr_array_index(imgs, i);
+			if (!fu_firmware_remove_image(firmware, img, NULL))
+				g_debug("failed to remove partial image");
+		}
+		return FALSE;
+	}
+	g_clear_pointer(&priv->dt_struct, g_bytes_unref);
+	g_clear_pointer(&priv->dt_strings, g_bytes_unref);
+	return TRUE;
+}
+
 static gboolean
 fu_fdt_firmware_parse_mem_rsvmap(FuFdtFirmware *self,
 				 const guint8 *buf,
@@ -382,6 +665,10 @@ fu_fdt_firmware_parse(FuFirmware *firmware,
 	}
 	fu_firmware_set_version_raw(firmware, fu_struct_fdt_get_version(st_hdr));
 
+	/* the images are built on demand, or looked up from the buffer directly */
+	g_clear_pointer(&priv->dt_struct, g_bytes_unref);
+	g_clear_pointer(&priv->dt_strings, g_bytes_unref);
+
 	/* parse device tree struct */
 	if (fu_struct_fdt_get_size_dt_struct(st_hdr) != 0x0 &&
 	    fu_struct_fdt_get_size_dt_strings(st_hdr) != 0x0) {
@@ -399,8 +686,11 @@ fu_fdt_firmware_parse(FuFirmware *firmware,
 						error);
 		if (dt_struct == NULL)
 			return FALSE;
-		if (!fu_fdt_firmware_parse_dt_struct(self, dt_struct, dt_strings, error))
+		fu_dump_bytes(G_LOG_DOMAIN, "dt_struct", dt_struct);
+		if (!fu_fdt_firmware_parse_dt_struct(self, dt_struct, dt_strings, FALSE, error))
 			return FALSE;
+		priv->dt_struct = g_steal_pointer(&dt_struct);
+		priv->dt_strings = g_steal_pointer(&dt_strings);
 	}
 
 	/* success */
@@ -580,13 +870,28 @@ fu_fdt_firmware_init(FuFdtFirmware *self)
 	fu_firmware_add_flag(FU_FIRMWARE(self), FU_FIRMWARE_FLAG_HAS_VID_PID);
 }
 
+static void
+fu_fdt_firmware_finalize(GObject *object)
+{
+	FuFdtFirmware *self = FU_FDT_FIRMWARE(object);
+	FuFdtFirmwarePrivate *priv = GET_PRIVATE(self);
+	if (priv->dt_struct != NULL)
+		g_bytes_unref(priv->dt_struct);
+	if (priv->dt_strings != NULL)
+		g_bytes_unref(priv->dt_strings);
+	G_OBJECT_CLASS(fu_fdt_firmware_parent_class)->finalize(object);
+}
+
 static void
 fu_fdt_firmware_class_init(FuFdtFirmwareClass *klass)
 {
+	GObjectClass *object_class = G_OBJECT_CLASS(klass);
 	FuFirmwareClass *klass_firmware = FU_FIRMWARE_CLASS(klass);
+	object_class->finalize = fu_fdt_firmware_finalize;
 	klass_firmware->check_magic = fu_fdt_firmware_check_magic;
 	klass_firmware->export = fu_fdt_firmware_export;
 	klass_firmware->parse = fu_fdt_firmware_parse;
+	klass_firmware->ensure_images = fu_fdt_firmware_ensure_images;
 	klass_firmware->write = fu_fdt_firmware_write;
 	klass_firmware->build = fu_fdt_firmware_build;
 }
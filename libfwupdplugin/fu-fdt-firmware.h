@@ -24,3 +24,18 @@ void
 fu_fdt_firmware_set_cpuid(FuFdtFirmware *self, guint32 cpuid);
 FuFdtImage *
 fu_fdt_firmware_get_image_by_path(FuFdtFirmware *self, const gchar *path, GError **error);
+GBytes *
+fu_fdt_firmware_get_attr_by_path(FuFdtFirmware *self,
+				 const gchar *path,
+				 const gchar *key,
+				 GError **error);
+gchar *
+fu_fdt_firmware_get_attr_str(FuFdtFirmware *self,
+			     const gchar *path,
+			     const gchar *key,
+			     GError **error);
+gchar **
+fu_fdt_firmware_get_attr_strlist(FuFdtFirmware *self,
+				 const gchar *path,
+				 const gchar *key,
+				 GError **error);
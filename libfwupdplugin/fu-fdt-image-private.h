@@ -0,0 +1,14 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * SPDX-License-Identifier: LGPL-2.1+
+ */
+
+#pragma once
+
+#include "fu-fdt-image.h"
+
+gchar *
+fu_fdt_image_str_from_bytes(GBytes *blob, const gchar *key, GError **error);
+gchar **
+fu_fdt_image_strlist_from_bytes(GBytes *blob, const gchar *key, GError **error);
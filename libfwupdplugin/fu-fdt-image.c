@@ -8,9 +8,11 @@
 
 #include "config.h"
 
+#include <string.h>
+
 #include "fu-byte-array.h"
 #include "fu-common.h"
-#include "fu-fdt-image.h"
+#include "fu-fdt-image-private.h"
 #include "fu-mem.h"
 #include "fu-string.h"
 
@@ -70,23 +72,67 @@ fu_fdt_image_guess_format_from_key(const gchar *key)
 static gchar **
 fu_fdt_image_strlist_from_blob(GBytes *blob)
 {
-	gchar **val;
 	gsize bufsz = 0;
 	const guint8 *buf = g_bytes_get_data(blob, &bufsz);
-	g_autoptr(GPtrArray) strs = g_ptr_array_new();
+	GPtrArray *strs = g_ptr_array_new();
 
-	/* delimit by NUL */
+	/* delimit by NUL, where the last string does not have to be terminated */
 	for (gsize i = 0; i < bufsz; i++) {
 		const gchar *tmp = (const gchar *)buf + i;
-		g_ptr_array_add(strs, (gpointer)tmp);
-		i += strlen(tmp);
+		gsize len = strnlen(tmp, bufsz - i);
+		g_ptr_array_add(strs, g_strndup(tmp, len));
+		i += len;
+	}
+	g_ptr_array_add(strs, NULL);
+	return (gchar **)g_ptr_array_free(strs, FALSE);
+}
+
+/* strings can only contain printable characters, and NUL if a stringlist */
+static gboolean
+fu_fdt_image_check_str(GBytes *blob, const gchar *key, GError **error)
+{
+	gsize bufsz = 0;
+	const guint8 *buf = g_bytes_get_data(blob, &bufsz);
+
+	if (bufsz == 0) {
+		g_set_error(error,
+			    G_IO_ERROR,
+			    G_IO_ERROR_INVALID_DATA,
+			    "invalid data size for %s, got 0x%x",
+			    key,
+			    (guint)bufsz);
+		return FALSE;
+	}
+	for (gsize i = 0; i < bufsz; i++) {
+		if (buf[i] != 0x0 && !g_ascii_isprint((gchar)buf[i])) {
+			g_set_error(error,
+				    G_IO_ERROR,
+				    G_IO_ERROR_INVALID_DATA,
+				    "nonprintable character 0x%02x at offset 0x%x in %s",
+				    buf[i],
+				    (guint)i,
+				    key);
+			return FALSE;
+		}
 	}
+	return TRUE;
+}
 
-	/* copy to GStrv */
-	val = g_new0(gchar *, strs->len + 1);
-	for (guint i = 0; i < strs->len; i++)
-		val[i] = g_strdup(g_ptr_array_index(strs, i));
-	return val;
+/* used for the parsed buffer as well as the attributes of the image */
+gchar *
+fu_fdt_image_str_from_bytes(GBytes *blob, const gchar *key, GError **error)
+{
+	if (!fu_fdt_image_check_str(blob, key, error))
+		return NULL;
+	return g_strndup(g_bytes_get_data(blob, NULL), g_bytes_get_size(blob));
+}
+
+gchar **
+fu_fdt_image_strlist_from_bytes(GBytes *blob, const gchar *key, GError **error)
+{
+	if (!fu_fdt_image_check_str(blob, key, error))
+		return NULL;
+	return fu_fdt_image_strlist_from_blob(blob);
 }
 
 static void
@@ -286,8 +332,7 @@ gboolean
 fu_fdt_image_get_attr_strlist(FuFdtImage *self, const gchar *key, gchar ***val, GError **error)
 {
 	g_autoptr(GBytes) blob = NULL;
-	const guint8 *buf;
-	gsize bufsz = 0;
+	g_auto(GStrv) tmp = NULL;
 
 	g_return_val_if_fail(FU_IS_FDT_IMAGE(self), FALSE);
 	g_return_val_if_fail(key != NULL, FALSE);
@@ -296,34 +341,13 @@ fu_fdt_image_get_attr_strlist(FuFdtImage *self, const gchar *key, gchar ***val,
 	blob = fu_fdt_image_get_attr(self, key, error);
 	if (blob == NULL)
 		return FALSE;
-	if (g_bytes_get_size(blob) == 0) {
-		g_set_error(error,
-			    G_IO_ERROR,
-			    G_IO_ERROR_INVALID_DATA,
-			    "invalid data size for %s, got 0x%x",
-			    key,
-			    (guint)g_bytes_get_size(blob));
+	tmp = fu_fdt_image_strlist_from_bytes(blob, key, error);
+	if (tmp == NULL)
 		return FALSE;
-	}
-
-	/* sanity check */
-	buf = g_bytes_get_data(blob, &bufsz);
-	for (gsize i = 0; i < bufsz; i++) {
-		if (buf[i] != 0x0 && !g_ascii_isprint((gchar)buf[i])) {
-			g_set_error(error,
-				    G_IO_ERROR,
-				    G_IO_ERROR_INVALID_DATA,
-				    "nonprintable character 0x%02x at offset 0x%x in %s",
-				    buf[i],
-				    (guint)i,
-				    key);
-			return FALSE;
-		}
-	}
 
 	/* success */
 	if (val != NULL)
-		*val = fu_fdt_image_strlist_from_blob(blob);
+		*val = g_steal_pointer(&tmp);
 	return TRUE;
 }
 
@@ -344,8 +368,7 @@ gboolean
 fu_fdt_image_get_attr_str(FuFdtImage *self, const gchar *key, gchar **val, GError **error)
 {
 	g_autoptr(GBytes) blob = NULL;
-	const guint8 *buf;
-	gsize bufsz = 0;
+	g_autofree gchar *tmp = NULL;
 
 	g_return_val_if_fail(FU_IS_FDT_IMAGE(self), FALSE);
 	g_return_val_if_fail(key != NULL, FALSE);
@@ -354,34 +377,13 @@ fu_fdt_image_get_attr_str(FuFdtImage *self, const gchar *key, gchar **val, GErro
 	blob = fu_fdt_image_get_attr(self, key, error);
 	if (blob == NULL)
 		return FALSE;
-	if (g_bytes_get_size(blob) == 0) {
-		g_set_error(error,
-			    G_IO_ERROR,
-			    G_IO_ERROR_INVALID_DATA,
-			    "invalid data size for %s, got 0x%x",
-			    key,
-			    (guint)g_bytes_get_size(blob));
+	tmp = fu_fdt_image_str_from_bytes(blob, key, error);
+	if (tmp == NULL)
 		return FALSE;
-	}
-
-	/* sanity check */
-	buf = g_bytes_get_data(blob, &bufsz);
-	for (gsize i = 0; i < bufsz; i++) {
-		if (buf[i] != 0x0 && !g_ascii_isprint((gchar)buf[i])) {
-			g_set_error(error,
-				    G_IO_ERROR,
-				    G_IO_ERROR_INVALID_DATA,
-				    "nonprintable character 0x%02x at offset 0x%x in %s",
-				    buf[i],
-				    (guint)i,
-				    key);
-			return FALSE;
-		}
-	}
 
 	/* success */
 	if (val != NULL)
-		*val = g_strndup(g_bytes_get_data(blob, NULL), g_bytes_get_size(blob));
+		*val = g_steal_pointer(&tmp);
 	return TRUE;
 }
 
@@ -19,7 +19,7 @@ struct FdtReserveEntry {
     address: u64be,
     size: u64be,
 }
-#[derive(New, Validate, Parse)]
+#[derive(New, Validate, Parse, View)]
 struct FdtProp {
     len: u32be,
     nameoff: u32be,
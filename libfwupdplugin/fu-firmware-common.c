@@ -15,6 +15,16 @@
 #include "fu-mem.h"
 #include "fu-string.h"
 
+/* the low nibble is the value, and the high nibble is set for any valid character */
+#define FU_FIRMWARE_HEX_VALID 0x10
+
+static const guint8 fu_firmware_hex_table[256] = {
+    ['0'] = 0x10, ['1'] = 0x11, ['2'] = 0x12, ['3'] = 0x13, ['4'] = 0x14, ['5'] = 0x15,
+    ['6'] = 0x16, ['7'] = 0x17, ['8'] = 0x18, ['9'] = 0x19, ['A'] = 0x1a, ['B'] = 0x1b,
+    ['C'] = 0x1c, ['D'] = 0x1d, ['E'] = 0x1e, ['F'] = 0x1f, ['a'] = 0x1a, ['b'] = 0x1b,
+    ['c'] = 0x1c, ['d'] = 0x1d, ['e'] = 0x1e, ['f'] = 0x1f,
+};
+
 /**
  * fu_firmware_strparse_uint4_safe:
  * @data: destination buffer
@@ -259,3 +269,63 @@ fu_firmware_strparse_uint32_safe(const gchar *data,
 		*value = (guint32)valuetmp;
 	return TRUE;
 }
+
+/**
+ * fu_firmware_strparse_hex_safe:
+ * @data: source buffer
+ * @datasz: size of @data, typically the same as `strlen(data)`
+ * @offset: offset in chars into @data to read
+ * @buf: destination buffer
+ * @bufsz: number of bytes to write into @buf, which is half the number of chars read
+ * @error: (nullable): optional return location for an error
+ *
+ * Parses a run of base 16 bytes from a string of `bufsz * 2` characters in length.
+ *
+ * This is much faster than calling fu_firmware_strparse_uint8_safe() for each byte, and
+ * should be used when decoding record payloads.
+ *
+ * Returns: %TRUE if parsed, %FALSE otherwise
+ *
+ * Since: 1.9.4
+ **/
+gboolean
+fu_firmware_strparse_hex_safe(const gchar *data,
+			      gsize datasz,
+			      gsize offset,
+			      guint8 *buf,
+			      gsize bufsz,
+			      GError **error)
+{
+	const guint8 *str = (const guint8 *)data + offset;
+	guint8 valid = FU_FIRMWARE_HEX_VALID;
+
+	g_return_val_if_fail(data != NULL, FALSE);
+	g_return_val_if_fail(buf != NULL || bufsz == 0, FALSE);
+
+	if (!fu_memchk_read(datasz, offset, bufsz * 2, error))
+		return FALSE;
+
+	/* no branches, so the compiler is free to vectorize this */
+	for (gsize i = 0; i < bufsz; i++) {
+		guint8 hi = fu_firmware_hex_table[str[i * 2]];
+		guint8 lo = fu_firmware_hex_table[str[(i * 2) + 1]];
+		valid &= hi & lo;
+		buf[i] = ((hi & 0x0f) << 4) | (lo & 0x0f);
+	}
+	if (valid == 0) {
+		for (gsize i = 0; i < bufsz; i++) {
+			g_autofree gchar *tmp = NULL;
+			if ((fu_firmware_hex_table[str[i * 2]] &
+			     fu_firmware_hex_table[str[(i * 2) + 1]]) != 0)
+				continue;
+			tmp = fu_strsafe((const gchar *)str + (i * 2), 2);
+			g_set_error(error,
+				    G_IO_ERROR,
+				    G_IO_ERROR_INVALID_DATA,
+				    "cannot parse %s as hex",
+				    tmp);
+			return FALSE;
+		}
+	}
+	return TRUE;
+}
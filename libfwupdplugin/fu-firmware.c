@@ -40,6 +40,9 @@ typedef struct {
 	gsize size;
 	GPtrArray *chunks;  /* nullable, element-type FuChunk */
 	GPtrArray *patches; /* nullable, element-type FuFirmwarePatch */
+	gboolean images_loaded;
+	GError *images_error; /* nullable */
+	gchar *checksums[G_CHECKSUM_SHA384 + 1]; /* nullable, indexed by GChecksumType */
 } FuFirmwarePrivate;
 
 G_DEFINE_TYPE_WITH_PRIVATE(FuFirmware, fu_firmware, G_TYPE_OBJECT)
@@ -506,6 +509,14 @@ fu_firmware_get_idx(FuFirmware *self)
 	return priv->idx;
 }
 
+static void
+fu_firmware_clear_checksums(FuFirmware *self)
+{
+	FuFirmwarePrivate *priv = GET_PRIVATE(self);
+	for (guint i = 0; i < G_N_ELEMENTS(priv->checksums); i++)
+		g_clear_pointer(&priv->checksums[i], g_free);
+}
+
 /**
  * fu_firmware_set_bytes:
  * @self: a #FuPlugin
@@ -524,6 +535,7 @@ fu_firmware_set_bytes(FuFirmware *self, GBytes *bytes)
 	if (priv->bytes != NULL)
 		g_bytes_unref(priv->bytes);
 	priv->bytes = g_bytes_ref(bytes);
+	fu_firmware_clear_checksums(self);
 }
 
 /**
@@ -731,9 +743,16 @@ fu_firmware_get_checksum(FuFirmware *self, GChecksumType csum_kind, GError **err
 	if (klass->get_checksum != NULL)
 		return klass->get_checksum(self, csum_kind, error);
 
-	/* internal data */
-	if (priv->bytes != NULL)
-		return g_compute_checksum_for_bytes(csum_kind, priv->bytes);
+	/* internal data, which only changes with fu_firmware_set_bytes() */
+	if (priv->bytes != NULL) {
+		if ((guint)csum_kind >= G_N_ELEMENTS(priv->checksums))
+			return g_compute_checksum_for_bytes(csum_kind, priv->bytes);
+		if (priv->checksums[csum_kind] == NULL) {
+			priv->checksums[csum_kind] =
+			    g_compute_checksum_for_bytes(csum_kind, priv->bytes);
+		}
+		return g_strdup(priv->checksums[csum_kind]);
+	}
 
 	/* write */
 	blob = fu_firmware_write(self, error);
@@ -902,6 +921,13 @@ fu_firmware_parse_full(FuFirmware *self,
 	 * ->tokenize() or ->parse() and needs to be destroyed before parsing again */
 	fu_firmware_add_flag(self, FU_FIRMWARE_FLAG_DONE_PARSE);
 
+	/* any deferred images are replaced by the ones from this blob */
+	if (klass->ensure_images != NULL) {
+		priv->images_loaded = FALSE;
+		g_clear_error(&priv->images_error);
+		g_ptr_array_set_size(priv->images, 0);
+	}
+
 	/* subclassed */
 	if (klass->tokenize != NULL) {
 		if (!klass->tokenize(self, fw, flags, error))
@@ -1419,6 +1445,35 @@ fu_firmware_write_file(FuFirmware *self, GFile *file, GError **error)
 				       error);
 }
 
+static gboolean
+fu_firmware_ensure_images(FuFirmware *self, GError **error)
+{
+	FuFirmwareClass *klass = FU_FIRMWARE_GET_CLASS(self);
+	FuFirmwarePrivate *priv = GET_PRIVATE(self);
+
+	/* only try once, but return the same error each time */
+	if (priv->images_error != NULL) {
+		g_propagate_error(error, g_error_copy(priv->images_error));
+		return FALSE;
+	}
+	if (priv->images_loaded || klass->ensure_images == NULL)
+		return TRUE;
+	priv->images_loaded = TRUE;
+	if (!klass->ensure_images(self, &priv->images_error)) {
+		g_propagate_error(error, g_error_copy(priv->images_error));
+		return FALSE;
+	}
+	return TRUE;
+}
+
+static gboolean
+fu_firmware_needs_ensure_images(FuFirmware *self)
+{
+	FuFirmwareClass *klass = FU_FIRMWARE_GET_CLASS(self);
+	FuFirmwarePrivate *priv = GET_PRIVATE(self);
+	return !priv->images_loaded && klass->ensure_images != NULL;
+}
+
 /**
  * fu_firmware_add_image:
  * @self: a #FuPlugin
@@ -1438,6 +1493,13 @@ fu_firmware_add_image(FuFirmware *self, FuFirmware *img)
 	g_return_if_fail(FU_IS_FIRMWARE(self));
 	g_return_if_fail(FU_IS_FIRMWARE(img));
 
+	/* the deferred images have to be added first */
+	if (fu_firmware_needs_ensure_images(self)) {
+		g_autoptr(GError) error_local = NULL;
+		if (!fu_firmware_ensure_images(self, &error_local))
+			g_debug("failed to load images: %s", error_local->message);
+	}
+
 	/* dedupe */
 	for (guint i = 0; i < priv->images->len; i++) {
 		FuFirmware *img_tmp = g_ptr_array_index(priv->images, i);
@@ -1482,6 +1544,8 @@ fu_firmware_remove_image(FuFirmware *self, FuFirmware *img, GError **error)
 	g_return_val_if_fail(FU_IS_FIRMWARE(img), FALSE);
 	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
 
+	if (!fu_firmware_ensure_images(self, error))
+		return FALSE;
 	if (g_ptr_array_remove(priv->images, img))
 		return TRUE;
 
@@ -1556,6 +1620,9 @@ fu_firmware_remove_image_by_id(FuFirmware *self, const gchar *id, GError **error
  *
  * Returns all the images in the firmware.
  *
+ * If the deferred images cannot be loaded then only the images added so far are returned;
+ * use fu_firmware_load_images() to get the error.
+ *
  * Returns: (transfer container) (element-type FuFirmware): images
  *
  * Since: 1.3.1
@@ -1565,9 +1632,12 @@ fu_firmware_get_images(FuFirmware *self)
 {
 	FuFirmwarePrivate *priv = GET_PRIVATE(self);
 	g_autoptr(GPtrArray) imgs = NULL;
+	g_autoptr(GError) error_local = NULL;
 
 	g_return_val_if_fail(FU_IS_FIRMWARE(self), NULL);
 
+	if (!fu_firmware_ensure_images(self, &error_local))
+		g_debug("failed to load images: %s", error_local->message);
 	imgs = g_ptr_array_new_with_free_func((GDestroyNotify)g_object_unref);
 	for (guint i = 0; i < priv->images->len; i++) {
 		FuFirmware *img = g_ptr_array_index(priv->images, i);
@@ -1576,6 +1646,117 @@ fu_firmware_get_images(FuFirmware *self)
 	return g_steal_pointer(&imgs);
 }
 
+typedef struct {
+	GMutex mutex;
+	GCond cond;
+	guint pending;
+	GError *error;
+	GThreadPool *pool;
+} FuFirmwareLoadHelper;
+
+static void
+fu_firmware_load_images_walk(FuFirmwareLoadHelper *helper, FuFirmware *self)
+{
+	FuFirmwarePrivate *priv = GET_PRIVATE(self);
+	for (guint i = 0; i < priv->images->len; i++) {
+		FuFirmware *img = g_ptr_array_index(priv->images, i);
+		FuFirmwarePrivate *priv_img = GET_PRIVATE(img);
+		if (priv_img->images_error != NULL) {
+			g_mutex_lock(&helper->mutex);
+			if (helper->error == NULL)
+				helper->error = g_error_copy(priv_img->images_error);
+			g_mutex_unlock(&helper->mutex);
+			continue;
+		}
+		if (fu_firmware_needs_ensure_images(img)) {
+			g_mutex_lock(&helper->mutex);
+			helper->pending++;
+			g_mutex_unlock(&helper->mutex);
+			g_thread_pool_push(helper->pool, g_object_ref(img), NULL);
+			continue;
+		}
+		fu_firmware_load_images_walk(helper, img);
+	}
+}
+
+static void
+fu_firmware_load_images_thread_cb(gpointer data, gpointer user_data)
+{
+	FuFirmwareLoadHelper *helper = (FuFirmwareLoadHelper *)user_data;
+	g_autoptr(FuFirmware) self = FU_FIRMWARE(data);
+	g_autoptr(GError) error_local = NULL;
+
+	/* images of siblings are independent, so can be loaded at the same time */
+	if (fu_firmware_ensure_images(self, &error_local)) {
+		fu_firmware_load_images_walk(helper, self);
+	} else {
+		g_mutex_lock(&helper->mutex);
+		if (helper->error == NULL)
+			helper->error = g_steal_pointer(&error_local);
+		g_mutex_unlock(&helper->mutex);
+	}
+
+	g_mutex_lock(&helper->mutex);
+	if (--helper->pending == 0)
+		g_cond_signal(&helper->cond);
+	g_mutex_unlock(&helper->mutex);
+}
+
+/**
+ * fu_firmware_load_images:
+ * @self: a #FuFirmware
+ * @error: (nullable): optional return location for an error
+ *
+ * Loads all the images that were deferred when parsing, for example compressed sections, for
+ * this firmware and all of the children. Independent images are loaded using a thread pool.
+ *
+ * Images are also loaded on demand when they are accessed, and so this only needs to be used
+ * when the entire image tree is required.
+ *
+ * Returns: %TRUE for success
+ *
+ * Since: 1.9.4
+ **/
+gboolean
+fu_firmware_load_images(FuFirmware *self, GError **error)
+{
+	FuFirmwareLoadHelper helper = {.pending = 0};
+
+	g_return_val_if_fail(FU_IS_FIRMWARE(self), FALSE);
+	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+
+	if (!fu_firmware_ensure_images(self, error))
+		return FALSE;
+
+	g_mutex_init(&helper.mutex);
+	g_cond_init(&helper.cond);
+	helper.pool = g_thread_pool_new(fu_firmware_load_images_thread_cb,
+					&helper,
+					g_get_num_processors(),
+					FALSE,
+					error);
+	if (helper.pool == NULL) {
+		g_mutex_clear(&helper.mutex);
+		g_cond_clear(&helper.cond);
+		return FALSE;
+	}
+	fu_firmware_load_images_walk(&helper, self);
+
+	/* wait for all the images, including ones found by the workers */
+	g_mutex_lock(&helper.mutex);
+	while (helper.pending > 0)
+		g_cond_wait(&helper.cond, &helper.mutex);
+	g_mutex_unlock(&helper.mutex);
+	g_thread_pool_free(helper.pool, FALSE, TRUE);
+	g_mutex_clear(&helper.mutex);
+	g_cond_clear(&helper.cond);
+	if (helper.error != NULL) {
+		g_propagate_error(error, helper.error);
+		return FALSE;
+	}
+	return TRUE;
+}
+
 /**
  * fu_firmware_get_image_by_id:
  * @self: a #FuPlugin
@@ -1596,6 +1777,8 @@ fu_firmware_get_image_by_id(FuFirmware *self, const gchar *id, GError **error)
 	g_return_val_if_fail(FU_IS_FIRMWARE(self), NULL);
 	g_return_val_if_fail(error == NULL || *error == NULL, NULL);
 
+	if (!fu_firmware_ensure_images(self, error))
+		return NULL;
 	for (guint i = 0; i < priv->images->len; i++) {
 		FuFirmware *img = g_ptr_array_index(priv->images, i);
 		if (g_strcmp0(fu_firmware_get_id(img), id) == 0)
@@ -1650,6 +1833,8 @@ fu_firmware_get_image_by_idx(FuFirmware *self, guint64 idx, GError **error)
 	g_return_val_if_fail(FU_IS_FIRMWARE(self), NULL);
 	g_return_val_if_fail(error == NULL || *error == NULL, NULL);
 
+	if (!fu_firmware_ensure_images(self, error))
+		return NULL;
 	for (guint i = 0; i < priv->images->len; i++) {
 		FuFirmware *img = g_ptr_array_index(priv->images, i);
 		if (fu_firmware_get_idx(img) == idx)
@@ -1686,6 +1871,8 @@ fu_firmware_get_image_by_checksum(FuFirmware *self, const gchar *checksum, GErro
 	g_return_val_if_fail(checksum != NULL, NULL);
 	g_return_val_if_fail(error == NULL || *error == NULL, NULL);
 
+	if (!fu_firmware_ensure_images(self, error))
+		return NULL;
 	csum_kind = fwupd_checksum_guess_kind(checksum);
 	for (guint i = 0; i < priv->images->len; i++) {
 		FuFirmware *img = g_ptr_array_index(priv->images, i);
@@ -1744,6 +1931,7 @@ fu_firmware_export(FuFirmware *self, FuFirmwareExportFlags flags, XbBuilderNode
 	FuFirmwareClass *klass = FU_FIRMWARE_GET_CLASS(self);
 	FuFirmwarePrivate *priv = GET_PRIVATE(self);
 	const gchar *gtypestr = G_OBJECT_TYPE_NAME(self);
+	g_autoptr(GError) error_local = NULL;
 
 	/* object */
 	if (g_strcmp0(gtypestr, "FuFirmware") != 0)
@@ -1803,6 +1991,8 @@ fu_firmware_export(FuFirmware *self, FuFirmwareExportFlags flags, XbBuilderNode
 		klass->export(self, flags, bn);
 
 	/* children */
+	if (!fu_firmware_ensure_images(self, &error_local))
+		xb_builder_node_insert_text(bn, "images_error", error_local->message, NULL);
 	if (priv->images->len > 0) {
 		for (guint i = 0; i < priv->images->len; i++) {
 			FuFirmware *img = g_ptr_array_index(priv->images, i);
@@ -1828,6 +2018,8 @@ gchar *
 fu_firmware_export_to_xml(FuFirmware *self, FuFirmwareExportFlags flags, GError **error)
 {
 	g_autoptr(XbBuilderNode) bn = xb_builder_node_new("firmware");
+	if (!fu_firmware_load_images(self, error))
+		return NULL;
 	fu_firmware_export(self, flags, bn);
 	return xb_builder_node_export(bn,
 				      XB_NODE_EXPORT_FLAG_FORMAT_MULTILINE |
@@ -1850,6 +2042,10 @@ gchar *
 fu_firmware_to_string(FuFirmware *self)
 {
 	g_autoptr(XbBuilderNode) bn = xb_builder_node_new("firmware");
+
+	/* any failure is included as images_error in the output */
+	if (!fu_firmware_load_images(self, NULL))
+		g_debug("failed to load all deferred images");
 	fu_firmware_export(self,
 			   FU_FIRMWARE_EXPORT_FLAG_INCLUDE_DEBUG |
 			       FU_FIRMWARE_EXPORT_FLAG_ASCII_DATA,
@@ -1907,12 +2103,15 @@ fu_firmware_finalize(GObject *object)
 	g_free(priv->filename);
 	if (priv->bytes != NULL)
 		g_bytes_unref(priv->bytes);
+	fu_firmware_clear_checksums(self);
 	if (priv->chunks != NULL)
 		g_ptr_array_unref(priv->chunks);
 	if (priv->patches != NULL)
 		g_ptr_array_unref(priv->patches);
 	if (priv->parent != NULL)
 		g_object_remove_weak_pointer(G_OBJECT(priv->parent), (gpointer *)&priv->parent);
+	if (priv->images_error != NULL)
+		g_error_free(priv->images_error);
 	g_ptr_array_unref(priv->images);
 	G_OBJECT_CLASS(fu_firmware_parent_class)->finalize(object);
 }
@@ -67,6 +67,7 @@ struct _FuFirmwareClass {
 				     FuFirmware *other,
 				     FwupdInstallFlags flags,
 				     GError **error);
+	gboolean (*ensure_images)(FuFirmware *self, GError **error) G_GNUC_WARN_UNUSED_RESULT;
 };
 
 /**
@@ -322,6 +323,8 @@ gboolean
 fu_firmware_remove_image_by_id(FuFirmware *self, const gchar *id, GError **error);
 GPtrArray *
 fu_firmware_get_images(FuFirmware *self);
+gboolean
+fu_firmware_load_images(FuFirmware *self, GError **error) G_GNUC_WARN_UNUSED_RESULT;
 FuFirmware *
 fu_firmware_get_image_by_id(FuFirmware *self, const gchar *id, GError **error);
 GBytes *
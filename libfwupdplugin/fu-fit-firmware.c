@@ -305,7 +305,7 @@ fu_fit_firmware_parse(FuFirmware *firmware,
 		 ->parse(firmware, fw, offset, flags, error))
 		return FALSE;
 
-	/* sanity check */
+	/* sanity check; verifying every image needs the whole tree, so the images are built here */
 	img_root = fu_firmware_get_image_by_id(firmware, NULL, error);
 	if (img_root == NULL)
 		return FALSE;
@@ -42,6 +42,11 @@ fu_hwids_dmi_setup(FuContext *ctx, FuHwids *self, GError **error)
 		g_autofree gchar *fn = g_build_filename(path, map[i].key, NULL);
 		g_autoptr(GError) error_local = NULL;
 
+		/* already set from the SMBIOS tables, and the first value set wins */
+		if (fu_hwids_get_value(self, map[i].hwid) != NULL &&
+		    (g_strcmp0(map[i].hwid, FU_HWIDS_KEY_ENCLOSURE_KIND) != 0 ||
+		     fu_context_get_chassis_kind(ctx) != FU_SMBIOS_CHASSIS_KIND_UNKNOWN))
+			continue;
 		if (!g_file_get_contents(fn, &buf, &bufsz, &error_local)) {
 			g_debug("unable to read SMBIOS data from %s: %s", fn, error_local->message);
 			continue;
@@ -16,9 +16,8 @@ gboolean
 fu_hwids_fdt_setup(FuContext *ctx, FuHwids *self, GError **error)
 {
 	g_autofree gchar *chassis_type = NULL;
+	g_autofree gchar *version = NULL;
 	g_auto(GStrv) compatible = NULL;
-	g_autoptr(FuFirmware) fdt_img = NULL;
-	g_autoptr(FuFdtImage) fdt_img_fwver = NULL;
 	g_autoptr(FuFirmware) fdt = NULL;
 	struct {
 		const gchar *hwid;
@@ -28,14 +27,13 @@ fu_hwids_fdt_setup(FuContext *ctx, FuHwids *self, GError **error)
 		   {FU_HWIDS_KEY_PRODUCT_NAME, "model"},
 		   {NULL, NULL}};
 
-	/* adds compatible GUIDs */
+	/* adds compatible GUIDs, using the parsed buffer directly rather than building images */
 	fdt = fu_context_get_fdt(ctx, error);
 	if (fdt == NULL)
 		return FALSE;
-	fdt_img = fu_firmware_get_image_by_id(fdt, NULL, error);
-	if (fdt_img == NULL)
-		return FALSE;
-	if (!fu_fdt_image_get_attr_strlist(FU_FDT_IMAGE(fdt_img), "compatible", &compatible, error))
+	compatible =
+	    fu_fdt_firmware_get_attr_strlist(FU_FDT_FIRMWARE(fdt), "/", "compatible", error);
+	if (compatible == NULL)
 		return FALSE;
 	for (guint i = 0; compatible[i] != NULL; i++) {
 		g_autofree gchar *guid = fwupd_guid_hash_string(compatible[i]);
@@ -45,15 +43,16 @@ fu_hwids_fdt_setup(FuContext *ctx, FuHwids *self, GError **error)
 
 	/* root node */
 	for (guint i = 0; map[i].key != NULL; i++) {
-		g_autofree gchar *tmp = NULL;
-		fu_fdt_image_get_attr_str(FU_FDT_IMAGE(fdt_img), map[i].key, &tmp, NULL);
+		g_autofree gchar *tmp =
+		    fu_fdt_firmware_get_attr_str(FU_FDT_FIRMWARE(fdt), "/", map[i].key, NULL);
 		if (tmp == NULL)
 			continue;
 		fu_hwids_add_value(self, map[i].hwid, tmp);
 	}
 
 	/* chassis kind */
-	fu_fdt_image_get_attr_str(FU_FDT_IMAGE(fdt_img), "chassis-type", &chassis_type, NULL);
+	chassis_type =
+	    fu_fdt_firmware_get_attr_str(FU_FDT_FIRMWARE(fdt), "/", "chassis-type", NULL);
 	if (chassis_type != NULL) {
 		struct {
 			FuSmbiosChassisKind chassis_kind;
@@ -82,16 +81,17 @@ fu_hwids_fdt_setup(FuContext *ctx, FuHwids *self, GError **error)
 	if (g_strv_length(compatible) > 1)
 		fu_hwids_add_value(self, FU_HWIDS_KEY_FAMILY, compatible[1]);
 	if (fu_context_get_chassis_kind(ctx) == FU_SMBIOS_CHASSIS_KIND_UNKNOWN) {
-		if (fu_fdt_image_get_attr_str(FU_FDT_IMAGE(fdt_img), "battery", NULL, NULL))
+		g_autofree gchar *battery =
+		    fu_fdt_firmware_get_attr_str(FU_FDT_FIRMWARE(fdt), "/", "battery", NULL);
+		if (battery != NULL)
 			fu_context_set_chassis_kind(ctx, FU_SMBIOS_CHASSIS_KIND_PORTABLE);
 	}
-	fdt_img_fwver =
-	    fu_fdt_firmware_get_image_by_path(FU_FDT_FIRMWARE(fdt), "ibm,firmware-versions", NULL);
-	if (fdt_img_fwver != NULL) {
-		g_autofree gchar *version = NULL;
-		fu_fdt_image_get_attr_str(FU_FDT_IMAGE(fdt_img), "version", &version, NULL);
+	version = fu_fdt_firmware_get_attr_str(FU_FDT_FIRMWARE(fdt),
+					       "/ibm,firmware-versions",
+					       "version",
+					       NULL);
+	if (version != NULL)
 		fu_hwids_add_value(self, FU_HWIDS_KEY_BIOS_VERSION, version);
-	}
 
 	/* success */
 	return TRUE;
@@ -26,8 +26,23 @@
  * See also: [class@FuFirmware]
  */
 
+/* a record, without any per-record allocations */
 typedef struct {
-	GPtrArray *records;
+	guint ln;
+	guint8 record_type;
+	guint8 byte_cnt;
+	guint16 addr;
+	gsize line_offset; /* into @fw */
+	gsize line_sz;
+	gsize data_offset; /* into @payload */
+} FuIhexFirmwareToken;
+
+typedef struct {
+	GPtrArray *records; /* built on demand from @tokens */
+	gboolean records_loaded;
+	GArray *tokens;	     /* of FuIhexFirmwareToken */
+	GByteArray *payload; /* decoded data for all records */
+	GBytes *fw;	     /* for the line text */
 	guint8 padding_value;
 } FuIhexFirmwarePrivate;
 
@@ -36,6 +51,35 @@ G_DEFINE_TYPE_WITH_PRIVATE(FuIhexFirmware, fu_ihex_firmware, FU_TYPE_FIRMWARE)
 
 #define FU_IHEX_FIRMWARE_TOKENS_MAX 100000 /* lines */
 
+static void
+fu_ihex_firmware_ensure_records(FuIhexFirmware *self)
+{
+	FuIhexFirmwarePrivate *priv = GET_PRIVATE(self);
+	const gchar *buf;
+
+	/* only build these once, as the caller may modify the array */
+	if (priv->records_loaded || priv->fw == NULL)
+		return;
+	priv->records_loaded = TRUE;
+
+	/* the tokenizer already validated everything */
+	buf = g_bytes_get_data(priv->fw, NULL);
+	for (guint i = 0; i < priv->tokens->len; i++) {
+		FuIhexFirmwareToken *tok = &g_array_index(priv->tokens, FuIhexFirmwareToken, i);
+		FuIhexFirmwareRecord *rcd = g_new0(FuIhexFirmwareRecord, 1);
+		rcd->ln = tok->ln;
+		rcd->buf = g_string_new_len(buf + tok->line_offset, tok->line_sz);
+		rcd->byte_cnt = tok->byte_cnt;
+		rcd->addr = tok->addr;
+		rcd->record_type = tok->record_type;
+		rcd->data = g_byte_array_sized_new(tok->byte_cnt);
+		g_byte_array_append(rcd->data,
+				    priv->payload->data + tok->data_offset,
+				    tok->byte_cnt);
+		g_ptr_array_add(priv->records, rcd);
+	}
+}
+
 /**
  * fu_ihex_firmware_get_records:
  * @self: A #FuIhexFirmware
@@ -45,6 +89,9 @@ G_DEFINE_TYPE_WITH_PRIVATE(FuIhexFirmware, fu_ihex_firmware, FU_TYPE_FIRMWARE)
  * This might be useful if the plugin is expecting the hex file to be a list
  * of operations, rather than a simple linear image with filled holes.
  *
+ * The records are only created when this function is first called, as most users only
+ * need the linear image.
+ *
  * Returns: (transfer none) (element-type FuIhexFirmwareRecord): records
  *
  * Since: 1.3.4
@@ -54,6 +101,7 @@ fu_ihex_firmware_get_records(FuIhexFirmware *self)
 {
 	FuIhexFirmwarePrivate *priv = GET_PRIVATE(self);
 	g_return_val_if_fail(FU_IS_IHEX_FIRMWARE(self), NULL);
+	fu_ihex_firmware_ensure_records(self);
 	return priv->records;
 }
 
@@ -85,85 +133,86 @@ fu_ihex_firmware_record_free(FuIhexFirmwareRecord *rcd)
 	g_free(rcd);
 }
 
-G_DEFINE_AUTOPTR_CLEANUP_FUNC(FuIhexFirmwareRecord, fu_ihex_firmware_record_free)
-
-static FuIhexFirmwareRecord *
-fu_ihex_firmware_record_new(guint ln, const gchar *line, FwupdInstallFlags flags, GError **error)
+static gboolean
+fu_ihex_firmware_tokenize_line(FuIhexFirmware *self,
+			       guint ln,
+			       const gchar *line,
+			       gsize linesz,
+			       gsize line_offset,
+			       FwupdInstallFlags flags,
+			       GError **error)
 {
-	g_autoptr(FuIhexFirmwareRecord) rcd = NULL;
-	gsize linesz = strlen(line);
+	FuIhexFirmwarePrivate *priv = GET_PRIVATE(self);
+	FuIhexFirmwareToken tok = {.ln = ln, .line_offset = line_offset, .line_sz = linesz};
+	guint8 hdr[4] = {0x0};
+	guint8 *data;
 	guint line_end;
-	guint16 addr16 = 0;
 
 	/* check starting token */
 	if (line[0] != ':') {
-		g_autofree gchar *strsafe = fu_strsafe(line, 5);
+		g_autofree gchar *strsafe = fu_strsafe(line, MIN(linesz, 5));
 		if (strsafe != NULL) {
 			g_set_error(error,
 				    FWUPD_ERROR,
 				    FWUPD_ERROR_INVALID_FILE,
 				    "invalid starting token: %s",
 				    strsafe);
-			return NULL;
+			return FALSE;
 		}
 		g_set_error_literal(error,
 				    FWUPD_ERROR,
 				    FWUPD_ERROR_INVALID_FILE,
 				    "invalid starting token");
-		return NULL;
+		return FALSE;
 	}
 
 	/* length, 16-bit address, type */
-	rcd = g_new0(FuIhexFirmwareRecord, 1);
-	rcd->ln = ln;
-	rcd->data = g_byte_array_new();
-	rcd->buf = g_string_new(line);
-	if (!fu_firmware_strparse_uint8_safe(line, linesz, 1, &rcd->byte_cnt, error))
-		return NULL;
-	if (!fu_firmware_strparse_uint16_safe(line, linesz, 3, &addr16, error))
-		return NULL;
-	rcd->addr = addr16;
-	if (!fu_firmware_strparse_uint8_safe(line, linesz, 7, &rcd->record_type, error))
-		return NULL;
+	if (!fu_firmware_strparse_hex_safe(line, linesz, 1, hdr, sizeof(hdr), error))
+		return FALSE;
+	tok.byte_cnt = hdr[0];
+	tok.addr = fu_memread_uint16(hdr + 1, G_BIG_ENDIAN);
+	tok.record_type = hdr[3];
 
 	/* position of checksum */
-	line_end = 9 + rcd->byte_cnt * 2;
-	if (line_end > (guint)rcd->buf->len) {
+	line_end = 9 + tok.byte_cnt * 2;
+	if (line_end > linesz) {
 		g_set_error(error,
 			    FWUPD_ERROR,
 			    FWUPD_ERROR_INVALID_FILE,
 			    "line malformed, length: %u",
 			    line_end);
-		return NULL;
+		return FALSE;
 	}
 
+	/* decode straight into the shared payload buffer */
+	tok.data_offset = priv->payload->len;
+	g_byte_array_set_size(priv->payload, priv->payload->len + tok.byte_cnt);
+	data = priv->payload->data + tok.data_offset;
+	if (!fu_firmware_strparse_hex_safe(line, linesz, 9, data, tok.byte_cnt, error))
+		return FALSE;
+
 	/* verify checksum */
 	if ((flags & FWUPD_INSTALL_FLAG_IGNORE_CHECKSUM) == 0) {
 		guint8 checksum = 0;
-		for (guint i = 1; i < line_end + 2; i += 2) {
-			guint8 data_tmp = 0;
-			if (!fu_firmware_strparse_uint8_safe(line, linesz, i, &data_tmp, error))
-				return NULL;
-			checksum += data_tmp;
-		}
+		if (!fu_firmware_strparse_hex_safe(line, linesz, line_end, &checksum, 1, error))
+			return FALSE;
+		for (guint i = 0; i < sizeof(hdr); i++)
+			checksum += hdr[i];
+		for (guint i = 0; i < tok.byte_cnt; i++)
+			checksum += data[i];
 		if (checksum != 0) {
 			g_set_error(error,
 				    FWUPD_ERROR,
 				    FWUPD_ERROR_INVALID_FILE,
 				    "invalid checksum (0x%02x)",
 				    checksum);
-			return NULL;
+			return FALSE;
 		}
 	}
 
-	/* add data */
-	for (guint i = 9; i < line_end; i += 2) {
-		guint8 tmp_c = 0;
-		if (!fu_firmware_strparse_uint8_safe(line, linesz, i, &tmp_c, error))
-			return NULL;
-		fu_byte_array_append_uint8(rcd->data, tmp_c);
-	}
-	return g_steal_pointer(&rcd);
+	/* success */
+	g_array_append_val(priv->tokens, tok);
+	return TRUE;
 }
 
 static const gchar *
@@ -186,60 +235,73 @@ fu_ihex_firmware_record_type_to_string(guint8 record_type)
 	return NULL;
 }
 
-typedef struct {
-	FuIhexFirmware *self;
-	FwupdInstallFlags flags;
-} FuIhexFirmwareTokenHelper;
-
 static gboolean
-fu_ihex_firmware_tokenize_cb(GString *token, guint token_idx, gpointer user_data, GError **error)
+fu_ihex_firmware_tokenize(FuFirmware *firmware, GBytes *fw, FwupdInstallFlags flags, GError **error)
 {
-	FuIhexFirmwareTokenHelper *helper = (FuIhexFirmwareTokenHelper *)user_data;
-	FuIhexFirmwarePrivate *priv = GET_PRIVATE(helper->self);
-	g_autoptr(FuIhexFirmwareRecord) rcd = NULL;
-
-	/* sanity check */
-	if (token_idx > FU_IHEX_FIRMWARE_TOKENS_MAX) {
-		g_set_error_literal(error,
-				    G_IO_ERROR,
-				    G_IO_ERROR_INVALID_DATA,
-				    "file has too many lines");
-		return FALSE;
-	}
-
-	/* remove WIN32 line endings */
-	g_strdelimit(token->str, "\r\x1a", '\0');
-	token->len = strlen(token->str);
+	FuIhexFirmware *self = FU_IHEX_FIRMWARE(firmware);
+	FuIhexFirmwarePrivate *priv = GET_PRIVATE(self);
+	gsize bufsz = 0;
+	const gchar *buf = g_bytes_get_data(fw, &bufsz);
+	guint token_idx = 0;
+
+	/* the decoded data is always less than half the size of the text */
+	g_byte_array_unref(priv->payload);
+	priv->payload = g_byte_array_sized_new(bufsz / 2);
+	g_array_set_size(priv->tokens, 0);
+	g_ptr_array_set_size(priv->records, 0);
+	priv->records_loaded = FALSE;
+	if (priv->fw != NULL)
+		g_bytes_unref(priv->fw);
+	priv->fw = g_bytes_ref(fw);
+
+	/* split into lines without copying */
+	for (gsize offset = 0; offset < bufsz; token_idx++) {
+		const gchar *line = buf + offset;
+		const gchar *eol = memchr(line, '\n', bufsz - offset);
+		gsize linesz = eol != NULL ? (gsize)(eol - line) : bufsz - offset;
+
+		offset += linesz + 1;
 
-	/* ignore blank lines */
-	if (token->len == 0)
-		return TRUE;
+		/* sanity check */
+		if (token_idx > FU_IHEX_FIRMWARE_TOKENS_MAX) {
+			g_set_error_literal(error,
+					    G_IO_ERROR,
+					    G_IO_ERROR_INVALID_DATA,
+					    "file has too many lines");
+			return FALSE;
+		}
 
-	/* ignore comments */
-	if (g_str_has_prefix(token->str, ";"))
-		return TRUE;
+		/* remove WIN32 line endings */
+		for (gsize i = 0; i < linesz; i++) {
+			if (line[i] == '\r' || line[i] == '\x1a' || line[i] == '\0') {
+				linesz = i;
+				break;
+			}
+		}
 
-	/* parse record */
-	rcd = fu_ihex_firmware_record_new(token_idx + 1, token->str, helper->flags, error);
-	if (rcd == NULL) {
-		g_prefix_error(error, "invalid line %u: ", token_idx + 1);
-		return FALSE;
+		/* ignore blank lines */
+		if (linesz == 0)
+			continue;
+
+		/* ignore comments */
+		if (line[0] == ';')
+			continue;
+
+		/* parse record */
+		if (!fu_ihex_firmware_tokenize_line(self,
+						    token_idx + 1,
+						    line,
+						    linesz,
+						    line - buf,
+						    flags,
+						    error)) {
+			g_prefix_error(error, "invalid line %u: ", token_idx + 1);
+			return FALSE;
+		}
 	}
-	g_ptr_array_add(priv->records, g_steal_pointer(&rcd));
-	return TRUE;
-}
 
-static gboolean
-fu_ihex_firmware_tokenize(FuFirmware *firmware, GBytes *fw, FwupdInstallFlags flags, GError **error)
-{
-	FuIhexFirmware *self = FU_IHEX_FIRMWARE(firmware);
-	FuIhexFirmwareTokenHelper helper = {.self = self, .flags = flags};
-	return fu_strsplit_full(g_bytes_get_data(fw, NULL),
-				g_bytes_get_size(fw),
-				"\n",
-				fu_ihex_firmware_tokenize_cb,
-				&helper,
-				error);
+	/* success */
+	return TRUE;
 }
 
 static gboolean
@@ -258,22 +320,23 @@ fu_ihex_firmware_parse(FuFirmware *firmware,
 	guint32 img_addr = G_MAXUINT32;
 	guint32 seg_addr = 0x0;
 	g_autoptr(GBytes) img_bytes = NULL;
-	g_autoptr(GByteArray) buf = g_byte_array_new();
+	g_autoptr(GByteArray) buf = g_byte_array_sized_new(priv->payload->len);
 
 	/* parse records */
-	for (guint k = 0; k < priv->records->len; k++) {
-		FuIhexFirmwareRecord *rcd = g_ptr_array_index(priv->records, k);
+	for (guint k = 0; k < priv->tokens->len; k++) {
+		FuIhexFirmwareToken *tok = &g_array_index(priv->tokens, FuIhexFirmwareToken, k);
+		const guint8 *data = priv->payload->data + tok->data_offset;
 		guint16 addr16 = 0;
-		guint32 addr = rcd->addr + seg_addr + abs_addr;
+		guint32 addr = tok->addr + seg_addr + abs_addr;
 		guint32 len_hole;
 
 		/* debug */
-		g_debug("%s:", fu_ihex_firmware_record_type_to_string(rcd->record_type));
-		g_debug("length:\t0x%02x", rcd->data->len);
+		g_debug("%s:", fu_ihex_firmware_record_type_to_string(tok->record_type));
+		g_debug("length:\t0x%02x", tok->byte_cnt);
 		g_debug("addr:\t0x%08x", addr);
 
 		/* sanity check */
-		if (rcd->record_type != FU_IHEX_FIRMWARE_RECORD_TYPE_EOF && rcd->data->len == 0) {
+		if (tok->record_type != FU_IHEX_FIRMWARE_RECORD_TYPE_EOF && tok->byte_cnt == 0) {
 			g_set_error(error,
 				    FWUPD_ERROR,
 				    FWUPD_ERROR_NOT_SUPPORTED,
@@ -283,7 +346,7 @@ fu_ihex_firmware_parse(FuFirmware *firmware,
 		}
 
 		/* process different record types */
-		switch (rcd->record_type) {
+		switch (tok->record_type) {
 		case FU_IHEX_FIRMWARE_RECORD_TYPE_DATA:
 
 			/* does not make sense */
@@ -294,7 +357,7 @@ fu_ihex_firmware_parse(FuFirmware *firmware,
 						    "cannot process data after EOF");
 				return FALSE;
 			}
-			if (rcd->data->len == 0) {
+			if (tok->byte_cnt == 0) {
 				g_set_error_literal(error,
 						    FWUPD_ERROR,
 						    FWUPD_ERROR_INVALID_FILE,
@@ -314,7 +377,7 @@ fu_ihex_firmware_parse(FuFirmware *firmware,
 					    "invalid address 0x%x, last was 0x%x on line %u",
 					    (guint)addr,
 					    (guint)addr_last,
-					    rcd->ln);
+					    tok->ln);
 				return FALSE;
 			}
 
@@ -326,30 +389,31 @@ fu_ihex_firmware_parse(FuFirmware *firmware,
 					    FWUPD_ERROR_INVALID_FILE,
 					    "hole of 0x%x bytes too large to fill on line %u",
 					    (guint)len_hole,
-					    rcd->ln);
+					    tok->ln);
 				return FALSE;
 			}
 			if (addr_last > 0x0 && len_hole > 1) {
 				g_debug("filling address 0x%08x to 0x%08x on line %u",
 					addr_last + 1,
 					addr_last + len_hole - 1,
-					rcd->ln);
-				for (guint j = 1; j < len_hole; j++)
-					fu_byte_array_append_uint8(buf, priv->padding_value);
+					tok->ln);
+				fu_byte_array_set_size(buf,
+						       buf->len + len_hole - 1,
+						       priv->padding_value);
 			}
-			addr_last = addr + rcd->data->len - 1;
+			addr_last = addr + tok->byte_cnt - 1;
 			if (addr_last < addr) {
 				g_set_error(error,
 					    FWUPD_ERROR,
 					    FWUPD_ERROR_INVALID_FILE,
 					    "overflow of address 0x%x on line %u",
 					    (guint)addr,
-					    rcd->ln);
+					    tok->ln);
 				return FALSE;
 			}
 
 			/* write into buf */
-			g_byte_array_append(buf, rcd->data->data, rcd->data->len);
+			g_byte_array_append(buf, data, tok->byte_cnt);
 			break;
 		case FU_IHEX_FIRMWARE_RECORD_TYPE_EOF:
 			if (got_eof) {
@@ -363,29 +427,29 @@ fu_ihex_firmware_parse(FuFirmware *firmware,
 			got_eof = TRUE;
 			break;
 		case FU_IHEX_FIRMWARE_RECORD_TYPE_EXTENDED_LINEAR:
-			if (!fu_memread_uint16_safe(rcd->data->data,
-						    rcd->data->len,
+			if (!fu_memread_uint16_safe(data,
+						    tok->byte_cnt,
 						    0x0,
 						    &addr16,
 						    G_BIG_ENDIAN,
 						    error))
 				return FALSE;
 			abs_addr = (guint32)addr16 << 16;
-			g_debug("abs_addr:\t0x%02x on line %u", abs_addr, rcd->ln);
+			g_debug("abs_addr:\t0x%02x on line %u", abs_addr, tok->ln);
 			break;
 		case FU_IHEX_FIRMWARE_RECORD_TYPE_START_LINEAR:
-			if (!fu_memread_uint32_safe(rcd->data->data,
-						    rcd->data->len,
+			if (!fu_memread_uint32_safe(data,
+						    tok->byte_cnt,
 						    0x0,
 						    &abs_addr,
 						    G_BIG_ENDIAN,
 						    error))
 				return FALSE;
-			g_debug("abs_addr:\t0x%08x on line %u", abs_addr, rcd->ln);
+			g_debug("abs_addr:\t0x%08x on line %u", abs_addr, tok->ln);
 			break;
 		case FU_IHEX_FIRMWARE_RECORD_TYPE_EXTENDED_SEGMENT:
-			if (!fu_memread_uint16_safe(rcd->data->data,
-						    rcd->data->len,
+			if (!fu_memread_uint16_safe(data,
+						    tok->byte_cnt,
 						    0x0,
 						    &addr16,
 						    G_BIG_ENDIAN,
@@ -393,18 +457,18 @@ fu_ihex_firmware_parse(FuFirmware *firmware,
 				return FALSE;
 			/* segment base address, so ~1Mb addressable */
 			seg_addr = (guint32)addr16 * 16;
-			g_debug("seg_addr:\t0x%08x on line %u", seg_addr, rcd->ln);
+			g_debug("seg_addr:\t0x%08x on line %u", seg_addr, tok->ln);
 			break;
 		case FU_IHEX_FIRMWARE_RECORD_TYPE_START_SEGMENT:
 			/* initial content of the CS:IP registers */
-			if (!fu_memread_uint32_safe(rcd->data->data,
-						    rcd->data->len,
+			if (!fu_memread_uint32_safe(data,
+						    tok->byte_cnt,
 						    0x0,
 						    &seg_addr,
 						    G_BIG_ENDIAN,
 						    error))
 				return FALSE;
-			g_debug("seg_addr:\t0x%02x on line %u", seg_addr, rcd->ln);
+			g_debug("seg_addr:\t0x%02x on line %u", seg_addr, tok->ln);
 			break;
 		case FU_IHEX_FIRMWARE_RECORD_TYPE_SIGNATURE:
 			if (got_sig) {
@@ -415,9 +479,9 @@ fu_ihex_firmware_parse(FuFirmware *firmware,
 						    "corrupt file");
 				return FALSE;
 			}
-			if (rcd->data->len > 0) {
+			if (tok->byte_cnt > 0) {
 				g_autoptr(GBytes) data_sig =
-				    g_bytes_new(rcd->data->data, rcd->data->len);
+				    g_bytes_new(data, tok->byte_cnt);
 				g_autoptr(FuFirmware) img_sig =
 				    fu_firmware_new_from_bytes(data_sig);
 				fu_firmware_set_id(img_sig, FU_FIRMWARE_ID_SIGNATURE);
@@ -433,8 +497,8 @@ fu_ihex_firmware_parse(FuFirmware *firmware,
 				    FWUPD_ERROR,
 				    FWUPD_ERROR_INVALID_FILE,
 				    "invalid ihex record type %i on line %u",
-				    rcd->record_type,
-				    rcd->ln);
+				    tok->record_type,
+				    tok->ln);
 			return FALSE;
 		}
 	}
@@ -557,6 +621,10 @@ fu_ihex_firmware_finalize(GObject *object)
 	FuIhexFirmware *self = FU_IHEX_FIRMWARE(object);
 	FuIhexFirmwarePrivate *priv = GET_PRIVATE(self);
 	g_ptr_array_unref(priv->records);
+	g_array_unref(priv->tokens);
+	g_byte_array_unref(priv->payload);
+	if (priv->fw != NULL)
+		g_bytes_unref(priv->fw);
 	G_OBJECT_CLASS(fu_ihex_firmware_parent_class)->finalize(object);
 }
 
@@ -566,6 +634,8 @@ fu_ihex_firmware_init(FuIhexFirmware *self)
 	FuIhexFirmwarePrivate *priv = GET_PRIVATE(self);
 	priv->padding_value = 0x00; /* chosen as we can't write 0xffff to PIC14 */
 	priv->records = g_ptr_array_new_with_free_func((GFreeFunc)fu_ihex_firmware_record_free);
+	priv->tokens = g_array_new(FALSE, FALSE, sizeof(FuIhexFirmwareToken));
+	priv->payload = g_byte_array_new();
 	fu_firmware_add_flag(FU_FIRMWARE(self), FU_FIRMWARE_FLAG_HAS_CHECKSUM);
 }
 
@@ -22,6 +22,10 @@ guint
 fu_plugin_get_order(FuPlugin *self);
 void
 fu_plugin_set_order(FuPlugin *self, guint order);
+gboolean
+fu_plugin_get_thread_safe(FuPlugin *self);
+void
+fu_plugin_set_thread_safe(FuPlugin *self, gboolean thread_safe);
 guint
 fu_plugin_get_priority(FuPlugin *self);
 void
@@ -41,6 +41,7 @@ typedef struct {
 	guint order;
 	guint priority;
 	gboolean done_init;
+	gboolean thread_safe;
 	GPtrArray *rules[FU_PLUGIN_RULE_LAST];
 	GPtrArray *devices; /* (nullable) (element-type FuDevice) */
 	GHashTable *runtime_versions;
@@ -408,6 +409,8 @@ fu_plugin_add_string(FuPlugin *self, guint idt, GString *str)
 		fu_string_append_ku(str, idt + 1, "Order", priv->order);
 	if (priv->priority != 0)
 		fu_string_append_ku(str, idt + 1, "Priority", priv->priority);
+	if (priv->thread_safe)
+		fu_string_append_kb(str, idt + 1, "ThreadSafe", priv->thread_safe);
 
 	/* optional */
 	if (vfuncs->to_string != NULL)
@@ -813,7 +816,8 @@ fu_plugin_device_read_firmware(FuPlugin *self,
 	g_autoptr(FuDeviceLocker) locker = NULL;
 	g_autoptr(FuFirmware) firmware = NULL;
 	g_autoptr(GBytes) fw = NULL;
-	GChecksumType checksum_types[] = {G_CHECKSUM_SHA1, G_CHECKSUM_SHA256, 0};
+	g_autoptr(GPtrArray) checksums = NULL;
+	GChecksumType checksum_types[] = {G_CHECKSUM_SHA1, G_CHECKSUM_SHA256};
 	locker = fu_device_locker_new(proxy, error);
 	if (locker == NULL)
 		return FALSE;
@@ -835,11 +839,9 @@ fu_plugin_device_read_firmware(FuPlugin *self,
 		g_prefix_error(error, "failed to write firmware: ");
 		return FALSE;
 	}
-	for (guint i = 0; checksum_types[i] != 0; i++) {
-		g_autofree gchar *hash = NULL;
-		hash = g_compute_checksum_for_bytes(checksum_types[i], fw);
-		fu_device_add_checksum(device, hash);
-	}
+	checksums = fu_bytes_get_checksums(fw, checksum_types, G_N_ELEMENTS(checksum_types));
+	for (guint i = 0; i < checksums->len; i++)
+		fu_device_add_checksum(device, g_ptr_array_index(checksums, i));
 	return fu_device_attach_full(device, progress, error);
 }
 
@@ -848,7 +850,10 @@ fu_plugin_device_read_firmware(FuPlugin *self,
  * @self: a #FuPlugin
  * @error: (nullable): optional return location for an error
  *
- * Runs the startup routine for the plugin
+ * Runs the startup routine for the plugin.
+ *
+ * Plugins with %FWUPD_PLUGIN_FLAG_REQUIRE_HWID set are not started, as the flag is only cleared
+ * when a HwId quirk lists the plugin for the current machine.
  *
  * Returns: #TRUE for success, #FALSE for failure
  *
@@ -872,6 +877,12 @@ fu_plugin_runner_startup(FuPlugin *self, FuProgress *progress, GError **error)
 	if (fu_plugin_has_flag(self, FWUPD_PLUGIN_FLAG_DISABLED))
 		return TRUE;
 
+	/* no HwId, so do not spend any time probing hardware that cannot be present */
+	if (fu_plugin_has_flag(self, FWUPD_PLUGIN_FLAG_REQUIRE_HWID)) {
+		g_debug("not starting %s as no HwId matched", fu_plugin_get_name(self));
+		return TRUE;
+	}
+
 	/* optional */
 	if (vfuncs->startup != NULL) {
 		g_debug("startup(%s)", fu_plugin_get_name(self));
@@ -1483,10 +1494,9 @@ fu_plugin_add_firmware_gtype(FuPlugin *self, const gchar *id, GType gtype)
 static gboolean
 fu_plugin_check_supported_device(FuPlugin *self, FuDevice *device)
 {
-	GPtrArray *instance_ids = fu_device_get_instance_ids(device);
-	for (guint i = 0; i < instance_ids->len; i++) {
-		const gchar *instance_id = g_ptr_array_index(instance_ids, i);
-		g_autofree gchar *guid = fwupd_guid_hash_string(instance_id);
+	g_autoptr(GPtrArray) guids = fu_device_get_instance_id_guids(device);
+	for (guint i = 0; i < guids->len; i++) {
+		const gchar *guid = g_ptr_array_index(guids, i);
 		if (fu_plugin_check_supported(self, guid))
 			return TRUE;
 	}
@@ -1750,6 +1760,10 @@ fu_plugin_runner_device_register(FuPlugin *self, FuDevice *device)
 	if (fu_plugin_has_flag(self, FWUPD_PLUGIN_FLAG_DISABLED))
 		return;
 
+	/* never started */
+	if (fu_plugin_has_flag(self, FWUPD_PLUGIN_FLAG_REQUIRE_HWID))
+		return;
+
 	/* optional */
 	if (vfuncs->device_registered != NULL) {
 		g_debug("fu_plugin_device_registered(%s)", fu_plugin_get_name(self));
@@ -2198,6 +2212,39 @@ fu_plugin_set_order(FuPlugin *self, guint order)
 	priv->order = order;
 }
 
+/**
+ * fu_plugin_get_thread_safe:
+ * @self: a #FuPlugin
+ *
+ * Gets if the plugin can set up devices from more than one thread at the same time.
+ *
+ * Returns: %TRUE if thread safe
+ *
+ * Since: 1.9.4
+ **/
+gboolean
+fu_plugin_get_thread_safe(FuPlugin *self)
+{
+	FuPluginPrivate *priv = fu_plugin_get_instance_private(self);
+	return priv->thread_safe;
+}
+
+/**
+ * fu_plugin_set_thread_safe:
+ * @self: a #FuPlugin
+ * @thread_safe: boolean
+ *
+ * Sets if the plugin can set up devices from more than one thread at the same time.
+ *
+ * Since: 1.9.4
+ **/
+void
+fu_plugin_set_thread_safe(FuPlugin *self, gboolean thread_safe)
+{
+	FuPluginPrivate *priv = fu_plugin_get_instance_private(self);
+	priv->thread_safe = thread_safe;
+}
+
 /**
  * fu_plugin_get_priority:
  * @self: a #FuPlugin
@@ -0,0 +1,12 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * SPDX-License-Identifier: LGPL-2.1+
+ */
+
+#pragma once
+
+#include "fu-progress.h"
+
+void
+fu_progress_add_bytes_full(FuProgress *self, gsize bytes, gint64 now);
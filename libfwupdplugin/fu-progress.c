@@ -10,7 +10,7 @@
 
 #include <math.h>
 
-#include "fu-progress.h"
+#include "fu-progress-private.h"
 #include "fu-string.h"
 
 /**
@@ -71,9 +71,20 @@ struct _FuProgress {
 	GTimer *timer;
 	GTimer *timer_child;
 	guint step_now;
-	FuProgress *parent; /* no-ref */
+	gint64 time_start;	  /* monotonic */
+	guint64 bytes;		  /* total transferred */
+	guint64 throughput_bytes; /* at throughput_ts */
+	gint64 throughput_ts;	  /* monotonic */
+	gdouble throughput;	  /* smoothed, bytes per second */
+	FuProgress *parent;	  /* no-ref */
 };
 
+/* minimum time between throughput samples */
+#define FU_PROGRESS_THROUGHPUT_INTERVAL (G_USEC_PER_SEC / 4)
+
+/* weighting of the newest sample in the moving average */
+#define FU_PROGRESS_THROUGHPUT_ALPHA 0.2f
+
 enum { SIGNAL_PERCENTAGE_CHANGED, SIGNAL_STATUS_CHANGED, SIGNAL_LAST };
 
 static guint signals[SIGNAL_LAST] = {0};
@@ -321,6 +332,118 @@ fu_progress_get_percentage(FuProgress *self)
 	return self->percentage;
 }
 
+/**
+ * fu_progress_add_bytes:
+ * @self: a #FuProgress
+ * @bytes: number of bytes transferred since the last call
+ *
+ * Records that data has been moved to or from the device, which is used to calculate the
+ * transfer rate. The byte count is also added to all the parent progress objects.
+ *
+ * Since: 1.9.4
+ **/
+void
+fu_progress_add_bytes(FuProgress *self, gsize bytes)
+{
+	g_return_if_fail(FU_IS_PROGRESS(self));
+	fu_progress_add_bytes_full(self, bytes, g_get_monotonic_time());
+}
+
+/* @now is the monotonic time of the sample */
+void
+fu_progress_add_bytes_full(FuProgress *self, gsize bytes, gint64 now)
+{
+	gint64 elapsed;
+
+	g_return_if_fail(FU_IS_PROGRESS(self));
+
+	/* the first sample is only used as the starting point */
+	self->bytes += bytes;
+	if (self->throughput_ts == 0) {
+		self->throughput_ts = now;
+		self->throughput_bytes = self->bytes;
+	}
+
+	/* exponentially smooth the rate to avoid jitter from short transfers */
+	elapsed = now - self->throughput_ts;
+	if (elapsed >= FU_PROGRESS_THROUGHPUT_INTERVAL) {
+		gdouble rate = (gdouble)(self->bytes - self->throughput_bytes) *
+			       G_USEC_PER_SEC / (gdouble)elapsed;
+		if (self->throughput == 0.f) {
+			self->throughput = rate;
+		} else {
+			gdouble weight = 1.f - FU_PROGRESS_THROUGHPUT_ALPHA;
+			self->throughput =
+			    (FU_PROGRESS_THROUGHPUT_ALPHA * rate) + (weight * self->throughput);
+		}
+		self->throughput_ts = now;
+		self->throughput_bytes = self->bytes;
+	}
+
+	/* propagate up the stack */
+	if (self->parent != NULL)
+		fu_progress_add_bytes_full(self->parent, bytes, now);
+}
+
+/**
+ * fu_progress_get_bytes:
+ * @self: a #FuProgress
+ *
+ * Gets the number of bytes transferred since the progress was reset.
+ *
+ * Returns: number of bytes, or 0 if fu_progress_add_bytes() was never used
+ *
+ * Since: 1.9.4
+ **/
+guint64
+fu_progress_get_bytes(FuProgress *self)
+{
+	g_return_val_if_fail(FU_IS_PROGRESS(self), 0);
+	return self->bytes;
+}
+
+/**
+ * fu_progress_get_throughput:
+ * @self: a #FuProgress
+ *
+ * Gets the smoothed transfer rate.
+ *
+ * Returns: bytes per second, or 0 if not yet known
+ *
+ * Since: 1.9.4
+ **/
+guint64
+fu_progress_get_throughput(FuProgress *self)
+{
+	g_return_val_if_fail(FU_IS_PROGRESS(self), 0);
+	return (guint64)self->throughput;
+}
+
+/**
+ * fu_progress_get_time_remaining:
+ * @self: a #FuProgress
+ *
+ * Estimates the time until the progress completes. As the percentage already takes into
+ * account the step weighting, the estimate is proportional to the time taken so far.
+ *
+ * Returns: seconds, or 0 if not yet known
+ *
+ * Since: 1.9.4
+ **/
+guint
+fu_progress_get_time_remaining(FuProgress *self)
+{
+	gdouble elapsed;
+
+	g_return_val_if_fail(FU_IS_PROGRESS(self), 0);
+
+	/* no useful data */
+	if (self->percentage == 0 || self->percentage >= 100)
+		return 0;
+	elapsed = (gdouble)(g_get_monotonic_time() - self->time_start) / G_USEC_PER_SEC;
+	return (guint)(elapsed * (100 - self->percentage) / self->percentage);
+}
+
 static void
 fu_progress_set_parent(FuProgress *self, FuProgress *parent)
 {
@@ -479,6 +602,11 @@ fu_progress_reset(FuProgress *self)
 	/* reset values */
 	self->step_now = 0;
 	self->percentage = G_MAXUINT;
+	self->time_start = g_get_monotonic_time();
+	self->bytes = 0;
+	self->throughput_bytes = 0;
+	self->throughput_ts = 0;
+	self->throughput = 0.f;
 
 	/* only use the timer if profiling; it's expensive */
 	if (self->profile) {
@@ -1033,6 +1161,7 @@ fu_progress_init(FuProgress *self)
 {
 	self->status = FWUPD_STATUS_UNKNOWN;
 	self->percentage = G_MAXUINT;
+	self->time_start = g_get_monotonic_time();
 	self->timer = g_timer_new();
 	self->timer_child = g_timer_new();
 	self->children = g_ptr_array_new_with_free_func((GDestroyNotify)g_object_unref);
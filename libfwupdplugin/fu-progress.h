@@ -106,6 +106,14 @@ fu_progress_get_percentage(FuProgress *self);
 gdouble
 fu_progress_get_duration(FuProgress *self);
 void
+fu_progress_add_bytes(FuProgress *self, gsize bytes);
+guint64
+fu_progress_get_bytes(FuProgress *self);
+guint64
+fu_progress_get_throughput(FuProgress *self);
+guint
+fu_progress_get_time_remaining(FuProgress *self);
+void
 fu_progress_set_profile(FuProgress *self, gboolean profile);
 gboolean
 fu_progress_get_profile(FuProgress *self);
@@ -54,11 +54,16 @@ struct _FuQuirks {
 	GHashTable *possible_keys;
 	GPtrArray *invalid_keys;
 	XbSilo *silo;
-	XbQuery *query_kv;
-	XbQuery *query_vs;
+	GHashTable *index; /* (element-type utf8 GArray) of FuQuirksEntry */
 	gboolean verbose;
 };
 
+/* both strings are owned by the silo */
+typedef struct {
+	const gchar *key;
+	const gchar *value;
+} FuQuirksEntry;
+
 G_DEFINE_TYPE(FuQuirks, fu_quirks, G_TYPE_OBJECT)
 
 static gchar *
@@ -337,6 +342,59 @@ fu_quirks_strcasecmp_cb(gconstpointer a, gconstpointer b)
 	return g_ascii_strcasecmp(entry1, entry2);
 }
 
+/*
+ * Each device instance ID is looked up for every possible quirk key during coldplug, so
+ * rather than running an XPath query each time, map each GUID to the key/value pairs in
+ * document order when the silo is loaded.
+ */
+static gboolean
+fu_quirks_build_index(FuQuirks *self, GError **error)
+{
+	g_autoptr(GError) error_local = NULL;
+	g_autoptr(GPtrArray) devices = NULL;
+
+	devices = xb_silo_query(self->silo, "quirk/device", 0, &error_local);
+	if (devices == NULL) {
+		if (g_error_matches(error_local, G_IO_ERROR, G_IO_ERROR_NOT_FOUND) ||
+		    g_error_matches(error_local, G_IO_ERROR, G_IO_ERROR_INVALID_ARGUMENT)) {
+			g_debug("no quirk data, not building index");
+			return TRUE;
+		}
+		g_propagate_error(error, g_steal_pointer(&error_local));
+		return FALSE;
+	}
+	for (guint i = 0; i < devices->len; i++) {
+		XbNode *n = g_ptr_array_index(devices, i);
+		const gchar *id = xb_node_get_attr(n, "id");
+		GArray *entries;
+		g_autoptr(GPtrArray) values = NULL;
+
+		if (id == NULL)
+			continue;
+		entries = g_hash_table_lookup(self->index, id);
+		if (entries == NULL) {
+			entries = g_array_new(FALSE, FALSE, sizeof(FuQuirksEntry));
+			g_hash_table_insert(self->index, (gpointer)id, entries);
+		}
+		values = xb_node_get_children(n);
+		if (values == NULL)
+			continue;
+		for (guint j = 0; j < values->len; j++) {
+			XbNode *c = g_ptr_array_index(values, j);
+			FuQuirksEntry entry = {
+			    .key = xb_node_get_attr(c, "key"),
+			    .value = xb_node_get_text(c),
+			};
+			if (entry.key == NULL)
+				continue;
+			g_array_append_val(entries, entry);
+		}
+	}
+
+	/* success */
+	return TRUE;
+}
+
 static gboolean
 fu_quirks_check_silo(FuQuirks *self, GError **error)
 {
@@ -345,12 +403,15 @@ fu_quirks_check_silo(FuQuirks *self, GError **error)
 	g_autofree gchar *localstatedir = NULL;
 	g_autoptr(GFile) file = NULL;
 	g_autoptr(XbBuilder) builder = NULL;
-	g_autoptr(XbNode) n_any = NULL;
 
 	/* everything is okay */
 	if (self->silo != NULL && xb_silo_is_valid(self->silo))
 		return TRUE;
 
+	/* the index points into the old silo */
+	g_hash_table_remove_all(self->index);
+	g_clear_object(&self->silo);
+
 	/* system datadir */
 	builder = xb_builder_new();
 	datadir = fu_path_from_kind(FU_PATH_KIND_DATADIR_QUIRKS);
@@ -392,35 +453,11 @@ fu_quirks_check_silo(FuQuirks *self, GError **error)
 		g_info("invalid key names: %s", str);
 	}
 
-	/* check if there is any quirk data to load, as older libxmlb versions will not be able to
-	 * create the prepared query with an unknown text ID */
-	n_any = xb_silo_query_first(self->silo, "quirk", NULL);
-	if (n_any == NULL) {
-		g_debug("no quirk data, not creating prepared queries");
-		return TRUE;
-	}
-
-	/* create prepared queries to save time later */
-	self->query_kv = xb_query_new_full(self->silo,
-					   "quirk/device[@id=?]/value[@key=?]",
-					   XB_QUERY_FLAG_OPTIMIZE,
-					   error);
-	if (self->query_kv == NULL) {
-		g_prefix_error(error, "failed to prepare query: ");
-		return FALSE;
-	}
-	self->query_vs = xb_query_new_full(self->silo,
-					   "quirk/device[@id=?]/value",
-					   XB_QUERY_FLAG_OPTIMIZE,
-					   error);
-	if (self->query_vs == NULL) {
-		g_prefix_error(error, "failed to prepare query: ");
+	/* build the index to save time later */
+	if (!fu_quirks_build_index(self, error)) {
+		g_prefix_error(error, "failed to build index: ");
 		return FALSE;
 	}
-	if (!xb_silo_query_build_index(self->silo, "quirk/device", "id", error))
-		return FALSE;
-	if (!xb_silo_query_build_index(self->silo, "quirk/device/value", "key", error))
-		return FALSE;
 
 	/* success */
 	return TRUE;
@@ -441,9 +478,8 @@ fu_quirks_check_silo(FuQuirks *self, GError **error)
 const gchar *
 fu_quirks_lookup_by_id(FuQuirks *self, const gchar *guid, const gchar *key)
 {
+	GArray *entries;
 	g_autoptr(GError) error = NULL;
-	g_autoptr(XbNode) n = NULL;
-	g_auto(XbQueryContext) context = XB_QUERY_CONTEXT_INIT();
 
 	g_return_val_if_fail(FU_IS_QUIRKS(self), NULL);
 	g_return_val_if_fail(guid != NULL, NULL);
@@ -455,26 +491,19 @@ fu_quirks_lookup_by_id(FuQuirks *self, const gchar *guid, const gchar *key)
 		return NULL;
 	}
 
-	/* no quirk data */
-	if (self->query_kv == NULL)
-		return NULL;
-
-	/* query */
-	xb_query_context_set_flags(&context, XB_QUERY_FLAG_USE_INDEXES);
-	xb_value_bindings_bind_str(xb_query_context_get_bindings(&context), 0, guid, NULL);
-	xb_value_bindings_bind_str(xb_query_context_get_bindings(&context), 1, key, NULL);
-	n = xb_silo_query_first_with_context(self->silo, self->query_kv, &context, &error);
-	if (n == NULL) {
-		if (g_error_matches(error, G_IO_ERROR, G_IO_ERROR_NOT_FOUND))
-			return NULL;
-		if (g_error_matches(error, G_IO_ERROR, G_IO_ERROR_INVALID_ARGUMENT))
-			return NULL;
-		g_warning("failed to query: %s", error->message);
+	/* lookup */
+	entries = g_hash_table_lookup(self->index, guid);
+	if (entries == NULL)
 		return NULL;
+	for (guint i = 0; i < entries->len; i++) {
+		FuQuirksEntry *entry = &g_array_index(entries, FuQuirksEntry, i);
+		if (g_strcmp0(entry->key, key) != 0)
+			continue;
+		if (self->verbose)
+			g_debug("%s:%s → %s", guid, key, entry->value);
+		return entry->value;
 	}
-	if (self->verbose)
-		g_debug("%s:%s → %s", guid, key, xb_node_get_text(n));
-	return xb_node_get_text(n);
+	return NULL;
 }
 
 /**
@@ -498,9 +527,9 @@ fu_quirks_lookup_by_id_iter(FuQuirks *self,
 			    FuQuirksIter iter_cb,
 			    gpointer user_data)
 {
+	GArray *entries;
+	gboolean found = FALSE;
 	g_autoptr(GError) error = NULL;
-	g_autoptr(GPtrArray) results = NULL;
-	g_auto(XbQueryContext) context = XB_QUERY_CONTEXT_INIT();
 
 	g_return_val_if_fail(FU_IS_QUIRKS(self), FALSE);
 	g_return_val_if_fail(guid != NULL, FALSE);
@@ -512,34 +541,20 @@ fu_quirks_lookup_by_id_iter(FuQuirks *self,
 		return FALSE;
 	}
 
-	/* no quirk data */
-	if (self->query_vs == NULL)
-		return FALSE;
-
-	/* query */
-	xb_query_context_set_flags(&context, XB_QUERY_FLAG_USE_INDEXES);
-	xb_value_bindings_bind_str(xb_query_context_get_bindings(&context), 0, guid, NULL);
-	if (key != NULL) {
-		xb_value_bindings_bind_str(xb_query_context_get_bindings(&context), 1, key, NULL);
-		results = xb_silo_query_with_context(self->silo, self->query_kv, &context, &error);
-	} else {
-		results = xb_silo_query_with_context(self->silo, self->query_vs, &context, &error);
-	}
-	if (results == NULL) {
-		if (g_error_matches(error, G_IO_ERROR, G_IO_ERROR_NOT_FOUND))
-			return FALSE;
-		if (g_error_matches(error, G_IO_ERROR, G_IO_ERROR_INVALID_ARGUMENT))
-			return FALSE;
-		g_warning("failed to query: %s", error->message);
+	/* lookup */
+	entries = g_hash_table_lookup(self->index, guid);
+	if (entries == NULL)
 		return FALSE;
-	}
-	for (guint i = 0; i < results->len; i++) {
-		XbNode *n = g_ptr_array_index(results, i);
+	for (guint i = 0; i < entries->len; i++) {
+		FuQuirksEntry *entry = &g_array_index(entries, FuQuirksEntry, i);
+		if (key != NULL && g_strcmp0(entry->key, key) != 0)
+			continue;
 		if (self->verbose)
-			g_debug("%s → %s", guid, xb_node_get_text(n));
-		iter_cb(self, xb_node_get_attr(n, "key"), xb_node_get_text(n), user_data);
+			g_debug("%s → %s", guid, entry->value);
+		iter_cb(self, entry->key, entry->value, user_data);
+		found = TRUE;
 	}
-	return TRUE;
+	return found;
 }
 
 /**
@@ -593,6 +608,8 @@ static void
 fu_quirks_init(FuQuirks *self)
 {
 	self->possible_keys = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+	self->index =
+	    g_hash_table_new_full(g_str_hash, g_str_equal, NULL, (GDestroyNotify)g_array_unref);
 	self->invalid_keys = g_ptr_array_new_with_free_func(g_free);
 
 	/* built in */
@@ -644,10 +661,7 @@ static void
 fu_quirks_finalize(GObject *obj)
 {
 	FuQuirks *self = FU_QUIRKS(obj);
-	if (self->query_kv != NULL)
-		g_object_unref(self->query_kv);
-	if (self->query_vs != NULL)
-		g_object_unref(self->query_vs);
+	g_hash_table_unref(self->index);
 	if (self->silo != NULL)
 		g_object_unref(self->silo);
 	g_hash_table_unref(self->possible_keys);
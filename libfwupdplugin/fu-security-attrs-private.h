@@ -20,6 +20,8 @@ typedef enum {
 	FU_SECURITY_ATTRS_FLAG_LAST
 } FuSecurityAttrsFlags;
 
+#include "fwupd-json-writer-private.h"
+
 #include "fu-security-attrs.h"
 
 FuSecurityAttrs *
@@ -37,6 +39,8 @@ fu_security_attrs_append_internal(FuSecurityAttrs *self, FwupdSecurityAttr *attr
 gchar *
 fu_security_attrs_to_json_string(FuSecurityAttrs *self, GError **error);
 gboolean
+fu_security_attrs_write_json(FuSecurityAttrs *self, FwupdJsonWriter *writer, GError **error);
+gboolean
 fu_security_attrs_from_json(FuSecurityAttrs *self, JsonNode *json_node, GError **error);
 gboolean
 fu_security_attrs_equal(FuSecurityAttrs *attrs1, FuSecurityAttrs *attrs2);
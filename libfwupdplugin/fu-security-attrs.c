@@ -11,6 +11,7 @@
 #include <fwupd.h>
 #include <glib/gi18n.h>
 
+#include "fwupd-json-writer-private.h"
 #include "fwupd-security-attr-private.h"
 
 #include "fu-security-attrs-private.h"
@@ -464,26 +465,47 @@ fu_security_attrs_depsolve(FuSecurityAttrs *self)
 	g_ptr_array_sort(self->attrs, fu_security_attrs_sort_cb);
 }
 
-static void
-fu_security_attrs_to_json(FuSecurityAttrs *self, JsonBuilder *builder)
+/**
+ * fu_security_attrs_write_json:
+ * @self: a pointer for a FuSecurityAttrs data structure.
+ * @writer: a #FwupdJsonWriter
+ * @error: (nullable): optional return location for an error
+ *
+ * Writes the security attributes as JSON, one attribute at a time.
+ *
+ * Returns: %TRUE for success
+ *
+ * Since: 1.9.4
+ */
+gboolean
+fu_security_attrs_write_json(FuSecurityAttrs *self, FwupdJsonWriter *writer, GError **error)
 {
 	g_autoptr(GPtrArray) items = NULL;
 
-	json_builder_begin_object(builder);
-	json_builder_set_member_name(builder, "SecurityAttributes");
-	json_builder_begin_array(builder);
+	g_return_val_if_fail(FU_IS_SECURITY_ATTRS(self), FALSE);
+	g_return_val_if_fail(writer != NULL, FALSE);
+	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+
+	if (!fwupd_json_writer_begin_object(writer, NULL, error))
+		return FALSE;
+	if (!fwupd_json_writer_begin_array(writer, "SecurityAttributes", error))
+		return FALSE;
 	items = fu_security_attrs_get_all(self);
 	for (guint i = 0; i < items->len; i++) {
 		FwupdSecurityAttr *attr = g_ptr_array_index(items, i);
 		guint64 created = fwupd_security_attr_get_created(attr);
+		g_autoptr(JsonBuilder) builder = json_builder_new();
 		json_builder_begin_object(builder);
 		fwupd_security_attr_set_created(attr, 0);
 		fwupd_security_attr_to_json(attr, builder);
 		fwupd_security_attr_set_created(attr, created);
 		json_builder_end_object(builder);
+		if (!fwupd_json_writer_add_builder(writer, NULL, builder, error))
+			return FALSE;
 	}
-	json_builder_end_array(builder);
-	json_builder_end_object(builder);
+	if (!fwupd_json_writer_end_array(writer, error))
+		return FALSE;
+	return fwupd_json_writer_end_object(writer, error);
 }
 
 /**
@@ -508,28 +530,24 @@ fu_security_attrs_to_json(FuSecurityAttrs *self, JsonBuilder *builder)
 gchar *
 fu_security_attrs_to_json_string(FuSecurityAttrs *self, GError **error)
 {
-	g_autofree gchar *data = NULL;
-	g_autoptr(JsonGenerator) json_generator = NULL;
-	g_autoptr(JsonBuilder) builder = json_builder_new();
-	g_autoptr(JsonNode) json_root = NULL;
+	g_autoptr(FwupdJsonWriter) writer = NULL;
+	g_autoptr(GOutputStream) stream = g_memory_output_stream_new_resizable();
 
 	g_return_val_if_fail(FU_IS_SECURITY_ATTRS(self), NULL);
 	g_return_val_if_fail(error == NULL || *error == NULL, NULL);
 
-	fu_security_attrs_to_json(self, builder);
-	json_root = json_builder_get_root(builder);
-	json_generator = json_generator_new();
-	json_generator_set_pretty(json_generator, TRUE);
-	json_generator_set_root(json_generator, json_root);
-	data = json_generator_to_data(json_generator, NULL);
-	if (data == NULL) {
-		g_set_error(error,
-			    FWUPD_ERROR,
-			    FWUPD_ERROR_INTERNAL,
-			    "Failed to convert security attribute to json.");
+	writer = fwupd_json_writer_new(stream);
+	if (!fu_security_attrs_write_json(self, writer, error)) {
+		g_prefix_error(error, "Failed to convert security attribute to json: ");
 		return NULL;
 	}
-	return g_steal_pointer(&data);
+	if (!fwupd_json_writer_finish(writer, error))
+		return NULL;
+	if (!g_output_stream_write_all(stream, "", 1, NULL, NULL, error))
+		return NULL;
+	if (!g_output_stream_close(stream, NULL, error))
+		return NULL;
+	return g_memory_output_stream_steal_data(G_MEMORY_OUTPUT_STREAM(stream));
 }
 
 /**
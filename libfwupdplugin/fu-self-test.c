@@ -8,21 +8,33 @@
 
 #include <fwupdplugin.h>
 
+#include <fcntl.h>
 #include <glib/gstdio.h>
 #include <libgcab.h>
 #include <string.h>
+#ifdef HAVE_MEMFD_CREATE
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+#ifdef HAVE_SOCKET_H
+#include <sys/socket.h>
+#endif
 
 #include "fwupd-bios-setting-private.h"
 #include "fwupd-security-attr-private.h"
 
 #include "fu-bios-settings-private.h"
+#include "fu-bluez-device-private.h"
 #include "fu-cabinet.h"
 #include "fu-common-private.h"
 #include "fu-context-private.h"
 #include "fu-coswid-firmware.h"
 #include "fu-device-private.h"
 #include "fu-device-progress.h"
+#include "fu-efi-common.h"
+#include "fu-hwids-private.h"
 #include "fu-plugin-private.h"
+#include "fu-progress-private.h"
 #include "fu-security-attrs-private.h"
 #include "fu-self-test-struct.h"
 #include "fu-smbios-private.h"
@@ -316,6 +328,48 @@ fu_device_cfi_device_func(void)
 	g_assert_cmpint(fu_cfi_device_get_block_size(cfi_device), ==, 0x8000);
 }
 
+static void
+fu_device_udev_pread_full_func(void)
+{
+	gboolean ret;
+	gint fd;
+	gsize bufsz = 0x280000; /* not a multiple of the block size */
+	const gchar *fn = "/tmp/fwupd-self-test/udev-pread-full.bin";
+	g_autofree guint8 *buf_in = g_malloc0(bufsz);
+	g_autofree guint8 *buf_out = g_malloc0(bufsz);
+	g_autoptr(FuContext) ctx = fu_context_new();
+	g_autoptr(FuProgress) progress = fu_progress_new(G_STRLOC);
+	g_autoptr(FuUdevDevice) udev_device = NULL;
+	g_autoptr(GError) error = NULL;
+
+	/* use a regular file as the device node */
+	ret = fu_path_mkdir_parent(fn, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	fd = g_open(fn, O_RDWR | O_CREAT | O_TRUNC, 0600);
+	g_assert_cmpint(fd, >=, 0);
+	udev_device = g_object_new(FU_TYPE_UDEV_DEVICE, "context", ctx, NULL);
+	fu_udev_device_set_fd(udev_device, fd);
+
+	/* write and read back */
+	for (gsize i = 0; i < bufsz; i++)
+		buf_in[i] = (guint8)(i * 7);
+	ret = fu_udev_device_pwrite_full(udev_device, 0x0, buf_in, bufsz, progress, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	fu_progress_reset(progress);
+	ret = fu_udev_device_pread_full(udev_device, 0x0, buf_out, bufsz, progress, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_assert_cmpint(memcmp(buf_in, buf_out, bufsz), ==, 0);
+
+	/* reading past the end is an error */
+	ret = fu_udev_device_pread_full(udev_device, 0x1000, buf_out, bufsz, NULL, &error);
+	g_assert_error(error, G_IO_ERROR, G_IO_ERROR_PARTIAL_INPUT);
+	g_assert_false(ret);
+	g_unlink(fn);
+}
+
 static void
 fu_device_metadata_func(void)
 {
@@ -448,6 +502,31 @@ fu_context_flags_func(void)
 	g_assert_true(fu_context_has_flag(ctx, FU_CONTEXT_FLAG_SAVE_EVENTS));
 }
 
+static void
+fu_context_guid_cache_func(void)
+{
+	g_autoptr(FuContext) ctx = fu_context_new();
+	g_autoptr(GPtrArray) guids = NULL;
+	g_autoptr(GPtrArray) instance_ids = g_ptr_array_new();
+	g_autofree gchar *guid1 = NULL;
+	g_autofree gchar *guid2 = NULL;
+
+	/* same as fwupd_guid_hash_string() */
+	guid1 = fu_context_get_guid_for_instance_id(ctx, "USB\\VID_0A5C&PID_6412");
+	g_assert_cmpstr(guid1, ==, "7a1ba7b9-6bcd-54a4-8a36-d60cc5ee935c");
+	guid2 = fu_context_get_guid_for_instance_id(ctx, "USB\\VID_0A5C&PID_6412");
+	g_assert_cmpstr(guid2, ==, guid1);
+	g_assert_null(fu_context_get_guid_for_instance_id(ctx, ""));
+
+	/* batch */
+	g_ptr_array_add(instance_ids, "USB\\VID_0A5C&PID_6412");
+	g_ptr_array_add(instance_ids, "USB\\VID_0BDA&PID_1100");
+	guids = fu_context_get_guids_for_instance_ids(ctx, instance_ids);
+	g_assert_cmpint(guids->len, ==, 2);
+	g_assert_cmpstr(g_ptr_array_index(guids, 0), ==, "7a1ba7b9-6bcd-54a4-8a36-d60cc5ee935c");
+	g_assert_cmpstr(g_ptr_array_index(guids, 1), ==, "bb9ec3e2-77b3-53bc-a1f1-b05916715627");
+}
+
 static void
 fu_context_hwids_dmi_func(void)
 {
@@ -467,6 +546,38 @@ fu_context_hwids_dmi_func(void)
 	g_assert_cmpuint(fu_context_get_chassis_kind(ctx), ==, 16);
 }
 
+static void
+fu_context_hwids_dmi_skip_func(void)
+{
+	FuHwids *hwids;
+	gboolean ret;
+	g_autoptr(FuContext) ctx1 = fu_context_new();
+	g_autoptr(FuContext) ctx2 = fu_context_new();
+	g_autoptr(GError) error = NULL;
+
+	/* values already set from the SMBIOS tables are not read again */
+	hwids = fu_context_get_hwids(ctx1);
+	fu_hwids_add_value(hwids, FU_HWIDS_KEY_MANUFACTURER, "FromSmbios");
+	fu_hwids_add_value(hwids, FU_HWIDS_KEY_ENCLOSURE_KIND, "9");
+	fu_context_set_chassis_kind(ctx1, FU_SMBIOS_CHASSIS_KIND_LAPTOP);
+	ret = fu_hwids_dmi_setup(ctx1, hwids, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_assert_cmpstr(fu_hwids_get_value(hwids, FU_HWIDS_KEY_MANUFACTURER), ==, "FromSmbios");
+	g_assert_cmpuint(fu_context_get_chassis_kind(ctx1), ==, FU_SMBIOS_CHASSIS_KIND_LAPTOP);
+
+	/* the enclosure kind is still read if the chassis kind is unknown */
+	hwids = fu_context_get_hwids(ctx2);
+	fu_hwids_add_value(hwids, FU_HWIDS_KEY_MANUFACTURER, "FromSmbios");
+	fu_hwids_add_value(hwids, FU_HWIDS_KEY_ENCLOSURE_KIND, "9");
+	ret = fu_hwids_dmi_setup(ctx2, hwids, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_assert_cmpstr(fu_hwids_get_value(hwids, FU_HWIDS_KEY_MANUFACTURER), ==, "FromSmbios");
+	g_assert_cmpstr(fu_hwids_get_value(hwids, FU_HWIDS_KEY_ENCLOSURE_KIND), ==, "9");
+	g_assert_cmpuint(fu_context_get_chassis_kind(ctx2), ==, 16);
+}
+
 static gboolean
 _strnsplit_add_cb(GString *token, guint token_idx, gpointer user_data, GError **error)
 {
@@ -819,10 +930,12 @@ fu_plugin_fdt_func(void)
 {
 	gboolean ret;
 	g_autofree gchar *compatible = NULL;
+	g_autofree gchar *version = NULL;
 	g_autoptr(FuContext) ctx = fu_context_new();
 	g_autoptr(FuFirmware) fdt = NULL;
 	g_autoptr(FuFirmware) fdt_root = NULL;
 	g_autoptr(FuFirmware) fdt_tmp = fu_fdt_firmware_new();
+	g_autoptr(FuProgress) progress = fu_progress_new(G_STRLOC);
 	g_autoptr(GError) error = NULL;
 	g_autoptr(GFile) file =
 	    g_file_new_for_path("/tmp/fwupd-self-test/var/lib/fwupd/system.dtb");
@@ -833,6 +946,10 @@ fu_plugin_fdt_func(void)
 	    "<firmware gtype=\"FuFdtFirmware\">\n"
 	    "  <firmware gtype=\"FuFdtImage\">\n"
 	    "    <metadata key=\"compatible\" format=\"str\">pine64,rockpro64-v2.1</metadata>\n"
+	    "    <firmware gtype=\"FuFdtImage\">\n"
+	    "      <id>ibm,firmware-versions</id>\n"
+	    "      <metadata key=\"version\" format=\"str\">v2.1-rc3</metadata>\n"
+	    "    </firmware>\n"
 	    "  </firmware>\n"
 	    "</firmware>\n",
 	    &error);
@@ -842,10 +959,23 @@ fu_plugin_fdt_func(void)
 	g_assert_no_error(error);
 	g_assert_true(ret);
 
+	/* the HwIds are read from the parsed buffer */
+	ret = fu_context_load_hwinfo(ctx, progress, FU_CONTEXT_HWID_FLAG_LOAD_FDT, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_assert_cmpstr(fu_context_get_hwid_value(ctx, FU_HWIDS_KEY_BIOS_VERSION), ==, "v2.1-rc3");
+	g_assert_cmpstr(fu_context_get_hwid_value(ctx, FU_HWIDS_KEY_MANUFACTURER), ==, "pine64");
+
 	/* get compatible from the context */
 	fdt = fu_context_get_fdt(ctx, &error);
 	g_assert_no_error(error);
 	g_assert_nonnull(fdt);
+	version = fu_fdt_firmware_get_attr_str(FU_FDT_FIRMWARE(fdt),
+					       "/ibm,firmware-versions",
+					       "version",
+					       &error);
+	g_assert_no_error(error);
+	g_assert_cmpstr(version, ==, "v2.1-rc3");
 	fdt_root = fu_firmware_get_image_by_id(fdt, NULL, &error);
 	g_assert_no_error(error);
 	g_assert_nonnull(fdt_root);
@@ -896,6 +1026,15 @@ fu_plugin_quirks_func(void)
 	g_assert_cmpstr(tmp, ==, "clever");
 }
 
+static void
+fu_plugin_quirks_performance_iter_cb(FuQuirks *quirks,
+				     const gchar *key,
+				     const gchar *value,
+				     gpointer user_data)
+{
+	g_assert_nonnull(key);
+}
+
 static void
 fu_plugin_quirks_performance_func(void)
 {
@@ -919,6 +1058,29 @@ fu_plugin_quirks_performance_func(void)
 		}
 	}
 	g_print("lookup=%.3fms ", g_timer_elapsed(timer, NULL) * 1000.f);
+
+	/* most instance IDs added during coldplug have no quirk entry at all */
+	g_timer_reset(timer);
+	for (guint j = 0; j < 1000; j++) {
+		const gchar *group = "8ff2ed23-b37e-5f61-b409-b7fe9563be36";
+		for (guint i = 0; keys[i] != NULL; i++) {
+			const gchar *tmp = fu_quirks_lookup_by_id(quirks, group, keys[i]);
+			g_assert_cmpstr(tmp, ==, NULL);
+		}
+	}
+	g_print("lookup-miss=%.3fms ", g_timer_elapsed(timer, NULL) * 1000.f);
+
+	/* all keys, as used by fu_device_add_instance_id() */
+	g_timer_reset(timer);
+	for (guint j = 0; j < 1000; j++) {
+		ret = fu_quirks_lookup_by_id_iter(quirks,
+						  "bb9ec3e2-77b3-53bc-a1f1-b05916715627",
+						  NULL,
+						  fu_plugin_quirks_performance_iter_cb,
+						  NULL);
+		g_assert_true(ret);
+	}
+	g_print("lookup-iter=%.3fms ", g_timer_elapsed(timer, NULL) * 1000.f);
 }
 
 typedef struct {
@@ -1210,6 +1372,110 @@ fu_common_bytes_get_data_func(void)
 	g_assert_null(buf);
 }
 
+static void
+fu_common_bytes_get_contents_fd_func(void)
+{
+#if defined(HAVE_MEMFD_CREATE) && defined(F_ADD_SEALS)
+	const gchar *fn = "/tmp/fwupdmmapfd";
+	gboolean ret;
+	gint fd;
+	gint fd_dup;
+	g_autoptr(GBytes) bytes1 = NULL;
+	g_autoptr(GBytes) bytes2 = NULL;
+	g_autoptr(GBytes) bytes3 = NULL;
+	g_autoptr(GError) error = NULL;
+
+	/* sealed memfd is mapped and cannot be modified afterwards */
+	fd = memfd_create("fwupd", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+	g_assert_cmpint(fd, >=, 0);
+	g_assert_cmpint(write(fd, "hello world", 11), ==, 11);
+	g_assert_cmpint(fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE), ==, 0);
+	g_assert_cmpint(lseek(fd, 0, SEEK_SET), ==, 0);
+	fd_dup = dup(fd);
+	bytes1 = fu_bytes_get_contents_fd(fd, 0x100, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(bytes1);
+	g_assert_cmpint(g_bytes_get_size(bytes1), ==, 11);
+	g_assert_cmpint(memcmp(g_bytes_get_data(bytes1, NULL), "hello world", 11), ==, 0);
+	g_assert_cmpint(pwrite(fd_dup, "HELLO", 5, 0), <, 0);
+	g_assert_cmpint(ftruncate(fd_dup, 0), <, 0);
+	g_close(fd_dup, NULL);
+
+	/* unsealed memfd is copied, so later writes do not change the blob */
+	fd = memfd_create("fwupd", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+	g_assert_cmpint(fd, >=, 0);
+	g_assert_cmpint(write(fd, "hello world", 11), ==, 11);
+	g_assert_cmpint(lseek(fd, 0, SEEK_SET), ==, 0);
+	fd_dup = dup(fd);
+	bytes2 = fu_bytes_get_contents_fd(fd, 0x100, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(bytes2);
+	g_assert_cmpint(pwrite(fd_dup, "HELLO", 5, 0), ==, 5);
+	g_assert_cmpint(ftruncate(fd_dup, 0), ==, 0);
+	g_close(fd_dup, NULL);
+	g_assert_cmpint(g_bytes_get_size(bytes2), ==, 11);
+	g_assert_cmpint(memcmp(g_bytes_get_data(bytes2, NULL), "hello world", 11), ==, 0);
+
+	/* regular file cannot be sealed, so is also copied */
+	ret = g_file_set_contents(fn, "hello world", -1, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	fd = g_open(fn, O_RDONLY, 0);
+	g_assert_cmpint(fd, >=, 0);
+	bytes3 = fu_bytes_get_contents_fd(fd, 0x100, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(bytes3);
+	fd_dup = g_open(fn, O_WRONLY | O_TRUNC, 0);
+	g_assert_cmpint(fd_dup, >=, 0);
+	g_close(fd_dup, NULL);
+	g_assert_cmpint(g_bytes_get_size(bytes3), ==, 11);
+	g_assert_cmpint(memcmp(g_bytes_get_data(bytes3, NULL), "hello world", 11), ==, 0);
+#else
+	g_test_skip("no memfd_create() support");
+#endif
+}
+
+static void
+fu_common_bytes_get_checksums_func(void)
+{
+	GChecksumType checksum_types[] = {G_CHECKSUM_SHA1,
+					  G_CHECKSUM_SHA256,
+					  G_CHECKSUM_SHA384,
+					  G_CHECKSUM_SHA512};
+	g_autofree gchar *csum1 = NULL;
+	g_autofree gchar *csum2 = NULL;
+	g_autoptr(FuFirmware) firmware = fu_firmware_new();
+	g_autoptr(GByteArray) buf = g_byte_array_new();
+	g_autoptr(GBytes) blob1 = NULL;
+	g_autoptr(GBytes) blob2 = g_bytes_new_static("hello world", 11);
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GPtrArray) checksums = NULL;
+
+	/* larger than one block, and not a multiple of the block size */
+	for (guint i = 0; i < 100000; i++)
+		fu_byte_array_append_uint8(buf, i % 0xFB);
+	blob1 = g_bytes_new(buf->data, buf->len);
+	checksums = fu_bytes_get_checksums(blob1, checksum_types, G_N_ELEMENTS(checksum_types));
+	g_assert_nonnull(checksums);
+	g_assert_cmpint(checksums->len, ==, G_N_ELEMENTS(checksum_types));
+	for (guint i = 0; i < checksums->len; i++) {
+		g_autofree gchar *csum = g_compute_checksum_for_bytes(checksum_types[i], blob1);
+		g_assert_cmpstr(g_ptr_array_index(checksums, i), ==, csum);
+	}
+
+	/* cached until the data changes */
+	fu_firmware_set_bytes(firmware, blob1);
+	csum1 = fu_firmware_get_checksum(firmware, G_CHECKSUM_SHA256, &error);
+	g_assert_no_error(error);
+	g_assert_cmpstr(csum1, ==, g_ptr_array_index(checksums, 1));
+	fu_firmware_set_bytes(firmware, blob2);
+	csum2 = fu_firmware_get_checksum(firmware, G_CHECKSUM_SHA256, &error);
+	g_assert_no_error(error);
+	g_assert_cmpstr(csum2,
+			==,
+			"b94d27b9934d3e08a52e52d7da7dabfac484efe37a5380ee9088f7ace2efcde9");
+}
+
 static gboolean
 fu_device_poll_cb(FuDevice *device, GError **error)
 {
@@ -2167,6 +2433,53 @@ fu_firmware_ihex_offset_func(void)
 	g_assert_cmpint(g_bytes_get_size(data_verify), ==, 0x4);
 }
 
+static void
+fu_firmware_ihex_performance_func(void)
+{
+	gboolean ret;
+	gdouble elapsed;
+	GPtrArray *records;
+	g_autoptr(FuFirmware) firmware = fu_ihex_firmware_new();
+	g_autoptr(FuFirmware) firmware_verify = fu_ihex_firmware_new();
+	g_autoptr(GByteArray) buf = g_byte_array_new();
+	g_autoptr(GBytes) blob = NULL;
+	g_autoptr(GBytes) data_hex = NULL;
+	g_autoptr(GBytes) data_verify = NULL;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GTimer) timer = g_timer_new();
+
+	/* 1MB of data is 64k records */
+	for (guint i = 0; i < 0x100000; i++)
+		fu_byte_array_append_uint8(buf, i * 7);
+	blob = g_bytes_new(buf->data, buf->len);
+	fu_firmware_set_bytes(firmware, blob);
+	data_hex = fu_firmware_write(firmware, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(data_hex);
+
+	/* parse */
+	g_timer_reset(timer);
+	ret = fu_firmware_parse(firmware_verify, data_hex, FWUPD_INSTALL_FLAG_NO_SEARCH, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	elapsed = g_timer_elapsed(timer, NULL);
+	g_print("parse=%.3fms (%.1fMB/s) ",
+		elapsed * 1000.f,
+		(gdouble)g_bytes_get_size(data_hex) / (elapsed * 1024.f * 1024.f));
+	data_verify = fu_firmware_get_bytes(firmware_verify, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(data_verify);
+	ret = fu_bytes_compare(blob, data_verify, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+
+	/* records are only built when required */
+	g_timer_reset(timer);
+	records = fu_ihex_firmware_get_records(FU_IHEX_FIRMWARE(firmware_verify));
+	g_print("records=%.3fms ", g_timer_elapsed(timer, NULL) * 1000.f);
+	g_assert_cmpint(records->len, ==, 0x10000 + 0xf + 1);
+}
+
 static void
 fu_firmware_srec_func(void)
 {
@@ -2213,6 +2526,10 @@ fu_firmware_fdt_func(void)
 	g_autoptr(FuFirmware) firmware = fu_fdt_firmware_new();
 	g_autoptr(FuFirmware) img1 = NULL;
 	g_autoptr(FuFdtImage) img2 = NULL;
+	g_autoptr(GBytes) blob1 = NULL;
+	g_autoptr(GBytes) blob2 = NULL;
+	g_autoptr(GBytes) blob3 = NULL;
+	g_autoptr(GBytes) blob4 = NULL;
 	g_autoptr(GBytes) data = NULL;
 	g_autoptr(GError) error = NULL;
 
@@ -2224,6 +2541,28 @@ fu_firmware_fdt_func(void)
 	g_assert_no_error(error);
 	g_assert_true(ret);
 	g_assert_cmpint(fu_fdt_firmware_get_cpuid(FU_FDT_FIRMWARE(firmware)), ==, 0x0);
+
+	/* get attrs from the buffer, before the images are built */
+	blob1 = fu_fdt_firmware_get_attr_by_path(FU_FDT_FIRMWARE(firmware), "/", "key", &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(blob1);
+	g_assert_cmpstr(g_bytes_get_data(blob1, NULL), ==, "hello world");
+	blob2 = fu_fdt_firmware_get_attr_by_path(FU_FDT_FIRMWARE(firmware),
+						 "/images/firmware-1",
+						 "key",
+						 &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(blob2);
+	g_assert_cmpint(g_bytes_get_size(blob2), ==, sizeof(guint32));
+	g_assert_cmpint(fu_memread_uint32(g_bytes_get_data(blob2, NULL), G_BIG_ENDIAN), ==, 0x123);
+	blob3 = fu_fdt_firmware_get_attr_by_path(FU_FDT_FIRMWARE(firmware),
+						 "/images",
+						 "key",
+						 &error);
+	g_assert_error(error, G_IO_ERROR, G_IO_ERROR_NOT_FOUND);
+	g_assert_null(blob3);
+	g_clear_error(&error);
+
 	str = fu_firmware_to_string(firmware);
 	g_debug("%s", str);
 
@@ -2246,6 +2585,15 @@ fu_firmware_fdt_func(void)
 	g_assert_true(ret);
 	g_assert_cmpint(val32, ==, 0x123);
 
+	/* same again, now using the images */
+	blob4 = fu_fdt_firmware_get_attr_by_path(FU_FDT_FIRMWARE(firmware),
+						 "/images/firmware-1",
+						 "key",
+						 &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(blob4);
+	g_assert_true(g_bytes_equal(blob2, blob4));
+
 	/* wrong type */
 	ret = fu_fdt_image_get_attr_u64(img2, "key", &val64, &error);
 	g_assert_error(error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA);
@@ -2450,6 +2798,60 @@ fu_firmware_dfuse_func(void)
 	g_assert_true(ret);
 }
 
+static void
+fu_firmware_efi_section_lazy_func(void)
+{
+	gboolean ret;
+	fwupd_guid_t guid = {0x0};
+	g_autofree gchar *str = NULL;
+	g_autoptr(FuFirmware) firmware = fu_efi_firmware_section_new();
+	g_autoptr(FuFirmware) img = NULL;
+	g_autoptr(GByteArray) buf = g_byte_array_new();
+	g_autoptr(GBytes) fw = NULL;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GPtrArray) images = NULL;
+
+	/* GUID-defined LZMA section with a corrupt payload */
+	ret = fwupd_guid_from_string(FU_EFI_FIRMWARE_SECTION_LZMA_COMPRESS,
+				     &guid,
+				     FWUPD_GUID_FLAG_MIXED_ENDIAN,
+				     &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	fu_byte_array_append_uint24(buf, 0x20, G_LITTLE_ENDIAN);
+	fu_byte_array_append_uint8(buf, 0x02); /* GuidDefined */
+	g_byte_array_append(buf, (const guint8 *)&guid, sizeof(guid));
+	fu_byte_array_append_uint16(buf, 0x18, G_LITTLE_ENDIAN);
+	fu_byte_array_append_uint16(buf, 0x0, G_LITTLE_ENDIAN);
+	for (guint i = 0; i < 8; i++)
+		fu_byte_array_append_uint8(buf, 0xFF);
+	fw = g_bytes_new(buf->data, buf->len);
+
+	/* decompression is deferred, so this succeeds */
+	ret = fu_firmware_parse(firmware, fw, FWUPD_INSTALL_FLAG_NONE, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_assert_cmpstr(fu_firmware_get_id(firmware), ==, FU_EFI_FIRMWARE_SECTION_LZMA_COMPRESS);
+
+	/* accessing the images decompresses */
+	img = fu_firmware_get_image_by_idx(firmware, 0x0, &error);
+	g_assert_error(error, G_IO_ERROR, G_IO_ERROR_NOT_SUPPORTED);
+	g_assert_null(img);
+	g_clear_error(&error);
+
+	/* only tried once, but the error is remembered */
+	ret = fu_firmware_load_images(firmware, &error);
+	g_assert_error(error, G_IO_ERROR, G_IO_ERROR_NOT_SUPPORTED);
+	g_assert_false(ret);
+	g_clear_error(&error);
+
+	/* accessors that cannot fail show the error */
+	str = fu_firmware_to_string(firmware);
+	g_assert_nonnull(g_strstr_len(str, -1, "<images_error>"));
+	images = fu_firmware_get_images(firmware);
+	g_assert_cmpint(images->len, ==, 0);
+}
+
 static void
 fu_firmware_fmap_func(void)
 {
@@ -2895,6 +3297,7 @@ fu_firmware_common_func(void)
 {
 	gboolean ret;
 	guint8 value = 0;
+	guint8 buf[3] = {0x0};
 	g_autoptr(GError) error = NULL;
 
 	ret = fu_firmware_strparse_uint8_safe("ff00XX", 6, 0, &value, &error);
@@ -2910,6 +3313,23 @@ fu_firmware_common_func(void)
 	ret = fu_firmware_strparse_uint8_safe("ff00XX", 6, 4, &value, &error);
 	g_assert_error(error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA);
 	g_assert_false(ret);
+	g_clear_error(&error);
+
+	ret = fu_firmware_strparse_hex_safe("ff00aBXX", 8, 0, buf, 3, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_assert_cmpint(buf[0], ==, 0xFF);
+	g_assert_cmpint(buf[1], ==, 0x00);
+	g_assert_cmpint(buf[2], ==, 0xAB);
+
+	ret = fu_firmware_strparse_hex_safe("ff00aBXX", 8, 2, buf, 3, &error);
+	g_assert_error(error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA);
+	g_assert_false(ret);
+	g_clear_error(&error);
+
+	ret = fu_firmware_strparse_hex_safe("ff00aBXX", 8, 4, buf, 3, &error);
+	g_assert_error(error, FWUPD_ERROR, FWUPD_ERROR_READ);
+	g_assert_false(ret);
 }
 
 static void
@@ -3014,11 +3434,23 @@ fu_efivar_func(void)
 	g_assert_cmpint(attr, ==, FU_EFIVAR_ATTR_NON_VOLATILE | FU_EFIVAR_ATTR_RUNTIME_ACCESS);
 	g_assert_cmpint(data[0], ==, '1');
 
+	/* the cached names are invalidated by the write */
+	g_ptr_array_unref(names);
+	names = fu_efivar_get_names(FU_EFIVAR_GUID_EFI_GLOBAL, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(names);
+	g_assert_cmpint(names->len, ==, 3);
+
 	/* delete single key */
 	ret = fu_efivar_delete(FU_EFIVAR_GUID_EFI_GLOBAL, "Test", &error);
 	g_assert_no_error(error);
 	g_assert_true(ret);
 	g_assert_false(fu_efivar_exists(FU_EFIVAR_GUID_EFI_GLOBAL, "Test"));
+	g_ptr_array_unref(names);
+	names = fu_efivar_get_names(FU_EFIVAR_GUID_EFI_GLOBAL, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(names);
+	g_assert_cmpint(names->len, ==, 2);
 
 	/* delete multiple keys */
 	ret = fu_efivar_set_data(FU_EFIVAR_GUID_EFI_GLOBAL, "Test1", (guint8 *)"1", 1, 0, &error);
@@ -3922,6 +4354,57 @@ fu_progress_finish_func(void)
 	fu_progress_step_done(progress);
 }
 
+static void
+fu_progress_throughput_func(void)
+{
+	FuProgress *child;
+	g_autoptr(FuProgress) progress = fu_progress_new(G_STRLOC);
+
+	/* nothing known */
+	g_assert_cmpint(fu_progress_get_bytes(progress), ==, 0);
+	g_assert_cmpint(fu_progress_get_throughput(progress), ==, 0);
+	g_assert_cmpint(fu_progress_get_time_remaining(progress), ==, 0);
+
+	/* write takes most of the time */
+	fu_progress_add_step(progress, FWUPD_STATUS_DEVICE_RESTART, 10, "detach");
+	fu_progress_add_step(progress, FWUPD_STATUS_DEVICE_WRITE, 90, "write");
+	fu_progress_step_done(progress);
+
+	/* bytes propagate to the parent, with a sample every 250ms */
+	child = fu_progress_get_child(progress);
+	fu_progress_set_id(child, G_STRLOC);
+	fu_progress_set_steps(child, 4);
+	fu_progress_add_bytes_full(child, 0x1000, 1000 * G_TIME_SPAN_MILLISECOND);
+	g_assert_cmpint(fu_progress_get_throughput(progress), ==, 0);
+	for (guint i = 1; i < 4; i++) {
+		gint64 now = (1000 + (i * 250)) * G_TIME_SPAN_MILLISECOND;
+		fu_progress_add_bytes_full(child, 0x1000, now);
+		fu_progress_step_done(child);
+	}
+	g_assert_cmpint(fu_progress_get_bytes(child), ==, 0x4000);
+	g_assert_cmpint(fu_progress_get_bytes(progress), ==, 0x4000);
+
+	/* exactly 16KiB/s */
+	g_assert_cmpint(fu_progress_get_throughput(child), ==, 0x4000);
+	g_assert_cmpint(fu_progress_get_throughput(progress), ==, 0x4000);
+
+	/* too soon after the last sample to be used */
+	fu_progress_add_bytes_full(child, 0x4000, 1850 * G_TIME_SPAN_MILLISECOND);
+	g_assert_cmpint(fu_progress_get_throughput(progress), ==, 0x4000);
+
+	/* 32KiB/s since the last sample, which is smoothed with the previous rate */
+	fu_progress_add_bytes_full(child, 0x0, 2250 * G_TIME_SPAN_MILLISECOND);
+	g_assert_cmpint(fu_progress_get_bytes(progress), ==, 0x8000);
+	g_assert_cmpint(fu_progress_get_throughput(progress), ==, 19660);
+
+	/* at 77% */
+	g_assert_cmpint(fu_progress_get_percentage(progress), ==, 77);
+
+	fu_progress_step_done(child);
+	fu_progress_step_done(progress);
+	g_assert_cmpint(fu_progress_get_time_remaining(progress), ==, 0);
+}
+
 static void
 fu_progress_child_finished(void)
 {
@@ -4005,6 +4488,73 @@ fu_plugin_struct_func(void)
 	g_assert_false(ret);
 }
 
+static void
+fu_plugin_struct_view_func(void)
+{
+	gboolean ret;
+	gsize bufsz = 0;
+	const guint8 *buf;
+	const FuStructSelfTestWrappedView *view;
+	const FuStructSelfTestView *view_base;
+	g_autoptr(GByteArray) st_base = fu_struct_self_test_new();
+	g_autoptr(GByteArray) st = fu_struct_self_test_wrapped_new();
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GTimer) timer = g_timer_new();
+
+	fu_struct_self_test_wrapped_set_less(st, 0x99);
+	fu_struct_self_test_wrapped_set_more(st, 0x12);
+	fu_struct_self_test_set_revision(st_base, 0xFE);
+	fu_struct_self_test_set_oem_revision(st_base, 0xDEADBEEF);
+	ret = fu_struct_self_test_wrapped_set_base(st, st_base, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+
+	/* view, without copying */
+	view = fu_struct_self_test_wrapped_view(st->data, st->len, 0x0, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(view);
+	g_assert_true((const guint8 *)view == st->data);
+	g_assert_cmpint(fu_struct_self_test_wrapped_view_get_less(view), ==, 0x99);
+	g_assert_cmpint(fu_struct_self_test_wrapped_view_get_more(view), ==, 0x12);
+	view_base = fu_struct_self_test_wrapped_view_get_base(view);
+	g_assert_cmpint(fu_struct_self_test_view_get_length(view_base), ==, 0x33);
+	g_assert_cmpint(fu_struct_self_test_view_get_revision(view_base), ==, 0xFE);
+	g_assert_cmpint(fu_struct_self_test_view_get_oem_revision(view_base), ==, 0xDEADBEEF);
+	buf = fu_struct_self_test_view_get_asl_compiler_id(view_base, &bufsz);
+	g_assert_cmpint(bufsz, ==, 4);
+	g_assert_cmpint(buf[0], ==, 0xDF);
+
+	/* compare with parse */
+	g_timer_reset(timer);
+	for (guint i = 0; i < 10000; i++) {
+		g_autoptr(GByteArray) st_tmp =
+		    fu_struct_self_test_wrapped_parse(st->data, st->len, 0x0, &error);
+		g_assert_no_error(error);
+		g_assert_cmpint(fu_struct_self_test_wrapped_get_more(st_tmp), ==, 0x12);
+	}
+	g_print("parse=%.3fms ", g_timer_elapsed(timer, NULL) * 1000.f);
+	g_timer_reset(timer);
+	for (guint i = 0; i < 10000; i++) {
+		const FuStructSelfTestWrappedView *view_tmp =
+		    fu_struct_self_test_wrapped_view(st->data, st->len, 0x0, &error);
+		g_assert_no_error(error);
+		g_assert_cmpint(fu_struct_self_test_wrapped_view_get_more(view_tmp), ==, 0x12);
+	}
+	g_print("view=%.3fms ", g_timer_elapsed(timer, NULL) * 1000.f);
+
+	/* truncated */
+	view = fu_struct_self_test_wrapped_view(st->data, st->len - 1, 0x0, &error);
+	g_assert_error(error, FWUPD_ERROR, FWUPD_ERROR_READ);
+	g_assert_null(view);
+	g_clear_error(&error);
+
+	/* nested constant failing */
+	st->data[FU_STRUCT_SELF_TEST_WRAPPED_OFFSET_BASE] = 0xFF;
+	view = fu_struct_self_test_wrapped_view(st->data, st->len, 0x0, &error);
+	g_assert_error(error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA);
+	g_assert_null(view);
+}
+
 static void
 fu_plugin_struct_wrapped_func(void)
 {
@@ -4079,6 +4629,80 @@ fu_plugin_struct_wrapped_func(void)
 	g_assert_false(ret);
 }
 
+static void
+fu_bluez_device_write_bytes_func(void)
+{
+#ifdef HAVE_SOCKET_H
+	gboolean ret;
+	gint fds[2] = {-1, -1};
+	guint8 buf[64] = {0x0};
+	gssize rc;
+	const gchar *uuid = "00cde35c-7062-11eb-9439-0242ac130002";
+	g_autoptr(FuContext) ctx = fu_context_new();
+	g_autoptr(FuBluezDevice) device = NULL;
+	g_autoptr(FuIOChannel) io_channel = NULL;
+	g_autoptr(FuProgress) progress = fu_progress_new(G_STRLOC);
+	g_autoptr(GByteArray) blob_rx = g_byte_array_new();
+	g_autoptr(GByteArray) buf_tx = g_byte_array_new();
+	g_autoptr(GBytes) blob_tx = NULL;
+	g_autoptr(GError) error = NULL;
+
+	device = g_object_new(FU_TYPE_BLUEZ_DEVICE, "context", ctx, NULL);
+	for (guint i = 0; i < 25; i++)
+		fu_byte_array_append_uint8(buf_tx, i);
+	blob_tx = g_bytes_new(buf_tx->data, buf_tx->len);
+
+	/* each write on a SOCK_SEQPACKET socket is a single packet, like the AcquireWrite fd */
+	g_assert_cmpint(socketpair(AF_UNIX, SOCK_SEQPACKET, 0, fds), ==, 0);
+	io_channel = fu_io_channel_unix_new(fds[0]);
+
+	/* MTU of 13 means packets of 10 bytes */
+	ret = fu_bluez_device_write_bytes_full(device,
+					       uuid,
+					       io_channel,
+					       13,
+					       blob_tx,
+					       progress,
+					       &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	for (guint i = 0; i < 3; i++) {
+		rc = recv(fds[1], buf, sizeof(buf), MSG_DONTWAIT);
+		g_assert_cmpint(rc, ==, i < 2 ? 10 : 5);
+		g_byte_array_append(blob_rx, buf, rc);
+	}
+	rc = recv(fds[1], buf, sizeof(buf), MSG_DONTWAIT);
+	g_assert_cmpint(rc, ==, -1);
+	g_assert_cmpint(blob_rx->len, ==, buf_tx->len);
+	g_assert_cmpint(memcmp(blob_rx->data, buf_tx->data, buf_tx->len), ==, 0);
+
+	/* MTU too small, so use the default ATT payload size */
+	fu_progress_reset(progress);
+	ret = fu_bluez_device_write_bytes_full(device,
+					       uuid,
+					       io_channel,
+					       0,
+					       blob_tx,
+					       progress,
+					       &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	rc = recv(fds[1], buf, sizeof(buf), MSG_DONTWAIT);
+	g_assert_cmpint(rc, ==, 20);
+	rc = recv(fds[1], buf, sizeof(buf), MSG_DONTWAIT);
+	g_assert_cmpint(rc, ==, 5);
+
+	/* no fd, so fall back to WriteValue which fails as the UUID is unknown */
+	fu_progress_reset(progress);
+	ret = fu_bluez_device_write_bytes_full(device, uuid, NULL, 0, blob_tx, progress, &error);
+	g_assert_error(error, G_IO_ERROR, G_IO_ERROR_NOT_SUPPORTED);
+	g_assert_false(ret);
+	(void)g_close(fds[1], NULL);
+#else
+	g_test_skip("no sys/socket.h support");
+#endif
+}
+
 int
 main(int argc, char **argv)
 {
@@ -4105,6 +4729,8 @@ main(int argc, char **argv)
 
 	g_test_add_func("/fwupd/struct", fu_plugin_struct_func);
 	g_test_add_func("/fwupd/struct{wrapped}", fu_plugin_struct_wrapped_func);
+	g_test_add_func("/fwupd/struct{view}", fu_plugin_struct_view_func);
+	g_test_add_func("/fwupd/bluez-device{write-bytes}", fu_bluez_device_write_bytes_func);
 	g_test_add_func("/fwupd/plugin{quirks-append}", fu_plugin_quirks_append_func);
 	g_test_add_func("/fwupd/common{strnsplit}", fu_strsplit_func);
 	g_test_add_func("/fwupd/common{memmem}", fu_common_memmem_func);
@@ -4115,6 +4741,7 @@ main(int argc, char **argv)
 	g_test_add_func("/fwupd/progress{parent-1-step}", fu_progress_parent_one_step_proxy_func);
 	g_test_add_func("/fwupd/progress{no-equal}", fu_progress_non_equal_steps_func);
 	g_test_add_func("/fwupd/progress{finish}", fu_progress_finish_func);
+	g_test_add_func("/fwupd/progress{throughput}", fu_progress_throughput_func);
 	g_test_add_func("/fwupd/bios-attrs{load}", fu_bios_settings_load_func);
 	g_test_add_func("/fwupd/security-attrs{hsi}", fu_security_attrs_hsi_func);
 	g_test_add_func("/fwupd/security-attrs{compare}", fu_security_attrs_compare_func);
@@ -4143,12 +4770,17 @@ main(int argc, char **argv)
 	g_test_add_func("/fwupd/common{endian}", fu_common_endian_func);
 	g_test_add_func("/fwupd/common{cabinet}", fu_common_cabinet_func);
 	g_test_add_func("/fwupd/common{bytes-get-data}", fu_common_bytes_get_data_func);
+	g_test_add_func("/fwupd/common{bytes-get-contents-fd}",
+			fu_common_bytes_get_contents_fd_func);
+	g_test_add_func("/fwupd/common{bytes-get-checksums}", fu_common_bytes_get_checksums_func);
 	g_test_add_func("/fwupd/common{kernel-lockdown}", fu_common_kernel_lockdown_func);
 	g_test_add_func("/fwupd/common{strsafe}", fu_strsafe_func);
 	g_test_add_func("/fwupd/efivar", fu_efivar_func);
 	g_test_add_func("/fwupd/hwids", fu_hwids_func);
 	g_test_add_func("/fwupd/context{flags}", fu_context_flags_func);
 	g_test_add_func("/fwupd/context{hwids-dmi}", fu_context_hwids_dmi_func);
+	g_test_add_func("/fwupd/context{hwids-dmi-skip}", fu_context_hwids_dmi_skip_func);
+	g_test_add_func("/fwupd/context{guid-cache}", fu_context_guid_cache_func);
 	g_test_add_func("/fwupd/smbios", fu_smbios_func);
 	g_test_add_func("/fwupd/smbios3", fu_smbios3_func);
 	g_test_add_func("/fwupd/kernel", fu_kernel_func);
@@ -4162,6 +4794,7 @@ main(int argc, char **argv)
 	g_test_add_func("/fwupd/firmware{ihex}", fu_firmware_ihex_func);
 	g_test_add_func("/fwupd/firmware{ihex-offset}", fu_firmware_ihex_offset_func);
 	g_test_add_func("/fwupd/firmware{ihex-signed}", fu_firmware_ihex_signed_func);
+	g_test_add_func("/fwupd/firmware{ihex-performance}", fu_firmware_ihex_performance_func);
 	g_test_add_func("/fwupd/firmware{srec-tokenization}", fu_firmware_srec_tokenization_func);
 	g_test_add_func("/fwupd/firmware{srec}", fu_firmware_srec_func);
 	g_test_add_func("/fwupd/firmware{fdt}", fu_firmware_fdt_func);
@@ -4174,6 +4807,7 @@ main(int argc, char **argv)
 	g_test_add_func("/fwupd/firmware{dfuse}", fu_firmware_dfuse_func);
 	g_test_add_func("/fwupd/firmware{builder-round-trip}", fu_firmware_builder_round_trip_func);
 	g_test_add_func("/fwupd/firmware{fmap}", fu_firmware_fmap_func);
+	g_test_add_func("/fwupd/firmware{efi-section-lazy}", fu_firmware_efi_section_lazy_func);
 	g_test_add_func("/fwupd/firmware{gtypes}", fu_firmware_new_from_gtypes_func);
 	g_test_add_func("/fwupd/archive{invalid}", fu_archive_invalid_func);
 	g_test_add_func("/fwupd/archive{cab}", fu_archive_cab_func);
@@ -4199,6 +4833,7 @@ main(int argc, char **argv)
 	g_test_add_func("/fwupd/device{retry-failed}", fu_device_retry_failed_func);
 	g_test_add_func("/fwupd/device{retry-hardware}", fu_device_retry_hardware_func);
 	g_test_add_func("/fwupd/device{cfi-device}", fu_device_cfi_device_func);
+	g_test_add_func("/fwupd/device{udev-pread-full}", fu_device_udev_pread_full_func);
 	g_test_add_func("/fwupd/device{progress}", fu_plugin_device_progress_func);
 	return g_test_run();
 }
@@ -20,7 +20,7 @@ struct SelfTest {
     asl_compiler_revision: u32le,
 }
 
-#[derive(New, Validate, Parse, ToString)]
+#[derive(New, Validate, Parse, ToString, View)]
 struct SelfTestWrapped {
     less: u8,
     base: SelfTest,
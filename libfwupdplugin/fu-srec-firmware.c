@@ -24,8 +24,20 @@
  * See also: [class@FuFirmware]
  */
 
+/* a record, without any per-record allocations */
 typedef struct {
-	GPtrArray *records;
+	guint ln;
+	FuFirmareSrecRecordKind kind;
+	guint32 addr;
+	guint8 data_sz;
+	gsize data_offset; /* into @payload */
+} FuSrecFirmwareToken;
+
+typedef struct {
+	GPtrArray *records; /* built on demand from @tokens */
+	gboolean records_loaded;
+	GArray *tokens;	     /* of FuSrecFirmwareToken */
+	GByteArray *payload; /* decoded data for all records */
 } FuSrecFirmwarePrivate;
 
 G_DEFINE_TYPE_WITH_PRIVATE(FuSrecFirmware, fu_srec_firmware, FU_TYPE_FIRMWARE)
@@ -33,6 +45,33 @@ G_DEFINE_TYPE_WITH_PRIVATE(FuSrecFirmware, fu_srec_firmware, FU_TYPE_FIRMWARE)
 
 #define FU_SREC_FIRMWARE_TOKENS_MAX 100000 /* lines */
 
+static void
+fu_srec_firmware_record_free(FuSrecFirmwareRecord *rcd)
+{
+	g_byte_array_unref(rcd->buf);
+	g_free(rcd);
+}
+
+static void
+fu_srec_firmware_ensure_records(FuSrecFirmware *self)
+{
+	FuSrecFirmwarePrivate *priv = GET_PRIVATE(self);
+
+	/* only build these once, as the caller may modify the array */
+	if (priv->records_loaded)
+		return;
+	priv->records_loaded = TRUE;
+	for (guint i = 0; i < priv->tokens->len; i++) {
+		FuSrecFirmwareToken *tok = &g_array_index(priv->tokens, FuSrecFirmwareToken, i);
+		FuSrecFirmwareRecord *rcd;
+		rcd = fu_srec_firmware_record_new(tok->ln, tok->kind, tok->addr);
+		g_byte_array_append(rcd->buf,
+				    priv->payload->data + tok->data_offset,
+				    tok->data_sz);
+		g_ptr_array_add(priv->records, rcd);
+	}
+}
+
 /**
  * fu_srec_firmware_get_records:
  * @self: A #FuSrecFirmware
@@ -42,6 +81,9 @@ G_DEFINE_TYPE_WITH_PRIVATE(FuSrecFirmware, fu_srec_firmware, FU_TYPE_FIRMWARE)
  * This might be useful if the plugin is expecting the SREC file to be a list
  * of operations, rather than a simple linear image with filled holes.
  *
+ * The records are only created when this function is first called, as most users only
+ * need the linear image.
+ *
  * Returns: (transfer none) (element-type FuSrecFirmwareRecord): records
  *
  * Since: 1.3.2
@@ -51,16 +93,10 @@ fu_srec_firmware_get_records(FuSrecFirmware *self)
 {
 	FuSrecFirmwarePrivate *priv = GET_PRIVATE(self);
 	g_return_val_if_fail(FU_IS_SREC_FIRMWARE(self), NULL);
+	fu_srec_firmware_ensure_records(self);
 	return priv->records;
 }
 
-static void
-fu_srec_firmware_record_free(FuSrecFirmwareRecord *rcd)
-{
-	g_byte_array_unref(rcd->buf);
-	g_free(rcd);
-}
-
 #pragma clang diagnostic push
 #pragma clang diagnostic ignored "-Wunused-function"
 G_DEFINE_AUTOPTR_CLEANUP_FUNC(FuSrecFirmwareRecord, fu_srec_firmware_record_free);
@@ -121,98 +157,77 @@ fu_srec_firmware_record_get_type(void)
 	return type_id;
 }
 
-typedef struct {
-	FuSrecFirmware *self;
-	FwupdInstallFlags flags;
-	gboolean got_eof;
-} FuSrecFirmwareTokenHelper;
-
 static gboolean
-fu_srec_firmware_tokenize_cb(GString *token, guint token_idx, gpointer user_data, GError **error)
+fu_srec_firmware_tokenize_line(FuSrecFirmware *self,
+			       guint ln,
+			       const gchar *line,
+			       gsize linesz,
+			       FwupdInstallFlags flags,
+			       gboolean *got_eof,
+			       GError **error)
 {
-	FuSrecFirmwareTokenHelper *helper = (FuSrecFirmwareTokenHelper *)user_data;
-	FuSrecFirmwarePrivate *priv = GET_PRIVATE(helper->self);
-	g_autoptr(FuSrecFirmwareRecord) rcd = NULL;
+	FuSrecFirmwarePrivate *priv = GET_PRIVATE(self);
+	FuSrecFirmwareToken tok = {.ln = ln};
 	gboolean require_data = FALSE;
-	guint32 rec_addr32;
 	guint16 rec_addr16;
 	guint8 addrsz = 0; /* bytes */
 	guint8 rec_count;  /* words */
 	guint8 rec_kind;
-
-	/* sanity check */
-	if (token_idx > FU_SREC_FIRMWARE_TOKENS_MAX) {
-		g_set_error_literal(error,
-				    G_IO_ERROR,
-				    G_IO_ERROR_INVALID_DATA,
-				    "file has too many lines");
-		return FALSE;
-	}
-
-	/* remove WIN32 line endings */
-	g_strdelimit(token->str, "\r\x1a", '\0');
-	token->len = strlen(token->str);
-
-	/* ignore blank lines */
-	if (token->len == 0)
-		return TRUE;
+	guint8 rec[G_MAXUINT8 + 1] = {0x0};
 
 	/* check starting token */
-	if (token->str[0] != 'S' || token->len < 3) {
-		g_autofree gchar *strsafe = fu_strsafe(token->str, 3);
+	if (line[0] != 'S' || linesz < 3) {
+		g_autofree gchar *strsafe = fu_strsafe(line, MIN(linesz, 3));
 		if (strsafe != NULL) {
 			g_set_error(error,
 				    FWUPD_ERROR,
 				    FWUPD_ERROR_INVALID_FILE,
 				    "invalid starting token, got '%s' at line %u",
 				    strsafe,
-				    token_idx + 1);
+				    ln);
 			return FALSE;
 		}
 		g_set_error(error,
 			    FWUPD_ERROR,
 			    FWUPD_ERROR_INVALID_FILE,
 			    "invalid starting token at line %u",
-			    token_idx + 1);
+			    ln);
 		return FALSE;
 	}
 
 	/* kind, count, address, (data), checksum, linefeed */
-	rec_kind = token->str[1] - '0';
-	if (!fu_firmware_strparse_uint8_safe(token->str, token->len, 2, &rec_count, error))
+	rec_kind = line[1] - '0';
+	if (!fu_firmware_strparse_hex_safe(line, linesz, 2, &rec_count, 1, error))
 		return FALSE;
-	if (rec_count * 2 != token->len - 4) {
+	if (rec_count * 2 != linesz - 4) {
 		g_set_error(error,
 			    FWUPD_ERROR,
 			    FWUPD_ERROR_INVALID_FILE,
 			    "count incomplete at line %u, "
 			    "length %u, expected %u",
-			    token_idx + 1,
-			    (guint)token->len - 4,
+			    ln,
+			    (guint)linesz - 4,
 			    (guint)rec_count * 2);
 		return FALSE;
 	}
 
+	/* count, address and data in one pass */
+	if (!fu_firmware_strparse_hex_safe(line, linesz, 2, rec, rec_count, error))
+		return FALSE;
+
 	/* checksum check */
-	if ((helper->flags & FWUPD_INSTALL_FLAG_IGNORE_CHECKSUM) == 0) {
+	if ((flags & FWUPD_INSTALL_FLAG_IGNORE_CHECKSUM) == 0) {
 		guint8 rec_csum = 0;
 		guint8 rec_csum_expected;
-		for (guint8 i = 0; i < rec_count; i++) {
-			guint8 csum_tmp = 0;
-			if (!fu_firmware_strparse_uint8_safe(token->str,
-							     token->len,
-							     (i * 2) + 2,
-							     &csum_tmp,
-							     error))
-				return FALSE;
-			rec_csum += csum_tmp;
-		}
+		for (guint i = 0; i < rec_count; i++)
+			rec_csum += rec[i];
 		rec_csum ^= 0xff;
-		if (!fu_firmware_strparse_uint8_safe(token->str,
-						     token->len,
-						     (rec_count * 2) + 2,
-						     &rec_csum_expected,
-						     error))
+		if (!fu_firmware_strparse_hex_safe(line,
+						   linesz,
+						   (rec_count * 2) + 2,
+						   &rec_csum_expected,
+						   1,
+						   error))
 			return FALSE;
 		if (rec_csum != rec_csum_expected) {
 			g_set_error(error,
@@ -220,7 +235,7 @@ fu_srec_firmware_tokenize_cb(GString *token, guint token_idx, gpointer user_data
 				    FWUPD_ERROR_INVALID_FILE,
 				    "checksum incorrect line %u, "
 				    "expected %02x, got %02x",
-				    token_idx + 1,
+				    ln,
 				    rec_csum_expected,
 				    rec_csum);
 			return FALSE;
@@ -244,67 +259,55 @@ fu_srec_firmware_tokenize_cb(GString *token, guint token_idx, gpointer user_data
 		break;
 	case FU_FIRMWARE_SREC_RECORD_KIND_S5_COUNT_16:
 		addrsz = 2;
-		helper->got_eof = TRUE;
+		*got_eof = TRUE;
 		break;
 	case FU_FIRMWARE_SREC_RECORD_KIND_S6_COUNT_24:
 		addrsz = 3;
 		break;
 	case FU_FIRMWARE_SREC_RECORD_KIND_S7_COUNT_32:
 		addrsz = 4;
-		helper->got_eof = TRUE;
+		*got_eof = TRUE;
 		break;
 	case FU_FIRMWARE_SREC_RECORD_KIND_S8_TERMINATION_24:
 		addrsz = 3;
-		helper->got_eof = TRUE;
+		*got_eof = TRUE;
 		break;
 	case FU_FIRMWARE_SREC_RECORD_KIND_S9_TERMINATION_16:
 		addrsz = 2;
-		helper->got_eof = TRUE;
+		*got_eof = TRUE;
 		break;
 	default:
 		g_set_error(error,
 			    FWUPD_ERROR,
 			    FWUPD_ERROR_INVALID_FILE,
 			    "invalid srec record type S%c at line %u",
-			    token->str[1],
-			    token_idx + 1);
+			    line[1],
+			    ln);
 		return FALSE;
 	}
 
 	/* parse address */
 	switch (addrsz) {
 	case 2:
-		if (!fu_firmware_strparse_uint16_safe(token->str,
-						      token->len,
-						      4,
-						      &rec_addr16,
-						      error))
+		if (!fu_firmware_strparse_uint16_safe(line, linesz, 4, &rec_addr16, error))
 			return FALSE;
-		rec_addr32 = rec_addr16;
+		tok.addr = rec_addr16;
 		break;
 	case 3:
-		if (!fu_firmware_strparse_uint24_safe(token->str,
-						      token->len,
-						      4,
-						      &rec_addr32,
-						      error))
+		if (!fu_firmware_strparse_uint24_safe(line, linesz, 4, &tok.addr, error))
 			return FALSE;
 		break;
 	case 4:
-		if (!fu_firmware_strparse_uint32_safe(token->str,
-						      token->len,
-						      4,
-						      &rec_addr32,
-						      error))
+		if (!fu_firmware_strparse_uint32_safe(line, linesz, 4, &tok.addr, error))
 			return FALSE;
 		break;
 	default:
 		g_assert_not_reached();
 	}
 	g_debug("line %03u S%u addr:0x%04x datalen:0x%02x",
-		token_idx + 1,
+		ln,
 		rec_kind,
-		rec_addr32,
+		tok.addr,
 		(guint)rec_count - addrsz - 1);
 	if (require_data && rec_count == addrsz) {
 		g_set_error(error,
@@ -315,21 +318,14 @@ fu_srec_firmware_tokenize_cb(GString *token, guint token_idx, gpointer user_data
 		return FALSE;
 	}
 
-	/* data */
-	rcd = fu_srec_firmware_record_new(token_idx + 1, rec_kind, rec_addr32);
+	/* data, which was already decoded */
+	tok.kind = rec_kind;
+	tok.data_offset = priv->payload->len;
 	if (rec_kind == 1 || rec_kind == 2 || rec_kind == 3) {
-		for (gsize i = 4 + (addrsz * 2); i <= rec_count * 2; i += 2) {
-			guint8 tmp = 0;
-			if (!fu_firmware_strparse_uint8_safe(token->str,
-							     token->len,
-							     i,
-							     &tmp,
-							     error))
-				return FALSE;
-			fu_byte_array_append_uint8(rcd->buf, tmp);
-		}
+		tok.data_sz = rec_count - addrsz - 1;
+		g_byte_array_append(priv->payload, rec + 1 + addrsz, tok.data_sz);
 	}
-	g_ptr_array_add(priv->records, g_steal_pointer(&rcd));
+	g_array_append_val(priv->tokens, tok);
 	return TRUE;
 }
 
@@ -337,19 +333,61 @@ static gboolean
 fu_srec_firmware_tokenize(FuFirmware *firmware, GBytes *fw, FwupdInstallFlags flags, GError **error)
 {
 	FuSrecFirmware *self = FU_SREC_FIRMWARE(firmware);
-	FuSrecFirmwareTokenHelper helper = {.self = self, .flags = flags, .got_eof = FALSE};
+	FuSrecFirmwarePrivate *priv = GET_PRIVATE(self);
+	gboolean got_eof = FALSE;
+	gsize bufsz = 0;
+	const gchar *buf = g_bytes_get_data(fw, &bufsz);
+	guint token_idx = 0;
+
+	/* the decoded data is always less than half the size of the text */
+	g_byte_array_unref(priv->payload);
+	priv->payload = g_byte_array_sized_new(bufsz / 2);
+	g_array_set_size(priv->tokens, 0);
+	g_ptr_array_set_size(priv->records, 0);
+	priv->records_loaded = FALSE;
+
+	/* split into lines without copying */
+	for (gsize offset = 0; offset < bufsz; token_idx++) {
+		const gchar *line = buf + offset;
+		const gchar *eol = memchr(line, '\n', bufsz - offset);
+		gsize linesz = eol != NULL ? (gsize)(eol - line) : bufsz - offset;
+
+		offset += linesz + 1;
+
+		/* sanity check */
+		if (token_idx > FU_SREC_FIRMWARE_TOKENS_MAX) {
+			g_set_error_literal(error,
+					    G_IO_ERROR,
+					    G_IO_ERROR_INVALID_DATA,
+					    "file has too many lines");
+			return FALSE;
+		}
 
-	/* parse records */
-	if (!fu_strsplit_full(g_bytes_get_data(fw, NULL),
-			      g_bytes_get_size(fw),
-			      "\n",
-			      fu_srec_firmware_tokenize_cb,
-			      &helper,
-			      error))
-		return FALSE;
+		/* remove WIN32 line endings */
+		for (gsize i = 0; i < linesz; i++) {
+			if (line[i] == '\r' || line[i] == '\x1a' || line[i] == '\0') {
+				linesz = i;
+				break;
+			}
+		}
+
+		/* ignore blank lines */
+		if (linesz == 0)
+			continue;
+
+		/* parse record */
+		if (!fu_srec_firmware_tokenize_line(self,
+						    token_idx + 1,
+						    line,
+						    linesz,
+						    flags,
+						    &got_eof,
+						    error))
+			return FALSE;
+	}
 
 	/* no EOF */
-	if (!helper.got_eof) {
+	if (!got_eof) {
 		g_set_error_literal(error,
 				    FWUPD_ERROR,
 				    FWUPD_ERROR_INVALID_FILE,
@@ -373,14 +411,15 @@ fu_srec_firmware_parse(FuFirmware *firmware,
 	guint32 addr32_last = 0;
 	guint32 img_address = 0;
 	g_autoptr(GBytes) img_bytes = NULL;
-	g_autoptr(GByteArray) outbuf = g_byte_array_new();
+	g_autoptr(GByteArray) outbuf = g_byte_array_sized_new(priv->payload->len);
 
 	/* parse records */
-	for (guint j = 0; j < priv->records->len; j++) {
-		FuSrecFirmwareRecord *rcd = g_ptr_array_index(priv->records, j);
+	for (guint j = 0; j < priv->tokens->len; j++) {
+		FuSrecFirmwareToken *tok = &g_array_index(priv->tokens, FuSrecFirmwareToken, j);
+		const guint8 *data = priv->payload->data + tok->data_offset;
 
 		/* header */
-		if (rcd->kind == FU_FIRMWARE_SREC_RECORD_KIND_S0_HEADER) {
+		if (tok->kind == FU_FIRMWARE_SREC_RECORD_KIND_S0_HEADER) {
 			g_autoptr(GString) modname = g_string_new(NULL);
 
 			/* check for duplicate */
@@ -389,13 +428,13 @@ fu_srec_firmware_parse(FuFirmware *firmware,
 					    FWUPD_ERROR,
 					    FWUPD_ERROR_INVALID_FILE,
 					    "duplicate header record at line %u",
-					    rcd->ln);
+					    tok->ln);
 				return FALSE;
 			}
 
 			/* could be anything, lets assume text */
-			for (guint i = 0; i < rcd->buf->len; i++) {
-				gchar tmp = rcd->buf->data[i];
+			for (guint i = 0; i < tok->data_sz; i++) {
+				gchar tmp = data[i];
 				if (!g_ascii_isgraph(tmp))
 					break;
 				g_string_append_c(modname, tmp);
@@ -407,54 +446,54 @@ fu_srec_firmware_parse(FuFirmware *firmware,
 		}
 
 		/* verify we got all records */
-		if (rcd->kind == FU_FIRMWARE_SREC_RECORD_KIND_S5_COUNT_16) {
-			if (rcd->addr != data_cnt) {
+		if (tok->kind == FU_FIRMWARE_SREC_RECORD_KIND_S5_COUNT_16) {
+			if (tok->addr != data_cnt) {
 				g_set_error(error,
 					    FWUPD_ERROR,
 					    FWUPD_ERROR_INVALID_FILE,
 					    "count record was not valid, got 0x%02x expected "
 					    "0x%02x at line %u",
-					    (guint)rcd->addr,
+					    (guint)tok->addr,
 					    (guint)data_cnt,
-					    rcd->ln);
+					    tok->ln);
 				return FALSE;
 			}
 			continue;
 		}
 
 		/* data */
-		if (rcd->kind == FU_FIRMWARE_SREC_RECORD_KIND_S1_DATA_16 ||
-		    rcd->kind == FU_FIRMWARE_SREC_RECORD_KIND_S2_DATA_24 ||
-		    rcd->kind == FU_FIRMWARE_SREC_RECORD_KIND_S3_DATA_32) {
+		if (tok->kind == FU_FIRMWARE_SREC_RECORD_KIND_S1_DATA_16 ||
+		    tok->kind == FU_FIRMWARE_SREC_RECORD_KIND_S2_DATA_24 ||
+		    tok->kind == FU_FIRMWARE_SREC_RECORD_KIND_S3_DATA_32) {
 			/* invalid */
 			if (!got_hdr) {
 				g_set_error(error,
 					    FWUPD_ERROR,
 					    FWUPD_ERROR_INVALID_FILE,
 					    "missing header record at line %u",
-					    rcd->ln);
+					    tok->ln);
 				return FALSE;
 			}
 
 			/* does not make sense */
-			if (rcd->addr < addr32_last) {
+			if (tok->addr < addr32_last) {
 				g_set_error(error,
 					    FWUPD_ERROR,
 					    FWUPD_ERROR_INVALID_FILE,
 					    "invalid address 0x%x, last was 0x%x at line %u",
-					    (guint)rcd->addr,
+					    (guint)tok->addr,
 					    (guint)addr32_last,
-					    rcd->ln);
+					    tok->ln);
 				return FALSE;
 			}
-			if (rcd->addr < offset) {
+			if (tok->addr < offset) {
 				g_debug(
 				    "ignoring data at 0x%x as before start address 0x%x at line %u",
-				    (guint)rcd->addr,
+				    (guint)tok->addr,
 				    (guint)offset,
-				    rcd->ln);
+				    tok->ln);
 			} else {
-				guint32 len_hole = rcd->addr - addr32_last;
+				guint32 len_hole = tok->addr - addr32_last;
 
 				/* fill any holes, but only up to 1Mb to avoid a DoS */
 				if (addr32_last > 0 && len_hole > 0x100000) {
@@ -464,30 +503,31 @@ fu_srec_firmware_parse(FuFirmware *firmware,
 					    FWUPD_ERROR_INVALID_FILE,
 					    "hole of 0x%x bytes too large to fill at line %u",
 					    (guint)len_hole,
-					    rcd->ln);
+					    tok->ln);
 					return FALSE;
 				}
 				if (addr32_last > 0x0 && len_hole > 1) {
 					g_debug("filling address 0x%08x to 0x%08x at line %u",
 						addr32_last + 1,
 						addr32_last + len_hole - 1,
-						rcd->ln);
-					for (guint i = 0; i < len_hole; i++)
-						fu_byte_array_append_uint8(outbuf, 0xff);
+						tok->ln);
+					fu_byte_array_set_size(outbuf,
+							       outbuf->len + len_hole,
+							       0xff);
 				}
 
 				/* add data */
-				g_byte_array_append(outbuf, rcd->buf->data, rcd->buf->len);
+				g_byte_array_append(outbuf, data, tok->data_sz);
 				if (img_address == 0x0)
-					img_address = rcd->addr;
-				addr32_last = rcd->addr + rcd->buf->len;
-				if (addr32_last < rcd->addr) {
+					img_address = tok->addr;
+				addr32_last = tok->addr + tok->data_sz;
+				if (addr32_last < tok->addr) {
 					g_set_error(error,
 						    FWUPD_ERROR,
 						    FWUPD_ERROR_INVALID_FILE,
 						    "overflow from address 0x%x at line %u",
-						    (guint)rcd->addr,
-						    rcd->ln);
+						    (guint)tok->addr,
+						    tok->ln);
 					return FALSE;
 				}
 			}
@@ -613,6 +653,8 @@ fu_srec_firmware_finalize(GObject *object)
 	FuSrecFirmware *self = FU_SREC_FIRMWARE(object);
 	FuSrecFirmwarePrivate *priv = GET_PRIVATE(self);
 	g_ptr_array_unref(priv->records);
+	g_array_unref(priv->tokens);
+	g_byte_array_unref(priv->payload);
 	G_OBJECT_CLASS(fu_srec_firmware_parent_class)->finalize(object);
 }
 
@@ -621,6 +663,8 @@ fu_srec_firmware_init(FuSrecFirmware *self)
 {
 	FuSrecFirmwarePrivate *priv = GET_PRIVATE(self);
 	priv->records = g_ptr_array_new_with_free_func((GFreeFunc)fu_srec_firmware_record_free);
+	priv->tokens = g_array_new(FALSE, FALSE, sizeof(FuSrecFirmwareToken));
+	priv->payload = g_byte_array_new();
 	fu_firmware_add_flag(FU_FIRMWARE(self), FU_FIRMWARE_FLAG_HAS_CHECKSUM);
 }
 
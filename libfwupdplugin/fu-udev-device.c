@@ -23,6 +23,7 @@
 
 #include "fu-device-private.h"
 #include "fu-i2c-device.h"
+#include "fu-progress.h"
 #include "fu-string.h"
 #include "fu-udev-device-private.h"
 
@@ -34,6 +35,9 @@
  * See also: [class@FuDevice]
  */
 
+/* large enough that syscall overhead is negligible, small enough for useful progress */
+#define FU_UDEV_DEVICE_IO_BLOCK_SIZE 0x100000 /* bytes */
+
 typedef struct {
 	GUdevDevice *udev_device;
 	gboolean udev_device_cleared;
@@ -1817,6 +1821,226 @@ fu_udev_device_pwrite(FuUdevDevice *self,
 #endif
 }
 
+#ifdef HAVE_PWRITE
+static gboolean
+fu_udev_device_pread_block(FuUdevDevice *self,
+			   goffset offset,
+			   guint8 *buf,
+			   gsize bufsz,
+			   GError **error)
+{
+	FuUdevDevicePrivate *priv = GET_PRIVATE(self);
+	gsize done = 0;
+
+	/* the kernel may return less than requested, e.g. when crossing an erase block */
+	while (done < bufsz) {
+		gssize rc = pread(priv->fd, buf + done, bufsz - done, offset + done);
+		if (rc < 0) {
+			if (errno == EINTR || errno == EAGAIN)
+				continue;
+			g_set_error(error,
+				    G_IO_ERROR,
+				    G_IO_ERROR_FAILED,
+				    "failed to read from 0x%x: %s",
+				    (guint)(offset + done),
+				    strerror(errno));
+			return FALSE;
+		}
+		if (rc == 0) {
+			g_set_error(error,
+				    G_IO_ERROR,
+				    G_IO_ERROR_PARTIAL_INPUT,
+				    "unexpected EOF at 0x%x",
+				    (guint)(offset + done));
+			return FALSE;
+		}
+		done += rc;
+	}
+	return TRUE;
+}
+
+static gboolean
+fu_udev_device_pwrite_block(FuUdevDevice *self,
+			    goffset offset,
+			    const guint8 *buf,
+			    gsize bufsz,
+			    GError **error)
+{
+	FuUdevDevicePrivate *priv = GET_PRIVATE(self);
+	gsize done = 0;
+
+	while (done < bufsz) {
+		gssize rc = pwrite(priv->fd, buf + done, bufsz - done, offset + done);
+		if (rc < 0) {
+			if (errno == EINTR || errno == EAGAIN)
+				continue;
+			g_set_error(error,
+				    G_IO_ERROR,
+				    G_IO_ERROR_FAILED,
+				    "failed to write to 0x%x: %s",
+				    (guint)(offset + done),
+				    strerror(errno));
+			return FALSE;
+		}
+		if (rc == 0) {
+			g_set_error(error,
+				    G_IO_ERROR,
+				    G_IO_ERROR_NO_SPACE,
+				    "no space left at 0x%x",
+				    (guint)(offset + done));
+			return FALSE;
+		}
+		done += rc;
+	}
+	return TRUE;
+}
+#endif
+
+/**
+ * fu_udev_device_pread_full:
+ * @self: a #FuUdevDevice
+ * @offset: offset address
+ * @buf: (out): data
+ * @bufsz: size of @buf
+ * @progress: (nullable): a #FuProgress
+ * @error: (nullable): optional return location for an error
+ *
+ * Reads a large buffer from a file descriptor at a given offset. Unlike fu_udev_device_pread()
+ * the data is transferred in large blocks, short reads are retried, and the kernel is told that
+ * the access is going to be sequential.
+ *
+ * This should be used when reading back the entire contents of a device, e.g. for verification.
+ *
+ * Returns: %TRUE for success
+ *
+ * Since: 1.9.4
+ **/
+gboolean
+fu_udev_device_pread_full(FuUdevDevice *self,
+			  goffset offset,
+			  guint8 *buf,
+			  gsize bufsz,
+			  FuProgress *progress,
+			  GError **error)
+{
+	FuUdevDevicePrivate *priv = GET_PRIVATE(self);
+#ifdef HAVE_PWRITE
+	guint blocks;
+#endif
+
+	g_return_val_if_fail(FU_IS_UDEV_DEVICE(self), FALSE);
+	g_return_val_if_fail(buf != NULL, FALSE);
+	g_return_val_if_fail(progress == NULL || FU_IS_PROGRESS(progress), FALSE);
+	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+
+	/* not open! */
+	if (priv->fd < 0) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_INTERNAL,
+			    "%s [%s] has not been opened",
+			    fu_device_get_id(FU_DEVICE(self)),
+			    fu_device_get_name(FU_DEVICE(self)));
+		return FALSE;
+	}
+
+#ifdef HAVE_PWRITE
+#ifdef HAVE_POSIX_FADVISE
+	/* allow the kernel to read ahead aggressively, failure is not fatal */
+	(void)posix_fadvise(priv->fd, offset, bufsz, POSIX_FADV_SEQUENTIAL);
+#endif
+	blocks = (bufsz + FU_UDEV_DEVICE_IO_BLOCK_SIZE - 1) / FU_UDEV_DEVICE_IO_BLOCK_SIZE;
+	if (progress != NULL) {
+		fu_progress_set_id(progress, G_STRLOC);
+		fu_progress_set_steps(progress, blocks);
+	}
+	for (guint i = 0; i < blocks; i++) {
+		gsize idx = (gsize)i * FU_UDEV_DEVICE_IO_BLOCK_SIZE;
+		gsize chunksz = MIN(bufsz - idx, FU_UDEV_DEVICE_IO_BLOCK_SIZE);
+		if (!fu_udev_device_pread_block(self, offset + idx, buf + idx, chunksz, error))
+			return FALSE;
+		if (progress != NULL)
+			fu_progress_step_done(progress);
+	}
+	return TRUE;
+#else
+	g_set_error_literal(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_NOT_SUPPORTED,
+			    "Not supported as pread() is unavailable");
+	return FALSE;
+#endif
+}
+
+/**
+ * fu_udev_device_pwrite_full:
+ * @self: a #FuUdevDevice
+ * @offset: offset address
+ * @buf: data
+ * @bufsz: size of @buf
+ * @progress: (nullable): a #FuProgress
+ * @error: (nullable): optional return location for an error
+ *
+ * Writes a large buffer to a file descriptor at a given offset. Unlike fu_udev_device_pwrite()
+ * the data is transferred in large blocks and short writes are retried.
+ *
+ * Returns: %TRUE for success
+ *
+ * Since: 1.9.4
+ **/
+gboolean
+fu_udev_device_pwrite_full(FuUdevDevice *self,
+			   goffset offset,
+			   const guint8 *buf,
+			   gsize bufsz,
+			   FuProgress *progress,
+			   GError **error)
+{
+	FuUdevDevicePrivate *priv = GET_PRIVATE(self);
+#ifdef HAVE_PWRITE
+	guint blocks;
+#endif
+
+	g_return_val_if_fail(FU_IS_UDEV_DEVICE(self), FALSE);
+	g_return_val_if_fail(buf != NULL, FALSE);
+	g_return_val_if_fail(progress == NULL || FU_IS_PROGRESS(progress), FALSE);
+	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+
+	/* not open! */
+	if (priv->fd < 0) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_INTERNAL,
+			    "%s [%s] has not been opened",
+			    fu_device_get_id(FU_DEVICE(self)),
+			    fu_device_get_name(FU_DEVICE(self)));
+		return FALSE;
+	}
+
+#ifdef HAVE_PWRITE
+	blocks = (bufsz + FU_UDEV_DEVICE_IO_BLOCK_SIZE - 1) / FU_UDEV_DEVICE_IO_BLOCK_SIZE;
+	if (progress != NULL) {
+		fu_progress_set_id(progress, G_STRLOC);
+		fu_progress_set_steps(progress, blocks);
+	}
+	for (guint i = 0; i < blocks; i++) {
+		gsize idx = (gsize)i * FU_UDEV_DEVICE_IO_BLOCK_SIZE;
+		gsize chunksz = MIN(bufsz - idx, FU_UDEV_DEVICE_IO_BLOCK_SIZE);
+		if (!fu_udev_device_pwrite_block(self, offset + idx, buf + idx, chunksz, error))
+			return FALSE;
+		if (progress != NULL)
+			fu_progress_step_done(progress);
+	}
+	return TRUE;
+#else
+	g_set_error_literal(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_NOT_SUPPORTED,
+			    "Not supported as pwrite() is unavailable");
+	return FALSE;
+#endif
+}
+
 /**
  * fu_udev_device_get_parent_name
  * @self: a #FuUdevDevice
@@ -8,6 +8,7 @@
 
 #include "config.h"
 
+#include "fu-chunk-private.h"
 #include "fu-device-private.h"
 #include "fu-dump.h"
 #include "fu-mem.h"
@@ -786,6 +787,391 @@ fu_usb_device_get_dev(FuUsbDevice *device)
 	return priv->usb_device;
 }
 
+#ifdef HAVE_GUSB
+typedef struct {
+	GUsbDevice *usb_device;
+	GPtrArray *chunks; /* element-type FuChunk */
+	FuProgress *progress;
+	GMainLoop *loop;
+	GCancellable *cancellable;
+	GError *error;
+	gboolean *completed;
+	guint8 endpoint;
+	gboolean interrupt;
+	gboolean emulated;
+	guint max_inflight;
+	guint timeout;
+	guint idx_next;
+	guint idx_done;
+	guint inflight;
+} FuUsbDeviceTransferHelper;
+
+typedef struct {
+	FuUsbDeviceTransferHelper *helper;
+	guint idx;
+} FuUsbDeviceTransferItem;
+
+static guint8 *
+fu_usb_device_transfer_chunk_data(FuUsbDeviceTransferHelper *helper, FuChunk *chk)
+{
+	/* OUT transfers are never written to by libusb */
+	if (helper->endpoint & 0x80)
+		return fu_chunk_get_data_out(chk);
+	return (guint8 *)fu_chunk_get_data(chk);
+}
+
+static gboolean
+fu_usb_device_transfer_chunk(FuUsbDeviceTransferHelper *helper,
+			     FuChunk *chk,
+			     gsize *actual_len,
+			     GError **error)
+{
+	guint8 *buf = fu_usb_device_transfer_chunk_data(helper, chk);
+	gsize bufsz = fu_chunk_get_data_sz(chk);
+
+	if (helper->interrupt) {
+		return g_usb_device_interrupt_transfer(helper->usb_device,
+						       helper->endpoint,
+						       buf,
+						       bufsz,
+						       actual_len,
+						       helper->timeout,
+						       NULL,
+						       error);
+	}
+	return g_usb_device_bulk_transfer(helper->usb_device,
+					  helper->endpoint,
+					  buf,
+					  bufsz,
+					  actual_len,
+					  helper->timeout,
+					  NULL,
+					  error);
+}
+
+static void
+fu_usb_device_transfer_chunks_cb(GObject *source, GAsyncResult *res, gpointer user_data);
+
+/* replay the recorded event now, but complete from the main loop like a real transfer */
+static void
+fu_usb_device_transfer_chunks_emulate(FuUsbDeviceTransferHelper *helper,
+				      FuChunk *chk,
+				      FuUsbDeviceTransferItem *item)
+{
+	gsize actual_len = 0;
+	g_autoptr(GError) error_local = NULL;
+	g_autoptr(GTask) task = g_task_new(helper->usb_device,
+					   helper->cancellable,
+					   fu_usb_device_transfer_chunks_cb,
+					   item);
+
+	if (!fu_usb_device_transfer_chunk(helper, chk, &actual_len, &error_local)) {
+		g_task_return_error(task, g_steal_pointer(&error_local));
+		return;
+	}
+	g_task_return_int(task, (gssize)actual_len);
+}
+
+static void
+fu_usb_device_transfer_chunks_submit(FuUsbDeviceTransferHelper *helper)
+{
+	while (helper->error == NULL && helper->inflight < helper->max_inflight &&
+	       helper->idx_next < helper->chunks->len) {
+		FuChunk *chk = g_ptr_array_index(helper->chunks, helper->idx_next);
+		guint8 *buf = fu_usb_device_transfer_chunk_data(helper, chk);
+		gsize bufsz = fu_chunk_get_data_sz(chk);
+		FuUsbDeviceTransferItem *item = g_new0(FuUsbDeviceTransferItem, 1);
+
+		item->helper = helper;
+		item->idx = helper->idx_next++;
+		helper->inflight++;
+		if (helper->emulated) {
+			fu_usb_device_transfer_chunks_emulate(helper, chk, item);
+		} else if (helper->interrupt) {
+			g_usb_device_interrupt_transfer_async(helper->usb_device,
+							      helper->endpoint,
+							      buf,
+							      bufsz,
+							      helper->timeout,
+							      helper->cancellable,
+							      fu_usb_device_transfer_chunks_cb,
+							      item);
+		} else {
+			g_usb_device_bulk_transfer_async(helper->usb_device,
+							 helper->endpoint,
+							 buf,
+							 bufsz,
+							 helper->timeout,
+							 helper->cancellable,
+							 fu_usb_device_transfer_chunks_cb,
+							 item);
+		}
+	}
+}
+
+static void
+fu_usb_device_transfer_chunks_cb(GObject *source, GAsyncResult *res, gpointer user_data)
+{
+	g_autofree FuUsbDeviceTransferItem *item = (FuUsbDeviceTransferItem *)user_data;
+	FuUsbDeviceTransferHelper *helper = item->helper;
+	FuChunk *chk = g_ptr_array_index(helper->chunks, item->idx);
+	gssize actual_len;
+	g_autoptr(GError) error_local = NULL;
+
+	if (helper->emulated) {
+		actual_len = g_task_propagate_int(G_TASK(res), &error_local);
+	} else if (helper->interrupt) {
+		actual_len =
+		    g_usb_device_interrupt_transfer_finish(G_USB_DEVICE(source), res, &error_local);
+	} else {
+		actual_len =
+		    g_usb_device_bulk_transfer_finish(G_USB_DEVICE(source), res, &error_local);
+	}
+	helper->inflight--;
+
+	/* the first failure cancels everything still in flight */
+	if (actual_len < 0) {
+		if (helper->error == NULL) {
+			g_propagate_prefixed_error(&helper->error,
+						   g_steal_pointer(&error_local),
+						   "failed to transfer chunk 0x%x: ",
+						   item->idx);
+		}
+		g_cancellable_cancel(helper->cancellable);
+	} else if ((gsize)actual_len != fu_chunk_get_data_sz(chk)) {
+		if (helper->error == NULL) {
+			g_set_error(&helper->error,
+				    G_IO_ERROR,
+				    G_IO_ERROR_PARTIAL_INPUT,
+				    "only transferred 0x%x of 0x%x bytes for chunk 0x%x",
+				    (guint)actual_len,
+				    (guint)fu_chunk_get_data_sz(chk),
+				    item->idx);
+		}
+		g_cancellable_cancel(helper->cancellable);
+	} else {
+		/* only report the chunks that have completed in order */
+		helper->completed[item->idx] = TRUE;
+		while (helper->idx_done < helper->chunks->len &&
+		       helper->completed[helper->idx_done])
+			helper->idx_done++;
+		if (helper->progress != NULL) {
+			fu_progress_add_bytes(helper->progress, actual_len);
+			fu_progress_set_percentage_full(helper->progress,
+							helper->idx_done,
+							helper->chunks->len);
+		}
+	}
+
+	/* keep the pipeline full */
+	fu_usb_device_transfer_chunks_submit(helper);
+	if (helper->inflight == 0)
+		g_main_loop_quit(helper->loop);
+}
+
+static gboolean
+fu_usb_device_transfer_chunks_sync(FuUsbDeviceTransferHelper *helper, GError **error)
+{
+	for (guint i = 0; i < helper->chunks->len; i++) {
+		FuChunk *chk = g_ptr_array_index(helper->chunks, i);
+		gsize bufsz = fu_chunk_get_data_sz(chk);
+		gsize actual_len = 0;
+
+		if (!fu_usb_device_transfer_chunk(helper, chk, &actual_len, error)) {
+			g_prefix_error(error, "failed to transfer chunk 0x%x: ", i);
+			return FALSE;
+		}
+		if (actual_len != bufsz) {
+			g_set_error(error,
+				    G_IO_ERROR,
+				    G_IO_ERROR_PARTIAL_INPUT,
+				    "only transferred 0x%x of 0x%x bytes for chunk 0x%x",
+				    (guint)actual_len,
+				    (guint)bufsz,
+				    i);
+			return FALSE;
+		}
+		if (helper->progress != NULL) {
+			fu_progress_add_bytes(helper->progress, actual_len);
+			fu_progress_set_percentage_full(helper->progress,
+							i + 1,
+							helper->chunks->len);
+		}
+	}
+	return TRUE;
+}
+#endif
+
+static gboolean
+fu_usb_device_transfer_chunks(FuUsbDevice *self,
+			      gboolean interrupt,
+			      guint8 endpoint,
+			      GPtrArray *chunks,
+			      guint max_inflight,
+			      guint timeout,
+			      FuProgress *progress,
+			      GError **error)
+{
+#ifdef HAVE_GUSB
+	FuUsbDevicePrivate *priv = GET_PRIVATE(self);
+	FuContext *ctx = fu_device_get_context(FU_DEVICE(self));
+	g_autofree gboolean *completed = NULL;
+	g_autoptr(GCancellable) cancellable = NULL;
+	g_autoptr(GMainContext) context = NULL;
+	g_autoptr(GMainLoop) loop = NULL;
+	FuUsbDeviceTransferHelper helper = {
+	    .usb_device = priv->usb_device,
+	    .chunks = chunks,
+	    .progress = progress,
+	    .endpoint = endpoint,
+	    .interrupt = interrupt,
+	    .max_inflight = MAX(max_inflight, 1),
+	    .timeout = timeout,
+	};
+
+	g_return_val_if_fail(FU_IS_USB_DEVICE(self), FALSE);
+	g_return_val_if_fail(chunks != NULL, FALSE);
+	g_return_val_if_fail(progress == NULL || FU_IS_PROGRESS(progress), FALSE);
+	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+
+	if (priv->usb_device == NULL) {
+		g_set_error_literal(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_INTERNAL,
+				    "no USB device set");
+		return FALSE;
+	}
+	if (chunks->len == 0)
+		return TRUE;
+
+	/* IN transfers write the received data into the chunks */
+	if (endpoint & 0x80) {
+		for (guint i = 0; i < chunks->len; i++) {
+			FuChunk *chk = g_ptr_array_index(chunks, i);
+			if (!fu_chunk_is_mutable(chk)) {
+				g_set_error(error,
+					    FWUPD_ERROR,
+					    FWUPD_ERROR_INTERNAL,
+					    "chunk 0x%x is read-only and cannot be used for an IN "
+					    "transfer",
+					    i);
+				return FALSE;
+			}
+		}
+	}
+
+	/* the events are recorded one at a time */
+	if (helper.max_inflight == 1 ||
+	    (ctx != NULL && fu_context_has_flag(ctx, FU_CONTEXT_FLAG_SAVE_EVENTS)))
+		return fu_usb_device_transfer_chunks_sync(&helper, error);
+	helper.emulated = fu_device_has_flag(FU_DEVICE(self), FWUPD_DEVICE_FLAG_EMULATED);
+
+	/* keep up to max_inflight transfers queued, dispatching on a private context */
+	context = g_main_context_new();
+	loop = g_main_loop_new(context, FALSE);
+	cancellable = g_cancellable_new();
+	completed = g_new0(gboolean, chunks->len);
+	helper.loop = loop;
+	helper.cancellable = cancellable;
+	helper.completed = completed;
+	g_main_context_push_thread_default(context);
+	fu_usb_device_transfer_chunks_submit(&helper);
+	g_main_loop_run(loop);
+	g_main_context_pop_thread_default(context);
+	if (helper.error != NULL) {
+		g_propagate_error(error, helper.error);
+		return FALSE;
+	}
+	return TRUE;
+#else
+	g_set_error_literal(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_NOT_SUPPORTED,
+			    "Not supported as <gusb.h> is unavailable");
+	return FALSE;
+#endif
+}
+
+/**
+ * fu_usb_device_bulk_transfer_chunks:
+ * @self: a #FuUsbDevice
+ * @endpoint: the USB endpoint, e.g. 0x01
+ * @chunks: (element-type FuChunk): chunks of data
+ * @max_inflight: the number of transfers to keep queued, e.g. 8
+ * @timeout: timeout for each transfer in ms
+ * @progress: (nullable): a #FuProgress
+ * @error: (nullable): optional return location for an error
+ *
+ * Sends or receives all the chunks using bulk transfers, keeping up to @max_inflight transfers
+ * queued to the device rather than waiting for each to complete before starting the next.
+ *
+ * The chunks complete in order, and the first failure or short transfer cancels all the
+ * queued transfers. When the events are being saved, the transfers are done one at a time.
+ *
+ * For an IN endpoint the received data is written into the chunks, so they have to be created
+ * using fu_chunk_array_mutable_new(), otherwise an error is returned.
+ *
+ * Returns: %TRUE if all the chunks were transferred
+ *
+ * Since: 1.9.4
+ **/
+gboolean
+fu_usb_device_bulk_transfer_chunks(FuUsbDevice *self,
+				   guint8 endpoint,
+				   GPtrArray *chunks,
+				   guint max_inflight,
+				   guint timeout,
+				   FuProgress *progress,
+				   GError **error)
+{
+	return fu_usb_device_transfer_chunks(self,
+					     FALSE,
+					     endpoint,
+					     chunks,
+					     max_inflight,
+					     timeout,
+					     progress,
+					     error);
+}
+
+/**
+ * fu_usb_device_interrupt_transfer_chunks:
+ * @self: a #FuUsbDevice
+ * @endpoint: the USB endpoint, e.g. 0x01
+ * @chunks: (element-type FuChunk): chunks of data
+ * @max_inflight: the number of transfers to keep queued, e.g. 8
+ * @timeout: timeout for each transfer in ms
+ * @progress: (nullable): a #FuProgress
+ * @error: (nullable): optional return location for an error
+ *
+ * Sends or receives all the chunks using interrupt transfers, keeping up to @max_inflight
+ * transfers queued to the device.
+ *
+ * See fu_usb_device_bulk_transfer_chunks() for details.
+ *
+ * Returns: %TRUE if all the chunks were transferred
+ *
+ * Since: 1.9.4
+ **/
+gboolean
+fu_usb_device_interrupt_transfer_chunks(FuUsbDevice *self,
+					guint8 endpoint,
+					GPtrArray *chunks,
+					guint max_inflight,
+					guint timeout,
+					FuProgress *progress,
+					GError **error)
+{
+	return fu_usb_device_transfer_chunks(self,
+					     TRUE,
+					     endpoint,
+					     chunks,
+					     max_inflight,
+					     timeout,
+					     progress,
+					     error);
+}
+
 static void
 fu_usb_device_incorporate(FuDevice *self, FuDevice *donor)
 {
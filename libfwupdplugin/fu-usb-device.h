@@ -17,6 +17,7 @@
 #endif
 
 #include "fu-plugin.h"
+#include "fu-progress.h"
 #include "fu-udev-device.h"
 
 #define FU_TYPE_USB_DEVICE (fu_usb_device_get_type())
@@ -46,3 +47,19 @@ void
 fu_usb_device_set_configuration(FuUsbDevice *device, gint configuration);
 void
 fu_usb_device_add_interface(FuUsbDevice *device, guint8 number);
+gboolean
+fu_usb_device_bulk_transfer_chunks(FuUsbDevice *self,
+				   guint8 endpoint,
+				   GPtrArray *chunks,
+				   guint max_inflight,
+				   guint timeout,
+				   FuProgress *progress,
+				   GError **error) G_GNUC_WARN_UNUSED_RESULT;
+gboolean
+fu_usb_device_interrupt_transfer_chunks(FuUsbDevice *self,
+					guint8 endpoint,
+					GPtrArray *chunks,
+					guint max_inflight,
+					guint timeout,
+					FuProgress *progress,
+					GError **error) G_GNUC_WARN_UNUSED_RESULT;
@@ -112,6 +112,10 @@ class StructObj:
     def c_define(self, suffix: str):
         return f"FU_STRUCT_{_camel_to_snake(self.name).upper()}_{suffix.upper()}"
 
+    @property
+    def c_view_type(self) -> str:
+        return f"FuStruct{self.name}View"
+
     @property
     def size(self) -> int:
         size: int = 0
@@ -126,13 +130,23 @@ class StructObj:
                 return True
         return False
 
+    def add_view(self) -> None:
+        if "View" not in self.derives:
+            self.derives.append("View")
+        for item in self.items:
+            if item.struct_obj:
+                item.struct_obj.add_view()
+
     def export(self, derive: str) -> Export:
-        if derive in ["New", "Parse", "Validate", "ToString"]:
+        if derive in ["New", "Parse", "Validate", "ToString", "View"]:
             if derive in self.derives:
                 return Export.PUBLIC
         if derive == "ToString":
             if "Parse" in self.derives:
                 return Export.PRIVATE
+        if derive == "Validate":
+            if "View" in self.derives:
+                return Export.PRIVATE
         return self._exports.get(derive, Export.NONE)
 
     def __str__(self) -> str:
@@ -166,11 +180,18 @@ class StructItem:
             if (
                 self.constant
                 and self.type != Type.STRING
-                and "Validate" in self.obj.derives
+                and self.obj.export("Validate") != Export.NONE
             ):
                 return Export.PRIVATE
             if not self.constant and self.obj.export("ToString") != Export.NONE:
                 return Export.PRIVATE
+        if derive == "ViewGetters":
+            if (
+                not self.constant
+                and self.type != Type.STRING
+                and "View" in self.obj.derives
+            ):
+                return Export.PUBLIC
         if derive == "Setters":
             if not self.constant and "Setters" in self.obj.derives:
                 return Export.PUBLIC
@@ -222,6 +243,10 @@ class StructItem:
     def c_setter(self):
         return self.obj.c_method("set_" + self.element_id)
 
+    @property
+    def c_view_getter(self):
+        return self.obj.c_method("view_get_" + self.element_id)
+
     @property
     def type_glib(self) -> str:
         if self.enum_obj:
@@ -460,6 +485,8 @@ class Generator:
                         if "New" in struct_cur.derives and item.struct_obj:
                             if "New" not in item.struct_obj.derives:
                                 item.struct_obj._exports["New"] = Export.PRIVATE
+                        if "View" in struct_cur.derives and item.struct_obj:
+                            item.struct_obj.add_view()
                 struct_cur = None
                 enum_cur = None
                 repr_type = None
@@ -513,6 +540,9 @@ class Generator:
         # process the templates here
         subst = {
             "basename": self.basename,
+            "has_view": any(
+                "View" in obj.derives for obj in self.struct_objs.values()
+            ),
         }
         template_h = self._env.get_template(os.path.basename("fu-rustgen.h.in"))
         template_c = self._env.get_template(os.path.basename("fu-rustgen.c.in"))
@@ -16,6 +16,7 @@
 #define FASTBOOT_EP_IN			   0x81
 #define FASTBOOT_EP_OUT			   0x01
 #define FASTBOOT_CMD_BUFSZ		   64 /* bytes */
+#define FASTBOOT_TRANSFERS_INFLIGHT	   8
 
 struct _FuFastbootDevice {
 	FuUsbDevice parent_instance;
@@ -270,16 +271,28 @@ fu_fastboot_device_download(FuDevice *device, GBytes *fw, FuProgress *progress,
 					       0x00, /* start addr */
 					       0x00, /* page_sz */
 					       self->blocksz);
-	fu_progress_set_id(progress, G_STRLOC);
-	fu_progress_set_steps(progress, chunks->len);
-	for (guint i = 0; i < chunks->len; i++) {
-		FuChunk *chk = g_ptr_array_index(chunks, i);
-		if (!fu_fastboot_device_write(device,
-					      fu_chunk_get_data(chk),
-					      fu_chunk_get_data_sz(chk),
-					      error))
+	if (self->operation_delay == 0) {
+		/* no need to wait between packets */
+		if (!fu_usb_device_bulk_transfer_chunks(FU_USB_DEVICE(self),
+							FASTBOOT_EP_OUT,
+							chunks,
+							FASTBOOT_TRANSFERS_INFLIGHT,
+							FASTBOOT_TRANSACTION_TIMEOUT,
+							progress,
+							error))
 			return FALSE;
-		fu_progress_step_done(progress);
+	} else {
+		fu_progress_set_id(progress, G_STRLOC);
+		fu_progress_set_steps(progress, chunks->len);
+		for (guint i = 0; i < chunks->len; i++) {
+			FuChunk *chk = g_ptr_array_index(chunks, i);
+			if (!fu_fastboot_device_write(device,
+						      fu_chunk_get_data(chk),
+						      fu_chunk_get_data_sz(chk),
+						      error))
+				return FALSE;
+			fu_progress_step_done(progress);
+		}
 	}
 	if (!fu_fastboot_device_read(device,
 				     NULL,
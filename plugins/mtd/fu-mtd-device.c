@@ -264,32 +264,23 @@ fu_mtd_device_erase(FuMtdDevice *self, GBytes *fw, FuProgress *progress, GError
 }
 
 static gboolean
-fu_mtd_device_write(FuMtdDevice *self, GPtrArray *chunks, FuProgress *progress, GError **error)
+fu_mtd_device_write(FuMtdDevice *self, GBytes *fw, FuProgress *progress, GError **error)
 {
-	/* progress */
-	fu_progress_set_id(progress, G_STRLOC);
-	fu_progress_set_steps(progress, chunks->len);
-
 	/* rewind */
 	if (!fu_udev_device_seek(FU_UDEV_DEVICE(self), 0x0, error)) {
 		g_prefix_error(error, "failed to rewind: ");
 		return FALSE;
 	}
 
-	/* write each chunk */
-	for (guint i = 0; i < chunks->len; i++) {
-		FuChunk *chk = g_ptr_array_index(chunks, i);
-		if (!fu_udev_device_pwrite(FU_UDEV_DEVICE(self),
-					   fu_chunk_get_address(chk),
-					   fu_chunk_get_data(chk),
-					   fu_chunk_get_data_sz(chk),
-					   error)) {
-			g_prefix_error(error,
-				       "failed to write @0x%x: ",
-				       (guint)fu_chunk_get_address(chk));
-			return FALSE;
-		}
-		fu_progress_step_done(progress);
+	/* write in large blocks */
+	if (!fu_udev_device_pwrite_full(FU_UDEV_DEVICE(self),
+					0x0,
+					g_bytes_get_data(fw, NULL),
+					g_bytes_get_size(fw),
+					progress,
+					error)) {
+		g_prefix_error(error, "failed to write: ");
+		return FALSE;
 	}
 
 	/* success */
@@ -297,37 +288,21 @@ fu_mtd_device_write(FuMtdDevice *self, GPtrArray *chunks, FuProgress *progress,
 }
 
 static gboolean
-fu_mtd_device_verify(FuMtdDevice *self, GPtrArray *chunks, FuProgress *progress, GError **error)
+fu_mtd_device_verify(FuMtdDevice *self, GBytes *fw, FuProgress *progress, GError **error)
 {
-	/* progress */
-	fu_progress_set_id(progress, G_STRLOC);
-	fu_progress_set_steps(progress, chunks->len);
+	gsize bufsz = g_bytes_get_size(fw);
+	g_autofree guint8 *buf = g_malloc0(bufsz);
+	g_autoptr(GBytes) fw_verify = NULL;
 
-	/* verify each chunk */
-	for (guint i = 0; i < chunks->len; i++) {
-		FuChunk *chk = g_ptr_array_index(chunks, i);
-		g_autofree guint8 *buf = g_malloc0(fu_chunk_get_data_sz(chk));
-		g_autoptr(GBytes) blob1 = fu_chunk_get_bytes(chk);
-		g_autoptr(GBytes) blob2 = NULL;
-
-		if (!fu_udev_device_pread(FU_UDEV_DEVICE(self),
-					  fu_chunk_get_address(chk),
-					  buf,
-					  fu_chunk_get_data_sz(chk),
-					  error)) {
-			g_prefix_error(error,
-				       "failed to read @0x%x: ",
-				       (guint)fu_chunk_get_address(chk));
-			return FALSE;
-		}
-		blob2 = g_bytes_new_static(buf, fu_chunk_get_data_sz(chk));
-		if (!fu_bytes_compare(blob1, blob2, error)) {
-			g_prefix_error(error,
-				       "failed to verify @0x%x: ",
-				       (guint)fu_chunk_get_address(chk));
-			return FALSE;
-		}
-		fu_progress_step_done(progress);
+	/* read back in large blocks */
+	if (!fu_udev_device_pread_full(FU_UDEV_DEVICE(self), 0x0, buf, bufsz, progress, error)) {
+		g_prefix_error(error, "failed to read: ");
+		return FALSE;
+	}
+	fw_verify = g_bytes_new_take(g_steal_pointer(&buf), bufsz);
+	if (!fu_bytes_compare(fw, fw_verify, error)) {
+		g_prefix_error(error, "failed to verify: ");
+		return FALSE;
 	}
 
 	/* success */
@@ -337,8 +312,6 @@ fu_mtd_device_verify(FuMtdDevice *self, GPtrArray *chunks, FuProgress *progress,
 static gboolean
 fu_mtd_device_write_verify(FuMtdDevice *self, GBytes *fw, FuProgress *progress, GError **error)
 {
-	g_autoptr(GPtrArray) chunks = fu_chunk_array_new_from_bytes(fw, 0x0, 0x0, 10 * 1024);
-
 	/* progress */
 	fu_progress_set_id(progress, G_STRLOC);
 	fu_progress_add_flag(progress, FU_PROGRESS_FLAG_GUESSED);
@@ -346,12 +319,12 @@ fu_mtd_device_write_verify(FuMtdDevice *self, GBytes *fw, FuProgress *progress,
 	fu_progress_add_step(progress, FWUPD_STATUS_DEVICE_VERIFY, 50, NULL);
 
 	/* write */
-	if (!fu_mtd_device_write(self, chunks, fu_progress_get_child(progress), error))
+	if (!fu_mtd_device_write(self, fw, fu_progress_get_child(progress), error))
 		return FALSE;
 	fu_progress_step_done(progress);
 
 	/* verify */
-	if (!fu_mtd_device_verify(self, chunks, fu_progress_get_child(progress), error))
+	if (!fu_mtd_device_verify(self, fw, fu_progress_get_child(progress), error))
 		return FALSE;
 	fu_progress_step_done(progress);
 
@@ -365,28 +338,20 @@ fu_mtd_device_dump_firmware(FuDevice *device, FuProgress *progress, GError **err
 	FuMtdDevice *self = FU_MTD_DEVICE(device);
 	gsize bufsz = fu_device_get_firmware_size_max(device);
 	g_autofree guint8 *buf = g_malloc0(bufsz);
-	g_autoptr(GPtrArray) chunks = NULL;
 
 	/* progress */
 	fu_progress_set_id(progress, G_STRLOC);
 	fu_progress_set_status(progress, FWUPD_STATUS_DEVICE_READ);
 
-	/* read each chunk */
-	chunks = fu_chunk_array_mutable_new(buf, bufsz, 0x0, 0x0, 10 * 1024);
-	fu_progress_set_steps(progress, chunks->len);
-	for (guint i = 0; i < chunks->len; i++) {
-		FuChunk *chk = g_ptr_array_index(chunks, i);
-		if (!fu_udev_device_pread(FU_UDEV_DEVICE(self),
-					  fu_chunk_get_address(chk),
-					  fu_chunk_get_data_out(chk),
-					  fu_chunk_get_data_sz(chk),
-					  error)) {
-			g_prefix_error(error,
-				       "failed to read @0x%x: ",
-				       (guint)fu_chunk_get_address(chk));
-			return NULL;
-		}
-		fu_progress_step_done(progress);
+	/* read in large blocks */
+	if (!fu_udev_device_pread_full(FU_UDEV_DEVICE(self),
+				       0x0,
+				       buf,
+				       bufsz,
+				       progress,
+				       error)) {
+		g_prefix_error(error, "failed to read: ");
+		return NULL;
 	}
 
 	/* success */
@@ -14,6 +14,27 @@ struct _FuTestBleDevice {
 
 G_DEFINE_TYPE(FuTestBleDevice, fu_test_ble_device, FU_TYPE_BLUEZ_DEVICE)
 
+#define FU_TEST_BLE_DEVICE_UUID_FIRMWARE "00cde35c-7062-11eb-9439-0242ac130002"
+
+static gboolean
+fu_test_ble_device_write_firmware(FuDevice *device,
+				  FuFirmware *firmware,
+				  FuProgress *progress,
+				  FwupdInstallFlags flags,
+				  GError **error)
+{
+	g_autoptr(GBytes) fw = NULL;
+
+	fw = fu_firmware_get_bytes(firmware, error);
+	if (fw == NULL)
+		return FALSE;
+	return fu_bluez_device_write_bytes(FU_BLUEZ_DEVICE(device),
+					   FU_TEST_BLE_DEVICE_UUID_FIRMWARE,
+					   fw,
+					   progress,
+					   error);
+}
+
 static void
 fu_test_ble_device_init(FuTestBleDevice *self)
 {
@@ -25,4 +46,6 @@ fu_test_ble_device_init(FuTestBleDevice *self)
 static void
 fu_test_ble_device_class_init(FuTestBleDeviceClass *klass)
 {
+	FuDeviceClass *klass_device = FU_DEVICE_CLASS(klass);
+	klass_device->write_firmware = fu_test_ble_device_write_firmware;
 }
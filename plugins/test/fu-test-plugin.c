@@ -13,6 +13,7 @@ struct _FuTestPlugin {
 	guint delay_decompress_ms;
 	guint delay_write_ms;
 	guint delay_verify_ms;
+	gint device_created_cnt;
 };
 
 G_DEFINE_TYPE(FuTestPlugin, fu_test_plugin, FU_TYPE_PLUGIN)
@@ -141,6 +142,22 @@ fu_test_plugin_coldplug(FuPlugin *plugin, FuProgress *progress, GError **error)
 	return TRUE;
 }
 
+static gboolean
+fu_test_plugin_device_created(FuPlugin *plugin, FuDevice *device, GError **error)
+{
+	FuTestPlugin *self = FU_TEST_PLUGIN(plugin);
+
+	/* record which thread set up the device, and in what order */
+	if (g_strcmp0(g_getenv("FWUPD_PLUGIN_TEST"), "coldplug-concurrency") == 0) {
+		g_autofree gchar *thread = g_strdup_printf("%p", g_thread_self());
+		fu_device_set_metadata(device, "CreatedThread", thread);
+		fu_device_set_metadata_integer(device,
+					       "CreatedOrder",
+					       g_atomic_int_add(&self->device_created_cnt, 1));
+	}
+	return TRUE;
+}
+
 static void
 fu_test_plugin_device_registered(FuPlugin *plugin, FuDevice *device)
 {
@@ -351,5 +368,6 @@ fu_test_plugin_class_init(FuTestPluginClass *klass)
 	plugin_class->verify = fu_test_plugin_verify;
 	plugin_class->startup = fu_test_plugin_startup;
 	plugin_class->coldplug = fu_test_plugin_coldplug;
+	plugin_class->device_created = fu_test_plugin_device_created;
 	plugin_class->device_registered = fu_test_plugin_device_registered;
 }
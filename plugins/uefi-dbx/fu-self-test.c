@@ -38,6 +38,80 @@ fu_efi_image_func(void)
 			"e99707d4378140c01eb3f867240d5cc9e237b126d3db0c3b4bbcd3da1720ddff");
 }
 
+static void
+fu_uefi_dbx_authenticode_hashes_func(void)
+{
+	gboolean ret;
+	g_autofree gchar *espdir = NULL;
+	g_autofree gchar *fn = NULL;
+	g_autofree gchar *fn_efi = NULL;
+	g_autofree gchar *fn_txt = NULL;
+	g_autofree gchar *tmpdir = NULL;
+	g_autoptr(GBytes) bytes = NULL;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GHashTable) hashes1 = NULL;
+	g_autoptr(GHashTable) hashes2 = NULL;
+	g_autoptr(GHashTable) hashes3 = NULL;
+
+	fn = g_test_build_filename(G_TEST_DIST, "tests", "fwupdx64.efi", NULL);
+	if (!g_file_test(fn, G_FILE_TEST_EXISTS)) {
+		g_test_skip("Missing fwupdx64.efi");
+		return;
+	}
+	bytes = fu_bytes_get_contents(fn, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(bytes);
+
+	/* create a fake ESP */
+	tmpdir = g_dir_make_tmp("fwupd-uefi-dbx-XXXXXX", &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(tmpdir);
+	espdir = g_build_filename(tmpdir, "esp", NULL);
+	fn_efi = g_build_filename(tmpdir, "esp", "EFI", "fwupd", "fwupdx64.efi", NULL);
+	ret = fu_path_mkdir_parent(fn_efi, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	ret = fu_bytes_set_contents(fn_efi, bytes, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	fn_txt = g_build_filename(tmpdir, "esp", "EFI", "fwupd", "README.txt", NULL);
+	ret = g_file_set_contents(fn_txt, "not an executable", -1, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+
+	/* only the executable has a hash */
+	hashes1 = fu_uefi_dbx_get_authenticode_hashes(espdir, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(hashes1);
+	g_assert_cmpint(g_hash_table_size(hashes1), ==, 1);
+	g_assert_cmpstr(g_hash_table_lookup(hashes1, fn_efi),
+			==,
+			"e99707d4378140c01eb3f867240d5cc9e237b126d3db0c3b4bbcd3da1720ddff");
+
+	/* the modified file is hashed again */
+	ret = g_file_set_contents(fn_efi, "no longer an executable", -1, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	hashes2 = fu_uefi_dbx_get_authenticode_hashes(espdir, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(hashes2);
+	g_assert_cmpint(g_hash_table_size(hashes2), ==, 0);
+
+	/* and again when restored */
+	ret = fu_bytes_set_contents(fn_efi, bytes, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	hashes3 = fu_uefi_dbx_get_authenticode_hashes(espdir, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(hashes3);
+	g_assert_cmpint(g_hash_table_size(hashes3), ==, 1);
+
+	/* clean up */
+	ret = fu_path_rmtree(tmpdir, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+}
+
 int
 main(int argc, char **argv)
 {
@@ -50,5 +124,6 @@ main(int argc, char **argv)
 
 	/* tests go here */
 	g_test_add_func("/uefi-dbx/image", fu_efi_image_func);
+	g_test_add_func("/uefi-dbx/authenticode-hashes", fu_uefi_dbx_authenticode_hashes_func);
 	return g_test_run();
 }
@@ -9,6 +9,19 @@
 #include "fu-efi-image.h"
 #include "fu-uefi-dbx-common.h"
 
+typedef struct {
+	gchar *fn;
+	gchar *checksum; /* nullable */
+} FuUefiDbxFileItem;
+
+static void
+fu_uefi_dbx_file_item_free(FuUefiDbxFileItem *item)
+{
+	g_free(item->fn);
+	g_free(item->checksum);
+	g_free(item);
+}
+
 static gchar *
 fu_uefi_dbx_get_authenticode_hash(const gchar *fn, GError **error)
 {
@@ -29,35 +42,93 @@ fu_uefi_dbx_get_authenticode_hash(const gchar *fn, GError **error)
 	return g_strdup(fu_efi_image_get_checksum(img));
 }
 
+static void
+fu_uefi_dbx_file_item_thread_cb(gpointer data, gpointer user_data)
+{
+	FuUefiDbxFileItem *item = (FuUefiDbxFileItem *)data;
+	g_autoptr(GError) error_local = NULL;
+
+	/* each file is independent, so can be hashed at the same time */
+	item->checksum = fu_uefi_dbx_get_authenticode_hash(item->fn, &error_local);
+	if (item->checksum == NULL)
+		g_debug("failed to get checksum for %s: %s", item->fn, error_local->message);
+}
+
+/**
+ * fu_uefi_dbx_get_authenticode_hashes:
+ * @path: a directory, typically the ESP mount point
+ * @error: (nullable): optional return location for an error
+ *
+ * Gets the Authenticode hash of every executable under @path. The files are hashed using a
+ * thread pool, and are never cached as the result is used to decide if writing dbx is safe.
+ *
+ * Returns: (transfer container) (element-type utf8 utf8): filename to hash, or %NULL on error
+ **/
+GHashTable *
+fu_uefi_dbx_get_authenticode_hashes(const gchar *path, GError **error)
+{
+	GThreadPool *pool;
+	g_autoptr(GHashTable) hashes = NULL;
+	g_autoptr(GPtrArray) files = NULL;
+	g_autoptr(GPtrArray) items = NULL;
+
+	/* get list of files contained in the ESP */
+	files = fu_path_get_files(path, error);
+	if (files == NULL)
+		return NULL;
+
+	/* hash each file at the same time */
+	items = g_ptr_array_new_with_free_func((GDestroyNotify)fu_uefi_dbx_file_item_free);
+	pool = g_thread_pool_new(fu_uefi_dbx_file_item_thread_cb,
+				 NULL,
+				 g_get_num_processors(),
+				 FALSE,
+				 error);
+	if (pool == NULL)
+		return NULL;
+	for (guint i = 0; i < files->len; i++) {
+		FuUefiDbxFileItem *item = g_new0(FuUefiDbxFileItem, 1);
+		item->fn = g_strdup(g_ptr_array_index(files, i));
+		g_ptr_array_add(items, item);
+		g_thread_pool_push(pool, item, NULL);
+	}
+	g_thread_pool_free(pool, FALSE, TRUE);
+
+	/* only executables have a hash */
+	hashes = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
+	for (guint i = 0; i < items->len; i++) {
+		FuUefiDbxFileItem *item = g_ptr_array_index(items, i);
+		if (item->checksum != NULL)
+			g_hash_table_insert(hashes, g_strdup(item->fn), g_strdup(item->checksum));
+	}
+
+	/* success */
+	return g_steal_pointer(&hashes);
+}
+
 static gboolean
 fu_uefi_dbx_signature_list_validate_volume(FuEfiSignatureList *siglist,
 					   FuVolume *esp,
 					   GError **error)
 {
 	g_autofree gchar *esp_path = NULL;
-	g_autoptr(GPtrArray) files = NULL;
+	g_autoptr(GHashTable) hashes = NULL;
+	g_autoptr(GList) fns = NULL;
 
-	/* get list of files contained in the ESP */
+	/* get checksum of each file contained in the ESP */
 	esp_path = fu_volume_get_mount_point(esp);
 	if (esp_path == NULL)
 		return TRUE;
-	files = fu_path_get_files(esp_path, error);
-	if (files == NULL)
+	hashes = fu_uefi_dbx_get_authenticode_hashes(esp_path, error);
+	if (hashes == NULL)
 		return FALSE;
 
 	/* verify each file does not exist in the ESP */
-	for (guint i = 0; i < files->len; i++) {
-		const gchar *fn = g_ptr_array_index(files, i);
-		g_autofree gchar *checksum = NULL;
+	fns = g_list_sort(g_hash_table_get_keys(hashes), (GCompareFunc)g_strcmp0);
+	for (GList *l = fns; l != NULL; l = l->next) {
+		const gchar *fn = l->data;
+		const gchar *checksum = g_hash_table_lookup(hashes, fn);
 		g_autoptr(FuFirmware) img = NULL;
-		g_autoptr(GError) error_local = NULL;
-
-		/* get checksum of file */
-		checksum = fu_uefi_dbx_get_authenticode_hash(fn, &error_local);
-		if (checksum == NULL) {
-			g_debug("failed to get checksum for %s: %s", fn, error_local->message);
-			continue;
-		}
 
 		/* Authenticode signature is present in dbx! */
 		g_debug("fn=%s, checksum=%s", fn, checksum);
@@ -10,3 +10,5 @@
 
 gboolean
 fu_uefi_dbx_signature_list_validate(FuContext *ctx, FuEfiSignatureList *siglist, GError **error);
+GHashTable *
+fu_uefi_dbx_get_authenticode_hashes(const gchar *path, GError **error);
@@ -27,6 +27,8 @@ struct _FuConsole {
 	guint length_percentage;   /* width in visible chars */
 	guint length_status;	   /* width in visible chars */
 	guint percentage;
+	guint64 throughput;   /* bytes per second */
+	guint time_remaining; /* seconds */
 	GSource *timer_source;
 	gint64 last_animated; /* monotonic */
 	GTimer *time_elapsed;
@@ -452,6 +454,7 @@ fu_console_refresh(FuConsole *self)
 {
 	const gchar *title;
 	guint i;
+	gboolean show_estimate;
 	g_autoptr(GString) str = g_string_new(NULL);
 
 	/* sanity check */
@@ -489,8 +492,21 @@ fu_console_refresh(FuConsole *self)
 	}
 	g_string_append_c(str, ']');
 
-	/* once we have good data show an estimate of time remaining */
-	if (fu_console_estimate_ready(self, self->percentage)) {
+	/* show the transfer rate if the device reports it */
+	if (self->throughput > 0 && self->percentage > 0 && self->percentage < 100) {
+		g_autofree gchar *rate = g_format_size(self->throughput);
+		g_string_append_printf(str, " %s/s", rate);
+	}
+
+	/* once we have good data show an estimate of time remaining, preferring the
+	 * daemon estimate as that knows about the step weighting */
+	if (self->time_remaining > 0 && _fu_status_is_predictable(self->status)) {
+		self->last_estimate = self->time_remaining;
+		show_estimate = TRUE;
+	} else {
+		show_estimate = fu_console_estimate_ready(self, self->percentage);
+	}
+	if (show_estimate) {
 		g_autofree gchar *remaining = fu_console_time_remaining_str(self);
 		if (remaining != NULL)
 			g_string_append_printf(str, " %s…", remaining);
@@ -670,8 +686,22 @@ fu_console_set_progress(FuConsole *self, FwupdStatus status, guint percentage)
 	self->status = status;
 	self->percentage = percentage;
 
+	/* the rate only applies to the operation that has just finished */
+	if (status == FWUPD_STATUS_IDLE) {
+		self->throughput = 0;
+		self->time_remaining = 0;
+	}
+
 	/* dumb */
 	if (!self->interactive && percentage != 0 && status != FWUPD_STATUS_IDLE) {
+		if (self->throughput > 0) {
+			g_autofree gchar *rate = g_format_size(self->throughput);
+			g_printerr("%s: %u%% (%s/s)\n",
+				   fu_console_status_to_string(status),
+				   percentage,
+				   rate);
+			return;
+		}
 		g_printerr("%s: %u%%\n", fu_console_status_to_string(status), percentage);
 		return;
 	}
@@ -697,6 +727,22 @@ fu_console_set_progress(FuConsole *self, FwupdStatus status, guint percentage)
 	fu_console_refresh(self);
 }
 
+/**
+ * fu_console_set_progress_rate:
+ * @self: A #FuConsole
+ * @throughput: bytes per second, or 0 for unknown
+ * @time_remaining: seconds, or 0 for unknown
+ *
+ * Sets the transfer rate and time estimate shown with the next progress bar refresh.
+ **/
+void
+fu_console_set_progress_rate(FuConsole *self, guint64 throughput, guint time_remaining)
+{
+	g_return_if_fail(FU_IS_CONSOLE(self));
+	self->throughput = throughput;
+	self->time_remaining = time_remaining;
+}
+
 /**
  * fu_console_set_interactive:
  * @self: A #FuConsole
@@ -60,6 +60,8 @@ fu_console_beep(FuConsole *self, guint count);
 void
 fu_console_set_progress(FuConsole *self, FwupdStatus status, guint percentage);
 void
+fu_console_set_progress_rate(FuConsole *self, guint64 throughput, guint time_remaining);
+void
 fu_console_set_status_length(FuConsole *self, guint len);
 void
 fu_console_set_percentage_length(FuConsole *self, guint len);
@@ -0,0 +1,30 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * SPDX-License-Identifier: LGPL-2.1+
+ */
+
+#pragma once
+
+#include <gio/gio.h>
+
+#include "fu-daemon.h"
+#include "fu-engine.h"
+
+void
+fu_daemon_set_connection(FuDaemon *self, GDBusConnection *connection);
+void
+fu_daemon_set_engine(FuDaemon *self, FuEngine *engine);
+void
+fu_daemon_install_begin(FuDaemon *self);
+void
+fu_daemon_install_end(FuDaemon *self);
+void
+fu_daemon_track_sender(FuDaemon *self, const gchar *sender);
+gboolean
+fu_daemon_has_sender(FuDaemon *self, const gchar *sender);
+gboolean
+fu_daemon_set_sender_uid(FuDaemon *self,
+			 const gchar *sender,
+			 guint calling_uid,
+			 GError **error) G_GNUC_WARN_UNUSED_RESULT;
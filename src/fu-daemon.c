@@ -25,7 +25,7 @@
 #include "fwupd-security-attr-private.h"
 
 #include "fu-bios-settings-private.h"
-#include "fu-daemon.h"
+#include "fu-daemon-private.h"
 #include "fu-device-private.h"
 #include "fu-engine.h"
 #include "fu-polkit-authority.h"
@@ -35,23 +35,49 @@
 static void
 fu_daemon_finalize(GObject *obj);
 
+/* shared with the GDBus worker thread, so only accessed with the mutex held */
+typedef struct {
+	GMutex mutex;
+	gboolean enabled;
+	GVariant *devices;	     /* (aa{sv}), or NULL if there are none */
+	GVariant *devices_trusted;   /* (aa{sv}), or NULL if there are none */
+	GVariant *remotes;	     /* (aa{sv}), or NULL */
+	GVariant *security_attrs;    /* (aa{sv}), or NULL */
+	GHashTable *properties;	     /* name:GVariant */
+	GHashTable *trusted_senders; /* sender */
+	GPtrArray *messages;	     /* of GDBusMessage, applied when the install completes */
+} FuDaemonSnapshot;
+
+typedef struct {
+	FwupdDevice *device;
+	gint priority;
+} FuDaemonSnapshotDevice;
+
 struct _FuDaemon {
 	GObject parent_instance;
 	GDBusConnection *connection;
+	guint filter_id;
 	GDBusNodeInfo *introspection_daemon;
 	GDBusProxy *proxy_uid;
 	GMainLoop *loop;
 	GHashTable *sender_items; /* sender:FuDaemonSenderItem */
 	FuPolkitAuthority *authority;
-	FwupdStatus status; /* last emitted */
-	guint percentage;   /* last emitted */
+	FwupdStatus status;   /* last emitted */
+	guint percentage;     /* last emitted */
+	guint64 throughput;   /* last emitted */
+	guint time_remaining; /* last emitted */
 	guint owner_id;
 	guint process_quit_id;
+	guint credentials_cache_hits;
+	guint credentials_cache_misses;
 	FuEngine *engine;
 	gboolean update_in_progress;
 	gboolean pending_stop;
 	FuDaemonMachineKind machine_kind;
 	GPtrArray *system_inhibits;
+	GPtrArray *pending_invocations; /* of GDBusMethodInvocation */
+	GPtrArray *snapshot_devices;	/* of FuDaemonSnapshotDevice */
+	FuDaemonSnapshot *snapshot;
 };
 
 G_DEFINE_TYPE(FuDaemon, fu_daemon, G_TYPE_OBJECT)
@@ -77,6 +103,10 @@ fu_daemon_stop(FuDaemon *self)
 typedef struct {
 	FwupdFeatureFlags feature_flags;
 	GHashTable *hints; /* str:str */
+	gboolean credentials_valid;
+	guint calling_uid;
+	gboolean trusted;
+	guint watch_id;
 } FuDaemonSenderItem;
 
 static FuDaemonMachineKind
@@ -92,72 +122,402 @@ fu_daemon_machine_kind_from_string(const gchar *kind)
 }
 
 static void
-fu_daemon_engine_changed_cb(FuEngine *engine, FuDaemon *self)
+fu_daemon_config_changed_cb(FuEngineConfig *config, FuDaemon *self)
 {
-	/* not yet connected */
-	if (self->connection == NULL)
+	GHashTableIter iter;
+	gpointer value;
+
+	/* the list of trusted UIDs may have changed */
+	g_hash_table_iter_init(&iter, self->sender_items);
+	while (g_hash_table_iter_next(&iter, NULL, &value)) {
+		FuDaemonSenderItem *sender_item = (FuDaemonSenderItem *)value;
+		if (!sender_item->credentials_valid)
+			continue;
+		sender_item->trusted =
+		    fu_engine_is_uid_trusted(self->engine, sender_item->calling_uid);
+	}
+}
+
+static FuDaemonSnapshot *
+fu_daemon_snapshot_new(void)
+{
+	FuDaemonSnapshot *snapshot = g_atomic_rc_box_new0(FuDaemonSnapshot);
+	g_mutex_init(&snapshot->mutex);
+	snapshot->properties = g_hash_table_new_full(g_str_hash,
+						     g_str_equal,
+						     g_free,
+						     (GDestroyNotify)g_variant_unref);
+	snapshot->trusted_senders = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+	snapshot->messages = g_ptr_array_new_with_free_func((GDestroyNotify)g_object_unref);
+	return snapshot;
+}
+
+/* must be called with the mutex held */
+static void
+fu_daemon_snapshot_reset(FuDaemonSnapshot *snapshot)
+{
+	snapshot->enabled = FALSE;
+	g_clear_pointer(&snapshot->devices, g_variant_unref);
+	g_clear_pointer(&snapshot->devices_trusted, g_variant_unref);
+	g_clear_pointer(&snapshot->remotes, g_variant_unref);
+	g_clear_pointer(&snapshot->security_attrs, g_variant_unref);
+	g_hash_table_remove_all(snapshot->properties);
+	g_hash_table_remove_all(snapshot->trusted_senders);
+	g_ptr_array_set_size(snapshot->messages, 0);
+}
+
+static void
+fu_daemon_snapshot_free_cb(gpointer data)
+{
+	FuDaemonSnapshot *snapshot = (FuDaemonSnapshot *)data;
+	fu_daemon_snapshot_reset(snapshot);
+	g_hash_table_unref(snapshot->properties);
+	g_hash_table_unref(snapshot->trusted_senders);
+	g_ptr_array_unref(snapshot->messages);
+	g_mutex_clear(&snapshot->mutex);
+}
+
+static void
+fu_daemon_snapshot_unref(gpointer data)
+{
+	g_atomic_rc_box_release_full(data, fu_daemon_snapshot_free_cb);
+}
+
+static GVariant *
+fu_daemon_snapshot_get_property(FuDaemonSnapshot *snapshot, const gchar *property_name)
+{
+	GVariant *value;
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&snapshot->mutex);
+
+	value = g_hash_table_lookup(snapshot->properties, property_name);
+	if (value == NULL)
+		return NULL;
+	return g_variant_ref(value);
+}
+
+static void
+fu_daemon_snapshot_set_property(FuDaemonSnapshot *snapshot,
+				const gchar *property_name,
+				GVariant *value)
+{
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&snapshot->mutex);
+
+	if (!snapshot->enabled)
 		return;
-	g_dbus_connection_emit_signal(self->connection,
-				      NULL,
-				      FWUPD_DBUS_PATH,
-				      FWUPD_DBUS_INTERFACE,
-				      "Changed",
-				      NULL,
-				      NULL);
+	g_hash_table_insert(snapshot->properties,
+			    g_strdup(property_name),
+			    g_variant_ref_sink(value));
 }
 
 static void
-fu_daemon_engine_device_added_cb(FuEngine *engine, FuDevice *device, FuDaemon *self)
+fu_daemon_snapshot_add_trusted_sender(FuDaemonSnapshot *snapshot, const gchar *sender)
 {
-	GVariant *val;
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&snapshot->mutex);
 
-	/* not yet connected */
-	if (self->connection == NULL)
+	if (!snapshot->enabled)
 		return;
-	val = fwupd_device_to_variant(FWUPD_DEVICE(device));
-	g_dbus_connection_emit_signal(self->connection,
-				      NULL,
-				      FWUPD_DBUS_PATH,
-				      FWUPD_DBUS_INTERFACE,
-				      "DeviceAdded",
-				      g_variant_new_tuple(&val, 1),
-				      NULL);
+	g_hash_table_add(snapshot->trusted_senders, g_strdup(sender));
+}
+
+/* returns TRUE if the method call can be answered, using @body or @error */
+static gboolean
+fu_daemon_snapshot_lookup(FuDaemonSnapshot *snapshot,
+			  GDBusMessage *message,
+			  GVariant **body,
+			  GError **error)
+{
+	const gchar *interface_name = g_dbus_message_get_interface(message);
+	const gchar *member = g_dbus_message_get_member(message);
+	const gchar *sender = g_dbus_message_get_sender(message);
+	GVariant *parameters = g_dbus_message_get_body(message);
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&snapshot->mutex);
+
+	/* not installing */
+	if (!snapshot->enabled)
+		return FALSE;
+
+	if (g_strcmp0(interface_name, FWUPD_DBUS_INTERFACE) == 0) {
+		if (g_strcmp0(member, "GetDevices") == 0) {
+			GVariant *devices = snapshot->devices;
+
+			/* using FWUPD_DBUS_SOCKET, or the credentials were already checked */
+			if (sender == NULL ||
+			    g_hash_table_contains(snapshot->trusted_senders, sender))
+				devices = snapshot->devices_trusted;
+			if (devices == NULL) {
+				g_set_error_literal(error,
+						    FWUPD_ERROR,
+						    FWUPD_ERROR_NOTHING_TO_DO,
+						    "No detected devices");
+				return TRUE;
+			}
+			*body = g_variant_ref(devices);
+			return TRUE;
+		}
+		if (g_strcmp0(member, "GetRemotes") == 0 && snapshot->remotes != NULL) {
+			*body = g_variant_ref(snapshot->remotes);
+			return TRUE;
+		}
+		if (g_strcmp0(member, "GetHostSecurityAttrs") == 0 &&
+		    snapshot->security_attrs != NULL) {
+			*body = g_variant_ref(snapshot->security_attrs);
+			return TRUE;
+		}
+
+		/* clients set these when connecting, so accept them now and apply them later */
+		if ((g_strcmp0(member, "SetFeatureFlags") == 0 && parameters != NULL &&
+		     g_variant_is_of_type(parameters, G_VARIANT_TYPE("(t)"))) ||
+		    (g_strcmp0(member, "SetHints") == 0 && parameters != NULL &&
+		     g_variant_is_of_type(parameters, G_VARIANT_TYPE("(a{ss})")))) {
+			g_ptr_array_add(snapshot->messages, g_object_ref(message));
+			return TRUE;
+		}
+		return FALSE;
+	}
+	if (g_strcmp0(interface_name, "org.freedesktop.DBus.Properties") == 0) {
+		if (g_strcmp0(member, "Get") == 0 && parameters != NULL &&
+		    g_variant_is_of_type(parameters, G_VARIANT_TYPE("(ss)"))) {
+			const gchar *iface = NULL;
+			const gchar *property_name = NULL;
+			GVariant *value;
+
+			g_variant_get(parameters, "(&s&s)", &iface, &property_name);
+			if (g_strcmp0(iface, FWUPD_DBUS_INTERFACE) != 0)
+				return FALSE;
+			value = g_hash_table_lookup(snapshot->properties, property_name);
+			if (value == NULL)
+				return FALSE;
+			*body = g_variant_ref_sink(g_variant_new("(v)", value));
+			return TRUE;
+		}
+		if (g_strcmp0(member, "GetAll") == 0 && parameters != NULL &&
+		    g_variant_is_of_type(parameters, G_VARIANT_TYPE("(s)"))) {
+			GHashTableIter iter;
+			GVariantBuilder builder;
+			const gchar *iface = NULL;
+			gpointer key;
+			gpointer value;
+
+			g_variant_get(parameters, "(&s)", &iface);
+			if (g_strcmp0(iface, FWUPD_DBUS_INTERFACE) != 0)
+				return FALSE;
+			g_variant_builder_init(&builder, G_VARIANT_TYPE_VARDICT);
+			g_hash_table_iter_init(&iter, snapshot->properties);
+			while (g_hash_table_iter_next(&iter, &key, &value))
+				g_variant_builder_add(&builder, "{sv}", key, value);
+			*body = g_variant_ref_sink(g_variant_new("(a{sv})", &builder));
+			return TRUE;
+		}
+	}
+	return FALSE;
+}
+
+/* runs on the GDBus worker thread, so the main thread can be blocked by the install */
+static GDBusMessage *
+fu_daemon_snapshot_filter_cb(GDBusConnection *connection,
+			     GDBusMessage *message,
+			     gboolean incoming,
+			     gpointer user_data)
+{
+	FuDaemonSnapshot *snapshot = (FuDaemonSnapshot *)user_data;
+	g_autoptr(GDBusMessage) reply = NULL;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GError) error_send = NULL;
+	g_autoptr(GVariant) body = NULL;
+
+	/* only method calls to the daemon object */
+	if (!incoming ||
+	    g_dbus_message_get_message_type(message) != G_DBUS_MESSAGE_TYPE_METHOD_CALL ||
+	    g_strcmp0(g_dbus_message_get_path(message), FWUPD_DBUS_PATH) != 0)
+		return message;
+	if (!fu_daemon_snapshot_lookup(snapshot, message, &body, &error))
+		return message;
+	if (error != NULL) {
+		g_autofree gchar *error_name = g_dbus_error_encode_gerror(error);
+		reply =
+		    g_dbus_message_new_method_error_literal(message, error_name, error->message);
+	} else {
+		reply = g_dbus_message_new_method_reply(message);
+		if (body != NULL)
+			g_dbus_message_set_body(reply, body);
+	}
+	if (!g_dbus_connection_send_message(connection,
+					    reply,
+					    G_DBUS_SEND_MESSAGE_FLAGS_NONE,
+					    NULL,
+					    &error_send))
+		g_debug("failed to reply from snapshot: %s", error_send->message);
+
+	/* answered, so do not dispatch to the main thread */
+	g_object_unref(message);
+	return NULL;
 }
 
 static void
-fu_daemon_engine_device_removed_cb(FuEngine *engine, FuDevice *device, FuDaemon *self)
+fu_daemon_snapshot_device_free(FuDaemonSnapshotDevice *item)
 {
-	GVariant *val;
+	g_object_unref(item->device);
+	g_free(item);
+}
+
+/* same order as fu_engine_get_devices() */
+static gint
+fu_daemon_snapshot_device_sort_cb(gconstpointer a, gconstpointer b)
+{
+	FuDaemonSnapshotDevice *item_a = *((FuDaemonSnapshotDevice **)a);
+	FuDaemonSnapshotDevice *item_b = *((FuDaemonSnapshotDevice **)b);
+	const gchar *name_a = fwupd_device_get_name(item_a->device);
+	const gchar *name_b = fwupd_device_get_name(item_b->device);
+
+	if (item_a->priority > item_b->priority)
+		return -1;
+	if (item_a->priority < item_b->priority)
+		return 1;
+	if (g_strcmp0(name_a, name_b) > 0)
+		return 1;
+	if (g_strcmp0(name_a, name_b) < 0)
+		return -1;
+	return 0;
+}
+
+static GVariant *
+fu_daemon_snapshot_devices_to_variant(GPtrArray *items, FwupdDeviceFlags flags)
+{
+	GVariantBuilder builder;
+
+	if (items->len == 0)
+		return NULL;
+	g_variant_builder_init(&builder, G_VARIANT_TYPE("aa{sv}"));
+	for (guint i = 0; i < items->len; i++) {
+		FuDaemonSnapshotDevice *item = g_ptr_array_index(items, i);
+		g_variant_builder_add_value(&builder,
+					    fwupd_device_to_variant_full(item->device, flags));
+	}
+	return g_variant_ref_sink(g_variant_new("(aa{sv})", &builder));
+}
+
+static void
+fu_daemon_snapshot_rebuild_devices(FuDaemon *self)
+{
+	FwupdDeviceFlags flags = FWUPD_DEVICE_FLAG_NONE;
+	GVariant *devices;
+	GVariant *devices_trusted;
+	g_autoptr(GMutexLocker) locker = NULL;
+
+	/* override when required */
+	if (fu_engine_config_get_show_device_private(fu_engine_get_config(self->engine)))
+		flags |= FWUPD_DEVICE_FLAG_TRUSTED;
+	g_ptr_array_sort(self->snapshot_devices, fu_daemon_snapshot_device_sort_cb);
+	devices = fu_daemon_snapshot_devices_to_variant(self->snapshot_devices, flags);
+	devices_trusted = fu_daemon_snapshot_devices_to_variant(self->snapshot_devices,
+							       FWUPD_DEVICE_FLAG_TRUSTED);
+
+	locker = g_mutex_locker_new(&self->snapshot->mutex);
+	g_clear_pointer(&self->snapshot->devices, g_variant_unref);
+	g_clear_pointer(&self->snapshot->devices_trusted, g_variant_unref);
+	self->snapshot->devices = devices;
+	self->snapshot->devices_trusted = devices_trusted;
+}
+
+static void
+fu_daemon_snapshot_add_device(FuDaemon *self, FuDevice *device)
+{
+	FuDaemonSnapshotDevice *item;
+	FwupdDevice *device_copy;
+	g_autoptr(GVariant) val = NULL;
+
+	/* copy rather than ref, as the install continues to modify the real device */
+	val = g_variant_ref_sink(
+	    fwupd_device_to_variant_full(FWUPD_DEVICE(device), FWUPD_DEVICE_FLAG_TRUSTED));
+	device_copy = fwupd_device_from_variant(val);
+	if (device_copy == NULL)
+		return;
+	item = g_new0(FuDaemonSnapshotDevice, 1);
+	item->device = device_copy;
+	item->priority = fu_device_get_priority(device);
+	g_ptr_array_add(self->snapshot_devices, item);
+}
+
+static void
+fu_daemon_snapshot_update_device(FuDaemon *self, const gchar *signal_name, FuDevice *device)
+{
+	/* only kept while installing */
+	if (self->snapshot_devices == NULL)
+		return;
+	for (guint i = 0; i < self->snapshot_devices->len; i++) {
+		FuDaemonSnapshotDevice *item = g_ptr_array_index(self->snapshot_devices, i);
+		if (g_strcmp0(fwupd_device_get_id(item->device),
+			      fwupd_device_get_id(FWUPD_DEVICE(device))) == 0) {
+			g_ptr_array_remove_index(self->snapshot_devices, i);
+			break;
+		}
+	}
+	if (g_strcmp0(signal_name, "DeviceRemoved") != 0)
+		fu_daemon_snapshot_add_device(self, device);
+	fu_daemon_snapshot_rebuild_devices(self);
+}
 
+static void
+fu_daemon_emit_signal(FuDaemon *self,
+		      const gchar *interface_name,
+		      const gchar *signal_name,
+		      GVariant *parameters)
+{
 	/* not yet connected */
-	if (self->connection == NULL)
+	if (self->connection == NULL) {
+		if (parameters != NULL)
+			g_variant_unref(g_variant_ref_sink(parameters));
 		return;
-	val = fwupd_device_to_variant(FWUPD_DEVICE(device));
+	}
 	g_dbus_connection_emit_signal(self->connection,
 				      NULL,
 				      FWUPD_DBUS_PATH,
-				      FWUPD_DBUS_INTERFACE,
-				      "DeviceRemoved",
-				      g_variant_new_tuple(&val, 1),
+				      interface_name,
+				      signal_name,
+				      parameters,
 				      NULL);
 }
 
 static void
-fu_daemon_engine_device_changed_cb(FuEngine *engine, FuDevice *device, FuDaemon *self)
+fu_daemon_emit_device_signal(FuDaemon *self, const gchar *signal_name, FuDevice *device)
 {
 	GVariant *val;
 
+	/* keep the snapshot in sync with what clients are told */
+	fu_daemon_snapshot_update_device(self, signal_name, device);
+
 	/* not yet connected */
 	if (self->connection == NULL)
 		return;
 	val = fwupd_device_to_variant(FWUPD_DEVICE(device));
-	g_dbus_connection_emit_signal(self->connection,
-				      NULL,
-				      FWUPD_DBUS_PATH,
-				      FWUPD_DBUS_INTERFACE,
-				      "DeviceChanged",
-				      g_variant_new_tuple(&val, 1),
-				      NULL);
+	fu_daemon_emit_signal(self,
+			      FWUPD_DBUS_INTERFACE,
+			      signal_name,
+			      g_variant_new_tuple(&val, 1));
+}
+
+static void
+fu_daemon_engine_changed_cb(FuEngine *engine, FuDaemon *self)
+{
+	fu_daemon_emit_signal(self, FWUPD_DBUS_INTERFACE, "Changed", NULL);
+}
+
+static void
+fu_daemon_engine_device_added_cb(FuEngine *engine, FuDevice *device, FuDaemon *self)
+{
+	fu_daemon_emit_device_signal(self, "DeviceAdded", device);
+}
+
+static void
+fu_daemon_engine_device_removed_cb(FuEngine *engine, FuDevice *device, FuDaemon *self)
+{
+	fu_daemon_emit_device_signal(self, "DeviceRemoved", device);
+}
+
+static void
+fu_daemon_engine_device_changed_cb(FuEngine *engine, FuDevice *device, FuDaemon *self)
+{
+	fu_daemon_emit_device_signal(self, "DeviceChanged", device);
 }
 
 static void
@@ -169,13 +529,10 @@ fu_daemon_engine_device_request_cb(FuEngine *engine, FwupdRequest *request, FuDa
 	if (self->connection == NULL)
 		return;
 	val = fwupd_request_to_variant(FWUPD_REQUEST(request));
-	g_dbus_connection_emit_signal(self->connection,
-				      NULL,
-				      FWUPD_DBUS_PATH,
-				      FWUPD_DBUS_INTERFACE,
-				      "DeviceRequest",
-				      g_variant_new_tuple(&val, 1),
-				      NULL);
+	fu_daemon_emit_signal(self,
+			      FWUPD_DBUS_INTERFACE,
+			      "DeviceRequest",
+			      g_variant_new_tuple(&val, 1));
 }
 
 static void
@@ -186,26 +543,18 @@ fu_daemon_emit_property_changed(FuDaemon *self,
 	GVariantBuilder builder;
 	GVariantBuilder invalidated_builder;
 
-	/* not yet connected */
-	if (self->connection == NULL) {
-		g_variant_unref(g_variant_ref_sink(property_value));
-		return;
-	}
+	/* keep the value returned while installing up to date */
+	fu_daemon_snapshot_set_property(self->snapshot, property_name, property_value);
 
 	/* build the dict */
 	g_variant_builder_init(&invalidated_builder, G_VARIANT_TYPE("as"));
 	g_variant_builder_init(&builder, G_VARIANT_TYPE_VARDICT);
 	g_variant_builder_add(&builder, "{sv}", property_name, property_value);
-	g_dbus_connection_emit_signal(
-	    self->connection,
-	    NULL,
-	    FWUPD_DBUS_PATH,
+	fu_daemon_emit_signal(
+	    self,
 	    "org.freedesktop.DBus.Properties",
 	    "PropertiesChanged",
-	    g_variant_new("(sa{sv}as)", FWUPD_DBUS_INTERFACE, &builder, &invalidated_builder),
-	    NULL);
-	g_variant_builder_clear(&builder);
-	g_variant_builder_clear(&invalidated_builder);
+	    g_variant_new("(sa{sv}as)", FWUPD_DBUS_INTERFACE, &builder, &invalidated_builder));
 }
 
 static void
@@ -231,13 +580,11 @@ fu_daemon_engine_status_changed_cb(FuEngine *engine, FwupdStatus status, FuDaemo
 }
 
 static FuEngineRequest *
-fu_daemon_create_request(FuDaemon *self, const gchar *sender, GError **error)
+fu_daemon_create_request(FuDaemon *self, const gchar *sender)
 {
 	FuDaemonSenderItem *sender_item;
 	FwupdDeviceFlags device_flags = FWUPD_DEVICE_FLAG_NONE;
-	guint calling_uid = 0;
 	g_autoptr(FuEngineRequest) request = fu_engine_request_new();
-	g_autoptr(GVariant) value = NULL;
 
 	/* if using FWUPD_DBUS_SOCKET... */
 	if (sender == NULL) {
@@ -252,23 +599,11 @@ fu_daemon_create_request(FuDaemon *self, const gchar *sender, GError **error)
 		if (locale != NULL)
 			fu_engine_request_set_locale(request, locale);
 		fu_engine_request_set_feature_flags(request, sender_item->feature_flags);
-	}
 
-	/* are we root and therefore trusted? */
-	value = g_dbus_proxy_call_sync(self->proxy_uid,
-				       "GetConnectionUnixUser",
-				       g_variant_new("(s)", sender),
-				       G_DBUS_CALL_FLAGS_NONE,
-				       2000,
-				       NULL,
-				       error);
-	if (value == NULL) {
-		g_prefix_error(error, "failed to read user id of caller: ");
-		return NULL;
+		/* are we root and therefore trusted? */
+		if (sender_item->trusted)
+			device_flags |= FWUPD_DEVICE_FLAG_TRUSTED;
 	}
-	g_variant_get(value, "(u)", &calling_uid);
-	if (fu_engine_is_uid_trusted(self->engine, calling_uid))
-		device_flags |= FWUPD_DEVICE_FLAG_TRUSTED;
 	fu_engine_request_set_device_flags(request, device_flags);
 
 	/* success */
@@ -291,8 +626,8 @@ fu_daemon_device_array_to_variant(FuDaemon *self,
 	if (fu_engine_config_get_show_device_private(fu_engine_get_config(self->engine)))
 		flags |= FWUPD_DEVICE_FLAG_TRUSTED;
 	for (guint i = 0; i < devices->len; i++) {
-		FuDevice *device = g_ptr_array_index(devices, i);
-		GVariant *tmp = fwupd_device_to_variant_full(FWUPD_DEVICE(device), flags);
+		FwupdDevice *device = g_ptr_array_index(devices, i);
+		GVariant *tmp = fwupd_device_to_variant_full(device, flags);
 		g_variant_builder_add_value(&builder, tmp);
 	}
 	return g_variant_new("(aa{sv})", &builder);
@@ -337,6 +672,25 @@ fu_daemon_remote_array_to_variant(GPtrArray *remotes)
 	return g_variant_new("(aa{sv})", &builder);
 }
 
+/* returns TRUE if the method call was answered */
+static gboolean
+fu_daemon_method_call_snapshot(FuDaemon *self, GDBusMethodInvocation *invocation)
+{
+	GDBusMessage *message = g_dbus_method_invocation_get_message(invocation);
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GVariant) body = NULL;
+
+	if (!fu_daemon_snapshot_lookup(self->snapshot, message, &body, &error))
+		return FALSE;
+	g_debug("Called %s() using snapshot", g_dbus_method_invocation_get_method_name(invocation));
+	if (error != NULL) {
+		g_dbus_method_invocation_return_gerror(invocation, error);
+		return TRUE;
+	}
+	g_dbus_method_invocation_return_value(invocation, body);
+	return TRUE;
+}
+
 #ifdef HAVE_GIO_UNIX
 static GVariant *
 fu_daemon_result_array_to_variant(GPtrArray *results)
@@ -564,7 +918,25 @@ fu_daemon_modify_config_cb(GObject *source, GAsyncResult *res, gpointer user_dat
 static void
 fu_daemon_progress_percentage_changed_cb(FuProgress *progress, guint percentage, FuDaemon *self)
 {
-	/* sanity check */
+	guint64 throughput = fu_progress_get_throughput(progress);
+	guint time_remaining = fu_progress_get_time_remaining(progress);
+
+	/* only emit what changed */
+	if (self->throughput != throughput) {
+		self->throughput = throughput;
+		g_debug("Emitting PropertyChanged('Throughput'='%" G_GUINT64_FORMAT "')",
+			throughput);
+		fu_daemon_emit_property_changed(self,
+						"Throughput",
+						g_variant_new_uint64(throughput));
+	}
+	if (self->time_remaining != time_remaining) {
+		self->time_remaining = time_remaining;
+		g_debug("Emitting PropertyChanged('TimeRemaining'='%us')", time_remaining);
+		fu_daemon_emit_property_changed(self,
+						"TimeRemaining",
+						g_variant_new_uint32(time_remaining));
+	}
 	if (self->percentage == percentage)
 		return;
 	self->percentage = percentage;
@@ -573,6 +945,20 @@ fu_daemon_progress_percentage_changed_cb(FuProgress *progress, guint percentage,
 	fu_daemon_emit_property_changed(self, "Percentage", g_variant_new_uint32(percentage));
 }
 
+/* the rate only applies to the operation that has just finished */
+static void
+fu_daemon_progress_reset_rate(FuDaemon *self)
+{
+	if (self->throughput != 0) {
+		self->throughput = 0;
+		fu_daemon_emit_property_changed(self, "Throughput", g_variant_new_uint64(0));
+	}
+	if (self->time_remaining != 0) {
+		self->time_remaining = 0;
+		fu_daemon_emit_property_changed(self, "TimeRemaining", g_variant_new_uint32(0));
+	}
+}
+
 static void
 fu_daemon_progress_status_changed_cb(FuProgress *progress, FwupdStatus status, FuDaemon *self)
 {
@@ -693,14 +1079,42 @@ fu_daemon_authorize_install_cb(GObject *source, GAsyncResult *res, gpointer user
 	fu_daemon_authorize_install_queue(g_steal_pointer(&helper));
 }
 
+static void
+fu_daemon_method_call_dispatch(FuDaemon *self, GDBusMethodInvocation *invocation);
+
+static void
+fu_daemon_fail_pending_invocations(FuDaemon *self)
+{
+	for (guint i = 0; i < self->pending_invocations->len; i++) {
+		GDBusMethodInvocation *invocation = g_ptr_array_index(self->pending_invocations, i);
+		g_dbus_method_invocation_return_error_literal(g_object_ref(invocation),
+							      FWUPD_ERROR,
+							      FWUPD_ERROR_INTERNAL,
+							      "daemon is shutting down");
+	}
+	g_ptr_array_set_size(self->pending_invocations, 0);
+}
+
+static void
+fu_daemon_dispatch_pending_invocations(FuDaemon *self)
+{
+	g_autoptr(GPtrArray) invocations = g_steal_pointer(&self->pending_invocations);
+
+	self->pending_invocations = g_ptr_array_new_with_free_func((GDestroyNotify)g_object_unref);
+	for (guint i = 0; i < invocations->len; i++) {
+		GDBusMethodInvocation *invocation = g_ptr_array_index(invocations, i);
+		fu_daemon_method_call_dispatch(self, g_object_ref(invocation));
+	}
+}
+
 static void
 fu_daemon_authorize_install_queue(FuMainAuthHelper *helper_ref)
 {
 	FuDaemon *self = helper_ref->self;
+	gboolean ret;
 	g_autoptr(FuMainAuthHelper) helper = helper_ref;
-	g_autoptr(GError) error = NULL;
 	g_autoptr(FuProgress) progress = fu_progress_new(G_STRLOC);
-	gboolean ret;
+	g_autoptr(GError) error = NULL;
 
 	/* still more things to to authenticate */
 	if (helper->action_ids->len > 0) {
@@ -721,36 +1135,49 @@ fu_daemon_authorize_install_queue(FuMainAuthHelper *helper_ref)
 		return;
 	}
 
+	/* another install was authenticated while this one was running */
+	if (self->update_in_progress) {
+		g_dbus_method_invocation_return_error_literal(helper->invocation,
+							      FWUPD_ERROR,
+							      FWUPD_ERROR_ALREADY_PENDING,
+							      "an update is already in progress");
+		return;
+	}
+
 	/* all authenticated, so install all the things */
 	fu_progress_set_profile(progress, g_getenv("FWUPD_VERBOSE") != NULL);
 	g_signal_connect(FU_PROGRESS(progress),
 			 "percentage-changed",
 			 G_CALLBACK(fu_daemon_progress_percentage_changed_cb),
-			 helper->self);
+			 self);
 	g_signal_connect(FU_PROGRESS(progress),
 			 "status-changed",
 			 G_CALLBACK(fu_daemon_progress_status_changed_cb),
-			 helper->self);
+			 self);
 
-	/* all authenticated, so install all the things */
-	self->update_in_progress = TRUE;
-	ret = fu_engine_install_releases(helper->self->engine,
+	/* the install blocks the main thread, so read-only queries are answered from a snapshot
+	 * by the GDBus worker thread rather than re-entering the engine mid-install */
+	fu_daemon_install_begin(self);
+	ret = fu_engine_install_releases(self->engine,
 					 helper->request,
 					 helper->releases,
 					 helper->blob_cab,
 					 progress,
 					 helper->flags,
 					 &error);
-	self->update_in_progress = FALSE;
-	if (self->pending_stop)
-		g_main_loop_quit(self->loop);
-	if (!ret) {
+	fu_daemon_install_end(self);
+	if (!ret)
 		g_dbus_method_invocation_return_gerror(helper->invocation, error);
+	else
+		g_dbus_method_invocation_return_value(helper->invocation, NULL);
+	if (self->pending_stop) {
+		fu_daemon_fail_pending_invocations(self);
+		g_main_loop_quit(self->loop);
 		return;
 	}
 
-	/* success */
-	g_dbus_method_invocation_return_value(helper->invocation, NULL);
+	/* run anything that could not be answered from the snapshot */
+	fu_daemon_dispatch_pending_invocations(self);
 }
 #endif /* HAVE_GIO_UNIX */
 
@@ -944,6 +1371,16 @@ fu_daemon_install_with_helper(FuMainAuthHelper *helper_ref, GError **error)
 }
 #endif /* HAVE_GIO_UNIX */
 
+static void
+fu_daemon_sender_vanished_cb(GDBusConnection *connection, const gchar *name, gpointer user_data)
+{
+	FuDaemon *self = FU_DAEMON(user_data);
+
+	/* unique names are never reused, so drop anything cached for the sender */
+	if (g_hash_table_remove(self->sender_items, name))
+		g_debug("removed sender %s", name);
+}
+
 static FuDaemonSenderItem *
 fu_daemon_ensure_sender_item(FuDaemon *self, const gchar *sender)
 {
@@ -956,11 +1393,277 @@ fu_daemon_ensure_sender_item(FuDaemon *self, const gchar *sender)
 	if (sender_item == NULL) {
 		sender_item = g_new0(FuDaemonSenderItem, 1);
 		sender_item->hints = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
+
+		/* only wake up when this sender disconnects, not for every name on the bus */
+		if (sender[0] != '\0' && self->connection != NULL) {
+			sender_item->watch_id =
+			    g_bus_watch_name_on_connection(self->connection,
+							   sender,
+							   G_BUS_NAME_WATCHER_FLAGS_NONE,
+							   NULL,
+							   fu_daemon_sender_vanished_cb,
+							   self,
+							   NULL);
+		}
 		g_hash_table_insert(self->sender_items, g_strdup(sender), sender_item);
 	}
 	return sender_item;
 }
 
+void
+fu_daemon_track_sender(FuDaemon *self, const gchar *sender)
+{
+	g_return_if_fail(FU_IS_DAEMON(self));
+	fu_daemon_ensure_sender_item(self, sender);
+}
+
+gboolean
+fu_daemon_has_sender(FuDaemon *self, const gchar *sender)
+{
+	g_return_val_if_fail(FU_IS_DAEMON(self), FALSE);
+	return g_hash_table_contains(self->sender_items, sender != NULL ? sender : "");
+}
+
+/* the sender may have vanished while the credentials were being looked up */
+gboolean
+fu_daemon_set_sender_uid(FuDaemon *self, const gchar *sender, guint calling_uid, GError **error)
+{
+	FuDaemonSenderItem *sender_item;
+
+	g_return_val_if_fail(FU_IS_DAEMON(self), FALSE);
+	g_return_val_if_fail(sender != NULL, FALSE);
+	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+
+	sender_item = g_hash_table_lookup(self->sender_items, sender);
+	if (sender_item == NULL) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_NOT_FOUND,
+			    "caller %s has disconnected",
+			    sender);
+		return FALSE;
+	}
+
+	/* cache until the sender vanishes from the bus */
+	sender_item->calling_uid = calling_uid;
+	sender_item->trusted = fu_engine_is_uid_trusted(self->engine, calling_uid);
+	sender_item->credentials_valid = TRUE;
+	if (sender_item->trusted)
+		fu_daemon_snapshot_add_trusted_sender(self->snapshot, sender);
+	return TRUE;
+}
+
+void
+fu_daemon_set_connection(FuDaemon *self, GDBusConnection *connection)
+{
+	g_return_if_fail(FU_IS_DAEMON(self));
+
+	if (self->connection == connection)
+		return;
+	if (self->filter_id != 0) {
+		g_dbus_connection_remove_filter(self->connection, self->filter_id);
+		self->filter_id = 0;
+	}
+	g_set_object(&self->connection, connection);
+
+	/* the filter may outlive the daemon, so it holds its own reference */
+	if (connection != NULL) {
+		FuDaemonSnapshot *snapshot = g_atomic_rc_box_acquire(self->snapshot);
+		self->filter_id = g_dbus_connection_add_filter(connection,
+							       fu_daemon_snapshot_filter_cb,
+							       snapshot,
+							       fu_daemon_snapshot_unref);
+	}
+}
+
+static GVariant *
+fu_daemon_daemon_get_property(GDBusConnection *connection_,
+			      const gchar *sender,
+			      const gchar *object_path,
+			      const gchar *interface_name,
+			      const gchar *property_name,
+			      GError **error,
+			      gpointer user_data);
+
+static void
+fu_daemon_snapshot_ensure(FuDaemon *self)
+{
+	GHashTableIter iter;
+	gpointer key;
+	gpointer value;
+	g_autoptr(GMutexLocker) locker = NULL;
+	g_autoptr(GPtrArray) devices = NULL;
+	g_autoptr(GPtrArray) remotes = NULL;
+	g_autoptr(GVariant) remotes_val = NULL;
+	g_autoptr(GVariant) security_attrs_val = NULL;
+	g_autoptr(GHashTable) properties = g_hash_table_new_full(g_str_hash,
+								 g_str_equal,
+								 g_free,
+								 (GDestroyNotify)g_variant_unref);
+
+	g_clear_pointer(&self->snapshot_devices, g_ptr_array_unref);
+	self->snapshot_devices =
+	    g_ptr_array_new_with_free_func((GDestroyNotify)fu_daemon_snapshot_device_free);
+	devices = fu_engine_get_devices(self->engine, NULL);
+	for (guint i = 0; devices != NULL && i < devices->len; i++) {
+		FuDevice *device = g_ptr_array_index(devices, i);
+		fu_daemon_snapshot_add_device(self, device);
+	}
+	fu_daemon_snapshot_rebuild_devices(self);
+	remotes = fu_engine_get_remotes(self->engine, NULL);
+	if (remotes != NULL)
+		remotes_val = g_variant_ref_sink(fu_daemon_remote_array_to_variant(remotes));
+#ifdef HAVE_HSI
+	if (self->machine_kind == FU_DAEMON_MACHINE_KIND_PHYSICAL) {
+		g_autoptr(FuSecurityAttrs) attrs = fu_engine_get_host_security_attrs(self->engine);
+		security_attrs_val = g_variant_ref_sink(fu_security_attrs_to_variant(attrs));
+	}
+#endif
+	if (self->introspection_daemon != NULL) {
+		GDBusPropertyInfo **props = self->introspection_daemon->interfaces[0]->properties;
+		for (guint i = 0; props != NULL && props[i] != NULL; i++) {
+			GVariant *val = fu_daemon_daemon_get_property(self->connection,
+								      NULL,
+								      FWUPD_DBUS_PATH,
+								      FWUPD_DBUS_INTERFACE,
+								      props[i]->name,
+								      NULL,
+								      self);
+			if (val == NULL)
+				continue;
+			g_hash_table_insert(properties,
+					    g_strdup(props[i]->name),
+					    g_variant_ref_sink(val));
+		}
+	}
+
+	/* publish to the GDBus worker thread */
+	locker = g_mutex_locker_new(&self->snapshot->mutex);
+	self->snapshot->remotes = g_steal_pointer(&remotes_val);
+	self->snapshot->security_attrs = g_steal_pointer(&security_attrs_val);
+	g_hash_table_iter_init(&iter, properties);
+	while (g_hash_table_iter_next(&iter, &key, &value)) {
+		g_hash_table_insert(self->snapshot->properties,
+				    g_strdup(key),
+				    g_variant_ref((GVariant *)value));
+	}
+	g_hash_table_iter_init(&iter, self->sender_items);
+	while (g_hash_table_iter_next(&iter, &key, &value)) {
+		FuDaemonSenderItem *sender_item = (FuDaemonSenderItem *)value;
+		if (sender_item->credentials_valid && sender_item->trusted)
+			g_hash_table_add(self->snapshot->trusted_senders, g_strdup(key));
+	}
+	self->snapshot->enabled = TRUE;
+}
+
+void
+fu_daemon_install_begin(FuDaemon *self)
+{
+	g_return_if_fail(FU_IS_DAEMON(self));
+	g_return_if_fail(!self->update_in_progress);
+
+	fu_daemon_snapshot_ensure(self);
+	self->update_in_progress = TRUE;
+}
+
+static void
+fu_daemon_set_sender_feature_flags(FuDaemon *self, const gchar *sender, GVariant *parameters)
+{
+	FuDaemonSenderItem *sender_item;
+	guint64 feature_flags_u64 = 0;
+
+	g_variant_get(parameters, "(t)", &feature_flags_u64);
+	g_debug("setting feature flags %" G_GUINT64_FORMAT, feature_flags_u64);
+
+	/* old flags for the same sender will be automatically destroyed */
+	sender_item = fu_daemon_ensure_sender_item(self, sender);
+	sender_item->feature_flags = feature_flags_u64;
+}
+
+static void
+fu_daemon_set_sender_hints(FuDaemon *self, const gchar *sender, GVariant *parameters)
+{
+	FuDaemonSenderItem *sender_item;
+	const gchar *prop_key;
+	const gchar *prop_value;
+	g_autoptr(GVariantIter) iter = NULL;
+
+	g_variant_get(parameters, "(a{ss})", &iter);
+	sender_item = fu_daemon_ensure_sender_item(self, sender);
+	while (g_variant_iter_next(iter, "{&s&s}", &prop_key, &prop_value)) {
+		g_debug("got hint %s=%s", prop_key, prop_value);
+		g_hash_table_insert(sender_item->hints, g_strdup(prop_key), g_strdup(prop_value));
+	}
+}
+
+void
+fu_daemon_install_end(FuDaemon *self)
+{
+	g_autoptr(GPtrArray) messages = NULL;
+
+	g_return_if_fail(FU_IS_DAEMON(self));
+
+	/* stop answering from the snapshot */
+	g_mutex_lock(&self->snapshot->mutex);
+	messages = g_steal_pointer(&self->snapshot->messages);
+	self->snapshot->messages = g_ptr_array_new_with_free_func((GDestroyNotify)g_object_unref);
+	fu_daemon_snapshot_reset(self->snapshot);
+	g_mutex_unlock(&self->snapshot->mutex);
+	g_clear_pointer(&self->snapshot_devices, g_ptr_array_unref);
+	self->update_in_progress = FALSE;
+	fu_daemon_progress_reset_rate(self);
+
+	/* apply what clients set while the install was running */
+	for (guint i = 0; i < messages->len; i++) {
+		GDBusMessage *message = g_ptr_array_index(messages, i);
+		const gchar *member = g_dbus_message_get_member(message);
+		const gchar *sender = g_dbus_message_get_sender(message);
+		GVariant *parameters = g_dbus_message_get_body(message);
+		if (g_strcmp0(member, "SetFeatureFlags") == 0)
+			fu_daemon_set_sender_feature_flags(self, sender, parameters);
+		else if (g_strcmp0(member, "SetHints") == 0)
+			fu_daemon_set_sender_hints(self, sender, parameters);
+	}
+}
+
+void
+fu_daemon_set_engine(FuDaemon *self, FuEngine *engine)
+{
+	g_return_if_fail(FU_IS_DAEMON(self));
+	g_return_if_fail(FU_IS_ENGINE(engine));
+	g_return_if_fail(self->engine == NULL);
+
+	self->engine = g_object_ref(engine);
+	g_signal_connect(FU_ENGINE(self->engine),
+			 "changed",
+			 G_CALLBACK(fu_daemon_engine_changed_cb),
+			 self);
+	g_signal_connect(FU_ENGINE(self->engine),
+			 "device-added",
+			 G_CALLBACK(fu_daemon_engine_device_added_cb),
+			 self);
+	g_signal_connect(FU_ENGINE(self->engine),
+			 "device-removed",
+			 G_CALLBACK(fu_daemon_engine_device_removed_cb),
+			 self);
+	g_signal_connect(FU_ENGINE(self->engine),
+			 "device-changed",
+			 G_CALLBACK(fu_daemon_engine_device_changed_cb),
+			 self);
+	g_signal_connect(FU_ENGINE(self->engine),
+			 "device-request",
+			 G_CALLBACK(fu_daemon_engine_device_request_cb),
+			 self);
+	g_signal_connect(FU_ENGINE(self->engine),
+			 "status-changed",
+			 G_CALLBACK(fu_daemon_engine_status_changed_cb),
+			 self);
+	g_signal_connect(FU_ENGINE_CONFIG(fu_engine_get_config(self->engine)),
+			 "changed",
+			 G_CALLBACK(fu_daemon_config_changed_cb),
+			 self);
+}
+
 static gboolean
 fu_daemon_device_id_valid(const gchar *device_id, GError **error)
 {
@@ -1044,28 +1747,28 @@ fu_daemon_inhibit_name_vanished_cb(GDBusConnection *connection,
 }
 
 static void
-fu_daemon_daemon_method_call(GDBusConnection *connection,
-			     const gchar *sender,
-			     const gchar *object_path,
-			     const gchar *interface_name,
-			     const gchar *method_name,
-			     GVariant *parameters,
-			     GDBusMethodInvocation *invocation,
-			     gpointer user_data)
+fu_daemon_daemon_method_call_with_request(FuDaemon *self,
+					  GDBusMethodInvocation *invocation,
+					  FuEngineRequest *request_tmp)
 {
 	FuPolkitAuthorityCheckFlags auth_flags =
 	    FU_POLKIT_AUTHORITY_CHECK_FLAG_ALLOW_USER_INTERACTION;
-	FuDaemon *self = FU_DAEMON(user_data);
+	const gchar *sender = g_dbus_method_invocation_get_sender(invocation);
+	const gchar *method_name = g_dbus_method_invocation_get_method_name(invocation);
+	GVariant *parameters = g_dbus_method_invocation_get_parameters(invocation);
 	GVariant *val = NULL;
-	g_autoptr(FuEngineRequest) request = NULL;
+	g_autoptr(FuEngineRequest) request = g_object_ref(request_tmp);
 	g_autoptr(GError) error = NULL;
 
-	/* build request */
-	request = fu_daemon_create_request(self, sender, &error);
-	if (request == NULL) {
-		g_dbus_method_invocation_return_gerror(invocation, error);
+	/* the engine is mid-install, so only the snapshot can be used */
+	if (self->update_in_progress) {
+		if (fu_daemon_method_call_snapshot(self, invocation))
+			return;
+		g_debug("deferring %s() until the install has completed", method_name);
+		g_ptr_array_add(self->pending_invocations, invocation);
 		return;
 	}
+
 	if (fu_engine_request_has_device_flag(request, FWUPD_DEVICE_FLAG_TRUSTED))
 		auth_flags |= FU_POLKIT_AUTHORITY_CHECK_FLAG_USER_IS_TRUSTED;
 
@@ -1297,6 +2000,22 @@ fu_daemon_daemon_method_call(GDBusConnection *connection,
 		g_dbus_method_invocation_return_value(invocation, val);
 		return;
 	}
+	if (g_strcmp0(method_name, "GetUpgradesAll") == 0) {
+		g_autoptr(GPtrArray) devices = NULL;
+		g_debug("Called %s()", method_name);
+		devices = fu_engine_get_upgrades_all(self->engine, request, &error);
+		if (devices == NULL) {
+			g_dbus_method_invocation_return_gerror(invocation, error);
+			return;
+		}
+		val = fu_daemon_device_array_to_variant(self, request, devices, &error);
+		if (val == NULL) {
+			g_dbus_method_invocation_return_gerror(invocation, error);
+			return;
+		}
+		g_dbus_method_invocation_return_value(invocation, val);
+		return;
+	}
 	if (g_strcmp0(method_name, "GetRemotes") == 0) {
 		g_autoptr(GPtrArray) remotes = NULL;
 		g_debug("Called %s()", method_name);
@@ -1663,33 +2382,14 @@ fu_daemon_daemon_method_call(GDBusConnection *connection,
 		return;
 	}
 	if (g_strcmp0(method_name, "SetFeatureFlags") == 0) {
-		FuDaemonSenderItem *sender_item;
-		guint64 feature_flags_u64 = 0;
-
-		g_variant_get(parameters, "(t)", &feature_flags_u64);
-		g_debug("Called %s(%" G_GUINT64_FORMAT ")", method_name, feature_flags_u64);
-
-		/* old flags for the same sender will be automatically destroyed */
-		sender_item = fu_daemon_ensure_sender_item(self, sender);
-		sender_item->feature_flags = feature_flags_u64;
+		g_debug("Called %s()", method_name);
+		fu_daemon_set_sender_feature_flags(self, sender, parameters);
 		g_dbus_method_invocation_return_value(invocation, NULL);
 		return;
 	}
 	if (g_strcmp0(method_name, "SetHints") == 0) {
-		FuDaemonSenderItem *sender_item;
-		const gchar *prop_key;
-		const gchar *prop_value;
-		g_autoptr(GVariantIter) iter = NULL;
-
-		g_variant_get(parameters, "(a{ss})", &iter);
 		g_debug("Called %s()", method_name);
-		sender_item = fu_daemon_ensure_sender_item(self, sender);
-		while (g_variant_iter_next(iter, "{&s&s}", &prop_key, &prop_value)) {
-			g_debug("got hint %s=%s", prop_key, prop_value);
-			g_hash_table_insert(sender_item->hints,
-					    g_strdup(prop_key),
-					    g_strdup(prop_value));
-		}
+		fu_daemon_set_sender_hints(self, sender, parameters);
 		g_dbus_method_invocation_return_value(invocation, NULL);
 		return;
 	}
@@ -1954,6 +2654,90 @@ fu_daemon_daemon_method_call(GDBusConnection *connection,
 	g_dbus_method_invocation_return_gerror(invocation, error);
 }
 
+static void
+fu_daemon_get_connection_unix_user_cb(GObject *source, GAsyncResult *res, gpointer user_data)
+{
+	GDBusMethodInvocation *invocation = G_DBUS_METHOD_INVOCATION(user_data);
+	FuDaemon *self = FU_DAEMON(g_dbus_method_invocation_get_user_data(invocation));
+	const gchar *sender = g_dbus_method_invocation_get_sender(invocation);
+	guint calling_uid = 0;
+	g_autoptr(FuEngineRequest) request = NULL;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GVariant) value = NULL;
+
+	value = g_dbus_proxy_call_finish(G_DBUS_PROXY(source), res, &error);
+	if (value == NULL) {
+		g_prefix_error(&error, "failed to read user id of caller: ");
+		g_dbus_method_invocation_return_gerror(invocation, error);
+		return;
+	}
+	g_variant_get(value, "(u)", &calling_uid);
+	if (!fu_daemon_set_sender_uid(self, sender, calling_uid, &error)) {
+		g_dbus_method_invocation_return_gerror(invocation, error);
+		return;
+	}
+
+	request = fu_daemon_create_request(self, sender);
+	fu_daemon_daemon_method_call_with_request(self, invocation, request);
+}
+
+static void
+fu_daemon_method_call_dispatch(FuDaemon *self, GDBusMethodInvocation *invocation)
+{
+	FuDaemonSenderItem *sender_item = NULL;
+	const gchar *sender = g_dbus_method_invocation_get_sender(invocation);
+	g_autoptr(FuEngineRequest) request = NULL;
+
+	/* already know the credentials of the caller, or using FWUPD_DBUS_SOCKET */
+	if (sender != NULL)
+		sender_item = g_hash_table_lookup(self->sender_items, sender);
+	if (sender == NULL || (sender_item != NULL && sender_item->credentials_valid)) {
+		if (sender != NULL)
+			self->credentials_cache_hits++;
+		request = fu_daemon_create_request(self, sender);
+		fu_daemon_daemon_method_call_with_request(self, invocation, request);
+		return;
+	}
+
+	/* look up the caller without blocking the main loop, watching for it to disconnect */
+	fu_daemon_ensure_sender_item(self, sender);
+	self->credentials_cache_misses++;
+	g_debug("no cached credentials for %s, %u hits and %u misses",
+		sender,
+		self->credentials_cache_hits,
+		self->credentials_cache_misses);
+	if (self->proxy_uid == NULL) {
+		g_dbus_method_invocation_return_error_literal(invocation,
+							      FWUPD_ERROR,
+							      FWUPD_ERROR_INTERNAL,
+							      "failed to read user id of caller: "
+							      "no D-Bus proxy");
+		return;
+	}
+	g_dbus_proxy_call(self->proxy_uid,
+			  "GetConnectionUnixUser",
+			  g_variant_new("(s)", sender),
+			  G_DBUS_CALL_FLAGS_NONE,
+			  2000,
+			  NULL,
+			  fu_daemon_get_connection_unix_user_cb,
+			  invocation);
+}
+
+static void
+fu_daemon_daemon_method_call(GDBusConnection *connection,
+			     const gchar *sender,
+			     const gchar *object_path,
+			     const gchar *interface_name,
+			     const gchar *method_name,
+			     GVariant *parameters,
+			     GDBusMethodInvocation *invocation,
+			     gpointer user_data)
+{
+	FuDaemon *self = FU_DAEMON(user_data);
+	fu_daemon_method_call_dispatch(self, invocation);
+}
+
 static GVariant *
 fu_daemon_daemon_get_property(GDBusConnection *connection_,
 			      const gchar *sender,
@@ -1968,6 +2752,13 @@ fu_daemon_daemon_get_property(GDBusConnection *connection_,
 	/* activity */
 	fu_engine_idle_reset(self->engine);
 
+	/* the engine is mid-install */
+	if (self->update_in_progress) {
+		GVariant *value = fu_daemon_snapshot_get_property(self->snapshot, property_name);
+		if (value != NULL)
+			return value;
+	}
+
 	if (g_strcmp0(property_name, "DaemonVersion") == 0)
 		return g_variant_new_string(SOURCE_VERSION);
 
@@ -1983,6 +2774,12 @@ fu_daemon_daemon_get_property(GDBusConnection *connection_,
 	if (g_strcmp0(property_name, "Percentage") == 0)
 		return g_variant_new_uint32(self->percentage);
 
+	if (g_strcmp0(property_name, "Throughput") == 0)
+		return g_variant_new_uint64(self->throughput);
+
+	if (g_strcmp0(property_name, "TimeRemaining") == 0)
+		return g_variant_new_uint32(self->time_remaining);
+
 	if (g_strcmp0(property_name, FWUPD_RESULT_KEY_BATTERY_LEVEL) == 0) {
 		FuContext *ctx = fu_engine_get_context(self->engine);
 		return g_variant_new_uint32(fu_context_get_battery_level(ctx));
@@ -2067,7 +2864,7 @@ fu_daemon_dbus_bus_acquired_cb(GDBusConnection *connection, const gchar *name, g
 	FuDaemon *self = FU_DAEMON(user_data);
 	g_autoptr(GError) error = NULL;
 
-	self->connection = g_object_ref(connection);
+	fu_daemon_set_connection(self, connection);
 	fu_daemon_register_object(self);
 
 	/* connect to D-Bus directly */
@@ -2112,7 +2909,7 @@ fu_daemon_dbus_connection_closed_cb(GDBusConnection *connection,
 {
 	FuDaemon *self = FU_DAEMON(user_data);
 	g_info("client connection closed: %s", error != NULL ? error->message : "unknown");
-	g_clear_object(&self->connection);
+	fu_daemon_set_connection(self, NULL);
 }
 
 static gboolean
@@ -2121,7 +2918,7 @@ fu_daemon_dbus_new_connection_cb(GDBusServer *server,
 				 gpointer user_data)
 {
 	FuDaemon *self = FU_DAEMON(user_data);
-	g_set_object(&self->connection, connection);
+	fu_daemon_set_connection(self, connection);
 	g_signal_connect(connection,
 			 "closed",
 			 G_CALLBACK(fu_daemon_dbus_connection_closed_cb),
@@ -2157,6 +2954,7 @@ gboolean
 fu_daemon_setup(FuDaemon *self, const gchar *socket_address, GError **error)
 {
 	const gchar *machine_kind = g_getenv("FWUPD_MACHINE_KIND");
+	g_autoptr(FuEngine) engine = fu_engine_new();
 	g_autoptr(FuProgress) progress = fu_progress_new(G_STRLOC);
 
 	g_return_val_if_fail(FU_IS_DAEMON(self), FALSE);
@@ -2184,31 +2982,7 @@ fu_daemon_setup(FuDaemon *self, const gchar *socket_address, GError **error)
 	}
 
 	/* load engine */
-	self->engine = fu_engine_new();
-	g_signal_connect(FU_ENGINE(self->engine),
-			 "changed",
-			 G_CALLBACK(fu_daemon_engine_changed_cb),
-			 self);
-	g_signal_connect(FU_ENGINE(self->engine),
-			 "device-added",
-			 G_CALLBACK(fu_daemon_engine_device_added_cb),
-			 self);
-	g_signal_connect(FU_ENGINE(self->engine),
-			 "device-removed",
-			 G_CALLBACK(fu_daemon_engine_device_removed_cb),
-			 self);
-	g_signal_connect(FU_ENGINE(self->engine),
-			 "device-changed",
-			 G_CALLBACK(fu_daemon_engine_device_changed_cb),
-			 self);
-	g_signal_connect(FU_ENGINE(self->engine),
-			 "device-request",
-			 G_CALLBACK(fu_daemon_engine_device_request_cb),
-			 self);
-	g_signal_connect(FU_ENGINE(self->engine),
-			 "status-changed",
-			 G_CALLBACK(fu_daemon_engine_status_changed_cb),
-			 self);
+	fu_daemon_set_engine(self, engine);
 	if (!fu_engine_load(self->engine,
 			    FU_ENGINE_LOAD_FLAG_COLDPLUG | FU_ENGINE_LOAD_FLAG_HWINFO |
 				FU_ENGINE_LOAD_FLAG_REMOTES | FU_ENGINE_LOAD_FLAG_BUILTIN_PLUGINS,
@@ -2282,6 +3056,8 @@ fu_daemon_setup(FuDaemon *self, const gchar *socket_address, GError **error)
 static void
 fu_daemon_sender_item_free(FuDaemonSenderItem *sender_item)
 {
+	if (sender_item->watch_id != 0)
+		g_bus_unwatch_name(sender_item->watch_id);
 	g_hash_table_unref(sender_item->hints);
 	g_free(sender_item);
 }
@@ -2297,6 +3073,9 @@ fu_daemon_init(FuDaemon *self)
 	self->loop = g_main_loop_new(NULL, FALSE);
 	self->system_inhibits =
 	    g_ptr_array_new_with_free_func((GDestroyNotify)fu_daemon_system_inhibit_free);
+	self->pending_invocations =
+	    g_ptr_array_new_with_free_func((GDestroyNotify)g_object_unref);
+	self->snapshot = fu_daemon_snapshot_new();
 }
 
 static void
@@ -2305,6 +3084,10 @@ fu_daemon_finalize(GObject *obj)
 	FuDaemon *self = FU_DAEMON(obj);
 
 	g_ptr_array_unref(self->system_inhibits);
+	fu_daemon_fail_pending_invocations(self);
+	g_ptr_array_unref(self->pending_invocations);
+	if (self->snapshot_devices != NULL)
+		g_ptr_array_unref(self->snapshot_devices);
 	g_hash_table_unref(self->sender_items);
 	if (self->process_quit_id != 0)
 		g_source_remove(self->process_quit_id);
@@ -2316,8 +3099,11 @@ fu_daemon_finalize(GObject *obj)
 		g_object_unref(self->proxy_uid);
 	if (self->engine != NULL)
 		g_object_unref(self->engine);
+	if (self->filter_id != 0)
+		g_dbus_connection_remove_filter(self->connection, self->filter_id);
 	if (self->connection != NULL)
 		g_object_unref(self->connection);
+	fu_daemon_snapshot_unref(self->snapshot);
 	if (self->authority != NULL)
 		g_object_unref(self->authority);
 	if (self->introspection_daemon != NULL)
@@ -0,0 +1,604 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * SPDX-License-Identifier: LGPL-2.1+
+ */
+
+#define G_LOG_DOMAIN "FuEmulationBlob"
+
+#include "config.h"
+
+#include <string.h>
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+#include "fu-emulation-blob.h"
+
+/*
+ * The binary format is little endian and versioned:
+ *
+ *   0x00  char[4]  magic, `FEMU`
+ *   0x04  guint8   version, currently 0x01
+ *   0x05  guint8   flags, e.g. FU_EMULATION_BLOB_HEADER_FLAG_ZSTD
+ *   0x06  guint16  reserved, zero
+ *   0x08  guint32  uncompressed payload size
+ *   0x0C           payload, optionally compressed
+ *
+ * The payload is a table of length-prefixed strings, where each string is only stored once,
+ * followed by the tree of JSON nodes. Every member name and string value is stored as an index
+ * into the string table, which means the repeated names and transfer data that make up most of
+ * an emulation capture are only stored once.
+ */
+
+#define FU_EMULATION_BLOB_MAGIC		   "FEMU"
+#define FU_EMULATION_BLOB_VERSION	   0x01
+#define FU_EMULATION_BLOB_HEADER_SIZE	   0x0C
+#define FU_EMULATION_BLOB_HEADER_FLAG_ZSTD (1 << 0)
+#define FU_EMULATION_BLOB_PAYLOAD_SIZE_MAX 0x10000000 /* 256MB */
+#define FU_EMULATION_BLOB_DEPTH_MAX	   32
+#define FU_EMULATION_BLOB_ZSTD_LEVEL	   3
+#define FU_EMULATION_BLOB_ZSTD_RATIO_MAX   0x400
+
+typedef enum {
+	FU_EMULATION_BLOB_TAG_NULL,
+	FU_EMULATION_BLOB_TAG_OBJECT,
+	FU_EMULATION_BLOB_TAG_ARRAY,
+	FU_EMULATION_BLOB_TAG_STRING,
+	FU_EMULATION_BLOB_TAG_INT,
+	FU_EMULATION_BLOB_TAG_DOUBLE,
+	FU_EMULATION_BLOB_TAG_BOOLEAN,
+} FuEmulationBlobTag;
+
+typedef struct {
+	GByteArray *strings;
+	GByteArray *nodes;
+	GHashTable *indexes; /* (element-type utf8 guint) */
+} FuEmulationBlobWriter;
+
+typedef struct {
+	const guint8 *buf;
+	gsize bufsz;
+	gsize offset;
+	GPtrArray *strings; /* (element-type utf8) */
+} FuEmulationBlobReader;
+
+static guint32
+fu_emulation_blob_writer_intern(FuEmulationBlobWriter *helper, const gchar *str)
+{
+	gpointer idx = NULL;
+	gsize strsz;
+
+	if (g_hash_table_lookup_extended(helper->indexes, str, NULL, &idx))
+		return GPOINTER_TO_UINT(idx);
+	idx = GUINT_TO_POINTER(g_hash_table_size(helper->indexes));
+	g_hash_table_insert(helper->indexes, (gpointer)str, idx);
+	strsz = strlen(str);
+	fu_byte_array_append_uint32(helper->strings, strsz, G_LITTLE_ENDIAN);
+	g_byte_array_append(helper->strings, (const guint8 *)str, strsz);
+	return GPOINTER_TO_UINT(idx);
+}
+
+static gboolean
+fu_emulation_blob_write_node(FuEmulationBlobWriter *helper,
+			     JsonNode *json_node,
+			     guint depth,
+			     GError **error)
+{
+	/* sanity check */
+	if (depth > FU_EMULATION_BLOB_DEPTH_MAX) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_NOT_SUPPORTED,
+			    "JSON nested too deeply, maximum is %u",
+			    (guint)FU_EMULATION_BLOB_DEPTH_MAX);
+		return FALSE;
+	}
+
+	switch (json_node_get_node_type(json_node)) {
+	case JSON_NODE_OBJECT: {
+		JsonObject *json_object = json_node_get_object(json_node);
+		g_autoptr(GList) members = json_object_get_members(json_object);
+		fu_byte_array_append_uint8(helper->nodes, FU_EMULATION_BLOB_TAG_OBJECT);
+		fu_byte_array_append_uint32(helper->nodes, g_list_length(members), G_LITTLE_ENDIAN);
+		for (GList *l = members; l != NULL; l = l->next) {
+			const gchar *member_name = l->data;
+			fu_byte_array_append_uint32(
+			    helper->nodes,
+			    fu_emulation_blob_writer_intern(helper, member_name),
+			    G_LITTLE_ENDIAN);
+			if (!fu_emulation_blob_write_node(
+				helper,
+				json_object_get_member(json_object, member_name),
+				depth + 1,
+				error))
+				return FALSE;
+		}
+		return TRUE;
+	}
+	case JSON_NODE_ARRAY: {
+		JsonArray *json_array = json_node_get_array(json_node);
+		guint json_arraysz = json_array_get_length(json_array);
+		fu_byte_array_append_uint8(helper->nodes, FU_EMULATION_BLOB_TAG_ARRAY);
+		fu_byte_array_append_uint32(helper->nodes, json_arraysz, G_LITTLE_ENDIAN);
+		for (guint i = 0; i < json_arraysz; i++) {
+			if (!fu_emulation_blob_write_node(helper,
+							  json_array_get_element(json_array, i),
+							  depth + 1,
+							  error))
+				return FALSE;
+		}
+		return TRUE;
+	}
+	case JSON_NODE_NULL:
+		fu_byte_array_append_uint8(helper->nodes, FU_EMULATION_BLOB_TAG_NULL);
+		return TRUE;
+	case JSON_NODE_VALUE:
+		break;
+	}
+
+	/* a scalar value */
+	if (json_node_get_value_type(json_node) == G_TYPE_STRING) {
+		fu_byte_array_append_uint8(helper->nodes, FU_EMULATION_BLOB_TAG_STRING);
+		fu_byte_array_append_uint32(
+		    helper->nodes,
+		    fu_emulation_blob_writer_intern(helper, json_node_get_string(json_node)),
+		    G_LITTLE_ENDIAN);
+		return TRUE;
+	}
+	if (json_node_get_value_type(json_node) == G_TYPE_INT64) {
+		fu_byte_array_append_uint8(helper->nodes, FU_EMULATION_BLOB_TAG_INT);
+		fu_byte_array_append_uint64(helper->nodes,
+					    (guint64)json_node_get_int(json_node),
+					    G_LITTLE_ENDIAN);
+		return TRUE;
+	}
+	if (json_node_get_value_type(json_node) == G_TYPE_DOUBLE) {
+		gdouble value = json_node_get_double(json_node);
+		guint64 value_bits = 0;
+		memcpy(&value_bits, &value, sizeof(value_bits));
+		fu_byte_array_append_uint8(helper->nodes, FU_EMULATION_BLOB_TAG_DOUBLE);
+		fu_byte_array_append_uint64(helper->nodes, value_bits, G_LITTLE_ENDIAN);
+		return TRUE;
+	}
+	if (json_node_get_value_type(json_node) == G_TYPE_BOOLEAN) {
+		fu_byte_array_append_uint8(helper->nodes, FU_EMULATION_BLOB_TAG_BOOLEAN);
+		fu_byte_array_append_uint8(helper->nodes, json_node_get_boolean(json_node));
+		return TRUE;
+	}
+	g_set_error(error,
+		    FWUPD_ERROR,
+		    FWUPD_ERROR_NOT_SUPPORTED,
+		    "JSON value type %s not supported",
+		    g_type_name(json_node_get_value_type(json_node)));
+	return FALSE;
+}
+
+/**
+ * fu_emulation_blob_from_json_node:
+ * @json_node: a #JsonNode
+ * @flags: a #FuEmulationBlobFlags, e.g. %FU_EMULATION_BLOB_FLAG_ZSTD
+ * @error: (nullable): optional return location for an error
+ *
+ * Converts emulation data from the JSON representation into the compact binary format.
+ *
+ * Returns: (transfer full): a #GBytes, or %NULL on error
+ **/
+GBytes *
+fu_emulation_blob_from_json_node(JsonNode *json_node, FuEmulationBlobFlags flags, GError **error)
+{
+	guint8 header_flags = 0;
+	g_autoptr(GByteArray) buf = g_byte_array_new();
+	g_autoptr(GByteArray) nodes = g_byte_array_new();
+	g_autoptr(GByteArray) payload = g_byte_array_new();
+	g_autoptr(GByteArray) strings = g_byte_array_new();
+	g_autoptr(GHashTable) indexes = g_hash_table_new(g_str_hash, g_str_equal);
+	FuEmulationBlobWriter helper = {
+	    .strings = strings,
+	    .nodes = nodes,
+	    .indexes = indexes,
+	};
+
+	g_return_val_if_fail(json_node != NULL, NULL);
+	g_return_val_if_fail(error == NULL || *error == NULL, NULL);
+
+	/* string table, then the tree */
+	if (!fu_emulation_blob_write_node(&helper, json_node, 0, error))
+		return NULL;
+	fu_byte_array_append_uint32(payload, g_hash_table_size(indexes), G_LITTLE_ENDIAN);
+	g_byte_array_append(payload, strings->data, strings->len);
+	g_byte_array_append(payload, nodes->data, nodes->len);
+	if (payload->len > FU_EMULATION_BLOB_PAYLOAD_SIZE_MAX) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_NOT_SUPPORTED,
+			    "emulation data too large, got 0x%x bytes",
+			    payload->len);
+		return NULL;
+	}
+
+	/* header */
+#ifdef HAVE_ZSTD
+	if (flags & FU_EMULATION_BLOB_FLAG_ZSTD)
+		header_flags |= FU_EMULATION_BLOB_HEADER_FLAG_ZSTD;
+#endif
+	g_byte_array_append(buf,
+			    (const guint8 *)FU_EMULATION_BLOB_MAGIC,
+			    strlen(FU_EMULATION_BLOB_MAGIC));
+	fu_byte_array_append_uint8(buf, FU_EMULATION_BLOB_VERSION);
+	fu_byte_array_append_uint8(buf, header_flags);
+	fu_byte_array_append_uint16(buf, 0x0, G_LITTLE_ENDIAN);
+	fu_byte_array_append_uint32(buf, payload->len, G_LITTLE_ENDIAN);
+
+	/* payload */
+#ifdef HAVE_ZSTD
+	if (header_flags & FU_EMULATION_BLOB_HEADER_FLAG_ZSTD) {
+		gsize bufsz_zstd = ZSTD_compressBound(payload->len);
+		gsize rc;
+		g_autofree guint8 *buf_zstd = g_malloc(bufsz_zstd);
+
+		rc = ZSTD_compress(buf_zstd,
+				   bufsz_zstd,
+				   payload->data,
+				   payload->len,
+				   FU_EMULATION_BLOB_ZSTD_LEVEL);
+		if (ZSTD_isError(rc)) {
+			g_set_error(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_INTERNAL,
+				    "failed to compress zstd data: %s",
+				    ZSTD_getErrorName(rc));
+			return NULL;
+		}
+		g_byte_array_append(buf, buf_zstd, rc);
+		return g_bytes_new(buf->data, buf->len);
+	}
+#endif
+	g_byte_array_append(buf, payload->data, payload->len);
+	return g_bytes_new(buf->data, buf->len);
+}
+
+static gboolean
+fu_emulation_blob_reader_uint8(FuEmulationBlobReader *helper, guint8 *value, GError **error)
+{
+	if (!fu_memread_uint8_safe(helper->buf, helper->bufsz, helper->offset, value, error))
+		return FALSE;
+	helper->offset += sizeof(*value);
+	return TRUE;
+}
+
+static gboolean
+fu_emulation_blob_reader_uint32(FuEmulationBlobReader *helper, guint32 *value, GError **error)
+{
+	if (!fu_memread_uint32_safe(helper->buf,
+				    helper->bufsz,
+				    helper->offset,
+				    value,
+				    G_LITTLE_ENDIAN,
+				    error))
+		return FALSE;
+	helper->offset += sizeof(*value);
+	return TRUE;
+}
+
+static gboolean
+fu_emulation_blob_reader_uint64(FuEmulationBlobReader *helper, guint64 *value, GError **error)
+{
+	if (!fu_memread_uint64_safe(helper->buf,
+				    helper->bufsz,
+				    helper->offset,
+				    value,
+				    G_LITTLE_ENDIAN,
+				    error))
+		return FALSE;
+	helper->offset += sizeof(*value);
+	return TRUE;
+}
+
+/* every element is at least one byte, so this stops a small blob causing a huge loop */
+static gboolean
+fu_emulation_blob_reader_count(FuEmulationBlobReader *helper, guint32 *value, GError **error)
+{
+	if (!fu_emulation_blob_reader_uint32(helper, value, error))
+		return FALSE;
+	if (*value > helper->bufsz - helper->offset) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_INVALID_FILE,
+			    "count 0x%x larger than remaining data 0x%x",
+			    *value,
+			    (guint)(helper->bufsz - helper->offset));
+		return FALSE;
+	}
+	return TRUE;
+}
+
+static const gchar *
+fu_emulation_blob_reader_string(FuEmulationBlobReader *helper, GError **error)
+{
+	guint32 idx = 0;
+	if (!fu_emulation_blob_reader_uint32(helper, &idx, error))
+		return NULL;
+	if (idx >= helper->strings->len) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_INVALID_FILE,
+			    "string index 0x%x invalid, only 0x%x strings",
+			    idx,
+			    helper->strings->len);
+		return NULL;
+	}
+	return g_ptr_array_index(helper->strings, idx);
+}
+
+static gboolean
+fu_emulation_blob_reader_strings(FuEmulationBlobReader *helper, GError **error)
+{
+	guint32 stringsz = 0;
+
+	if (!fu_emulation_blob_reader_count(helper, &stringsz, error))
+		return FALSE;
+	for (guint i = 0; i < stringsz; i++) {
+		guint32 strsz = 0;
+		const gchar *str;
+
+		if (!fu_emulation_blob_reader_uint32(helper, &strsz, error))
+			return FALSE;
+		if (strsz > helper->bufsz - helper->offset) {
+			g_set_error(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_INVALID_FILE,
+				    "string length 0x%x larger than remaining data 0x%x",
+				    strsz,
+				    (guint)(helper->bufsz - helper->offset));
+			return FALSE;
+		}
+		str = (const gchar *)helper->buf + helper->offset;
+		if (!g_utf8_validate(str, strsz, NULL)) {
+			g_set_error(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_INVALID_FILE,
+				    "string 0x%x is not valid UTF-8",
+				    i);
+			return FALSE;
+		}
+		g_ptr_array_add(helper->strings, g_strndup(str, strsz));
+		helper->offset += strsz;
+	}
+	return TRUE;
+}
+
+static JsonNode *
+fu_emulation_blob_read_node(FuEmulationBlobReader *helper, guint depth, GError **error)
+{
+	guint8 tag = 0;
+
+	/* sanity check */
+	if (depth > FU_EMULATION_BLOB_DEPTH_MAX) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_INVALID_FILE,
+			    "nested too deeply, maximum is %u",
+			    (guint)FU_EMULATION_BLOB_DEPTH_MAX);
+		return NULL;
+	}
+
+	if (!fu_emulation_blob_reader_uint8(helper, &tag, error))
+		return NULL;
+	if (tag == FU_EMULATION_BLOB_TAG_OBJECT) {
+		guint32 membersz = 0;
+		g_autoptr(JsonObject) json_object = json_object_new();
+		if (!fu_emulation_blob_reader_count(helper, &membersz, error))
+			return NULL;
+		for (guint i = 0; i < membersz; i++) {
+			const gchar *member_name = fu_emulation_blob_reader_string(helper, error);
+			JsonNode *json_member;
+			if (member_name == NULL)
+				return NULL;
+			json_member = fu_emulation_blob_read_node(helper, depth + 1, error);
+			if (json_member == NULL)
+				return NULL;
+			json_object_set_member(json_object, member_name, json_member);
+		}
+		return json_node_init_object(json_node_alloc(), json_object);
+	}
+	if (tag == FU_EMULATION_BLOB_TAG_ARRAY) {
+		guint32 elementsz = 0;
+		g_autoptr(JsonArray) json_array = NULL;
+		if (!fu_emulation_blob_reader_count(helper, &elementsz, error))
+			return NULL;
+		json_array = json_array_sized_new(elementsz);
+		for (guint i = 0; i < elementsz; i++) {
+			JsonNode *json_element;
+			json_element = fu_emulation_blob_read_node(helper, depth + 1, error);
+			if (json_element == NULL)
+				return NULL;
+			json_array_add_element(json_array, json_element);
+		}
+		return json_node_init_array(json_node_alloc(), json_array);
+	}
+	if (tag == FU_EMULATION_BLOB_TAG_STRING) {
+		const gchar *str = fu_emulation_blob_reader_string(helper, error);
+		if (str == NULL)
+			return NULL;
+		return json_node_init_string(json_node_alloc(), str);
+	}
+	if (tag == FU_EMULATION_BLOB_TAG_INT) {
+		guint64 value = 0;
+		if (!fu_emulation_blob_reader_uint64(helper, &value, error))
+			return NULL;
+		return json_node_init_int(json_node_alloc(), (gint64)value);
+	}
+	if (tag == FU_EMULATION_BLOB_TAG_DOUBLE) {
+		gdouble value = 0;
+		guint64 value_bits = 0;
+		if (!fu_emulation_blob_reader_uint64(helper, &value_bits, error))
+			return NULL;
+		memcpy(&value, &value_bits, sizeof(value));
+		return json_node_init_double(json_node_alloc(), value);
+	}
+	if (tag == FU_EMULATION_BLOB_TAG_BOOLEAN) {
+		guint8 value = 0;
+		if (!fu_emulation_blob_reader_uint8(helper, &value, error))
+			return NULL;
+		return json_node_init_boolean(json_node_alloc(), value > 0);
+	}
+	if (tag == FU_EMULATION_BLOB_TAG_NULL)
+		return json_node_init_null(json_node_alloc());
+	g_set_error(error,
+		    FWUPD_ERROR,
+		    FWUPD_ERROR_INVALID_FILE,
+		    "unknown tag 0x%x at offset 0x%x",
+		    tag,
+		    (guint)helper->offset - 1);
+	return NULL;
+}
+
+/**
+ * fu_emulation_blob_to_json_node:
+ * @blob: a #GBytes created by fu_emulation_blob_from_json_node()
+ * @error: (nullable): optional return location for an error
+ *
+ * Converts emulation data from the compact binary format back into the JSON representation,
+ * without needing to generate or parse any JSON text.
+ *
+ * Returns: (transfer full): a #JsonNode, or %NULL on error
+ **/
+JsonNode *
+fu_emulation_blob_to_json_node(GBytes *blob, GError **error)
+{
+	gsize bufsz = 0;
+	guint8 flags = 0;
+	guint8 version = 0;
+	guint32 payloadsz = 0;
+	const guint8 *buf = g_bytes_get_data(blob, &bufsz);
+	g_autofree guint8 *payload_zstd = NULL;
+	g_autoptr(GPtrArray) strings = g_ptr_array_new_with_free_func(g_free);
+	g_autoptr(JsonNode) json_node = NULL;
+	FuEmulationBlobReader helper = {.strings = strings};
+
+	g_return_val_if_fail(blob != NULL, NULL);
+	g_return_val_if_fail(error == NULL || *error == NULL, NULL);
+
+	/* header */
+	if (bufsz < FU_EMULATION_BLOB_HEADER_SIZE ||
+	    memcmp(buf, FU_EMULATION_BLOB_MAGIC, strlen(FU_EMULATION_BLOB_MAGIC)) != 0) {
+		g_set_error_literal(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_INVALID_FILE,
+				    "not emulation data, invalid magic");
+		return NULL;
+	}
+	if (!fu_memread_uint8_safe(buf, bufsz, 0x04, &version, error))
+		return NULL;
+	if (version != FU_EMULATION_BLOB_VERSION) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_NOT_SUPPORTED,
+			    "emulation data version 0x%x not supported",
+			    version);
+		return NULL;
+	}
+	if (!fu_memread_uint8_safe(buf, bufsz, 0x05, &flags, error))
+		return NULL;
+	if (!fu_memread_uint32_safe(buf, bufsz, 0x08, &payloadsz, G_LITTLE_ENDIAN, error))
+		return NULL;
+	if (payloadsz > FU_EMULATION_BLOB_PAYLOAD_SIZE_MAX) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_INVALID_FILE,
+			    "emulation payload too large, got 0x%x bytes",
+			    payloadsz);
+		return NULL;
+	}
+
+	/* payload */
+	if (flags & FU_EMULATION_BLOB_HEADER_FLAG_ZSTD) {
+#ifdef HAVE_ZSTD
+		gsize bufsz_zstd = bufsz - FU_EMULATION_BLOB_HEADER_SIZE;
+		gsize rc;
+		guint64 framesz;
+
+		/* do not trust the header to allocate a huge buffer for a tiny blob */
+		if ((guint64)payloadsz > (guint64)bufsz_zstd * FU_EMULATION_BLOB_ZSTD_RATIO_MAX) {
+			g_set_error(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_INVALID_FILE,
+				    "payload size 0x%x too large for 0x%x bytes of zstd data",
+				    payloadsz,
+				    (guint)bufsz_zstd);
+			return NULL;
+		}
+		framesz = ZSTD_getFrameContentSize(buf + FU_EMULATION_BLOB_HEADER_SIZE, bufsz_zstd);
+		if (framesz != payloadsz) {
+			g_set_error(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_INVALID_FILE,
+				    "zstd frame content size 0x%" G_GINT64_MODIFIER
+				    "x, expected 0x%x",
+				    framesz,
+				    payloadsz);
+			return NULL;
+		}
+		payload_zstd = g_malloc(payloadsz);
+		rc = ZSTD_decompress(payload_zstd,
+				     payloadsz,
+				     buf + FU_EMULATION_BLOB_HEADER_SIZE,
+				     bufsz_zstd);
+		if (ZSTD_isError(rc)) {
+			g_set_error(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_INVALID_FILE,
+				    "failed to decompress zstd data: %s",
+				    ZSTD_getErrorName(rc));
+			return NULL;
+		}
+		if (rc != payloadsz) {
+			g_set_error(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_INVALID_FILE,
+				    "decompressed size 0x%x, expected 0x%x",
+				    (guint)rc,
+				    payloadsz);
+			return NULL;
+		}
+		helper.buf = payload_zstd;
+#else
+		g_set_error_literal(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_NOT_SUPPORTED,
+				    "emulation data is zstd compressed, but not supported");
+		return NULL;
+#endif
+	} else {
+		if (payloadsz != bufsz - FU_EMULATION_BLOB_HEADER_SIZE) {
+			g_set_error(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_INVALID_FILE,
+				    "payload size 0x%x, expected 0x%x",
+				    (guint)(bufsz - FU_EMULATION_BLOB_HEADER_SIZE),
+				    payloadsz);
+			return NULL;
+		}
+		helper.buf = buf + FU_EMULATION_BLOB_HEADER_SIZE;
+	}
+	helper.bufsz = payloadsz;
+
+	/* string table, then the tree */
+	if (!fu_emulation_blob_reader_strings(&helper, error))
+		return NULL;
+	json_node = fu_emulation_blob_read_node(&helper, 0, error);
+	if (json_node == NULL)
+		return NULL;
+	if (helper.offset != helper.bufsz) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_INVALID_FILE,
+			    "0x%x bytes of trailing data",
+			    (guint)(helper.bufsz - helper.offset));
+		return NULL;
+	}
+
+	/* success */
+	return g_steal_pointer(&json_node);
+}
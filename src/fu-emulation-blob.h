@@ -0,0 +1,26 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * SPDX-License-Identifier: LGPL-2.1+
+ */
+
+#pragma once
+
+#include <fwupdplugin.h>
+
+/**
+ * FuEmulationBlobFlags:
+ * @FU_EMULATION_BLOB_FLAG_NONE:	No flags set
+ * @FU_EMULATION_BLOB_FLAG_ZSTD:	Compress the payload using zstd, if supported
+ *
+ * The flags to use when converting emulation data to the binary format.
+ **/
+typedef enum {
+	FU_EMULATION_BLOB_FLAG_NONE = 0,
+	FU_EMULATION_BLOB_FLAG_ZSTD = 1 << 0,
+} FuEmulationBlobFlags;
+
+GBytes *
+fu_emulation_blob_from_json_node(JsonNode *json_node, FuEmulationBlobFlags flags, GError **error);
+JsonNode *
+fu_emulation_blob_to_json_node(GBytes *blob, GError **error);
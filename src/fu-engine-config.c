@@ -38,6 +38,7 @@ G_DEFINE_TYPE(FuEngineConfig, fu_engine_config, FU_TYPE_CONFIG)
 #define FU_DAEMON_CONFIG_DEFAULT_SHOW_DEVICE_PRIVATE   TRUE
 #define FU_DAEMON_CONFIG_DEFAULT_ALLOW_EMULATION       FALSE
 #define FU_DAEMON_CONFIG_DEFAULT_ENUMERATE_ALL_DEVICES TRUE
+#define FU_DAEMON_CONFIG_DEFAULT_COLDPLUG_CONCURRENCY  0
 #define FU_DAEMON_CONFIG_DEFAULT_TRUSTED_UIDS	       NULL
 #define FU_DAEMON_CONFIG_DEFAULT_HOST_BKC	       NULL
 #define FU_DAEMON_CONFIG_DEFAULT_TRUSTED_REPORTS       "VendorId=$OEM"
@@ -364,6 +365,15 @@ fu_engine_config_get_enumerate_all_devices(FuEngineConfig *self)
 					FU_DAEMON_CONFIG_DEFAULT_ENUMERATE_ALL_DEVICES);
 }
 
+guint
+fu_engine_config_get_coldplug_concurrency(FuEngineConfig *self)
+{
+	return fu_config_get_value_u64(FU_CONFIG(self),
+				       "fwupd",
+				       "ColdplugConcurrency",
+				       FU_DAEMON_CONFIG_DEFAULT_COLDPLUG_CONCURRENCY);
+}
+
 const gchar *
 fu_engine_config_get_host_bkc(FuEngineConfig *self)
 {
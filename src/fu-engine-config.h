@@ -37,6 +37,8 @@ gboolean
 fu_engine_config_get_update_motd(FuEngineConfig *self);
 gboolean
 fu_engine_config_get_enumerate_all_devices(FuEngineConfig *self);
+guint
+fu_engine_config_get_coldplug_concurrency(FuEngineConfig *self);
 gboolean
 fu_engine_config_get_ignore_power(FuEngineConfig *self);
 gboolean
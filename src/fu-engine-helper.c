@@ -14,6 +14,7 @@
 #include <glib/gi18n.h>
 
 #include "fwupd-device-private.h"
+#include "fwupd-json-writer-private.h"
 
 #include "fu-engine-helper.h"
 #include "fu-engine.h"
@@ -147,50 +148,47 @@ gboolean
 fu_engine_update_devices_file(FuEngine *self, GError **error)
 {
 	FwupdDeviceFlags flags = FWUPD_DEVICE_FLAG_NONE;
-	gsize len;
-	g_autoptr(JsonBuilder) builder = NULL;
-	g_autoptr(JsonGenerator) generator = NULL;
-	g_autoptr(JsonNode) root = NULL;
+	g_autoptr(FwupdJsonWriter) writer = NULL;
+	g_autoptr(GFile) file = NULL;
+	g_autoptr(GFileOutputStream) stream = NULL;
 	g_autoptr(GPtrArray) devices = NULL;
-	g_autofree gchar *data = NULL;
 	g_autofree gchar *directory = NULL;
 	g_autofree gchar *target = NULL;
 
 	if (fu_engine_config_get_show_device_private(fu_engine_get_config(self)))
 		flags |= FWUPD_DEVICE_FLAG_TRUSTED;
 
-	builder = json_builder_new();
-	json_builder_begin_object(builder);
-	json_builder_set_member_name(builder, "Devices");
-	json_builder_begin_array(builder);
+	/* write each device in turn rather than building the whole tree */
+	directory = fu_path_from_kind(FU_PATH_KIND_CACHEDIR_PKG);
+	target = g_build_filename(directory, "devices.json", NULL);
+	file = g_file_new_for_path(target);
+	stream = g_file_replace(file, NULL, FALSE, G_FILE_CREATE_NONE, NULL, error);
+	if (stream == NULL)
+		return FALSE;
+	writer = fwupd_json_writer_new(G_OUTPUT_STREAM(stream));
+	if (!fwupd_json_writer_begin_object(writer, NULL, error))
+		return FALSE;
+	if (!fwupd_json_writer_begin_array(writer, "Devices", error))
+		return FALSE;
 	devices = fu_engine_get_devices(self, NULL);
 	if (devices != NULL) {
 		for (guint i = 0; i < devices->len; i++) {
 			FwupdDevice *dev = g_ptr_array_index(devices, i);
+			g_autoptr(JsonBuilder) builder = json_builder_new();
 			json_builder_begin_object(builder);
 			fwupd_device_to_json_full(dev, builder, flags);
 			json_builder_end_object(builder);
+			if (!fwupd_json_writer_add_builder(writer, NULL, builder, error))
+				return FALSE;
 		}
 	}
-	json_builder_end_array(builder);
-	json_builder_end_object(builder);
-
-	root = json_builder_get_root(builder);
-	generator = json_generator_new();
-	json_generator_set_pretty(generator, TRUE);
-	json_generator_set_root(generator, root);
-	data = json_generator_to_data(generator, &len);
-	if (data == NULL) {
-		g_set_error_literal(error,
-				    FWUPD_ERROR,
-				    FWUPD_ERROR_INTERNAL,
-				    "Failed to convert to JSON string");
+	if (!fwupd_json_writer_end_array(writer, error))
 		return FALSE;
-	}
-
-	directory = fu_path_from_kind(FU_PATH_KIND_CACHEDIR_PKG);
-	target = g_build_filename(directory, "devices.json", NULL);
-	return g_file_set_contents(target, data, (gssize)len, error);
+	if (!fwupd_json_writer_end_object(writer, error))
+		return FALSE;
+	if (!fwupd_json_writer_finish(writer, error))
+		return FALSE;
+	return g_output_stream_close(G_OUTPUT_STREAM(stream), NULL, error);
 }
 
 static void
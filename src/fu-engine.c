@@ -9,6 +9,7 @@
 #include "config.h"
 
 #include <fcntl.h>
+#include <glib/gstdio.h>
 
 #ifdef HAVE_GIO_UNIX
 #include <gio/gunixinputstream.h>
@@ -47,6 +48,7 @@
 #include "fu-device-list.h"
 #include "fu-device-private.h"
 #include "fu-device-progress.h"
+#include "fu-emulation-blob.h"
 #include "fu-engine-helper.h"
 #include "fu-engine-request.h"
 #include "fu-engine.h"
@@ -75,6 +77,9 @@
 #ifdef HAVE_BLUEZ
 #include "fu-bluez-backend.h"
 #endif
+#ifdef HAVE_ZSTD
+#include "fu-zstd-decompressor.h"
+#endif
 
 /* only needed until we hard depend on jcat 0.1.3 */
 #include <libjcat/jcat-version.h>
@@ -132,7 +137,7 @@ struct _FuEngine {
 	GHashTable *compile_versions;
 	GHashTable *approved_firmware; /* (nullable) */
 	GHashTable *blocked_firmware;  /* (nullable) */
-	GHashTable *emulation_phases;  /* (element-type int utf8) */
+	GHashTable *emulation_phases;  /* (element-type int JsonNode) */
 	GHashTable *emulation_backend_ids; /* (element-type str int) */
 	gchar *host_machine_id;
 	JcatContext *jcat_context;
@@ -161,6 +166,86 @@ static guint signals[SIGNAL_LAST] = {0};
 
 G_DEFINE_TYPE(FuEngine, fu_engine, G_TYPE_OBJECT)
 
+typedef enum {
+	FU_ENGINE_COLDPLUG_ACTION_KIND_DEVICE_REGISTER,
+	FU_ENGINE_COLDPLUG_ACTION_KIND_DEVICE_ADDED,
+	FU_ENGINE_COLDPLUG_ACTION_KIND_DEVICE_REMOVED,
+	FU_ENGINE_COLDPLUG_ACTION_KIND_RULES_CHANGED,
+} FuEngineColdplugActionKind;
+
+typedef struct {
+	FuEngineColdplugActionKind kind;
+	FuPlugin *plugin; /* (owned) */
+	FuDevice *device; /* (owned) (nullable) */
+} FuEngineColdplugAction;
+
+typedef struct {
+	const gchar *guid;
+	gboolean supported;
+	gboolean done;
+} FuEngineColdplugQuery;
+
+typedef struct {
+	FuEngine *self;
+	GMutex mutex;
+	GCond cond;
+	guint done;
+	GPtrArray *queries; /* (element-type FuEngineColdplugQuery) */
+} FuEngineColdplugHelper;
+
+typedef struct {
+	FuDevice *device;		/* (owned) */
+	FuEngineColdplugHelper *helper; /* (nullable), set when using a worker thread */
+	GPtrArray *actions;		/* (element-type FuEngineColdplugAction) (owned) */
+	gboolean probed;
+	gdouble duration;
+} FuEngineColdplugItem;
+
+/* set for the duration of the plugin setup of each coldplugged device */
+static GPrivate fu_engine_coldplug_item = G_PRIVATE_INIT(NULL);
+
+static void
+fu_engine_coldplug_action_free(FuEngineColdplugAction *action)
+{
+	g_object_unref(action->plugin);
+	if (action->device != NULL)
+		g_object_unref(action->device);
+	g_free(action);
+}
+
+/* plugin signals are replayed from the main thread in the order the devices were enumerated */
+static gboolean
+fu_engine_coldplug_defer_action(FuEngineColdplugActionKind kind, FuPlugin *plugin, FuDevice *device)
+{
+	FuEngineColdplugItem *item = g_private_get(&fu_engine_coldplug_item);
+	FuEngineColdplugAction *action;
+
+	if (item == NULL)
+		return FALSE;
+	action = g_new0(FuEngineColdplugAction, 1);
+	action->kind = kind;
+	action->plugin = g_object_ref(plugin);
+	if (device != NULL)
+		action->device = g_object_ref(device);
+	g_ptr_array_add(item->actions, action);
+	return TRUE;
+}
+
+/* the main thread answers this as it owns the silo */
+static gboolean
+fu_engine_coldplug_helper_check_supported(FuEngineColdplugHelper *helper, const gchar *guid)
+{
+	FuEngineColdplugQuery query = {.guid = guid};
+
+	g_mutex_lock(&helper->mutex);
+	g_ptr_array_add(helper->queries, &query);
+	g_cond_broadcast(&helper->cond);
+	while (!query.done)
+		g_cond_wait(&helper->cond, &helper->mutex);
+	g_mutex_unlock(&helper->mutex);
+	return query.supported;
+}
+
 static gboolean
 fu_engine_update_motd_timeout_cb(gpointer user_data)
 {
@@ -766,12 +851,13 @@ fu_engine_get_remote_id_for_checksum(FuEngine *self, const gchar *csum)
 gchar *
 fu_engine_get_remote_id_for_blob(FuEngine *self, GBytes *blob)
 {
-	GChecksumType checksum_types[] = {G_CHECKSUM_SHA256, G_CHECKSUM_SHA1, 0};
+	GChecksumType checksum_types[] = {G_CHECKSUM_SHA256, G_CHECKSUM_SHA1};
 
 	g_return_val_if_fail(FU_IS_ENGINE(self), NULL);
 	g_return_val_if_fail(blob != NULL, NULL);
 
-	for (guint i = 0; checksum_types[i] != 0; i++) {
+	/* the legacy SHA-1 is only required if the SHA-256 is not found */
+	for (guint i = 0; i < G_N_ELEMENTS(checksum_types); i++) {
 		g_autofree gchar *csum = g_compute_checksum_for_bytes(checksum_types[i], blob);
 		const gchar *remote_id = fu_engine_get_remote_id_for_checksum(self, csum);
 		if (remote_id != NULL)
@@ -1416,7 +1502,9 @@ fu_engine_get_component_by_guid(FuEngine *self, const gchar *guid)
 	if (self->query_component_by_guid == NULL)
 		return NULL;
 
-	xb_query_context_set_flags(&context, XB_QUERY_FLAG_USE_INDEXES);
+	/* reuse the same node so the parsed requirements are cached for the silo */
+	xb_query_context_set_flags(&context,
+				   XB_QUERY_FLAG_USE_INDEXES | XB_QUERY_FLAG_FORCE_NODE_CACHE);
 	xb_value_bindings_bind_str(xb_query_context_get_bindings(&context), 0, guid, NULL);
 	component = xb_silo_query_first_with_context(self->silo,
 						     self->query_component_by_guid,
@@ -1677,41 +1765,44 @@ fu_engine_verify(FuEngine *self, const gchar *device_id, FuProgress *progress, G
 }
 
 static gboolean
-fu_engine_require_vercmp(XbNode *req, const gchar *version, FwupdVersionFormat fmt, GError **error)
+fu_engine_require_vercmp(FuRequirement *req,
+			 const gchar *version,
+			 FwupdVersionFormat fmt,
+			 GError **error)
 {
 	gboolean ret = FALSE;
-	gint rc = 0;
-	const gchar *tmp = xb_node_get_attr(req, "compare");
-	const gchar *version_req = xb_node_get_attr(req, "version");
-
-	if (g_strcmp0(tmp, "eq") == 0) {
-		rc = fu_version_compare(version, version_req, fmt);
-		ret = rc == 0;
-	} else if (g_strcmp0(tmp, "ne") == 0) {
-		rc = fu_version_compare(version, version_req, fmt);
-		ret = rc != 0;
-	} else if (g_strcmp0(tmp, "lt") == 0) {
-		rc = fu_version_compare(version, version_req, fmt);
-		ret = rc < 0;
-	} else if (g_strcmp0(tmp, "gt") == 0) {
-		rc = fu_version_compare(version, version_req, fmt);
-		ret = rc > 0;
-	} else if (g_strcmp0(tmp, "le") == 0) {
-		rc = fu_version_compare(version, version_req, fmt);
-		ret = rc <= 0;
-	} else if (g_strcmp0(tmp, "ge") == 0) {
-		rc = fu_version_compare(version, version_req, fmt);
-		ret = rc >= 0;
-	} else if (g_strcmp0(tmp, "glob") == 0) {
-		ret = g_pattern_match_simple(version_req, version);
-	} else if (g_strcmp0(tmp, "regex") == 0) {
-		ret = g_regex_match_simple(version_req, version, 0, 0);
-	} else {
+
+	switch (req->compare) {
+	case FU_REQUIREMENT_COMPARE_EQ:
+		ret = fu_requirement_version_compare(req, version, fmt) == 0;
+		break;
+	case FU_REQUIREMENT_COMPARE_NE:
+		ret = fu_requirement_version_compare(req, version, fmt) != 0;
+		break;
+	case FU_REQUIREMENT_COMPARE_LT:
+		ret = fu_requirement_version_compare(req, version, fmt) < 0;
+		break;
+	case FU_REQUIREMENT_COMPARE_GT:
+		ret = fu_requirement_version_compare(req, version, fmt) > 0;
+		break;
+	case FU_REQUIREMENT_COMPARE_LE:
+		ret = fu_requirement_version_compare(req, version, fmt) <= 0;
+		break;
+	case FU_REQUIREMENT_COMPARE_GE:
+		ret = fu_requirement_version_compare(req, version, fmt) >= 0;
+		break;
+	case FU_REQUIREMENT_COMPARE_GLOB:
+		ret = g_pattern_match_simple(req->version, version);
+		break;
+	case FU_REQUIREMENT_COMPARE_REGEX:
+		ret = req->regex != NULL && g_regex_match(req->regex, version, 0, NULL);
+		break;
+	default:
 		g_set_error(error,
 			    FWUPD_ERROR,
 			    FWUPD_ERROR_NOT_SUPPORTED,
 			    "failed to compare [%s] and [%s]",
-			    version_req,
+			    req->version,
 			    version);
 		return FALSE;
 	}
@@ -1722,25 +1813,28 @@ fu_engine_require_vercmp(XbNode *req, const gchar *version, FwupdVersionFormat f
 			    FWUPD_ERROR,
 			    FWUPD_ERROR_INTERNAL,
 			    "failed predicate [%s %s %s]",
-			    version_req,
-			    tmp,
+			    req->version,
+			    req->compare_str,
 			    version);
 	}
 	return ret;
 }
 
 static gboolean
-fu_engine_check_requirement_not_child(FuEngine *self, XbNode *req, FuDevice *device, GError **error)
+fu_engine_check_requirement_not_child(FuEngine *self,
+				      FuRequirement *req,
+				      FuDevice *device,
+				      GError **error)
 {
 	GPtrArray *children = fu_device_get_children(device);
 
 	/* only <firmware> supported */
-	if (g_strcmp0(xb_node_get_element(req), "firmware") != 0) {
+	if (req->kind != FU_REQUIREMENT_KIND_FIRMWARE) {
 		g_set_error(error,
 			    FWUPD_ERROR,
 			    FWUPD_ERROR_NOT_SUPPORTED,
 			    "cannot handle not-child %s requirement",
-			    xb_node_get_element(req));
+			    req->element);
 		return FALSE;
 	}
 
@@ -1773,7 +1867,10 @@ fu_engine_check_requirement_not_child(FuEngine *self, XbNode *req, FuDevice *dev
 }
 
 static gboolean
-fu_engine_check_requirement_vendor_id(FuEngine *self, XbNode *req, FuDevice *device, GError **error)
+fu_engine_check_requirement_vendor_id(FuEngine *self,
+				      FuRequirement *req,
+				      FuDevice *device,
+				      GError **error)
 {
 	GPtrArray *vendor_ids;
 	const gchar *vendor_ids_metadata;
@@ -1791,7 +1888,7 @@ fu_engine_check_requirement_vendor_id(FuEngine *self, XbNode *req, FuDevice *dev
 	}
 
 	/* metadata with empty vendor IDs should not exist! */
-	vendor_ids_metadata = xb_node_get_attr(req, "version");
+	vendor_ids_metadata = req->version;
 	if (vendor_ids_metadata == NULL) {
 		g_set_error_literal(error,
 				    FWUPD_ERROR,
@@ -1800,9 +1897,9 @@ fu_engine_check_requirement_vendor_id(FuEngine *self, XbNode *req, FuDevice *dev
 		return FALSE;
 	}
 
-	/* it is always safe to use a regex, even for simple strings */
+	/* the regex was compiled when the metadata was loaded */
 	vendor_ids_device = fu_strjoin("|", vendor_ids);
-	if (!g_regex_match_simple(vendor_ids_metadata, vendor_ids_device, 0, 0)) {
+	if (req->regex == NULL || !g_regex_match(req->regex, vendor_ids_device, 0, NULL)) {
 		g_set_error(error,
 			    FWUPD_ERROR,
 			    FWUPD_ERROR_INVALID_FILE,
@@ -1830,7 +1927,7 @@ fu_device_has_guids_any(FuDevice *self, gchar **guids)
 
 static gboolean
 fu_engine_check_requirement_firmware(FuEngine *self,
-				     XbNode *req,
+				     FuRequirement *req,
 				     FuDevice *device,
 				     FwupdInstallFlags flags,
 				     GError **error)
@@ -1838,11 +1935,11 @@ fu_engine_check_requirement_firmware(FuEngine *self,
 	const gchar *version;
 	guint64 depth;
 	g_autoptr(FuDevice) device_actual = g_object_ref(device);
+	gchar **guids = req->values;
 	g_autoptr(GError) error_local = NULL;
-	g_auto(GStrv) guids = NULL;
 
 	/* look at the parent device */
-	depth = xb_node_get_attr_as_uint(req, "depth");
+	depth = req->depth;
 	if (depth != G_MAXUINT64) {
 		for (guint64 i = 0; i < depth; i++) {
 			FuDevice *device_tmp = fu_device_get_parent(device_actual);
@@ -1862,20 +1959,20 @@ fu_engine_check_requirement_firmware(FuEngine *self,
 	}
 
 	/* old firmware version */
-	if (xb_node_get_text(req) == NULL) {
+	if (req->firmware == FU_REQUIREMENT_FIRMWARE_VERSION) {
 		version = fu_device_get_version(device_actual);
 		if (!fu_engine_require_vercmp(req,
 					      version,
 					      fu_device_get_version_format(device_actual),
 					      &error_local)) {
-			if (g_strcmp0(xb_node_get_attr(req, "compare"), "ge") == 0) {
+			if (req->compare == FU_REQUIREMENT_COMPARE_GE) {
 				g_set_error(
 				    error,
 				    FWUPD_ERROR,
 				    FWUPD_ERROR_INVALID_FILE,
 				    "Not compatible with firmware version %s, requires >= %s",
 				    version,
-				    xb_node_get_attr(req, "version"));
+				    req->version);
 			} else {
 				g_set_error(error,
 					    FWUPD_ERROR,
@@ -1889,20 +1986,20 @@ fu_engine_check_requirement_firmware(FuEngine *self,
 	}
 
 	/* bootloader version */
-	if (g_strcmp0(xb_node_get_text(req), "bootloader") == 0) {
+	if (req->firmware == FU_REQUIREMENT_FIRMWARE_BOOTLOADER) {
 		version = fu_device_get_version_bootloader(device_actual);
 		if (!fu_engine_require_vercmp(req,
 					      version,
 					      fu_device_get_version_format(device_actual),
 					      &error_local)) {
-			if (g_strcmp0(xb_node_get_attr(req, "compare"), "ge") == 0) {
+			if (req->compare == FU_REQUIREMENT_COMPARE_GE) {
 				g_set_error(
 				    error,
 				    FWUPD_ERROR,
 				    FWUPD_ERROR_NOT_SUPPORTED,
 				    "Not compatible with bootloader version %s, requires >= %s",
 				    version,
-				    xb_node_get_attr(req, "version"));
+				    req->version);
 
 			} else {
 				g_debug("Bootloader is not compatible: %s", error_local->message);
@@ -1917,27 +2014,24 @@ fu_engine_check_requirement_firmware(FuEngine *self,
 	}
 
 	/* vendor ID */
-	if (g_strcmp0(xb_node_get_text(req), "vendor-id") == 0) {
+	if (req->firmware == FU_REQUIREMENT_FIRMWARE_VENDOR_ID) {
 		if (flags & FWUPD_INSTALL_FLAG_IGNORE_VID_PID)
 			return TRUE;
 		return fu_engine_check_requirement_vendor_id(self, req, device_actual, error);
 	}
 
 	/* child version */
-	if (g_strcmp0(xb_node_get_text(req), "not-child") == 0)
+	if (req->firmware == FU_REQUIREMENT_FIRMWARE_NOT_CHILD)
 		return fu_engine_check_requirement_not_child(self, req, device_actual, error);
 
 	/* another device, specified by GUID|GUID|GUID */
-	guids = g_strsplit(xb_node_get_text(req), "|", -1);
-	for (guint i = 0; guids[i] != NULL; i++) {
-		if (!fwupd_guid_is_valid(guids[i])) {
-			g_set_error(error,
-				    FWUPD_ERROR,
-				    FWUPD_ERROR_NOT_SUPPORTED,
-				    "%s is not a valid GUID",
-				    guids[i]);
-			return FALSE;
-		}
+	if (req->invalid != NULL) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_NOT_SUPPORTED,
+			    "%s is not a valid GUID",
+			    req->invalid);
+		return FALSE;
 	}
 
 	/* find if any of the other devices exists */
@@ -1953,7 +2047,7 @@ fu_engine_check_requirement_firmware(FuEngine *self,
 				    FWUPD_ERROR,
 				    FWUPD_ERROR_NOT_SUPPORTED,
 				    "No other device %s found",
-				    xb_node_get_text(req));
+				    req->text);
 			return FALSE;
 		}
 		g_set_object(&device_actual, device_tmp);
@@ -1971,7 +2065,7 @@ fu_engine_check_requirement_firmware(FuEngine *self,
 					    FWUPD_ERROR,
 					    FWUPD_ERROR_NOT_SUPPORTED,
 					    "No GUID of %s on self device %s",
-					    xb_node_get_text(req),
+					    req->text,
 					    fu_device_get_name(device_actual));
 				return FALSE;
 			}
@@ -1989,7 +2083,7 @@ fu_engine_check_requirement_firmware(FuEngine *self,
 				    FWUPD_ERROR,
 				    FWUPD_ERROR_NOT_SUPPORTED,
 				    "No sibling found with GUID of %s",
-				    xb_node_get_text(req));
+				    req->text);
 			return FALSE;
 		}
 		g_set_object(&device_actual, child);
@@ -2001,7 +2095,7 @@ fu_engine_check_requirement_firmware(FuEngine *self,
 				    FWUPD_ERROR,
 				    FWUPD_ERROR_NOT_SUPPORTED,
 				    "No GUID of %s on parent device %s",
-				    xb_node_get_text(req),
+				    req->text,
 				    fu_device_get_name(device_actual));
 			return FALSE;
 		}
@@ -2009,19 +2103,19 @@ fu_engine_check_requirement_firmware(FuEngine *self,
 
 	/* get the version of the other device */
 	version = fu_device_get_version(device_actual);
-	if (version != NULL && xb_node_get_attr(req, "compare") != NULL &&
+	if (version != NULL && req->compare_str != NULL &&
 	    !fu_engine_require_vercmp(req,
 				      version,
 				      fu_device_get_version_format(device_actual),
 				      &error_local)) {
-		if (g_strcmp0(xb_node_get_attr(req, "compare"), "ge") == 0) {
+		if (req->compare == FU_REQUIREMENT_COMPARE_GE) {
 			g_set_error(error,
 				    FWUPD_ERROR,
 				    FWUPD_ERROR_INVALID_FILE,
 				    "Not compatible with %s version %s, requires >= %s",
 				    fu_device_get_name(device_actual),
 				    version,
-				    xb_node_get_attr(req, "version"));
+				    req->version);
 		} else {
 			g_set_error(error,
 				    FWUPD_ERROR,
@@ -2038,63 +2132,61 @@ fu_engine_check_requirement_firmware(FuEngine *self,
 }
 
 static gboolean
-fu_engine_check_requirement_id(FuEngine *self, XbNode *req, GError **error)
+fu_engine_check_requirement_id(FuEngine *self, FuRequirement *req, GError **error)
 {
 	g_autoptr(GError) error_local = NULL;
 	const gchar *version;
 
 	/* sanity check */
-	if (xb_node_get_text(req) == NULL) {
+	if (req->text == NULL) {
 		g_set_error_literal(error,
 				    FWUPD_ERROR,
 				    FWUPD_ERROR_NOT_SUPPORTED,
 				    "no requirement value supplied");
 		return FALSE;
 	}
-	version = g_hash_table_lookup(self->runtime_versions, xb_node_get_text(req));
+	version = g_hash_table_lookup(self->runtime_versions, req->text);
 	if (version == NULL) {
 		g_set_error(error,
 			    FWUPD_ERROR,
 			    FWUPD_ERROR_NOT_FOUND,
 			    "no version available for %s",
-			    xb_node_get_text(req));
+			    req->text);
 		return FALSE;
 	}
 	if (!fu_engine_require_vercmp(req, version, FWUPD_VERSION_FORMAT_UNKNOWN, &error_local)) {
-		if (g_strcmp0(xb_node_get_attr(req, "compare"), "ge") == 0) {
+		if (req->compare == FU_REQUIREMENT_COMPARE_GE) {
 			g_set_error(error,
 				    FWUPD_ERROR,
 				    FWUPD_ERROR_INVALID_FILE,
 				    "Not compatible with %s version %s, requires >= %s",
-				    xb_node_get_text(req),
+				    req->text,
 				    version,
-				    xb_node_get_attr(req, "version"));
+				    req->version);
 		} else {
 			g_set_error(error,
 				    FWUPD_ERROR,
 				    FWUPD_ERROR_INVALID_FILE,
 				    "Not compatible with %s version: %s",
-				    xb_node_get_text(req),
+				    req->text,
 				    error_local->message);
 		}
 		return FALSE;
 	}
 
 	g_debug("requirement %s %s %s -> %s passed",
-		xb_node_get_attr(req, "version"),
-		xb_node_get_attr(req, "compare"),
+		req->version,
+		req->compare_str,
 		version,
-		xb_node_get_text(req));
+		req->text);
 	return TRUE;
 }
 
 static gboolean
-fu_engine_check_requirement_hardware(FuEngine *self, XbNode *req, GError **error)
+fu_engine_check_requirement_hardware(FuEngine *self, FuRequirement *req, GError **error)
 {
-	g_auto(GStrv) hwid_split = NULL;
-
 	/* sanity check */
-	if (xb_node_get_text(req) == NULL) {
+	if (req->text == NULL) {
 		g_set_error_literal(error,
 				    FWUPD_ERROR,
 				    FWUPD_ERROR_NOT_SUPPORTED,
@@ -2102,11 +2194,10 @@ fu_engine_check_requirement_hardware(FuEngine *self, XbNode *req, GError **error
 		return FALSE;
 	}
 
-	/* split and treat as OR */
-	hwid_split = g_strsplit(xb_node_get_text(req), "|", -1);
-	for (guint i = 0; hwid_split[i] != NULL; i++) {
-		if (fu_context_has_hwid_guid(self->ctx, hwid_split[i])) {
-			g_debug("HWID provided %s", hwid_split[i]);
+	/* treat as OR */
+	for (guint i = 0; req->values[i] != NULL; i++) {
+		if (fu_context_has_hwid_guid(self->ctx, req->values[i])) {
+			g_debug("HWID provided %s", req->values[i]);
 			return TRUE;
 		}
 	}
@@ -2116,21 +2207,20 @@ fu_engine_check_requirement_hardware(FuEngine *self, XbNode *req, GError **error
 		    FWUPD_ERROR,
 		    FWUPD_ERROR_INVALID_FILE,
 		    "no HWIDs matched %s",
-		    xb_node_get_text(req));
+		    req->text);
 	return FALSE;
 }
 
 static gboolean
 fu_engine_check_requirement_client(FuEngine *self,
 				   FuEngineRequest *request,
-				   XbNode *req,
+				   FuRequirement *req,
 				   GError **error)
 {
-	FwupdFeatureFlags flags;
-	g_auto(GStrv) feature_split = NULL;
+	FwupdFeatureFlags flags = fu_engine_request_get_feature_flags(request);
 
 	/* sanity check */
-	if (xb_node_get_text(req) == NULL) {
+	if (req->text == NULL) {
 		g_set_error_literal(error,
 				    FWUPD_ERROR,
 				    FWUPD_ERROR_NOT_SUPPORTED,
@@ -2138,31 +2228,29 @@ fu_engine_check_requirement_client(FuEngine *self,
 		return FALSE;
 	}
 
-	/* split and treat as AND */
-	feature_split = g_strsplit(xb_node_get_text(req), "|", -1);
-	flags = fu_engine_request_get_feature_flags(request);
-	for (guint i = 0; feature_split[i] != NULL; i++) {
-		FwupdFeatureFlags flag = fwupd_feature_flag_from_string(feature_split[i]);
-
-		/* not recognized */
-		if (flag == FWUPD_FEATURE_FLAG_LAST) {
-			g_set_error(error,
-				    FWUPD_ERROR,
-				    FWUPD_ERROR_NOT_FOUND,
-				    "client requirement %s unknown",
-				    feature_split[i]);
-			return FALSE;
+	/* treat as AND, where the known flags are all before any unknown flag */
+	if ((req->feature_flags & ~flags) != 0) {
+		for (guint i = 0; req->values[i] != NULL; i++) {
+			FwupdFeatureFlags flag = fwupd_feature_flag_from_string(req->values[i]);
+			if ((flags & flag) == 0) {
+				g_set_error(error,
+					    FWUPD_ERROR,
+					    FWUPD_ERROR_NOT_SUPPORTED,
+					    "client requirement %s not supported",
+					    req->values[i]);
+				return FALSE;
+			}
 		}
+	}
 
-		/* not supported */
-		if ((flags & flag) == 0) {
-			g_set_error(error,
-				    FWUPD_ERROR,
-				    FWUPD_ERROR_NOT_SUPPORTED,
-				    "client requirement %s not supported",
-				    feature_split[i]);
-			return FALSE;
-		}
+	/* not recognized */
+	if (req->invalid != NULL) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_NOT_FOUND,
+			    "client requirement %s unknown",
+			    req->invalid);
+		return FALSE;
 	}
 
 	/* success */
@@ -2172,41 +2260,40 @@ fu_engine_check_requirement_client(FuEngine *self,
 static gboolean
 fu_engine_check_requirement(FuEngine *self,
 			    FuRelease *release,
-			    XbNode *req,
+			    FuRequirement *req,
 			    FwupdInstallFlags flags,
 			    GError **error)
 {
 	FuDevice *device = fu_release_get_device(release);
 	FuEngineRequest *request = fu_release_get_request(release);
 
-	/* ensure component requirement */
-	if (g_strcmp0(xb_node_get_element(req), "id") == 0)
+	switch (req->kind) {
+	case FU_REQUIREMENT_KIND_ID:
+		/* ensure component requirement */
 		return fu_engine_check_requirement_id(self, req, error);
-
-	/* ensure firmware requirement */
-	if (g_strcmp0(xb_node_get_element(req), "firmware") == 0) {
+	case FU_REQUIREMENT_KIND_FIRMWARE:
+		/* ensure firmware requirement */
 		if (device == NULL)
 			return TRUE;
 		return fu_engine_check_requirement_firmware(self, req, device, flags, error);
-	}
-
-	/* ensure hardware requirement */
-	if (g_strcmp0(xb_node_get_element(req), "hardware") == 0) {
+	case FU_REQUIREMENT_KIND_HARDWARE:
+		/* ensure hardware requirement */
 		if (!self->has_hwinfo)
 			return TRUE;
 		return fu_engine_check_requirement_hardware(self, req, error);
-	}
-
-	/* ensure client requirement */
-	if (g_strcmp0(xb_node_get_element(req), "client") == 0)
+	case FU_REQUIREMENT_KIND_CLIENT:
+		/* ensure client requirement */
 		return fu_engine_check_requirement_client(self, request, req, error);
+	default:
+		break;
+	}
 
 	/* not supported */
 	g_set_error(error,
 		    FWUPD_ERROR,
 		    FWUPD_ERROR_NOT_SUPPORTED,
 		    "cannot handle requirement type %s",
-		    xb_node_get_element(req));
+		    req->element);
 	return FALSE;
 }
 
@@ -2234,7 +2321,7 @@ fu_engine_check_trust(FuEngine *self, FuRelease *release, GError **error)
 static gboolean
 fu_engine_check_soft_requirement(FuEngine *self,
 				 FuRelease *release,
-				 XbNode *req,
+				 FuRequirement *req,
 				 FwupdInstallFlags flags,
 				 GError **error)
 {
@@ -2263,7 +2350,7 @@ fu_engine_check_requirements(FuEngine *self,
 	reqs = fu_release_get_hard_reqs(release);
 	if (reqs != NULL) {
 		for (guint i = 0; i < reqs->len; i++) {
-			XbNode *req = g_ptr_array_index(reqs, i);
+			FuRequirement *req = g_ptr_array_index(reqs, i);
 			if (!fu_engine_check_requirement(self, release, req, flags, error))
 				return FALSE;
 		}
@@ -2273,7 +2360,7 @@ fu_engine_check_requirements(FuEngine *self,
 	reqs = fu_release_get_soft_reqs(release);
 	if (reqs != NULL) {
 		for (guint i = 0; i < reqs->len; i++) {
-			XbNode *req = g_ptr_array_index(reqs, i);
+			FuRequirement *req = g_ptr_array_index(reqs, i);
 			if (!fu_engine_check_soft_requirement(self, release, req, flags, error))
 				return FALSE;
 		}
@@ -3075,6 +3162,30 @@ fu_engine_save_into_backup_remote(FuEngine *self, GBytes *fw, GError **error)
 	return fwupd_remote_save_to_filename(remote, remotes_fn, NULL, error);
 }
 
+static void
+fu_engine_record_throughput(FuEngine *self,
+			    FuDevice *device,
+			    FuRelease *release,
+			    guint64 bytes,
+			    gint64 elapsed)
+{
+	g_autofree gchar *str = NULL;
+	g_autoptr(GError) error_local = NULL;
+
+	/* the plugin does not report transfers */
+	if (bytes == 0 || elapsed <= 0)
+		return;
+
+	str = g_strdup_printf("%" G_GUINT64_FORMAT, (bytes * G_USEC_PER_SEC) / (guint64)elapsed);
+	g_info("average throughput for %s was %s bytes/sec", fu_device_get_id(device), str);
+	fwupd_release_add_metadata_item(FWUPD_RELEASE(release), "Throughput", str);
+	if (!fu_history_modify_device_release(self->history,
+					      device,
+					      FWUPD_RELEASE(release),
+					      &error_local))
+		g_warning("failed to save throughput: %s", error_local->message);
+}
+
 /**
  * fu_engine_install_release:
  * @self: a #FuEngine
@@ -3108,6 +3219,8 @@ fu_engine_install_release(FuEngine *self,
 	GBytes *blob_fw;
 	const gchar *tmp;
 	const gchar *version_rel;
+	gint64 install_start;
+	guint64 install_bytes;
 	g_autofree gchar *version_orig = NULL;
 	g_autoptr(FuDevice) device = NULL;
 	g_autoptr(FuDevice) device_tmp = NULL;
@@ -3125,10 +3238,11 @@ fu_engine_install_release(FuEngine *self,
 
 	/* add the checksum of the container blob if not already set */
 	if (fwupd_release_get_checksums(FWUPD_RELEASE(release))->len == 0) {
-		GChecksumType checksum_types[] = {G_CHECKSUM_SHA256, G_CHECKSUM_SHA1, 0};
-		for (guint i = 0; checksum_types[i] != 0; i++) {
-			g_autofree gchar *checksum =
-			    g_compute_checksum_for_bytes(checksum_types[i], blob_cab);
+		GChecksumType checksum_types[] = {G_CHECKSUM_SHA256, G_CHECKSUM_SHA1};
+		g_autoptr(GPtrArray) checksums =
+		    fu_bytes_get_checksums(blob_cab, checksum_types, G_N_ELEMENTS(checksum_types));
+		for (guint i = 0; i < checksums->len; i++) {
+			const gchar *checksum = g_ptr_array_index(checksums, i);
 			fwupd_release_add_checksum(FWUPD_RELEASE(release), checksum);
 		}
 	}
@@ -3200,6 +3314,8 @@ fu_engine_install_release(FuEngine *self,
 
 	/* install firmware blob */
 	version_orig = g_strdup(fu_device_get_version(device));
+	install_start = g_get_monotonic_time();
+	install_bytes = fu_progress_get_bytes(progress);
 	if (!fu_engine_install_blob(self,
 				    device,
 				    blob_fw,
@@ -3221,6 +3337,15 @@ fu_engine_install_release(FuEngine *self,
 		return FALSE;
 	}
 
+	/* save the average transfer rate to predict how long future updates will take */
+	if ((flags & FWUPD_INSTALL_FLAG_NO_HISTORY) == 0) {
+		fu_engine_record_throughput(self,
+					    device,
+					    release,
+					    fu_progress_get_bytes(progress) - install_bytes,
+					    g_get_monotonic_time() - install_start);
+	}
+
 	/* the device may have changed */
 	device_tmp = fu_device_list_get_by_id(self->device_list, fu_device_get_id(device), error);
 	if (device_tmp == NULL) {
@@ -3288,21 +3413,22 @@ fu_engine_get_plugins(FuEngine *self)
 }
 
 static gboolean
-fu_engine_emulation_load_json(FuEngine *self, const gchar *json, GError **error)
+fu_engine_emulation_load_json(FuEngine *self, JsonNode *json_node, GError **error)
 {
-	JsonNode *root;
-	g_autoptr(JsonParser) parser = json_parser_new();
-
-	/* parse */
-	if (!json_parser_load_from_data(parser, json, -1, error))
+	/* sanity check */
+	if (!JSON_NODE_HOLDS_OBJECT(json_node)) {
+		g_set_error_literal(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_INVALID_FILE,
+				    "emulation data is not a JSON object");
 		return FALSE;
-	root = json_parser_get_root(parser);
+	}
 
 	/* load into all backends */
 	for (guint i = 0; i < self->backends->len; i++) {
 		FuBackend *backend = g_ptr_array_index(self->backends, i);
 		if (!fu_backend_load(backend,
-				     json_node_get_object(root),
+				     json_node_get_object(json_node),
 				     FU_USB_DEVICE_EMULATION_TAG,
 				     FU_BACKEND_LOAD_FLAG_NONE,
 				     error))
@@ -3316,11 +3442,43 @@ fu_engine_emulation_load_json(FuEngine *self, const gchar *json, GError **error)
 static gboolean
 fu_engine_emulation_load_phase(FuEngine *self, FuEngineInstallPhase phase, GError **error)
 {
-	const gchar *json = g_hash_table_lookup(self->emulation_phases, GINT_TO_POINTER(phase));
-	if (json == NULL)
+	JsonNode *json_node = g_hash_table_lookup(self->emulation_phases, GINT_TO_POINTER(phase));
+	if (json_node == NULL)
 		return TRUE;
-	g_info("loading phase %s: %s", fu_engine_install_phase_to_string(phase), json);
-	return fu_engine_emulation_load_json(self, json, error);
+	g_info("loading phase %s", fu_engine_install_phase_to_string(phase));
+	return fu_engine_emulation_load_json(self, json_node, error);
+}
+
+/* the compact binary format is preferred, but captures using JSON are still supported */
+static JsonNode *
+fu_engine_emulation_load_archive_phase(FuArchive *archive,
+				       FuEngineInstallPhase phase,
+				       GError **error)
+{
+	const gchar *phase_str = fu_engine_install_phase_to_string(phase);
+	g_autofree gchar *fn_bin = g_strdup_printf("%s.bin", phase_str);
+	g_autofree gchar *fn_json = g_strdup_printf("%s.json", phase_str);
+	GBytes *blob;
+	g_autoptr(JsonParser) parser = json_parser_new();
+
+	blob = fu_archive_lookup_by_fn(archive, fn_bin, NULL);
+	if (blob != NULL)
+		return fu_emulation_blob_to_json_node(blob, error);
+	blob = fu_archive_lookup_by_fn(archive, fn_json, NULL);
+	if (blob == NULL) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_NOT_FOUND,
+			    "no emulation data for phase %s",
+			    phase_str);
+		return NULL;
+	}
+	if (!json_parser_load_from_data(parser,
+					g_bytes_get_data(blob, NULL),
+					g_bytes_get_size(blob),
+					error))
+		return NULL;
+	return json_parser_steal_root(parser);
 }
 
 gboolean
@@ -3328,6 +3486,7 @@ fu_engine_emulation_load(FuEngine *self, GBytes *data, GError **error)
 {
 	gboolean got_json = FALSE;
 	g_autoptr(FuArchive) archive = NULL;
+	g_autoptr(JsonParser) parser = json_parser_new();
 
 	g_return_val_if_fail(FU_IS_ENGINE(self), FALSE);
 	g_return_val_if_fail(data != NULL, FALSE);
@@ -3343,7 +3502,9 @@ fu_engine_emulation_load(FuEngine *self, GBytes *data, GError **error)
 	}
 
 	/* unload any existing devices */
-	if (!fu_engine_emulation_load_json(self, "{\"UsbDevices\":[]}", error))
+	if (!json_parser_load_from_data(parser, "{\"UsbDevices\":[]}", -1, error))
+		return FALSE;
+	if (!fu_engine_emulation_load_json(self, json_parser_get_root(parser), error))
 		return FALSE;
 
 	/* load archive */
@@ -3351,28 +3512,30 @@ fu_engine_emulation_load(FuEngine *self, GBytes *data, GError **error)
 	if (archive == NULL)
 		return FALSE;
 
-	/* load JSON files from archive */
+	/* load each phase from archive, which is only parsed once */
 	g_hash_table_remove_all(self->emulation_phases);
 	for (guint phase = FU_ENGINE_INSTALL_PHASE_SETUP; phase < FU_ENGINE_INSTALL_PHASE_LAST;
 	     phase++) {
-		g_autofree gchar *fn =
-		    g_strdup_printf("%s.json", fu_engine_install_phase_to_string(phase));
-		g_autofree gchar *json_safe = NULL;
-		GBytes *blob = fu_archive_lookup_by_fn(archive, fn, NULL);
+		g_autoptr(GError) error_local = NULL;
+		g_autoptr(JsonNode) json_node = NULL;
 
 		/* not found */
-		if (blob == NULL)
-			continue;
-		json_safe = g_strndup(g_bytes_get_data(blob, NULL), g_bytes_get_size(blob));
+		json_node = fu_engine_emulation_load_archive_phase(archive, phase, &error_local);
+		if (json_node == NULL) {
+			if (g_error_matches(error_local, FWUPD_ERROR, FWUPD_ERROR_NOT_FOUND))
+				continue;
+			g_propagate_error(error, g_steal_pointer(&error_local));
+			return FALSE;
+		}
 		got_json = TRUE;
 		g_info("got emulation for phase %s", fu_engine_install_phase_to_string(phase));
 		if (phase == FU_ENGINE_INSTALL_PHASE_SETUP) {
-			if (!fu_engine_emulation_load_json(self, json_safe, error))
+			if (!fu_engine_emulation_load_json(self, json_node, error))
 				return FALSE;
 		} else {
 			g_hash_table_insert(self->emulation_phases,
 					    GINT_TO_POINTER(phase),
-					    g_steal_pointer(&json_safe));
+					    g_steal_pointer(&json_node));
 		}
 	}
 	if (!got_json) {
@@ -3409,17 +3572,23 @@ fu_engine_emulation_save(FuEngine *self, GError **error)
 	/* sanity check */
 	for (guint phase = FU_ENGINE_INSTALL_PHASE_SETUP; phase < FU_ENGINE_INSTALL_PHASE_LAST;
 	     phase++) {
-		const gchar *json =
+		JsonNode *json_node =
 		    g_hash_table_lookup(self->emulation_phases, GINT_TO_POINTER(phase));
 		g_autofree gchar *fn =
-		    g_strdup_printf("%s.json", fu_engine_install_phase_to_string(phase));
+		    g_strdup_printf("%s.bin", fu_engine_install_phase_to_string(phase));
 		g_autoptr(GBytes) blob = NULL;
 
 		/* nothing set */
-		if (json == NULL)
+		if (json_node == NULL)
 			continue;
 		got_json = TRUE;
-		blob = g_bytes_new_static(json, strlen(json));
+
+		/* the archive is already compressed */
+		blob = fu_emulation_blob_from_json_node(json_node,
+							FU_EMULATION_BLOB_FLAG_NONE,
+							error);
+		if (blob == NULL)
+			return NULL;
 		fu_archive_add_entry(archive, fn, blob);
 	}
 	if (!got_json) {
@@ -3443,12 +3612,9 @@ fu_engine_emulation_save(FuEngine *self, GError **error)
 static gboolean
 fu_engine_backends_save_phase(FuEngine *self, GError **error)
 {
-	const gchar *data_old;
-	g_autofree gchar *data_new = NULL;
-	g_autofree gchar *data_new_safe = NULL;
+	JsonNode *json_old;
 	g_autoptr(JsonBuilder) json_builder = json_builder_new();
-	g_autoptr(JsonGenerator) json_generator = NULL;
-	g_autoptr(JsonNode) json_root = NULL;
+	g_autoptr(JsonNode) json_new = NULL;
 
 	/* all devices in all backends */
 	for (guint i = 0; i < self->backends->len; i++) {
@@ -3460,32 +3626,27 @@ fu_engine_backends_save_phase(FuEngine *self, GError **error)
 				     error))
 			return FALSE;
 	}
-	json_root = json_builder_get_root(json_builder);
-	json_generator = json_generator_new();
-	json_generator_set_pretty(json_generator, TRUE);
-	json_generator_set_root(json_generator, json_root);
-
-	data_old =
-	    g_hash_table_lookup(self->emulation_phases, GINT_TO_POINTER(self->install_phase));
-	data_new = json_generator_to_data(json_generator, NULL);
-	if (g_strcmp0(data_new, "") == 0) {
+	json_new = json_builder_get_root(json_builder);
+	if (json_new == NULL) {
 		g_info("no data for phase %s",
 		       fu_engine_install_phase_to_string(self->install_phase));
 		return TRUE;
 	}
-	if (g_strcmp0(data_old, data_new) == 0) {
+
+	/* compare the trees rather than generating and comparing the text */
+	json_old =
+	    g_hash_table_lookup(self->emulation_phases, GINT_TO_POINTER(self->install_phase));
+	if (json_old != NULL && json_node_equal(json_old, json_new)) {
 		g_info("JSON unchanged for phase %s",
 		       fu_engine_install_phase_to_string(self->install_phase));
 		return TRUE;
 	}
-	data_new_safe = g_strndup(data_new, 8000);
-	g_info("JSON %s for phase %s: %s...",
-	       data_old == NULL ? "added" : "changed",
-	       fu_engine_install_phase_to_string(self->install_phase),
-	       data_new_safe);
+	g_info("JSON %s for phase %s",
+	       json_old == NULL ? "added" : "changed",
+	       fu_engine_install_phase_to_string(self->install_phase));
 	g_hash_table_insert(self->emulation_phases,
 			    GINT_TO_POINTER(self->install_phase),
-			    g_steal_pointer(&data_new));
+			    g_steal_pointer(&json_new));
 
 	/* success */
 	return TRUE;
@@ -4290,7 +4451,7 @@ fu_engine_create_silo_index(FuEngine *self, GError **error)
 	    xb_query_new_full(self->silo,
 			      "components/component/provides/firmware[@type=$'flashed'][text()=?]/"
 			      "../..",
-			      XB_QUERY_FLAG_OPTIMIZE,
+			      XB_QUERY_FLAG_OPTIMIZE | XB_QUERY_FLAG_FORCE_NODE_CACHE,
 			      error);
 	if (self->query_component_by_guid == NULL) {
 		g_prefix_error(error, "failed to prepare query: ");
@@ -4355,6 +4516,112 @@ fu_engine_appstream_upgrade_cb(XbBuilderFixup *self,
 	return TRUE;
 }
 
+typedef struct {
+	FuEngine *self;
+	gchar *filename;
+	gchar *cachedir; /* nullable */
+} FuEngineCabinetHelper;
+
+static void
+fu_engine_cabinet_helper_free(FuEngineCabinetHelper *helper)
+{
+	g_free(helper->filename);
+	g_free(helper->cachedir);
+	g_free(helper);
+}
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC(FuEngineCabinetHelper, fu_engine_cabinet_helper_free)
+
+static gint
+fu_engine_cabinet_cache_sort_cb(gconstpointer a, gconstpointer b)
+{
+	return g_strcmp0(*(const gchar **)a, *(const gchar **)b);
+}
+
+/* the trust flags are included in the exported XML, so the cache has to be invalidated when the
+ * daemon version, the archive limits or any of the public keys change */
+static gchar *
+fu_engine_cabinet_cache_salt(FuEngine *self)
+{
+	const gchar *subdirs[] = {"fwupd", "fwupd-metadata", NULL};
+	g_autofree gchar *sysconfdir = fu_path_from_kind(FU_PATH_KIND_SYSCONFDIR);
+	g_autofree gchar *str = NULL;
+	g_autoptr(GChecksum) csum = g_checksum_new(G_CHECKSUM_SHA256);
+
+	str = g_strdup_printf("%s:%" G_GUINT64_FORMAT,
+			      SOURCE_VERSION,
+			      fu_engine_config_get_archive_size_max(self->config));
+	g_checksum_update(csum, (const guchar *)str, -1);
+	for (guint i = 0; subdirs[i] != NULL; i++) {
+		g_autofree gchar *pkidir = g_build_filename(sysconfdir, "pki", subdirs[i], NULL);
+		g_autoptr(GPtrArray) files = fu_path_get_files(pkidir, NULL);
+		if (files == NULL)
+			continue;
+		g_ptr_array_sort(files, fu_engine_cabinet_cache_sort_cb);
+		for (guint j = 0; j < files->len; j++) {
+			const gchar *fn = g_ptr_array_index(files, j);
+			GStatBuf statbuf = {0};
+			g_autofree gchar *tmp = NULL;
+			if (g_stat(fn, &statbuf) != 0)
+				continue;
+			tmp = g_strdup_printf("%s:%" G_GUINT64_FORMAT ":%" G_GINT64_FORMAT,
+					      fn,
+					      (guint64)statbuf.st_size,
+					      (gint64)statbuf.st_mtime);
+			g_checksum_update(csum, (const guchar *)tmp, -1);
+		}
+	}
+	return g_strdup(g_checksum_get_string(csum));
+}
+
+/* the checksum file is named from the cabinet path, and is prefixed with the file attributes */
+static gchar *
+fu_engine_cabinet_cache_build_checksum_filename(const gchar *cachedir, const gchar *filename)
+{
+	g_autofree gchar *basename = NULL;
+	g_autofree gchar *id = g_compute_checksum_for_string(G_CHECKSUM_SHA256, filename, -1);
+	basename = g_strdup_printf("%s.checksum", id);
+	return g_build_filename(cachedir, basename, NULL);
+}
+
+static gchar *
+fu_engine_cabinet_cache_build_xml_filename(const gchar *cachedir, const gchar *checksum)
+{
+	g_autofree gchar *basename = g_strdup_printf("%s.xml", checksum);
+	return g_build_filename(cachedir, basename, NULL);
+}
+
+/* the mtime alone is only accurate to the second and can be set to any value, so also include the
+ * sub-second part, the ctime and the inode -- replacing the file by renaming changes the inode */
+static gchar *
+fu_engine_cabinet_cache_stat_prefix(const gchar *filename)
+{
+	g_autoptr(GFile) file = g_file_new_for_path(filename);
+	g_autoptr(GFileInfo) info = NULL;
+
+	info = g_file_query_info(file,
+				 G_FILE_ATTRIBUTE_STANDARD_SIZE
+				 "," G_FILE_ATTRIBUTE_TIME_MODIFIED
+				 "," G_FILE_ATTRIBUTE_TIME_MODIFIED_USEC
+				 "," G_FILE_ATTRIBUTE_TIME_CHANGED
+				 "," G_FILE_ATTRIBUTE_TIME_CHANGED_USEC
+				 "," G_FILE_ATTRIBUTE_UNIX_INODE,
+				 G_FILE_QUERY_INFO_NONE,
+				 NULL,
+				 NULL);
+	if (info == NULL)
+		return NULL;
+	return g_strdup_printf(
+	    "%" G_GUINT64_FORMAT ":%" G_GUINT64_FORMAT ".%06u:%" G_GUINT64_FORMAT
+	    ".%06u:%" G_GUINT64_FORMAT ":",
+	    g_file_info_get_attribute_uint64(info, G_FILE_ATTRIBUTE_STANDARD_SIZE),
+	    g_file_info_get_attribute_uint64(info, G_FILE_ATTRIBUTE_TIME_MODIFIED),
+	    g_file_info_get_attribute_uint32(info, G_FILE_ATTRIBUTE_TIME_MODIFIED_USEC),
+	    g_file_info_get_attribute_uint64(info, G_FILE_ATTRIBUTE_TIME_CHANGED),
+	    g_file_info_get_attribute_uint32(info, G_FILE_ATTRIBUTE_TIME_CHANGED_USEC),
+	    g_file_info_get_attribute_uint64(info, G_FILE_ATTRIBUTE_UNIX_INODE));
+}
+
 static GInputStream *
 fu_engine_builder_cabinet_adapter_cb(XbBuilderSource *source,
 				     XbBuilderSourceCtx *ctx,
@@ -4362,37 +4629,90 @@ fu_engine_builder_cabinet_adapter_cb(XbBuilderSource *source,
 				     GCancellable *cancellable,
 				     GError **error)
 {
-	FuEngine *self = FU_ENGINE(user_data);
-	g_autoptr(GBytes) blob = NULL;
-	g_autoptr(XbSilo) silo = NULL;
+	FuEngineCabinetHelper *helper = (FuEngineCabinetHelper *)user_data;
+	g_autofree gchar *checksum = NULL;
+	g_autofree gchar *fn_checksum = NULL;
+	g_autofree gchar *fn_xml = NULL;
+	g_autofree gchar *prefix = NULL;
 	g_autofree gchar *xml = NULL;
+	g_autoptr(GBytes) blob = NULL;
 
-	/* convert the CAB into metadata XML */
+	/* the cabinet has not been modified since it was last converted */
+	if (helper->cachedir != NULL) {
+		g_autofree gchar *buf = NULL;
+		fn_checksum = fu_engine_cabinet_cache_build_checksum_filename(helper->cachedir,
+									      helper->filename);
+		prefix = fu_engine_cabinet_cache_stat_prefix(helper->filename);
+		if (prefix != NULL && g_file_get_contents(fn_checksum, &buf, NULL, NULL) &&
+		    g_str_has_prefix(buf, prefix)) {
+			g_autofree gchar *fn = NULL;
+			fn = fu_engine_cabinet_cache_build_xml_filename(helper->cachedir,
+									buf + strlen(prefix));
+			if (g_file_get_contents(fn, &xml, NULL, NULL)) {
+				g_debug("using cached metadata for %s", helper->filename);
+				return g_memory_input_stream_new_from_data(g_steal_pointer(&xml),
+									   -1,
+									   g_free);
+			}
+		}
+	}
+
+	/* the cabinet may have just been touched, so check the contents */
 	blob = xb_builder_source_ctx_get_bytes(ctx, cancellable, error);
 	if (blob == NULL)
 		return NULL;
-	silo = fu_engine_get_silo_from_blob(self, blob, error);
-	if (silo == NULL)
-		return NULL;
-	xml = xb_silo_export(silo, XB_NODE_EXPORT_FLAG_NONE, error);
-	if (xml == NULL)
-		return NULL;
+	if (helper->cachedir != NULL) {
+		checksum = g_compute_checksum_for_bytes(G_CHECKSUM_SHA256, blob);
+		fn_xml = fu_engine_cabinet_cache_build_xml_filename(helper->cachedir, checksum);
+		if (g_file_get_contents(fn_xml, &xml, NULL, NULL))
+			g_debug("using cached metadata for %s contents", helper->filename);
+	}
+
+	/* convert the CAB into metadata XML */
+	if (xml == NULL) {
+		g_autoptr(XbSilo) silo = fu_engine_get_silo_from_blob(helper->self, blob, error);
+		if (silo == NULL)
+			return NULL;
+		xml = xb_silo_export(silo, XB_NODE_EXPORT_FLAG_NONE, error);
+		if (xml == NULL)
+			return NULL;
+		if (fn_xml != NULL) {
+			g_autoptr(GError) error_local = NULL;
+			if (!g_file_set_contents(fn_xml, xml, -1, &error_local))
+				g_debug("failed to save cached metadata: %s", error_local->message);
+		}
+	}
+
+	/* only the checksum has to be calculated next time */
+	if (fn_checksum != NULL && prefix != NULL) {
+		g_autofree gchar *buf = g_strdup_printf("%s%s", prefix, checksum);
+		g_autoptr(GError) error_local = NULL;
+		if (!g_file_set_contents(fn_checksum, buf, -1, &error_local))
+			g_debug("failed to save cached checksum: %s", error_local->message);
+	}
 	return g_memory_input_stream_new_from_data(g_steal_pointer(&xml), -1, g_free);
 }
 
 static XbBuilderSource *
-fu_engine_create_metadata_builder_source(FuEngine *self, const gchar *fn, GError **error)
+fu_engine_create_metadata_builder_source(FuEngine *self,
+					 const gchar *fn,
+					 const gchar *cachedir,
+					 GError **error)
 {
+	g_autoptr(FuEngineCabinetHelper) helper = g_new0(FuEngineCabinetHelper, 1);
 	g_autoptr(GFile) file = g_file_new_for_path(fn);
 	g_autoptr(XbBuilderSource) source = xb_builder_source_new();
 
 	g_info("using %s as metadata source", fn);
+	helper->self = self;
+	helper->filename = g_strdup(fn);
+	helper->cachedir = g_strdup(cachedir);
 	xb_builder_source_add_simple_adapter(source,
 					     "application/vnd.ms-cab-compressed,"
 					     "application/octet-stream",
 					     fu_engine_builder_cabinet_adapter_cb,
-					     self,
-					     NULL);
+					     g_steal_pointer(&helper),
+					     (GDestroyNotify)fu_engine_cabinet_helper_free);
 	if (!xb_builder_source_load_file(source,
 					 file,
 #if LIBJCAT_CHECK_VERSION(0, 2, 0)
@@ -4407,11 +4727,88 @@ fu_engine_create_metadata_builder_source(FuEngine *self, const gchar *fn, GError
 	return g_steal_pointer(&source);
 }
 
+/* remove anything that does not match a cabinet still in the directory */
+static void
+fu_engine_cabinet_cache_prune(const gchar *cachedir, GHashTable *checksum_fns)
+{
+	const gchar *fn;
+	g_autoptr(GDir) dir = NULL;
+	g_autoptr(GHashTable) xml_fns = NULL;
+	g_autoptr(GPtrArray) unused = g_ptr_array_new_with_free_func(g_free);
+
+	dir = g_dir_open(cachedir, 0, NULL);
+	if (dir == NULL)
+		return;
+	xml_fns = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+	while ((fn = g_dir_read_name(dir)) != NULL) {
+		g_autofree gchar *buf = NULL;
+		g_autofree gchar *path = g_build_filename(cachedir, fn, NULL);
+		const gchar *checksum;
+		if (!g_str_has_suffix(fn, ".checksum"))
+			continue;
+		if (!g_hash_table_contains(checksum_fns, path)) {
+			g_ptr_array_add(unused, g_steal_pointer(&path));
+			continue;
+		}
+		if (!g_file_get_contents(path, &buf, NULL, NULL))
+			continue;
+		checksum = g_strrstr(buf, ":");
+		if (checksum != NULL)
+			g_hash_table_add(xml_fns, g_strdup_printf("%s.xml", checksum + 1));
+	}
+	g_dir_rewind(dir);
+	while ((fn = g_dir_read_name(dir)) != NULL) {
+		if (g_str_has_suffix(fn, ".xml") && !g_hash_table_contains(xml_fns, fn))
+			g_ptr_array_add(unused, g_build_filename(cachedir, fn, NULL));
+	}
+	for (guint i = 0; i < unused->len; i++) {
+		const gchar *path = g_ptr_array_index(unused, i);
+		g_debug("removing unused %s", path);
+		if (g_unlink(path) != 0)
+			g_debug("failed to delete %s", path);
+	}
+}
+
+static gchar *
+fu_engine_cabinet_cache_ensure_dir(FuEngine *self, FwupdRemote *remote, GError **error)
+{
+	const gchar *fn;
+	g_autofree gchar *cachedirpkg = fu_path_from_kind(FU_PATH_KIND_CACHEDIR_PKG);
+	g_autofree gchar *cachedir = NULL;
+	g_autofree gchar *cachedir_remote = NULL;
+	g_autofree gchar *salt = fu_engine_cabinet_cache_salt(self);
+	g_autoptr(GDir) dir = NULL;
+
+	/* delete anything created with different keys or an older daemon */
+	cachedir_remote =
+	    g_build_filename(cachedirpkg, "cabinets", fwupd_remote_get_id(remote), NULL);
+	dir = g_dir_open(cachedir_remote, 0, NULL);
+	while (dir != NULL && (fn = g_dir_read_name(dir)) != NULL) {
+		g_autofree gchar *path = NULL;
+		g_autoptr(GError) error_local = NULL;
+		if (g_strcmp0(fn, salt) == 0)
+			continue;
+		path = g_build_filename(cachedir_remote, fn, NULL);
+		if (!fu_path_rmtree(path, &error_local))
+			g_debug("failed to remove %s: %s", path, error_local->message);
+	}
+	g_clear_pointer(&dir, g_dir_close);
+
+	/* create the new location */
+	cachedir = g_build_filename(cachedir_remote, salt, NULL);
+	if (!fu_path_mkdir(cachedir, error))
+		return NULL;
+	return g_steal_pointer(&cachedir);
+}
+
 static gboolean
 fu_engine_create_metadata(FuEngine *self, XbBuilder *builder, FwupdRemote *remote, GError **error)
 {
-	g_autoptr(GPtrArray) files = NULL;
 	const gchar *path;
+	g_autofree gchar *cachedir = NULL;
+	g_autoptr(GError) error_cache = NULL;
+	g_autoptr(GHashTable) checksum_fns = NULL;
+	g_autoptr(GPtrArray) files = NULL;
 
 	/* find all files in directory */
 	path = fwupd_remote_get_filename_cache(remote);
@@ -4419,6 +4816,12 @@ fu_engine_create_metadata(FuEngine *self, XbBuilder *builder, FwupdRemote *remot
 	if (files == NULL)
 		return FALSE;
 
+	/* so only the cabinets that have changed need to be parsed */
+	cachedir = fu_engine_cabinet_cache_ensure_dir(self, remote, &error_cache);
+	if (cachedir == NULL)
+		g_info("not caching cabinet metadata: %s", error_cache->message);
+	checksum_fns = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+
 	/* add each source */
 	for (guint i = 0; i < files->len; i++) {
 		g_autoptr(XbBuilderNode) custom = NULL;
@@ -4434,7 +4837,7 @@ fu_engine_create_metadata(FuEngine *self, XbBuilder *builder, FwupdRemote *remot
 		}
 
 		/* build source for file */
-		source = fu_engine_create_metadata_builder_source(self, fn, &error_local);
+		source = fu_engine_create_metadata_builder_source(self, fn, cachedir, &error_local);
 		if (source == NULL) {
 			g_warning("failed to create builder source: %s", error_local->message);
 			continue;
@@ -4456,7 +4859,16 @@ fu_engine_create_metadata(FuEngine *self, XbBuilder *builder, FwupdRemote *remot
 					    NULL);
 		xb_builder_source_set_info(source, custom);
 		xb_builder_import_source(builder, source);
+		if (cachedir != NULL) {
+			g_autofree gchar *fn_checksum =
+			    fu_engine_cabinet_cache_build_checksum_filename(cachedir, fn);
+			g_hash_table_add(checksum_fns, g_steal_pointer(&fn_checksum));
+		}
 	}
+
+	/* the cache entries for deleted cabinets are no longer required */
+	if (cachedir != NULL)
+		fu_engine_cabinet_cache_prune(cachedir, checksum_fns);
 	return TRUE;
 }
 
@@ -4557,6 +4969,22 @@ fu_engine_load_metadata_store_local(FuEngine *self,
 	return TRUE;
 }
 
+#ifdef HAVE_ZSTD
+static GInputStream *
+fu_engine_builder_zstd_adapter_cb(XbBuilderSource *source,
+				  XbBuilderSourceCtx *ctx,
+				  gpointer user_data,
+				  GCancellable *cancellable,
+				  GError **error)
+{
+	GInputStream *istream = xb_builder_source_ctx_get_stream(ctx);
+	g_autoptr(FuZstdDecompressor) conv = fu_zstd_decompressor_new();
+
+	/* decompress as the XML is parsed rather than into one huge buffer */
+	return g_converter_input_stream_new(istream, G_CONVERTER(conv));
+}
+#endif
+
 static gboolean
 fu_engine_load_metadata_store(FuEngine *self, FuEngineLoadFlags flags, GError **error)
 {
@@ -4608,6 +5036,13 @@ fu_engine_load_metadata_store(FuEngine *self, FuEngineLoadFlags flags, GError **
 
 		/* save the remote-id in the custom metadata space */
 		file = g_file_new_for_path(path);
+#ifdef HAVE_ZSTD
+		xb_builder_source_add_adapter(source,
+					      "application/zstd,application/x-zstd,.zst",
+					      fu_engine_builder_zstd_adapter_cb,
+					      NULL,
+					      NULL);
+#endif
 		if (!xb_builder_source_load_file(source,
 						 file,
 						 XB_BUILDER_SOURCE_FLAG_NONE,
@@ -4887,6 +5322,17 @@ fu_engine_update_metadata_bytes(FuEngine *self,
 		return FALSE;
 	}
 
+#ifndef HAVE_ZSTD
+	if (g_str_has_suffix(fwupd_remote_get_filename_cache(remote), ".zst")) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_NOT_SUPPORTED,
+			    "remote %s uses zstd metadata but zstd support is not compiled in",
+			    remote_id);
+		return FALSE;
+	}
+#endif
+
 	/* verify JCatFile, or create a dummy one from legacy data */
 	keyring_kind = fwupd_remote_get_keyring_kind(remote);
 	if (keyring_kind == FWUPD_KEYRING_KIND_JCAT) {
@@ -5199,11 +5645,11 @@ fu_engine_get_details_for_bytes(FuEngine *self,
 				GError **error)
 {
 	const gchar *remote_id = NULL;
-	GChecksumType checksum_types[] = {G_CHECKSUM_SHA256, G_CHECKSUM_SHA1, 0};
+	GChecksumType checksum_types[] = {G_CHECKSUM_SHA256, G_CHECKSUM_SHA1};
 	g_autoptr(GError) error_local = NULL;
 	g_autoptr(GPtrArray) components = NULL;
 	g_autoptr(GPtrArray) details = NULL;
-	g_autoptr(GPtrArray) checksums = g_ptr_array_new_with_free_func(g_free);
+	g_autoptr(GPtrArray) checksums = NULL;
 	g_autoptr(XbSilo) silo = NULL;
 
 	silo = fu_engine_get_silo_from_blob(self, blob, error);
@@ -5232,8 +5678,7 @@ fu_engine_get_details_for_bytes(FuEngine *self,
 		return NULL;
 
 	/* calculate the checksums of the blob */
-	for (guint i = 0; checksum_types[i] != 0; i++)
-		g_ptr_array_add(checksums, g_compute_checksum_for_bytes(checksum_types[i], blob));
+	checksums = fu_bytes_get_checksums(blob, checksum_types, G_N_ELEMENTS(checksum_types));
 
 	/* does this exist in any enabled remote */
 	for (guint i = 0; i < checksums->len; i++) {
@@ -5859,7 +6304,10 @@ fu_engine_get_releases_for_device(FuEngine *self,
 		g_autoptr(GPtrArray) components = NULL;
 		g_auto(XbQueryContext) context = XB_QUERY_CONTEXT_INIT();
 
-		xb_query_context_set_flags(&context, XB_QUERY_FLAG_USE_INDEXES);
+		/* reuse the same nodes so the parsed requirements are cached for the silo */
+		xb_query_context_set_flags(&context,
+					   XB_QUERY_FLAG_USE_INDEXES |
+					       XB_QUERY_FLAG_FORCE_NODE_CACHE);
 		xb_value_bindings_bind_str(xb_query_context_get_bindings(&context), 0, guid, NULL);
 		components = xb_silo_query_with_context(self->silo,
 							self->query_component_by_guid,
@@ -6197,37 +6645,16 @@ fu_engine_self_sign(FuEngine *self, const gchar *value, JcatSignFlags flags, GEr
 	return jcat_blob_get_data_as_string(jcat_signature);
 }
 
-/**
- * fu_engine_get_upgrades:
- * @self: a #FuEngine
- * @request: a #FuEngineRequest
- * @device_id: a device ID
- * @error: (nullable): optional return location for an error
- *
- * Gets the upgrades available for a specific device.
- *
- * Returns: (transfer container) (element-type FwupdDevice): results
- **/
-GPtrArray *
-fu_engine_get_upgrades(FuEngine *self,
-		       FuEngineRequest *request,
-		       const gchar *device_id,
-		       GError **error)
+static GPtrArray *
+fu_engine_get_upgrades_for_device(FuEngine *self,
+				  FuEngineRequest *request,
+				  FuDevice *device,
+				  GError **error)
 {
-	g_autoptr(FuDevice) device = NULL;
 	g_autoptr(GPtrArray) releases = NULL;
 	g_autoptr(GPtrArray) releases_tmp = NULL;
 	g_autoptr(GString) error_str = g_string_new(NULL);
 
-	g_return_val_if_fail(FU_IS_ENGINE(self), NULL);
-	g_return_val_if_fail(device_id != NULL, NULL);
-	g_return_val_if_fail(error == NULL || *error == NULL, NULL);
-
-	/* find the device */
-	device = fu_device_list_get_by_id(self->device_list, device_id, error);
-	if (device == NULL)
-		return NULL;
-
 	/* there is no point checking each release */
 	if (!fu_device_has_flag(device, FWUPD_DEVICE_FLAG_UPDATABLE) &&
 	    !fu_device_has_flag(device, FWUPD_DEVICE_FLAG_UPDATABLE_HIDDEN)) {
@@ -6332,6 +6759,92 @@ fu_engine_get_upgrades(FuEngine *self,
 	return g_steal_pointer(&releases);
 }
 
+/**
+ * fu_engine_get_upgrades:
+ * @self: a #FuEngine
+ * @request: a #FuEngineRequest
+ * @device_id: a device ID
+ * @error: (nullable): optional return location for an error
+ *
+ * Gets the upgrades available for a specific device.
+ *
+ * Returns: (transfer container) (element-type FwupdDevice): results
+ **/
+GPtrArray *
+fu_engine_get_upgrades(FuEngine *self,
+		       FuEngineRequest *request,
+		       const gchar *device_id,
+		       GError **error)
+{
+	g_autoptr(FuDevice) device = NULL;
+
+	g_return_val_if_fail(FU_IS_ENGINE(self), NULL);
+	g_return_val_if_fail(device_id != NULL, NULL);
+	g_return_val_if_fail(error == NULL || *error == NULL, NULL);
+
+	/* find the device */
+	device = fu_device_list_get_by_id(self->device_list, device_id, error);
+	if (device == NULL)
+		return NULL;
+	return fu_engine_get_upgrades_for_device(self, request, device, error);
+}
+
+/**
+ * fu_engine_get_upgrades_all:
+ * @self: a #FuEngine
+ * @request: a #FuEngineRequest
+ * @error: (nullable): optional return location for an error
+ *
+ * Gets all the devices, each with any available upgrades added as releases. Devices with no
+ * upgrades are also included, so the client does not need to call fu_engine_get_devices() too.
+ *
+ * Returns: (transfer container) (element-type FwupdDevice): devices
+ **/
+GPtrArray *
+fu_engine_get_upgrades_all(FuEngine *self, FuEngineRequest *request, GError **error)
+{
+	g_autoptr(GPtrArray) devices = NULL;
+	g_autoptr(GPtrArray) results = NULL;
+
+	g_return_val_if_fail(FU_IS_ENGINE(self), NULL);
+	g_return_val_if_fail(error == NULL || *error == NULL, NULL);
+
+	devices = fu_engine_get_devices(self, error);
+	if (devices == NULL)
+		return NULL;
+	results = g_ptr_array_new_with_free_func((GDestroyNotify)g_object_unref);
+	for (guint i = 0; i < devices->len; i++) {
+		FuDevice *device = g_ptr_array_index(devices, i);
+		g_autoptr(FwupdDevice) result = NULL;
+		g_autoptr(GError) error_local = NULL;
+		g_autoptr(GPtrArray) releases = NULL;
+		g_autoptr(GVariant) value = NULL;
+
+		/* copy everything, as the releases must not be added to the real device */
+		value =
+		    fwupd_device_to_variant_full(FWUPD_DEVICE(device), FWUPD_DEVICE_FLAG_TRUSTED);
+		result = fwupd_device_from_variant(g_variant_ref_sink(value));
+		g_ptr_array_add(results, g_object_ref(result));
+
+		/* same as GetUpgrades, but without looking up the device again */
+		if (!fu_device_has_flag(device, FWUPD_DEVICE_FLAG_UPDATABLE) &&
+		    !fu_device_has_flag(device, FWUPD_DEVICE_FLAG_UPDATABLE_HIDDEN))
+			continue;
+		releases = fu_engine_get_upgrades_for_device(self, request, device, &error_local);
+		if (releases == NULL) {
+			g_debug("no upgrades for %s: %s",
+				fu_device_get_id(device),
+				error_local->message);
+			continue;
+		}
+		for (guint j = 0; j < releases->len; j++) {
+			FwupdRelease *release = g_ptr_array_index(releases, j);
+			fwupd_device_add_release(result, release);
+		}
+	}
+	return g_steal_pointer(&results);
+}
+
 /**
  * fu_engine_clear_results:
  * @self: a #FuEngine
@@ -6467,7 +6980,8 @@ fu_engine_plugins_coldplug(FuEngine *self, FuProgress *progress)
 	/* print what we do have */
 	for (guint i = 0; i < plugins->len; i++) {
 		FuPlugin *plugin = g_ptr_array_index(plugins, i);
-		if (fu_plugin_has_flag(plugin, FWUPD_PLUGIN_FLAG_DISABLED))
+		if (fu_plugin_has_flag(plugin, FWUPD_PLUGIN_FLAG_DISABLED) ||
+		    fu_plugin_has_flag(plugin, FWUPD_PLUGIN_FLAG_REQUIRE_HWID))
 			continue;
 		g_string_append_printf(str, "%s, ", fu_plugin_get_name(plugin));
 	}
@@ -6501,6 +7015,10 @@ static void
 fu_engine_plugin_device_register_cb(FuPlugin *plugin, FuDevice *device, gpointer user_data)
 {
 	FuEngine *self = FU_ENGINE(user_data);
+	if (fu_engine_coldplug_defer_action(FU_ENGINE_COLDPLUG_ACTION_KIND_DEVICE_REGISTER,
+					    plugin,
+					    device))
+		return;
 	fu_engine_plugin_device_register(self, device);
 }
 
@@ -6517,6 +7035,12 @@ fu_engine_plugin_device_added_cb(FuPlugin *plugin, FuDevice *device, gpointer us
 		fu_device_set_priority(device, fu_plugin_get_priority(plugin));
 	}
 
+	/* being coldplugged, so add in the enumerated order later */
+	if (fu_engine_coldplug_defer_action(FU_ENGINE_COLDPLUG_ACTION_KIND_DEVICE_ADDED,
+					    plugin,
+					    device))
+		return;
+
 	fu_engine_add_device(self, device);
 }
 
@@ -6828,7 +7352,13 @@ static void
 fu_engine_plugin_rules_changed_cb(FuPlugin *plugin, gpointer user_data)
 {
 	FuEngine *self = FU_ENGINE(user_data);
-	GPtrArray *rules = fu_plugin_get_rules(plugin, FU_PLUGIN_RULE_INHIBITS_IDLE);
+	GPtrArray *rules;
+
+	if (fu_engine_coldplug_defer_action(FU_ENGINE_COLDPLUG_ACTION_KIND_RULES_CHANGED,
+					    plugin,
+					    NULL))
+		return;
+	rules = fu_plugin_get_rules(plugin, FU_PLUGIN_RULE_INHIBITS_IDLE);
 	if (rules == NULL)
 		return;
 	for (guint j = 0; j < rules->len; j++) {
@@ -6857,6 +7387,10 @@ fu_engine_plugin_device_removed_cb(FuPlugin *plugin, FuDevice *device, gpointer
 	g_autoptr(FuDevice) device_tmp = NULL;
 	g_autoptr(GError) error = NULL;
 
+	if (fu_engine_coldplug_defer_action(FU_ENGINE_COLDPLUG_ACTION_KIND_DEVICE_REMOVED,
+					    plugin,
+					    device))
+		return;
 	device_tmp = fu_device_list_get_by_id(self->device_list, fu_device_get_id(device), &error);
 	if (device_tmp == NULL) {
 		g_info("failed to find device %s: %s", fu_device_get_id(device), error->message);
@@ -6891,6 +7425,12 @@ fu_engine_add_plugin(FuEngine *self, FuPlugin *plugin)
 	fu_plugin_list_add(self->plugin_list, plugin);
 }
 
+void
+fu_engine_add_backend(FuEngine *self, FuBackend *backend)
+{
+	g_ptr_array_add(self->backends, g_object_ref(backend));
+}
+
 gboolean
 fu_engine_is_uid_trusted(FuEngine *self, guint64 calling_uid)
 {
@@ -6945,7 +7485,7 @@ fu_engine_add_plugin_filter(FuEngine *self, const gchar *plugin_glob)
 }
 
 static gboolean
-fu_engine_plugin_check_supported_cb(FuPlugin *plugin, const gchar *guid, FuEngine *self)
+fu_engine_check_supported_guid(FuEngine *self, const gchar *guid)
 {
 	g_autoptr(XbNode) n = NULL;
 	g_autofree gchar *xpath = NULL;
@@ -6960,6 +7500,17 @@ fu_engine_plugin_check_supported_cb(FuPlugin *plugin, const gchar *guid, FuEngin
 	return n != NULL;
 }
 
+static gboolean
+fu_engine_plugin_check_supported_cb(FuPlugin *plugin, const gchar *guid, FuEngine *self)
+{
+	FuEngineColdplugItem *item = g_private_get(&fu_engine_coldplug_item);
+
+	/* being set up from a coldplug worker thread */
+	if (item != NULL && item->helper != NULL)
+		return fu_engine_coldplug_helper_check_supported(item->helper, guid);
+	return fu_engine_check_supported_guid(self, guid);
+}
+
 FuEngineConfig *
 fu_engine_get_config(FuEngine *self)
 {
@@ -7709,20 +8260,13 @@ fu_engine_backend_device_added_run_plugins(FuEngine *self, FuDevice *device, FuP
 	}
 }
 
-static void
-fu_engine_backend_device_added(FuEngine *self, FuDevice *device, FuProgress *progress)
+static gboolean
+fu_engine_backend_device_probe(FuEngine *self, FuDevice *device)
 {
 	g_autofree gchar *str1 = NULL;
 	g_autofree gchar *str2 = NULL;
 	g_autoptr(GError) error_local = NULL;
 
-	/* progress */
-	fu_progress_set_id(progress, G_STRLOC);
-	fu_progress_add_flag(progress, FU_PROGRESS_FLAG_NO_PROFILE);
-	fu_progress_set_name(progress, fu_device_get_backend_id(device));
-	fu_progress_add_step(progress, FWUPD_STATUS_LOADING, 50, "probe-baseclass");
-	fu_progress_add_step(progress, FWUPD_STATUS_LOADING, 50, "query-possible-plugins");
-
 	/* super useful for plugin development */
 	str1 = fu_device_to_string(FU_DEVICE(device));
 	g_debug("%s added %s", fu_device_get_backend_id(device), str1);
@@ -7739,10 +8283,8 @@ fu_engine_backend_device_added(FuEngine *self, FuDevice *device, FuProgress *pro
 				fu_device_get_backend_id(device),
 				error_local->message);
 		}
-		fu_progress_finished(progress);
-		return;
+		return FALSE;
 	}
-	fu_progress_step_done(progress);
 
 	/* check if the device needs emulation-tag */
 	fu_engine_ensure_device_emulation_tag(self, device);
@@ -7753,6 +8295,24 @@ fu_engine_backend_device_added(FuEngine *self, FuDevice *device, FuProgress *pro
 
 	/* if this is for firmware attributes, reload that part of the daemon */
 	fu_engine_check_firmware_attributes(self, device, TRUE);
+	return TRUE;
+}
+
+static void
+fu_engine_backend_device_added(FuEngine *self, FuDevice *device, FuProgress *progress)
+{
+	/* progress */
+	fu_progress_set_id(progress, G_STRLOC);
+	fu_progress_add_flag(progress, FU_PROGRESS_FLAG_NO_PROFILE);
+	fu_progress_set_name(progress, fu_device_get_backend_id(device));
+	fu_progress_add_step(progress, FWUPD_STATUS_LOADING, 50, "probe-baseclass");
+	fu_progress_add_step(progress, FWUPD_STATUS_LOADING, 50, "query-possible-plugins");
+
+	if (!fu_engine_backend_device_probe(self, device)) {
+		fu_progress_finished(progress);
+		return;
+	}
+	fu_progress_step_done(progress);
 
 	/* can be specified using a quirk */
 	fu_engine_backend_device_added_run_plugins(self, device, fu_progress_get_child(progress));
@@ -8120,20 +8680,266 @@ fu_common_win32_registry_get_string(HKEY hkey,
 }
 #endif
 
+static void
+fu_engine_coldplug_item_free(FuEngineColdplugItem *item)
+{
+	g_object_unref(item->device);
+	g_ptr_array_unref(item->actions);
+	g_free(item);
+}
+
+static void
+fu_engine_coldplug_action_run(FuEngine *self, FuEngineColdplugAction *action)
+{
+	switch (action->kind) {
+	case FU_ENGINE_COLDPLUG_ACTION_KIND_DEVICE_REGISTER:
+		fu_engine_plugin_device_register_cb(action->plugin, action->device, self);
+		break;
+	case FU_ENGINE_COLDPLUG_ACTION_KIND_DEVICE_ADDED:
+		fu_engine_add_device(self, action->device);
+		break;
+	case FU_ENGINE_COLDPLUG_ACTION_KIND_DEVICE_REMOVED:
+		fu_engine_plugin_device_removed_cb(action->plugin, action->device, self);
+		break;
+	case FU_ENGINE_COLDPLUG_ACTION_KIND_RULES_CHANGED:
+		fu_engine_plugin_rules_changed_cb(action->plugin, self);
+		break;
+	default:
+		break;
+	}
+}
+
+/* devices on the same physical device, or below the same USB device, have to be set up in order */
+static gchar *
+fu_engine_coldplug_get_group_key(FuDevice *device)
+{
+	for (guint i = 0; i < 0xff; i++) {
+		FuDevice *device_tmp = fu_device_get_parent(device);
+		if (device_tmp == NULL)
+			device_tmp = fu_device_get_proxy(device);
+		if (device_tmp == NULL)
+			break;
+		device = device_tmp;
+	}
+
+	/* e.g. the hidraw nodes for each interface of a USB device */
+	if (FU_IS_UDEV_DEVICE(device)) {
+		g_autoptr(FuUdevDevice) usb_device =
+		    fu_udev_device_get_parent_with_subsystem(FU_UDEV_DEVICE(device), "usb");
+		const gchar *sysfs_path =
+		    usb_device != NULL ? fu_udev_device_get_sysfs_path(usb_device) : NULL;
+		if (sysfs_path != NULL) {
+			g_autofree gchar *basename = g_path_get_basename(sysfs_path);
+
+			/* use the device rather than the interface, e.g. 1-2 not 1-2:1.0 */
+			if (g_strstr_len(basename, -1, ":") != NULL)
+				return g_path_get_dirname(sysfs_path);
+			return g_strdup(sysfs_path);
+		}
+	}
+	if (fu_device_get_physical_id(device) != NULL)
+		return g_strdup(fu_device_get_physical_id(device));
+	return g_strdup_printf("%p", device);
+}
+
+/* only plugins that opt in can be used from a worker thread */
+static gboolean
+fu_engine_coldplug_device_is_thread_safe(FuEngine *self, FuDevice *device)
+{
+	g_autoptr(GPtrArray) possible_plugins = fu_device_get_possible_plugins(device);
+	for (guint i = 0; i < possible_plugins->len; i++) {
+		const gchar *plugin_name = g_ptr_array_index(possible_plugins, i);
+		FuPlugin *plugin;
+
+		plugin = fu_plugin_list_find_by_name(self->plugin_list, plugin_name, NULL);
+		if (plugin != NULL && !fu_plugin_get_thread_safe(plugin))
+			return FALSE;
+	}
+	return TRUE;
+}
+
+static void
+fu_engine_coldplug_group_thread_cb(gpointer data, gpointer user_data)
+{
+	FuEngineColdplugHelper *helper = (FuEngineColdplugHelper *)user_data;
+	g_autoptr(GPtrArray) items = (GPtrArray *)data;
+
+	for (guint i = 0; i < items->len; i++) {
+		FuEngineColdplugItem *item = g_ptr_array_index(items, i);
+		g_autoptr(FuProgress) progress = fu_progress_new(G_STRLOC);
+		g_autoptr(GTimer) timer = g_timer_new();
+
+		/* the plugin signals are deferred to the main thread */
+		g_private_set(&fu_engine_coldplug_item, item);
+		fu_engine_backend_device_added_run_plugins(helper->self, item->device, progress);
+		g_private_set(&fu_engine_coldplug_item, NULL);
+		item->duration = g_timer_elapsed(timer, NULL);
+
+		g_mutex_lock(&helper->mutex);
+		helper->done++;
+		g_cond_broadcast(&helper->cond);
+		g_mutex_unlock(&helper->mutex);
+	}
+}
+
+static gboolean
+fu_engine_backends_coldplug_backend_add_devices_parallel(FuEngine *self,
+							 GPtrArray *devices,
+							 guint max_threads,
+							 FuProgress *progress,
+							 GError **error)
+{
+	FuEngineColdplugHelper helper = {.self = self, .done = 0};
+	GThreadPool *pool;
+	guint stepped = 0;
+	guint total = 0;
+	g_autoptr(GHashTable) groups = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+	g_autoptr(GPtrArray) items =
+	    g_ptr_array_new_with_free_func((GDestroyNotify)fu_engine_coldplug_item_free);
+	g_autoptr(GPtrArray) items_serial = g_ptr_array_new();
+	g_autoptr(GPtrArray) groups_ordered = g_ptr_array_new();
+	g_autoptr(GPtrArray) queries = g_ptr_array_new();
+
+	/* progress */
+	fu_progress_set_id(progress, G_STRLOC);
+	fu_progress_set_steps(progress, devices->len);
+
+	/* probe in the main thread as this updates the quirks and firmware attributes */
+	for (guint i = 0; i < devices->len; i++) {
+		FuDevice *device = g_ptr_array_index(devices, i);
+		FuEngineColdplugItem *item = g_new0(FuEngineColdplugItem, 1);
+		GPtrArray *group;
+		g_autofree gchar *group_key = NULL;
+
+		item->device = g_object_ref(device);
+		item->actions =
+		    g_ptr_array_new_with_free_func((GDestroyNotify)fu_engine_coldplug_action_free);
+		g_ptr_array_add(items, item);
+		item->probed = fu_engine_backend_device_probe(self, device);
+		if (!item->probed) {
+			fu_progress_step_done(progress);
+			continue;
+		}
+		if (!fu_engine_coldplug_device_is_thread_safe(self, device)) {
+			g_ptr_array_add(items_serial, item);
+			continue;
+		}
+		item->helper = &helper;
+		group_key = fu_engine_coldplug_get_group_key(device);
+		group = g_hash_table_lookup(groups, group_key);
+		if (group == NULL) {
+			group = g_ptr_array_new();
+			g_hash_table_insert(groups, g_steal_pointer(&group_key), group);
+			g_ptr_array_add(groups_ordered, group);
+		}
+		g_ptr_array_add(group, item);
+		total++;
+	}
+
+	/* set up each group of related devices on a worker thread */
+	helper.queries = queries;
+	g_mutex_init(&helper.mutex);
+	g_cond_init(&helper.cond);
+	pool = g_thread_pool_new(fu_engine_coldplug_group_thread_cb,
+				 &helper,
+				 max_threads,
+				 FALSE,
+				 error);
+	if (pool == NULL) {
+		g_ptr_array_set_free_func(groups_ordered, (GDestroyNotify)g_ptr_array_unref);
+		g_mutex_clear(&helper.mutex);
+		g_cond_clear(&helper.cond);
+		return FALSE;
+	}
+	for (guint i = 0; i < groups_ordered->len; i++)
+		g_thread_pool_push(pool, g_ptr_array_index(groups_ordered, i), NULL);
+
+	/* progress is not thread safe, so only update it from the main thread */
+	while (stepped < total) {
+		guint done;
+		g_mutex_lock(&helper.mutex);
+		while (helper.done == stepped && helper.queries->len == 0)
+			g_cond_wait(&helper.cond, &helper.mutex);
+
+		/* the workers are blocked until these are answered */
+		for (guint i = 0; i < helper.queries->len; i++) {
+			FuEngineColdplugQuery *query = g_ptr_array_index(helper.queries, i);
+			query->supported = fu_engine_check_supported_guid(self, query->guid);
+			query->done = TRUE;
+		}
+		if (helper.queries->len > 0) {
+			g_ptr_array_set_size(helper.queries, 0);
+			g_cond_broadcast(&helper.cond);
+		}
+		done = helper.done;
+		g_mutex_unlock(&helper.mutex);
+		for (; stepped < done; stepped++)
+			fu_progress_step_done(progress);
+	}
+	g_thread_pool_free(pool, FALSE, TRUE);
+	g_mutex_clear(&helper.mutex);
+	g_cond_clear(&helper.cond);
+
+	/* a possible plugin is not thread safe, so set these up in the main thread */
+	for (guint i = 0; i < items_serial->len; i++) {
+		FuEngineColdplugItem *item = g_ptr_array_index(items_serial, i);
+		g_autoptr(GTimer) timer = g_timer_new();
+
+		g_private_set(&fu_engine_coldplug_item, item);
+		fu_engine_backend_device_added_run_plugins(self,
+							   item->device,
+							   fu_progress_get_child(progress));
+		g_private_set(&fu_engine_coldplug_item, NULL);
+		item->duration = g_timer_elapsed(timer, NULL);
+		fu_progress_step_done(progress);
+	}
+
+	/* run the plugin signals in the order the backend enumerated the devices */
+	for (guint i = 0; i < items->len; i++) {
+		FuEngineColdplugItem *item = g_ptr_array_index(items, i);
+		if (!item->probed)
+			continue;
+		g_info("%s set up in %.1fms",
+		       fu_device_get_backend_id(item->device),
+		       item->duration * 1000.f);
+		for (guint j = 0; j < item->actions->len; j++) {
+			FuEngineColdplugAction *action = g_ptr_array_index(item->actions, j);
+			fu_engine_coldplug_action_run(self, action);
+		}
+	}
+
+	/* success */
+	return TRUE;
+}
+
 static gboolean
 fu_engine_backends_coldplug_backend_add_devices(FuEngine *self,
 						FuBackend *backend,
 						FuProgress *progress,
 						GError **error)
 {
+	guint max_threads = fu_engine_config_get_coldplug_concurrency(self->config);
 	g_autoptr(GPtrArray) devices = fu_backend_get_devices(backend);
 
+	/* opt-in, and only used for the plugins marked as thread safe */
+	if (max_threads > 0 && devices->len > 1) {
+		return fu_engine_backends_coldplug_backend_add_devices_parallel(self,
+										devices,
+										max_threads,
+										progress,
+										error);
+	}
+
 	/* progress */
 	fu_progress_set_id(progress, G_STRLOC);
 	fu_progress_set_steps(progress, devices->len);
 	for (guint i = 0; i < devices->len; i++) {
 		FuDevice *device = g_ptr_array_index(devices, i);
+		g_autoptr(GTimer) timer = g_timer_new();
 		fu_engine_backend_device_added(self, device, fu_progress_get_child(progress));
+		g_debug("%s set up in %.1fms",
+			fu_device_get_backend_id(device),
+			g_timer_elapsed(timer, NULL) * 1000.f);
 		fu_progress_step_done(progress);
 	}
 
@@ -8759,7 +9565,10 @@ fu_engine_init(FuEngine *self)
 	self->runtime_versions = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
 	self->compile_versions = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
 	self->acquiesce_loop = g_main_loop_new(NULL, FALSE);
-	self->emulation_phases = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, g_free);
+	self->emulation_phases = g_hash_table_new_full(g_direct_hash,
+						       g_direct_equal,
+						       NULL,
+						       (GDestroyNotify)json_node_unref);
 	self->emulation_backend_ids = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
 
 	fu_context_set_runtime_versions(self->ctx, self->runtime_versions);
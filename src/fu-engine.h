@@ -100,6 +100,8 @@ fu_engine_get_upgrades(FuEngine *self,
 		       FuEngineRequest *request,
 		       const gchar *device_id,
 		       GError **error);
+GPtrArray *
+fu_engine_get_upgrades_all(FuEngine *self, FuEngineRequest *request, GError **error);
 FwupdDevice *
 fu_engine_get_results(FuEngine *self, const gchar *device_id, GError **error);
 FuSecurityAttrs *
@@ -214,6 +216,8 @@ fu_engine_add_device(FuEngine *self, FuDevice *device);
 void
 fu_engine_add_plugin(FuEngine *self, FuPlugin *plugin);
 void
+fu_engine_add_backend(FuEngine *self, FuBackend *backend);
+void
 fu_engine_add_runtime_version(FuEngine *self, const gchar *component_id, const gchar *version);
 GPtrArray *
 fu_engine_get_details_for_bytes(FuEngine *self,
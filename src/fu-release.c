@@ -28,8 +28,8 @@ struct _FuRelease {
 	FuEngineConfig *config;
 	GBytes *blob_fw;
 	gchar *update_request_id;
-	GPtrArray *soft_reqs; /* nullable, element-type XbNode */
-	GPtrArray *hard_reqs; /* nullable, element-type XbNode */
+	GPtrArray *soft_reqs; /* nullable, element-type FuRequirement */
+	GPtrArray *hard_reqs; /* nullable, element-type FuRequirement */
 	guint64 priority;
 };
 
@@ -154,7 +154,7 @@ fu_release_get_fw_blob(FuRelease *self)
  *
  * Gets the additional soft requirements that need to be checked in the engine.
  *
- * Returns: (transfer none) (nullable) (element-type XbNode): nodes
+ * Returns: (transfer none) (nullable) (element-type FuRequirement): requirements
  **/
 GPtrArray *
 fu_release_get_soft_reqs(FuRelease *self)
@@ -169,7 +169,7 @@ fu_release_get_soft_reqs(FuRelease *self)
  *
  * Gets the additional hard requirements that need to be checked in the engine.
  *
- * Returns: (transfer none) (nullable) (element-type XbNode): nodes
+ * Returns: (transfer none) (nullable) (element-type FuRequirement): requirements
  **/
 GPtrArray *
 fu_release_get_hard_reqs(FuRelease *self)
@@ -448,9 +448,9 @@ fu_release_check_requirements_version_check(FuRelease *self, GError **error)
 {
 	if (self->hard_reqs != NULL) {
 		for (guint i = 0; i < self->hard_reqs->len; i++) {
-			XbNode *req = g_ptr_array_index(self->hard_reqs, i);
-			if (g_strcmp0(xb_node_get_element(req), "firmware") == 0 &&
-			    xb_node_get_text(req) == NULL) {
+			FuRequirement *req = g_ptr_array_index(self->hard_reqs, i);
+			if (req->kind == FU_REQUIREMENT_KIND_FIRMWARE &&
+			    req->firmware == FU_REQUIREMENT_FIRMWARE_VERSION) {
 				return TRUE;
 			}
 		}
@@ -1061,8 +1061,8 @@ fu_release_load(FuRelease *self,
 	if (tmp != NULL)
 		fu_release_set_update_request_id(self, tmp);
 
-	/* hard and soft requirements */
-	self->hard_reqs = xb_node_query(component, "requires/*", 0, &error_hard);
+	/* hard and soft requirements, parsed once for each component */
+	self->hard_reqs = fu_requirement_array_from_component(component, "requires/*", &error_hard);
 	if (self->hard_reqs == NULL) {
 		if (!g_error_matches(error_hard, G_IO_ERROR, G_IO_ERROR_NOT_FOUND) &&
 		    !g_error_matches(error_hard, G_IO_ERROR, G_IO_ERROR_INVALID_ARGUMENT)) {
@@ -1070,7 +1070,8 @@ fu_release_load(FuRelease *self,
 			return FALSE;
 		}
 	}
-	self->soft_reqs = xb_node_query(component, "suggests/*|recommends/*", 0, &error_soft);
+	self->soft_reqs =
+	    fu_requirement_array_from_component(component, "suggests/*|recommends/*", &error_soft);
 	if (self->soft_reqs == NULL) {
 		if (!g_error_matches(error_soft, G_IO_ERROR, G_IO_ERROR_NOT_FOUND) &&
 		    !g_error_matches(error_soft, G_IO_ERROR, G_IO_ERROR_INVALID_ARGUMENT)) {
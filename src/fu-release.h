@@ -10,6 +10,7 @@
 
 #include "fu-engine-config.h"
 #include "fu-engine-request.h"
+#include "fu-requirement.h"
 
 #define FU_TYPE_RELEASE (fu_release_get_type())
 G_DECLARE_FINAL_TYPE(FuRelease, fu_release, FU, RELEASE, FwupdRelease)
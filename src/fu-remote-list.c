@@ -190,34 +190,39 @@ static gboolean
 fu_remote_list_cleanup_remote(FwupdRemote *remote, GError **error)
 {
 	const gchar *fn_cache = fwupd_remote_get_filename_cache(remote);
+	g_autofree gchar *basename_cache = NULL;
 	g_autofree gchar *dirname = NULL;
 	g_autoptr(GPtrArray) files = NULL;
 
 	/* sanity check */
 	if (fn_cache == NULL)
 		return TRUE;
-	if (!g_str_has_suffix(fn_cache, ".xz"))
+	if (fwupd_remote_get_kind(remote) != FWUPD_REMOTE_KIND_DOWNLOAD)
 		return TRUE;
 
 	/* get all files */
+	basename_cache = g_path_get_basename(fn_cache);
 	dirname = g_path_get_dirname(fn_cache);
 	files = fu_path_get_files(dirname, NULL);
 	if (files == NULL)
 		return TRUE;
 
-	/* delete any obsolete ones */
+	/* delete any metadata, or detached signatures, using a different compression format */
 	for (guint i = 0; i < files->len; i++) {
 		const gchar *fn = g_ptr_array_index(files, i);
-		if (g_strstr_len(fn, -1, ".gz") != NULL) {
-			g_info("deleting obsolete %s", fn);
-			if (g_unlink(fn) == -1) {
-				g_set_error(error,
-					    G_IO_ERROR,
-					    G_IO_ERROR_FAILED,
-					    "failed to delete obsolete %s",
-					    fn);
-				return FALSE;
-			}
+		g_autofree gchar *basename = g_path_get_basename(fn);
+		if (!g_str_has_prefix(basename, "metadata.xml."))
+			continue;
+		if (g_str_has_prefix(basename, basename_cache))
+			continue;
+		g_info("deleting obsolete %s", fn);
+		if (g_unlink(fn) == -1) {
+			g_set_error(error,
+				    G_IO_ERROR,
+				    G_IO_ERROR_FAILED,
+				    "failed to delete obsolete %s",
+				    fn);
+			return FALSE;
 		}
 	}
 
@@ -0,0 +1,308 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * SPDX-License-Identifier: LGPL-2.1+
+ */
+
+#define G_LOG_DOMAIN "FuRequirement"
+
+#include "config.h"
+
+#include <string.h>
+
+#include "fu-requirement.h"
+
+static FuRequirementCompare
+fu_requirement_compare_from_string(const gchar *compare)
+{
+	if (g_strcmp0(compare, "eq") == 0)
+		return FU_REQUIREMENT_COMPARE_EQ;
+	if (g_strcmp0(compare, "ne") == 0)
+		return FU_REQUIREMENT_COMPARE_NE;
+	if (g_strcmp0(compare, "lt") == 0)
+		return FU_REQUIREMENT_COMPARE_LT;
+	if (g_strcmp0(compare, "gt") == 0)
+		return FU_REQUIREMENT_COMPARE_GT;
+	if (g_strcmp0(compare, "le") == 0)
+		return FU_REQUIREMENT_COMPARE_LE;
+	if (g_strcmp0(compare, "ge") == 0)
+		return FU_REQUIREMENT_COMPARE_GE;
+	if (g_strcmp0(compare, "glob") == 0)
+		return FU_REQUIREMENT_COMPARE_GLOB;
+	if (g_strcmp0(compare, "regex") == 0)
+		return FU_REQUIREMENT_COMPARE_REGEX;
+	return FU_REQUIREMENT_COMPARE_UNKNOWN;
+}
+
+static FuRequirementKind
+fu_requirement_kind_from_string(const gchar *element)
+{
+	if (g_strcmp0(element, "id") == 0)
+		return FU_REQUIREMENT_KIND_ID;
+	if (g_strcmp0(element, "firmware") == 0)
+		return FU_REQUIREMENT_KIND_FIRMWARE;
+	if (g_strcmp0(element, "hardware") == 0)
+		return FU_REQUIREMENT_KIND_HARDWARE;
+	if (g_strcmp0(element, "client") == 0)
+		return FU_REQUIREMENT_KIND_CLIENT;
+	return FU_REQUIREMENT_KIND_UNKNOWN;
+}
+
+static FuRequirementFirmware
+fu_requirement_firmware_from_string(const gchar *text)
+{
+	if (text == NULL)
+		return FU_REQUIREMENT_FIRMWARE_VERSION;
+	if (g_strcmp0(text, "bootloader") == 0)
+		return FU_REQUIREMENT_FIRMWARE_BOOTLOADER;
+	if (g_strcmp0(text, "vendor-id") == 0)
+		return FU_REQUIREMENT_FIRMWARE_VENDOR_ID;
+	if (g_strcmp0(text, "not-child") == 0)
+		return FU_REQUIREMENT_FIRMWARE_NOT_CHILD;
+	return FU_REQUIREMENT_FIRMWARE_GUIDS;
+}
+
+/* split the version in the same way as fu_version_compare() so this only has to be done once */
+static void
+fu_requirement_ensure_version_split(FuRequirement *self)
+{
+	if (self->version == NULL)
+		return;
+	self->version_split = g_strsplit(self->version, ".", -1);
+	self->version_sections = g_strv_length(self->version_split);
+	self->version_vals = g_new0(gint64, self->version_sections);
+	self->version_suffixes = g_new0(const gchar *, self->version_sections);
+	for (guint i = 0; i < self->version_sections; i++) {
+		gchar *endptr = NULL;
+		self->version_vals[i] = g_ascii_strtoll(self->version_split[i], &endptr, 10);
+		self->version_suffixes[i] = endptr;
+	}
+}
+
+static void
+fu_requirement_ensure_values(FuRequirement *self)
+{
+	if (self->text == NULL)
+		return;
+	self->values = g_strsplit(self->text, "|", -1);
+
+	/* only these are validated, in the order they would be checked */
+	for (guint i = 0; self->values[i] != NULL && self->invalid == NULL; i++) {
+		if (self->kind == FU_REQUIREMENT_KIND_FIRMWARE) {
+			if (!fwupd_guid_is_valid(self->values[i]))
+				self->invalid = g_strdup(self->values[i]);
+		} else if (self->kind == FU_REQUIREMENT_KIND_CLIENT) {
+			FwupdFeatureFlags flag = fwupd_feature_flag_from_string(self->values[i]);
+			if (flag == FWUPD_FEATURE_FLAG_LAST) {
+				self->invalid = g_strdup(self->values[i]);
+				break;
+			}
+			self->feature_flags |= flag;
+		}
+	}
+}
+
+/**
+ * fu_requirement_new_from_node:
+ * @n: a #XbNode, e.g. `<firmware compare="ge" version="1.2.3"/>`
+ *
+ * Parses a requirement from the metadata. Invalid requirements are not rejected here, and
+ * instead fail with the same error as before when checked against a device.
+ *
+ * Returns: (transfer full): a #FuRequirement
+ **/
+FuRequirement *
+fu_requirement_new_from_node(XbNode *n)
+{
+	FuRequirement *self;
+
+	g_return_val_if_fail(XB_IS_NODE(n), NULL);
+
+	self = g_new0(FuRequirement, 1);
+	self->element = g_strdup(xb_node_get_element(n));
+	self->text = g_strdup(xb_node_get_text(n));
+	self->compare_str = g_strdup(xb_node_get_attr(n, "compare"));
+	self->version = g_strdup(xb_node_get_attr(n, "version"));
+	self->depth = xb_node_get_attr_as_uint(n, "depth");
+	self->kind = fu_requirement_kind_from_string(self->element);
+	self->compare = fu_requirement_compare_from_string(self->compare_str);
+	if (self->kind == FU_REQUIREMENT_KIND_FIRMWARE)
+		self->firmware = fu_requirement_firmware_from_string(self->text);
+
+	/* GUIDs, HWIDs or feature flags */
+	if ((self->kind == FU_REQUIREMENT_KIND_FIRMWARE &&
+	     self->firmware == FU_REQUIREMENT_FIRMWARE_GUIDS) ||
+	    self->kind == FU_REQUIREMENT_KIND_HARDWARE || self->kind == FU_REQUIREMENT_KIND_CLIENT)
+		fu_requirement_ensure_values(self);
+
+	/* it is always safe to use a regex for the vendor ID, even for simple strings */
+	if (self->version != NULL &&
+	    (self->compare == FU_REQUIREMENT_COMPARE_REGEX ||
+	     (self->kind == FU_REQUIREMENT_KIND_FIRMWARE &&
+	      self->firmware == FU_REQUIREMENT_FIRMWARE_VENDOR_ID)))
+		self->regex = g_regex_new(self->version, G_REGEX_OPTIMIZE, 0, NULL);
+	fu_requirement_ensure_version_split(self);
+	return self;
+}
+
+/**
+ * fu_requirement_free:
+ * @self: a #FuRequirement
+ *
+ * Frees a requirement.
+ **/
+void
+fu_requirement_free(FuRequirement *self)
+{
+	g_return_if_fail(self != NULL);
+	if (self->regex != NULL)
+		g_regex_unref(self->regex);
+	g_strfreev(self->values);
+	g_strfreev(self->version_split);
+	g_free(self->version_vals);
+	g_free(self->version_suffixes);
+	g_free(self->element);
+	g_free(self->text);
+	g_free(self->compare_str);
+	g_free(self->version);
+	g_free(self->invalid);
+	g_free(self);
+}
+
+static gint
+fu_requirement_version_compare_char(gchar chr1, gchar chr2)
+{
+	if (chr1 == chr2)
+		return 0;
+	if (chr1 == '~')
+		return -1;
+	if (chr2 == '~')
+		return 1;
+	return chr1 < chr2 ? -1 : 1;
+}
+
+static gint
+fu_requirement_version_compare_chunk(const gchar *str1, gsize str1sz, const gchar *str2)
+{
+	gsize i;
+	for (i = 0; i < str1sz && str2[i] != '\0'; i++) {
+		gint rc = fu_requirement_version_compare_char(str1[i], str2[i]);
+		if (rc != 0)
+			return rc;
+	}
+	return fu_requirement_version_compare_char(i < str1sz ? str1[i] : '\0', str2[i]);
+}
+
+/**
+ * fu_requirement_version_compare:
+ * @self: a #FuRequirement
+ * @version: (nullable): the device version, e.g. `1.2.3`
+ * @fmt: a version format, e.g. %FWUPD_VERSION_FORMAT_TRIPLET
+ *
+ * Compares the device version with the requirement version, returning the same result as
+ * fu_version_compare() but without splitting the requirement version each time.
+ *
+ * Returns: -1 if @version < requirement, +1 if greater, 0 if equal, and %G_MAXINT on error
+ **/
+gint
+fu_requirement_version_compare(FuRequirement *self, const gchar *version, FwupdVersionFormat fmt)
+{
+	const gchar *str;
+
+	g_return_val_if_fail(self != NULL, G_MAXINT);
+
+	/* these depend on the device format, and so cannot be pre-parsed */
+	if (fmt == FWUPD_VERSION_FORMAT_PLAIN || fmt == FWUPD_VERSION_FORMAT_HEX)
+		return fu_version_compare(version, self->version, fmt);
+
+	/* sanity check */
+	if (version == NULL || self->version == NULL)
+		return G_MAXINT;
+
+	/* optimization */
+	if (g_strcmp0(version, self->version) == 0)
+		return 0;
+
+	/* walk each section of the device version without allocating */
+	str = version[0] != '\0' ? version : NULL;
+	for (guint i = 0;; i++) {
+		const gchar *sep;
+		gchar *endptr = NULL;
+		gint64 val;
+		gsize suffixsz;
+
+		/* we lost or gained a dot */
+		if (str == NULL && i >= self->version_sections)
+			break;
+		if (str == NULL)
+			return -1;
+		if (i >= self->version_sections)
+			return 1;
+
+		/* compare integers */
+		val = g_ascii_strtoll(str, &endptr, 10);
+		if (val < self->version_vals[i])
+			return -1;
+		if (val > self->version_vals[i])
+			return 1;
+
+		/* compare strings */
+		sep = strchr(str, '.');
+		suffixsz = sep != NULL ? (gsize)(sep - endptr) : strlen(endptr);
+		if (suffixsz > 0 || self->version_suffixes[i][0] != '\0') {
+			gint rc = fu_requirement_version_compare_chunk(endptr,
+								       suffixsz,
+								       self->version_suffixes[i]);
+			if (rc < 0)
+				return -1;
+			if (rc > 0)
+				return 1;
+		}
+		str = sep != NULL ? sep + 1 : NULL;
+	}
+
+	/* we really shouldn't get here */
+	return 0;
+}
+
+/**
+ * fu_requirement_array_from_component:
+ * @component: a #XbNode
+ * @xpath: an XPath query, e.g. `requires/*`
+ * @error: (nullable): optional return location for an error
+ *
+ * Parses the requirements for the component. The result is cached on @component so that each
+ * requirement is only parsed once for each silo.
+ *
+ * Returns: (transfer container) (element-type FuRequirement): requirements
+ **/
+GPtrArray *
+fu_requirement_array_from_component(XbNode *component, const gchar *xpath, GError **error)
+{
+	GPtrArray *reqs;
+	g_autofree gchar *key = g_strdup_printf("fwupd::Requirements(%s)", xpath);
+	g_autoptr(GPtrArray) nodes = NULL;
+
+	g_return_val_if_fail(XB_IS_NODE(component), NULL);
+	g_return_val_if_fail(xpath != NULL, NULL);
+	g_return_val_if_fail(error == NULL || *error == NULL, NULL);
+
+	/* already parsed */
+	reqs = g_object_get_data(G_OBJECT(component), key);
+	if (reqs != NULL)
+		return g_ptr_array_ref(reqs);
+
+	nodes = xb_node_query(component, xpath, 0, error);
+	if (nodes == NULL)
+		return NULL;
+	reqs = g_ptr_array_new_with_free_func((GDestroyNotify)fu_requirement_free);
+	for (guint i = 0; i < nodes->len; i++) {
+		XbNode *n = g_ptr_array_index(nodes, i);
+		g_ptr_array_add(reqs, fu_requirement_new_from_node(n));
+	}
+	g_object_set_data_full(G_OBJECT(component),
+			       key,
+			       g_ptr_array_ref(reqs),
+			       (GDestroyNotify)g_ptr_array_unref);
+	return reqs;
+}
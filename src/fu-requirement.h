@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * SPDX-License-Identifier: LGPL-2.1+
+ */
+
+#pragma once
+
+#include <fwupdplugin.h>
+#include <xmlb.h>
+
+typedef enum {
+	FU_REQUIREMENT_KIND_UNKNOWN,
+	FU_REQUIREMENT_KIND_ID,
+	FU_REQUIREMENT_KIND_FIRMWARE,
+	FU_REQUIREMENT_KIND_HARDWARE,
+	FU_REQUIREMENT_KIND_CLIENT,
+} FuRequirementKind;
+
+typedef enum {
+	FU_REQUIREMENT_FIRMWARE_VERSION,
+	FU_REQUIREMENT_FIRMWARE_BOOTLOADER,
+	FU_REQUIREMENT_FIRMWARE_VENDOR_ID,
+	FU_REQUIREMENT_FIRMWARE_NOT_CHILD,
+	FU_REQUIREMENT_FIRMWARE_GUIDS,
+} FuRequirementFirmware;
+
+typedef enum {
+	FU_REQUIREMENT_COMPARE_UNKNOWN,
+	FU_REQUIREMENT_COMPARE_EQ,
+	FU_REQUIREMENT_COMPARE_NE,
+	FU_REQUIREMENT_COMPARE_LT,
+	FU_REQUIREMENT_COMPARE_GT,
+	FU_REQUIREMENT_COMPARE_LE,
+	FU_REQUIREMENT_COMPARE_GE,
+	FU_REQUIREMENT_COMPARE_GLOB,
+	FU_REQUIREMENT_COMPARE_REGEX,
+} FuRequirementCompare;
+
+/**
+ * FuRequirement:
+ *
+ * A `<requires>`, `<recommends>` or `<suggests>` child node parsed into a form that can be
+ * checked against a device many times without needing to parse the metadata again.
+ **/
+typedef struct {
+	FuRequirementKind kind;
+	FuRequirementFirmware firmware;
+	FuRequirementCompare compare;
+	FwupdFeatureFlags feature_flags;
+	guint64 depth; /* G_MAXUINT64 if unset */
+	gchar *element;
+	gchar *text;			/* nullable */
+	gchar *compare_str;		/* nullable */
+	gchar *version;			/* nullable */
+	gchar **values;			/* nullable, the text split by '|' */
+	gchar *invalid;			/* nullable, the first value that was not valid */
+	GRegex *regex;			/* nullable */
+	gchar **version_split;		/* nullable, the version split by '.' */
+	gint64 *version_vals;		/* nullable, element per section */
+	const gchar **version_suffixes;	/* nullable, element per section */
+	guint version_sections;
+} FuRequirement;
+
+FuRequirement *
+fu_requirement_new_from_node(XbNode *n);
+void
+fu_requirement_free(FuRequirement *self);
+gint
+fu_requirement_version_compare(FuRequirement *self, const gchar *version, FwupdVersionFormat fmt);
+GPtrArray *
+fu_requirement_array_from_component(XbNode *component, const gchar *xpath, GError **error);
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC(FuRequirement, fu_requirement_free)
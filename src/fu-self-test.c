@@ -12,6 +12,9 @@
 #include <libgcab.h>
 #include <stdlib.h>
 #include <string.h>
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
 
 #include "fwupd-bios-setting-private.h"
 #include "fwupd-remote-private.h"
@@ -23,8 +26,10 @@
 #include "fu-cabinet-common.h"
 #include "fu-console.h"
 #include "fu-context-private.h"
+#include "fu-daemon-private.h"
 #include "fu-device-list.h"
 #include "fu-device-private.h"
+#include "fu-emulation-blob.h"
 #include "fu-engine-config.h"
 #include "fu-engine.h"
 #include "fu-history.h"
@@ -35,6 +40,9 @@
 #include "fu-smbios-private.h"
 #include "fu-spawn.h"
 #include "fu-usb-backend.h"
+#ifdef HAVE_ZSTD
+#include "fu-zstd-decompressor.h"
+#endif
 
 typedef struct {
 	FuPlugin *plugin;
@@ -126,13 +134,31 @@ fu_engine_generate_md_func(gconstpointer user_data)
 	FuTest *self = (FuTest *)user_data;
 	const gchar *tmp;
 	gboolean ret;
+	g_autofree gchar *basename = NULL;
+	g_autofree gchar *cachedir = NULL;
+	g_autofree gchar *cachedirpkg = fu_path_from_kind(FU_PATH_KIND_CACHEDIR_PKG);
+	g_autofree gchar *checksum_buf = NULL;
+	g_autofree gchar *dirname = NULL;
 	g_autofree gchar *filename = NULL;
+	g_autofree gchar *fn_checksum = NULL;
+	g_autofree gchar *fn_xml = NULL;
+	g_autofree gchar *fn_xml_fake = NULL;
+	g_autofree gchar *prefix = NULL;
+	g_autofree gchar *xml = NULL;
 	g_autoptr(FuDevice) device = fu_device_new(self->ctx);
 	g_autoptr(FuEngine) engine = fu_engine_new();
+	g_autoptr(FuEngine) engine2 = fu_engine_new();
+	g_autoptr(FuEngine) engine3 = fu_engine_new();
 	g_autoptr(FuProgress) progress = fu_progress_new(G_STRLOC);
+	g_autoptr(FuProgress) progress2 = fu_progress_new(G_STRLOC);
+	g_autoptr(FuProgress) progress3 = fu_progress_new(G_STRLOC);
 	g_autoptr(GBytes) data = NULL;
 	g_autoptr(GError) error = NULL;
+	g_autoptr(GPtrArray) files = NULL;
+	g_autoptr(GString) xml_fake = NULL;
 	g_autoptr(XbNode) component = NULL;
+	g_autoptr(XbNode) component2 = NULL;
+	g_autoptr(XbNode) component3 = NULL;
 
 	/* put cab file somewhere we can parse it */
 	filename =
@@ -166,6 +192,74 @@ fu_engine_generate_md_func(gconstpointer user_data)
 	g_assert_cmpstr(tmp, ==, "3da49ddd961144a79336b3ac3b0e469cb2531d0e");
 	tmp = xb_node_query_text(component, "releases/release/checksum[@target='content']", NULL);
 	g_assert_cmpstr(tmp, ==, NULL);
+
+	/* point the cached checksum at different metadata, so that using it can be detected */
+	cachedir = g_build_filename(cachedirpkg, "cabinets", "directory", NULL);
+	files = fu_path_get_files(cachedir, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(files);
+	for (guint i = 0; i < files->len; i++) {
+		const gchar *fn = g_ptr_array_index(files, i);
+		if (g_str_has_suffix(fn, ".checksum"))
+			fn_checksum = g_strdup(fn);
+	}
+	g_assert_nonnull(fn_checksum);
+	ret = g_file_get_contents(fn_checksum, &checksum_buf, NULL, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	tmp = g_strrstr(checksum_buf, ":");
+	g_assert_nonnull(tmp);
+	prefix = g_strndup(checksum_buf, tmp - checksum_buf + 1);
+	dirname = g_path_get_dirname(fn_checksum);
+	basename = g_strdup_printf("%s.xml", tmp + 1);
+	fn_xml = g_build_filename(dirname, basename, NULL);
+	ret = g_file_get_contents(fn_xml, &xml, NULL, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	xml_fake = g_string_new(xml);
+	fu_string_replace(xml_fake,
+			  "3da49ddd961144a79336b3ac3b0e469cb2531d0e",
+			  "0000000000000000000000000000000000000000");
+	fn_xml_fake = g_build_filename(dirname, "fake.xml", NULL);
+	ret = g_file_set_contents(fn_xml_fake, xml_fake->str, -1, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_free(checksum_buf);
+	checksum_buf = g_strdup_printf("%sfake", prefix);
+	ret = g_file_set_contents(fn_checksum, checksum_buf, -1, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+
+	/* load again, this time using the metadata cached from the unmodified cabinet */
+	ret = fu_engine_load(engine2,
+			     FU_ENGINE_LOAD_FLAG_REMOTES | FU_ENGINE_LOAD_FLAG_NO_CACHE,
+			     progress2,
+			     &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	component2 = fu_engine_get_component_by_guids(engine2, device);
+	g_assert_nonnull(component2);
+	tmp = xb_node_query_text(component2,
+				 "releases/release/checksum[@target='container']",
+				 NULL);
+	g_assert_cmpstr(tmp, ==, "0000000000000000000000000000000000000000");
+
+	/* replacing the cabinet changes the inode, even with the same size in the same second */
+	ret = fu_bytes_set_contents("/tmp/fwupd-self-test/var/cache/fwupd/foo.cab", data, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	ret = fu_engine_load(engine3,
+			     FU_ENGINE_LOAD_FLAG_REMOTES | FU_ENGINE_LOAD_FLAG_NO_CACHE,
+			     progress3,
+			     &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	component3 = fu_engine_get_component_by_guids(engine3, device);
+	g_assert_nonnull(component3);
+	tmp = xb_node_query_text(component3,
+				 "releases/release/checksum[@target='container']",
+				 NULL);
+	g_assert_cmpstr(tmp, ==, "3da49ddd961144a79336b3ac3b0e469cb2531d0e");
 }
 
 static void
@@ -726,6 +820,405 @@ fu_engine_requirements_device_func(gconstpointer user_data)
 	g_assert_true(ret);
 }
 
+static void
+fu_engine_requirements_benchmark_func(gconstpointer user_data)
+{
+	FuTest *self = (FuTest *)user_data;
+	gboolean ret;
+	g_autoptr(FuDevice) device = fu_device_new(self->ctx);
+	g_autoptr(FuEngine) engine = fu_engine_new();
+	g_autoptr(FuEngineRequest) request = fu_engine_request_new();
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GPtrArray) reqs = NULL;
+	g_autoptr(GTimer) timer = g_timer_new();
+	g_autoptr(XbQuery) query = NULL;
+	g_autoptr(XbSilo) silo = NULL;
+	const gchar *xml =
+	    "<component>"
+	    "  <requires>"
+	    "    <firmware compare=\"ge\" version=\"1.2.3\"/>"
+	    "    <firmware compare=\"lt\" version=\"2.0.0~rc1\"/>"
+	    "    <firmware compare=\"eq\" version=\"4.5.6\">bootloader</firmware>"
+	    "    <firmware compare=\"regex\" version=\"USB:0xFFFF|DMI:Lenovo\">vendor-id</firmware>"
+	    "    <firmware depth=\"0\">12345678-1234-1234-1234-123456789012|"
+	    "ffffffff-ffff-ffff-ffff-ffffffffffff</firmware>"
+	    "    <id compare=\"ge\" version=\"1.2.3\">org.test.dummy</id>"
+	    "    <client>detach-action</client>"
+	    "  </requires>"
+	    "  <provides>"
+	    "    <firmware type=\"flashed\">12345678-1234-1234-1234-123456789012</firmware>"
+	    "  </provides>"
+	    "  <releases>"
+	    "    <release version=\"1.2.4\"/>"
+	    "  </releases>"
+	    "</component>";
+
+	/* set up a dummy device */
+	fu_engine_add_runtime_version(engine, "org.test.dummy", "1.2.3");
+	fu_engine_request_set_feature_flags(request, FWUPD_FEATURE_FLAG_DETACH_ACTION);
+	fu_device_set_version_format(device, FWUPD_VERSION_FORMAT_TRIPLET);
+	fu_device_set_version(device, "1.2.3");
+	fu_device_set_version_bootloader(device, "4.5.6");
+	fu_device_add_vendor_id(device, "USB:0xFFFF");
+	fu_device_add_flag(device, FWUPD_DEVICE_FLAG_UPDATABLE);
+	fu_device_add_guid(device, "12345678-1234-1234-1234-123456789012");
+
+	silo = xb_silo_new_from_xml(xml, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(silo);
+	query = xb_query_new_full(silo, "component", XB_QUERY_FLAG_FORCE_NODE_CACHE, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(query);
+
+	/* query the silo for each check like the engine does, which should reuse the same node
+	 * and so only parse the requirements once for each component */
+	g_timer_reset(timer);
+	for (guint i = 0; i < 10000; i++) {
+		g_auto(XbQueryContext) context = XB_QUERY_CONTEXT_INIT();
+		g_autoptr(FuRelease) release = fu_release_new();
+		g_autoptr(XbNode) component = NULL;
+
+		xb_query_context_set_flags(&context, XB_QUERY_FLAG_FORCE_NODE_CACHE);
+		component = xb_silo_query_first_with_context(silo, query, &context, &error);
+		g_assert_no_error(error);
+		g_assert_nonnull(component);
+		fu_release_set_device(release, device);
+		fu_release_set_request(release, request);
+		ret = fu_release_load(release, component, NULL, FWUPD_INSTALL_FLAG_NONE, &error);
+		g_assert_no_error(error);
+		g_assert_true(ret);
+		ret = fu_engine_check_requirements(engine,
+						   release,
+						   FWUPD_INSTALL_FLAG_NONE,
+						   &error);
+		g_assert_no_error(error);
+		g_assert_true(ret);
+
+		/* parsed once for each component */
+		if (reqs == NULL)
+			reqs = g_ptr_array_ref(fu_release_get_hard_reqs(release));
+		g_assert_true(reqs == fu_release_get_hard_reqs(release));
+	}
+	g_print("check=%.3fms ", g_timer_elapsed(timer, NULL) * 1000.f);
+}
+
+static void
+fu_daemon_sender_vanished_func(void)
+{
+	gboolean ret;
+	g_autofree gchar *dbus_daemon = g_find_program_in_path("dbus-daemon");
+	g_autofree gchar *sender = NULL;
+	g_autoptr(FuDaemon) daemon = fu_daemon_new();
+	g_autoptr(GDBusConnection) client = NULL;
+	g_autoptr(GDBusConnection) connection = NULL;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GTestDBus) bus = NULL;
+
+	if (dbus_daemon == NULL) {
+		g_test_skip("no dbus-daemon");
+		return;
+	}
+	bus = g_test_dbus_new(G_TEST_DBUS_NONE);
+	g_test_dbus_up(bus);
+	connection = g_dbus_connection_new_for_address_sync(
+	    g_test_dbus_get_bus_address(bus),
+	    G_DBUS_CONNECTION_FLAGS_AUTHENTICATION_CLIENT |
+		G_DBUS_CONNECTION_FLAGS_MESSAGE_BUS_CONNECTION,
+	    NULL,
+	    NULL,
+	    &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(connection);
+	client = g_dbus_connection_new_for_address_sync(
+	    g_test_dbus_get_bus_address(bus),
+	    G_DBUS_CONNECTION_FLAGS_AUTHENTICATION_CLIENT |
+		G_DBUS_CONNECTION_FLAGS_MESSAGE_BUS_CONNECTION,
+	    NULL,
+	    NULL,
+	    &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(client);
+	sender = g_strdup(g_dbus_connection_get_unique_name(client));
+	fu_daemon_set_connection(daemon, connection);
+
+	/* the credentials lookup has started */
+	fu_daemon_track_sender(daemon, sender);
+	g_assert_true(fu_daemon_has_sender(daemon, sender));
+
+	/* the client disconnects before the reply arrives */
+	ret = g_dbus_connection_close_sync(client, NULL, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	while (fu_daemon_has_sender(daemon, sender))
+		g_main_context_iteration(NULL, TRUE);
+
+	/* the late reply must not re-create the sender */
+	ret = fu_daemon_set_sender_uid(daemon, sender, 1000, &error);
+	g_assert_error(error, FWUPD_ERROR, FWUPD_ERROR_NOT_FOUND);
+	g_assert_false(ret);
+	g_assert_false(fu_daemon_has_sender(daemon, sender));
+
+	/* drop the watches before the bus goes away */
+	g_clear_object(&daemon);
+	g_dbus_connection_close_sync(connection, NULL, NULL);
+	g_test_dbus_down(bus);
+}
+
+static GPtrArray *
+fu_daemon_test_get_devices(GDBusConnection *client, const gchar *name, GError **error)
+{
+	g_autoptr(GVariant) val = NULL;
+
+	val = g_dbus_connection_call_sync(client,
+					  name,
+					  FWUPD_DBUS_PATH,
+					  FWUPD_DBUS_INTERFACE,
+					  "GetDevices",
+					  NULL,
+					  G_VARIANT_TYPE("(aa{sv})"),
+					  G_DBUS_CALL_FLAGS_NONE,
+					  5000,
+					  NULL,
+					  error);
+	if (val == NULL)
+		return NULL;
+	return fwupd_device_array_from_variant(val);
+}
+
+static void
+fu_daemon_snapshot_func(gconstpointer user_data)
+{
+	FuTest *self = (FuTest *)user_data;
+	FwupdDevice *device_tmp;
+	const gchar *name;
+	g_autofree gchar *dbus_daemon = g_find_program_in_path("dbus-daemon");
+	g_autoptr(FuDaemon) daemon = fu_daemon_new();
+	g_autoptr(FuDevice) device1 = fu_device_new(self->ctx);
+	g_autoptr(FuDevice) device2 = fu_device_new(self->ctx);
+	g_autoptr(FuDevice) device3 = fu_device_new(self->ctx);
+	g_autoptr(FuEngine) engine = fu_engine_new();
+	g_autoptr(GDBusConnection) client = NULL;
+	g_autoptr(GDBusConnection) connection = NULL;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GPtrArray) devices = NULL;
+	g_autoptr(GTestDBus) bus = NULL;
+	g_autoptr(XbSilo) silo_empty = xb_silo_new();
+
+	if (dbus_daemon == NULL) {
+		g_test_skip("no dbus-daemon");
+		return;
+	}
+	bus = g_test_dbus_new(G_TEST_DBUS_NONE);
+	g_test_dbus_up(bus);
+	connection = g_dbus_connection_new_for_address_sync(
+	    g_test_dbus_get_bus_address(bus),
+	    G_DBUS_CONNECTION_FLAGS_AUTHENTICATION_CLIENT |
+		G_DBUS_CONNECTION_FLAGS_MESSAGE_BUS_CONNECTION,
+	    NULL,
+	    NULL,
+	    &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(connection);
+	client = g_dbus_connection_new_for_address_sync(
+	    g_test_dbus_get_bus_address(bus),
+	    G_DBUS_CONNECTION_FLAGS_AUTHENTICATION_CLIENT |
+		G_DBUS_CONNECTION_FLAGS_MESSAGE_BUS_CONNECTION,
+	    NULL,
+	    NULL,
+	    &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(client);
+	name = g_dbus_connection_get_unique_name(connection);
+
+	/* no metadata in daemon */
+	fu_engine_set_silo(engine, silo_empty);
+	fu_device_set_id(device1, "beta");
+	fu_device_set_name(device1, "Beta");
+	fu_engine_add_device(engine, device1);
+	fu_device_set_id(device2, "alpha");
+	fu_device_set_name(device2, "Alpha");
+	fu_engine_add_device(engine, device2);
+	fu_daemon_set_engine(daemon, engine);
+	fu_daemon_set_connection(daemon, connection);
+
+	/* the install blocks this thread, so nothing iterates the main context */
+	fu_daemon_install_begin(daemon);
+	devices = fu_daemon_test_get_devices(client, name, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(devices);
+	g_assert_cmpint(devices->len, ==, 2);
+	device_tmp = g_ptr_array_index(devices, 0);
+	g_assert_cmpstr(fwupd_device_get_name(device_tmp), ==, "Alpha");
+	g_clear_pointer(&devices, g_ptr_array_unref);
+
+	/* a device added by the install is sorted as fu_engine_get_devices() would */
+	fu_device_set_id(device3, "gamma");
+	fu_device_set_name(device3, "Gamma");
+	fu_device_set_priority(device3, 1);
+	g_signal_emit_by_name(engine, "device-added", device3);
+	devices = fu_daemon_test_get_devices(client, name, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(devices);
+	g_assert_cmpint(devices->len, ==, 3);
+	device_tmp = g_ptr_array_index(devices, 0);
+	g_assert_cmpstr(fwupd_device_get_name(device_tmp), ==, "Gamma");
+	device_tmp = g_ptr_array_index(devices, 1);
+	g_assert_cmpstr(fwupd_device_get_name(device_tmp), ==, "Alpha");
+	device_tmp = g_ptr_array_index(devices, 2);
+	g_assert_cmpstr(fwupd_device_get_name(device_tmp), ==, "Beta");
+	g_clear_pointer(&devices, g_ptr_array_unref);
+
+	/* no object is registered, so once finished nothing answers the call */
+	fu_daemon_install_end(daemon);
+	devices = fu_daemon_test_get_devices(client, name, &error);
+	g_assert_error(error, G_DBUS_ERROR, G_DBUS_ERROR_UNKNOWN_METHOD);
+	g_assert_null(devices);
+
+	/* drop the filter before the bus goes away */
+	g_clear_object(&daemon);
+	g_dbus_connection_close_sync(client, NULL, NULL);
+	g_dbus_connection_close_sync(connection, NULL, NULL);
+	g_test_dbus_down(bus);
+}
+
+static void
+fu_zstd_decompressor_func(void)
+{
+#ifdef HAVE_ZSTD
+	gssize rc;
+	gsize bufsz;
+	g_autofree guint8 *buf = NULL;
+	g_autoptr(FuZstdDecompressor) conv = fu_zstd_decompressor_new();
+	g_autoptr(GBytes) blob = NULL;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GInputStream) istream_conv = NULL;
+	g_autoptr(GInputStream) istream = NULL;
+	g_autoptr(GOutputStream) ostream = g_memory_output_stream_new_resizable();
+	g_autoptr(GString) str = g_string_new("<components>");
+
+	/* large enough to need several reads */
+	for (guint i = 0; i < 10000; i++)
+		g_string_append_printf(str, "<component><id>%u</id></component>", i);
+	g_string_append(str, "</components>");
+	bufsz = ZSTD_compressBound(str->len);
+	buf = g_malloc0(bufsz);
+	bufsz = ZSTD_compress(buf, bufsz, str->str, str->len, 3);
+	g_assert_false(ZSTD_isError(bufsz));
+
+	/* decompress to EOF, where the converter sees INPUT_AT_END with no more input */
+	istream = g_memory_input_stream_new_from_data(buf, bufsz, NULL);
+	istream_conv = g_converter_input_stream_new(istream, G_CONVERTER(conv));
+	rc = g_output_stream_splice(ostream,
+				    istream_conv,
+				    G_OUTPUT_STREAM_SPLICE_CLOSE_SOURCE |
+					G_OUTPUT_STREAM_SPLICE_CLOSE_TARGET,
+				    NULL,
+				    &error);
+	g_assert_no_error(error);
+	g_assert_cmpint(rc, ==, str->len);
+	blob = g_memory_output_stream_steal_as_bytes(G_MEMORY_OUTPUT_STREAM(ostream));
+	g_assert_cmpint(g_bytes_get_size(blob), ==, str->len);
+	g_assert_cmpint(memcmp(g_bytes_get_data(blob, NULL), str->str, str->len), ==, 0);
+#else
+	g_test_skip("no zstd support");
+#endif
+}
+
+static void
+fu_emulation_blob_func(void)
+{
+	gboolean ret;
+	JsonNode *json_root;
+	const gchar *json =
+	    "{\"UsbDevices\":[{\"Created\":\"2023-02-01T16:35:03.302027Z\",\"IdVendor\":10047,"
+	    "\"Emulated\":true,\"Ratio\":0.5,\"Parent\":null,\"UsbEvents\":["
+	    "{\"Id\":\"GetCustomIndex:ClassId=0xff\",\"Data\":\"Ag==\"},"
+	    "{\"Id\":\"GetCustomIndex:ClassId=0xff\",\"Data\":\"Ag==\"},"
+	    "{\"Id\":\"\",\"Data\":\"\u00e9\"}]}]}";
+	const FuEmulationBlobFlags flags[] = {FU_EMULATION_BLOB_FLAG_NONE,
+					      FU_EMULATION_BLOB_FLAG_ZSTD};
+	g_autoptr(JsonParser) parser = json_parser_new();
+
+	ret = json_parser_load_from_data(parser, json, -1, NULL);
+	g_assert_true(ret);
+	json_root = json_parser_get_root(parser);
+
+	/* round trip, optionally using compression */
+	for (guint i = 0; i < G_N_ELEMENTS(flags); i++) {
+		gsize bufsz = 0;
+		const guint8 *buf;
+		g_autoptr(GBytes) blob = NULL;
+		g_autoptr(GBytes) blob_trunc = NULL;
+		g_autoptr(GError) error = NULL;
+		g_autoptr(JsonNode) json_node = NULL;
+		g_autoptr(JsonNode) json_node_trunc = NULL;
+
+		blob = fu_emulation_blob_from_json_node(json_root, flags[i], &error);
+		g_assert_no_error(error);
+		g_assert_nonnull(blob);
+		json_node = fu_emulation_blob_to_json_node(blob, &error);
+		g_assert_no_error(error);
+		g_assert_nonnull(json_node);
+		g_assert_true(json_node_equal(json_root, json_node));
+
+		/* corrupt */
+		buf = g_bytes_get_data(blob, &bufsz);
+		blob_trunc = g_bytes_new(buf, bufsz - 1);
+		json_node_trunc = fu_emulation_blob_to_json_node(blob_trunc, &error);
+		g_assert_error(error, FWUPD_ERROR, FWUPD_ERROR_INVALID_FILE);
+		g_assert_null(json_node_trunc);
+	}
+
+#ifdef HAVE_ZSTD
+	/* the uncompressed size in the header is far larger than the zstd data */
+	{
+		const guint8 buf[] = {'F', 'E', 'M', 'U', 0x01, 0x01, 0x00, 0x00, 0x00,
+				      0x00, 0x00, 0x10, 0x28, 0xB5, 0x2F, 0xFD, 0x00};
+		g_autoptr(GBytes) blob = g_bytes_new_static(buf, sizeof(buf));
+		g_autoptr(GError) error = NULL;
+		g_autoptr(JsonNode) json_node = NULL;
+
+		json_node = fu_emulation_blob_to_json_node(blob, &error);
+		g_assert_error(error, FWUPD_ERROR, FWUPD_ERROR_INVALID_FILE);
+		g_assert_null(json_node);
+	}
+#endif
+}
+
+static void
+fu_engine_requirements_version_compare_func(void)
+{
+	const gchar *versions[] = {"1.2.3", "1.2.4", "1.2", "1.2.3.4", "1.2.3~rc1", "1.2.3a",
+				   "1.2.3b", "1.10", "01.2.3", "1..2", "1.2.", "", "abc",
+				   "-1.2", NULL};
+
+	/* this has to give the same result as fu_version_compare() for every combination */
+	for (guint j = 0; versions[j] != NULL; j++) {
+		g_autofree gchar *xml =
+		    g_strdup_printf("<firmware compare=\"eq\" version=\"%s\"/>", versions[j]);
+		g_autoptr(FuRequirement) req = NULL;
+		g_autoptr(GError) error = NULL;
+		g_autoptr(XbNode) n = NULL;
+		g_autoptr(XbSilo) silo = xb_silo_new_from_xml(xml, &error);
+		g_assert_no_error(error);
+		g_assert_nonnull(silo);
+		n = xb_silo_query_first(silo, "firmware", &error);
+		g_assert_no_error(error);
+		g_assert_nonnull(n);
+		req = fu_requirement_new_from_node(n);
+		for (guint i = 0; versions[i] != NULL; i++) {
+			g_assert_cmpint(
+			    fu_requirement_version_compare(req,
+							   versions[i],
+							   FWUPD_VERSION_FORMAT_TRIPLET),
+			    ==,
+			    fu_version_compare(versions[i],
+					       versions[j],
+					       FWUPD_VERSION_FORMAT_TRIPLET));
+		}
+	}
+}
+
 static void
 fu_engine_requirements_device_plain_func(gconstpointer user_data)
 {
@@ -1409,6 +1902,132 @@ fu_engine_partial_hash_func(gconstpointer user_data)
 	g_assert_true(ret);
 }
 
+static void
+fu_engine_coldplug_concurrency_check(gboolean thread_safe)
+{
+	gboolean ret;
+	g_autofree gchar *thread_main = g_strdup_printf("%p", g_thread_self());
+	g_autoptr(FuBackend) backend = NULL;
+	g_autoptr(FuEngine) engine = fu_engine_new();
+	g_autoptr(FuPlugin) plugin = NULL;
+	g_autoptr(FuProgress) progress = fu_progress_new(G_STRLOC);
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GPtrArray) devices = NULL;
+	g_autoptr(GPtrArray) devices_test = g_ptr_array_new();
+
+	/* the plugin creates a FuDevice for each backend device */
+	plugin = fu_plugin_new_from_gtype(fu_test_plugin_get_type(), fu_engine_get_context(engine));
+	fu_plugin_set_thread_safe(plugin, thread_safe);
+	fu_plugin_add_device_gtype(plugin, FU_TYPE_DEVICE);
+	fu_engine_add_plugin(engine, plugin);
+
+	/* each pair of devices shares a physical ID, and so is set up on the same thread */
+	backend = g_object_new(FU_TYPE_BACKEND,
+			       "context",
+			       fu_engine_get_context(engine),
+			       "name",
+			       "test",
+			       NULL);
+	for (guint i = 0; i < 8; i++) {
+		g_autoptr(FuDevice) device = fu_device_new(fu_engine_get_context(engine));
+		g_autofree gchar *backend_id = g_strdup_printf("/sys/devices/test/dev%u", i);
+		g_autofree gchar *instance_id = g_strdup_printf("TEST\\DEV_%02u", i);
+		g_autofree gchar *logical_id = g_strdup_printf("%u", i % 2);
+		g_autofree gchar *physical_id = g_strdup_printf("test:%u", i / 2);
+
+		fu_device_set_backend_id(device, backend_id);
+		fu_device_set_physical_id(device, physical_id);
+		fu_device_set_logical_id(device, logical_id);
+		fu_device_add_instance_id(device, instance_id);
+		fu_device_add_possible_plugin(device, "test");
+
+		/* the worker threads have to ask the main thread about the metadata */
+		fu_device_add_internal_flag(device, FU_DEVICE_INTERNAL_FLAG_ONLY_SUPPORTED);
+		fu_backend_device_added(backend, device);
+	}
+	fu_engine_add_backend(engine, backend);
+	ret = fu_engine_load(engine,
+			     FU_ENGINE_LOAD_FLAG_COLDPLUG | FU_ENGINE_LOAD_FLAG_NO_CACHE,
+			     progress,
+			     &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+
+	/* all added from the main thread */
+	devices = fu_engine_get_devices(engine, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(devices);
+	for (guint i = 0; i < 8; i++) {
+		g_autofree gchar *backend_id = g_strdup_printf("/sys/devices/test/dev%u", i);
+		for (guint j = 0; j < devices->len; j++) {
+			FuDevice *device = g_ptr_array_index(devices, j);
+			if (g_strcmp0(fu_device_get_backend_id(device), backend_id) == 0) {
+				g_ptr_array_add(devices_test, device);
+				break;
+			}
+		}
+	}
+	g_assert_cmpint(devices_test->len, ==, 8);
+
+	/* only the thread safe plugin is used from the worker threads */
+	for (guint i = 0; i < devices_test->len; i++) {
+		FuDevice *device = g_ptr_array_index(devices_test, i);
+		const gchar *thread = fu_device_get_metadata(device, "CreatedThread");
+		g_assert_nonnull(thread);
+		if (thread_safe)
+			g_assert_cmpstr(thread, !=, thread_main);
+		else
+			g_assert_cmpstr(thread, ==, thread_main);
+	}
+
+	/* devices sharing a physical ID are set up in order on the same thread */
+	for (guint i = 0; i < devices_test->len; i += 2) {
+		FuDevice *device1 = g_ptr_array_index(devices_test, i);
+		FuDevice *device2 = g_ptr_array_index(devices_test, i + 1);
+		g_assert_cmpstr(fu_device_get_metadata(device1, "CreatedThread"),
+				==,
+				fu_device_get_metadata(device2, "CreatedThread"));
+		g_assert_cmpint(fu_device_get_metadata_integer(device1, "CreatedOrder"),
+				<,
+				fu_device_get_metadata_integer(device2, "CreatedOrder"));
+	}
+}
+
+static void
+fu_engine_coldplug_concurrency_func(void)
+{
+	gboolean ret;
+	g_autoptr(FuEngine) engine = fu_engine_new();
+	g_autoptr(FuProgress) progress = fu_progress_new(G_STRLOC);
+	g_autoptr(GError) error = NULL;
+
+	/* set up at most four devices at the same time */
+	ret = fu_engine_load(engine, FU_ENGINE_LOAD_FLAG_NO_CACHE, progress, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	ret = fu_config_set_value(FU_CONFIG(fu_engine_get_config(engine)),
+				  "fwupd",
+				  "ColdplugConcurrency",
+				  "4",
+				  &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+
+	/* the test plugin records the thread used to set up each device */
+	(void)g_setenv("FWUPD_PLUGIN_TEST", "coldplug-concurrency", TRUE);
+	fu_engine_coldplug_concurrency_check(TRUE);
+	fu_engine_coldplug_concurrency_check(FALSE);
+	g_unsetenv("FWUPD_PLUGIN_TEST");
+
+	ret = fu_config_set_value(FU_CONFIG(fu_engine_get_config(engine)),
+				  "fwupd",
+				  "ColdplugConcurrency",
+				  "0",
+				  &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+}
+
 static void
 fu_engine_device_unlock_func(gconstpointer user_data)
 {
@@ -1709,6 +2328,7 @@ static void
 fu_engine_downgrade_func(gconstpointer user_data)
 {
 	FuTest *self = (FuTest *)user_data;
+	FwupdDevice *device_up;
 	FwupdRelease *rel;
 	gboolean ret;
 	g_autoptr(FuDevice) device = fu_device_new(self->ctx);
@@ -1718,6 +2338,7 @@ fu_engine_downgrade_func(gconstpointer user_data)
 	g_autoptr(GError) error = NULL;
 	g_autoptr(GPtrArray) devices = NULL;
 	g_autoptr(GPtrArray) devices_pre = NULL;
+	g_autoptr(GPtrArray) devices_up = NULL;
 	g_autoptr(GPtrArray) releases_dg = NULL;
 	g_autoptr(GPtrArray) releases = NULL;
 	g_autoptr(GPtrArray) releases_up = NULL;
@@ -1882,6 +2503,18 @@ fu_engine_downgrade_func(gconstpointer user_data)
 	rel = FWUPD_RELEASE(g_ptr_array_index(releases_up, 1));
 	g_assert_cmpstr(fwupd_release_get_version(rel), ==, "1.2.4");
 
+	/* upgrades for all devices, without modifying the device itself */
+	devices_up = fu_engine_get_upgrades_all(engine, request, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(devices_up);
+	g_assert_cmpint(devices_up->len, ==, 1);
+	device_up = g_ptr_array_index(devices_up, 0);
+	g_assert_cmpstr(fwupd_device_get_id(device_up), ==, fu_device_get_id(device));
+	g_assert_cmpint(fwupd_device_get_releases(device_up)->len, ==, 2);
+	rel = FWUPD_RELEASE(g_ptr_array_index(fwupd_device_get_releases(device_up), 0));
+	g_assert_cmpstr(fwupd_release_get_version(rel), ==, "1.2.5");
+	g_assert_cmpint(fwupd_device_get_releases(FWUPD_DEVICE(device))->len, ==, 0);
+
 	/* downgrades */
 	releases_dg = fu_engine_get_downgrades(engine, request, fu_device_get_id(device), &error);
 	g_assert_no_error(error);
@@ -3633,6 +4266,204 @@ fu_backend_usb_invalid_func(gconstpointer user_data)
 #endif
 }
 
+static void
+fu_backend_usb_transfer_chunks_func(gconstpointer user_data)
+{
+#ifdef HAVE_GUSB
+	FuTest *self = (FuTest *)user_data;
+	gboolean ret;
+	FuDevice *device_tmp;
+	const gchar *data1 = "abcdefghij";
+	const gchar *data2 = "0123456789";
+	g_autofree gchar *gusb_emulate_fn = NULL;
+	g_autoptr(FuBackend) backend = fu_usb_backend_new(self->ctx);
+	g_autoptr(FuProgress) progress = fu_progress_new(G_STRLOC);
+	g_autoptr(FuProgress) progress_chunks = fu_progress_new(G_STRLOC);
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GPtrArray) chunks1 = NULL;
+	g_autoptr(GPtrArray) chunks2 = NULL;
+	g_autoptr(GPtrArray) devices = NULL;
+
+#if !G_USB_CHECK_VERSION(0, 4, 5)
+	g_test_skip("GUsb version too old");
+	return;
+#endif
+
+	/* load the JSON into the backend */
+	ret = fu_backend_setup(backend, progress, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	gusb_emulate_fn =
+	    g_test_build_filename(G_TEST_DIST, "tests", "usb-devices-bulk.json", NULL);
+	fu_backend_usb_load_file(backend, gusb_emulate_fn);
+	ret = fu_backend_coldplug(backend, progress, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	devices = fu_backend_get_devices(backend);
+	g_assert_cmpint(devices->len, ==, 1);
+	device_tmp = g_ptr_array_index(devices, 0);
+	fu_device_set_context(device_tmp, self->ctx);
+
+	/* saving events does one transfer at a time */
+	fu_context_add_flag(self->ctx, FU_CONTEXT_FLAG_SAVE_EVENTS);
+
+	/* split into 4+4+2 bytes, each sent in order */
+	chunks1 = fu_chunk_array_new((const guint8 *)data1, strlen(data1), 0x0, 0x0, 4);
+	g_assert_cmpint(chunks1->len, ==, 3);
+	ret = fu_usb_device_bulk_transfer_chunks(FU_USB_DEVICE(device_tmp),
+						 0x01,
+						 chunks1,
+						 8,
+						 1000,
+						 progress_chunks,
+						 &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_assert_cmpint(fu_progress_get_percentage(progress_chunks), ==, 100);
+
+	/* the second chunk is short, which has to fail */
+	chunks2 = fu_chunk_array_new((const guint8 *)data2, strlen(data2), 0x0, 0x0, 4);
+	ret = fu_usb_device_bulk_transfer_chunks(FU_USB_DEVICE(device_tmp),
+						 0x01,
+						 chunks2,
+						 8,
+						 1000,
+						 NULL,
+						 &error);
+	g_assert_error(error, G_IO_ERROR, G_IO_ERROR_PARTIAL_INPUT);
+	g_assert_cmpstr(error->message, ==, "only transferred 0x2 of 0x4 bytes for chunk 0x1");
+	g_assert_false(ret);
+	fu_context_remove_flag(self->ctx, FU_CONTEXT_FLAG_SAVE_EVENTS);
+#else
+	g_test_skip("No GUsb support");
+#endif
+}
+
+static void
+fu_backend_usb_transfer_chunks_async_func(gconstpointer user_data)
+{
+#ifdef HAVE_GUSB
+	FuTest *self = (FuTest *)user_data;
+	gboolean ret;
+	FuDevice *device_tmp;
+	const gchar *data1 = "ABCDEFGH";
+	const gchar *data2 = "klmnopqrstuv";
+	guint8 buf[4] = {0x0};
+	g_autofree gchar *gusb_emulate_fn = NULL;
+	g_autoptr(FuBackend) backend = fu_usb_backend_new(self->ctx);
+	g_autoptr(FuProgress) progress = fu_progress_new(G_STRLOC);
+	g_autoptr(FuProgress) progress_chunks1 = fu_progress_new(G_STRLOC);
+	g_autoptr(FuProgress) progress_chunks2 = fu_progress_new(G_STRLOC);
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GPtrArray) chunks1 = NULL;
+	g_autoptr(GPtrArray) chunks2 = NULL;
+	g_autoptr(GPtrArray) chunks3 = NULL;
+	g_autoptr(GPtrArray) devices = NULL;
+
+#if !G_USB_CHECK_VERSION(0, 4, 5)
+	g_test_skip("GUsb version too old");
+	return;
+#endif
+
+	/* load the JSON into the backend */
+	ret = fu_backend_setup(backend, progress, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	gusb_emulate_fn =
+	    g_test_build_filename(G_TEST_DIST, "tests", "usb-devices-bulk.json", NULL);
+	fu_backend_usb_load_file(backend, gusb_emulate_fn);
+	ret = fu_backend_coldplug(backend, progress, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	devices = fu_backend_get_devices(backend);
+	g_assert_cmpint(devices->len, ==, 1);
+	device_tmp = g_ptr_array_index(devices, 0);
+	fu_device_set_context(device_tmp, self->ctx);
+	g_assert_true(fu_device_has_flag(device_tmp, FWUPD_DEVICE_FLAG_EMULATED));
+
+	/* IN transfers write into the chunks, so read-only chunks are rejected up front */
+	chunks3 = fu_chunk_array_new(buf, sizeof(buf), 0x0, 0x0, 2);
+	ret = fu_usb_device_bulk_transfer_chunks(FU_USB_DEVICE(device_tmp),
+						 0x81,
+						 chunks3,
+						 2,
+						 1000,
+						 NULL,
+						 &error);
+	g_assert_error(error, FWUPD_ERROR, FWUPD_ERROR_INTERNAL);
+	g_assert_false(ret);
+	g_clear_error(&error);
+
+	/* four chunks with only two queued at any time */
+	chunks1 = fu_chunk_array_new((const guint8 *)data1, strlen(data1), 0x0, 0x0, 2);
+	g_assert_cmpint(chunks1->len, ==, 4);
+	ret = fu_usb_device_bulk_transfer_chunks(FU_USB_DEVICE(device_tmp),
+						 0x01,
+						 chunks1,
+						 2,
+						 1000,
+						 progress_chunks1,
+						 &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_assert_cmpint(fu_progress_get_percentage(progress_chunks1), ==, 100);
+
+	/* the fourth of six chunks is short, which cancels the fifth that is already queued */
+	chunks2 = fu_chunk_array_new((const guint8 *)data2, strlen(data2), 0x0, 0x0, 2);
+	g_assert_cmpint(chunks2->len, ==, 6);
+	ret = fu_usb_device_bulk_transfer_chunks(FU_USB_DEVICE(device_tmp),
+						 0x01,
+						 chunks2,
+						 2,
+						 1000,
+						 progress_chunks2,
+						 &error);
+	g_assert_error(error, G_IO_ERROR, G_IO_ERROR_PARTIAL_INPUT);
+	g_assert_cmpstr(error->message, ==, "only transferred 0x1 of 0x2 bytes for chunk 0x3");
+	g_assert_false(ret);
+
+	/* only the chunks before the failure were reported */
+	g_assert_cmpint(fu_progress_get_percentage(progress_chunks2), ==, 50);
+#else
+	g_test_skip("No GUsb support");
+#endif
+}
+
+static void
+fu_plugin_require_hwid_func(gconstpointer user_data)
+{
+	FuTest *self = (FuTest *)user_data;
+	gboolean ret;
+	g_autoptr(FuDevice) device = NULL;
+	g_autoptr(FuPlugin) plugin = fu_plugin_new_from_gtype(fu_test_plugin_get_type(), self->ctx);
+	g_autoptr(FuProgress) progress = fu_progress_new(G_STRLOC);
+	g_autoptr(GError) error = NULL;
+
+	/* startup would fail if it was run */
+	(void)g_setenv("FWUPD_TEST_PLUGIN_XML", "<invalid", TRUE);
+	g_signal_connect(FU_PLUGIN(plugin),
+			 "device-added",
+			 G_CALLBACK(_plugin_device_added_cb),
+			 &device);
+
+	/* no HwId matched, so the plugin is never started or coldplugged */
+	fu_plugin_add_flag(plugin, FWUPD_PLUGIN_FLAG_REQUIRE_HWID);
+	ret = fu_plugin_runner_startup(plugin, progress, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	ret = fu_plugin_runner_coldplug(plugin, progress, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_assert_null(device);
+
+	/* matched */
+	fu_plugin_remove_flag(plugin, FWUPD_PLUGIN_FLAG_REQUIRE_HWID);
+	ret = fu_plugin_runner_startup(plugin, progress, &error);
+	g_assert_nonnull(error);
+	g_assert_false(ret);
+	g_unsetenv("FWUPD_TEST_PLUGIN_XML");
+}
+
 static void
 fu_plugin_module_func(gconstpointer user_data)
 {
@@ -5170,8 +6001,15 @@ main(int argc, char **argv)
 		g_test_add_data_func("/fwupd/console", self, fu_console_func);
 	}
 	g_test_add_data_func("/fwupd/backend{usb}", self, fu_backend_usb_func);
+	g_test_add_data_func("/fwupd/backend{usb-transfer-chunks}",
+			     self,
+			     fu_backend_usb_transfer_chunks_func);
+	g_test_add_data_func("/fwupd/backend{usb-transfer-chunks-async}",
+			     self,
+			     fu_backend_usb_transfer_chunks_async_func);
 	g_test_add_data_func("/fwupd/backend{usb-invalid}", self, fu_backend_usb_invalid_func);
 	g_test_add_data_func("/fwupd/plugin{module}", self, fu_plugin_module_func);
+	g_test_add_data_func("/fwupd/plugin{require-hwid}", self, fu_plugin_require_hwid_func);
 	g_test_add_data_func("/fwupd/memcpy", self, fu_memcpy_func);
 	g_test_add_data_func("/fwupd/security-attr", self, fu_security_attr_func);
 	g_test_add_data_func("/fwupd/device-list", self, fu_device_list_func);
@@ -5199,6 +6037,7 @@ main(int argc, char **argv)
 	g_test_add_data_func("/fwupd/engine{get-details-missing}",
 			     self,
 			     fu_engine_get_details_missing_func);
+	g_test_add_func("/fwupd/engine{coldplug-concurrency}", fu_engine_coldplug_concurrency_func);
 	g_test_add_data_func("/fwupd/engine{device-unlock}", self, fu_engine_device_unlock_func);
 	g_test_add_data_func("/fwupd/engine{device-md-set-flags}",
 			     self,
@@ -5267,6 +6106,15 @@ main(int argc, char **argv)
 	g_test_add_data_func("/fwupd/engine{requirements-device}",
 			     self,
 			     fu_engine_requirements_device_func);
+	g_test_add_data_func("/fwupd/engine{requirements-benchmark}",
+			     self,
+			     fu_engine_requirements_benchmark_func);
+	g_test_add_func("/fwupd/engine{requirements-version-compare}",
+			fu_engine_requirements_version_compare_func);
+	g_test_add_func("/fwupd/emulation-blob", fu_emulation_blob_func);
+	g_test_add_func("/fwupd/zstd-decompressor", fu_zstd_decompressor_func);
+	g_test_add_func("/fwupd/daemon{sender-vanished}", fu_daemon_sender_vanished_func);
+	g_test_add_data_func("/fwupd/daemon{snapshot}", self, fu_daemon_snapshot_func);
 	g_test_add_data_func("/fwupd/engine{requirements-device-plain}",
 			     self,
 			     fu_engine_requirements_device_plain_func);
@@ -399,6 +399,9 @@ fu_util_progress_percentage_changed_cb(FuProgress *progress, guint percentage, F
 {
 	if (priv->as_json)
 		return;
+	fu_console_set_progress_rate(priv->console,
+				     fu_progress_get_throughput(progress),
+				     fu_progress_get_time_remaining(progress));
 	fu_console_set_progress(priv->console, fu_progress_get_status(progress), percentage);
 }
 
@@ -425,23 +428,23 @@ fu_util_plugin_name_sort_cb(FuPlugin **item1, FuPlugin **item2)
 	return fu_plugin_name_compare(*item1, *item2);
 }
 
-static gboolean
-fu_util_get_plugins_as_json(FuUtilPrivate *priv, GPtrArray *plugins, GError **error)
+static void
+fu_util_plugin_build_json_cb(FwupdPlugin *plugin, JsonBuilder *builder, FuUtilPrivate *priv)
 {
-	g_autoptr(JsonBuilder) builder = json_builder_new();
 	json_builder_begin_object(builder);
-
-	json_builder_set_member_name(builder, "Plugins");
-	json_builder_begin_array(builder);
-	for (guint i = 0; i < plugins->len; i++) {
-		FwupdPlugin *plugin = g_ptr_array_index(plugins, i);
-		json_builder_begin_object(builder);
-		fwupd_plugin_to_json(plugin, builder);
-		json_builder_end_object(builder);
-	}
-	json_builder_end_array(builder);
+	fwupd_plugin_to_json(plugin, builder);
 	json_builder_end_object(builder);
-	return fu_util_print_builder(priv->console, builder, error);
+}
+
+static gboolean
+fu_util_get_plugins_as_json(FuUtilPrivate *priv, GPtrArray *plugins, GError **error)
+{
+	return fu_util_print_json_array(priv->console,
+					"Plugins",
+					plugins,
+					(FuUtilJsonBuildFunc)fu_util_plugin_build_json_cb,
+					priv,
+					error);
 }
 
 static gboolean
@@ -3021,6 +3024,13 @@ fu_util_get_remotes(FuUtilPrivate *priv, gchar **values, GError **error)
 	return TRUE;
 }
 
+static gboolean
+fu_util_security_attrs_write_json_cb(FwupdJsonWriter *writer, gpointer user_data, GError **error)
+{
+	FuSecurityAttrs *attrs = FU_SECURITY_ATTRS(user_data);
+	return fu_security_attrs_write_json(attrs, writer, error);
+}
+
 static gboolean
 fu_util_security(FuUtilPrivate *priv, gchar **values, GError **error)
 {
@@ -3075,13 +3085,11 @@ fu_util_security(FuUtilPrivate *priv, gchar **values, GError **error)
 	}
 
 	/* print the "why" */
-	if (priv->as_json) {
-		str = fu_security_attrs_to_json_string(attrs, error);
-		if (str == NULL)
-			return FALSE;
-		fu_console_print_literal(priv->console, str);
-		return TRUE;
-	}
+	if (priv->as_json)
+		return fu_util_print_json_writer(priv->console,
+						 fu_util_security_attrs_write_json_cb,
+						 attrs,
+						 error);
 
 	fu_console_print(priv->console,
 			 "%s \033[1m%s\033[0m",
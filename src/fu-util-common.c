@@ -11,6 +11,9 @@
 #include <glib/gi18n.h>
 #include <stdio.h>
 #include <unistd.h>
+#ifdef HAVE_GIO_UNIX
+#include <gio/gunixoutputstream.h>
+#endif
 #ifdef HAVE_GUSB
 #include <gusb.h>
 #endif
@@ -2899,6 +2902,86 @@ fu_util_print_builder(FuConsole *console, JsonBuilder *builder, GError **error)
 	return TRUE;
 }
 
+/* stream directly to stdout where possible so the whole document is never held in memory */
+gboolean
+fu_util_print_json_writer(FuConsole *console,
+			  FuUtilJsonWriteFunc func,
+			  gpointer user_data,
+			  GError **error)
+{
+	g_autoptr(FwupdJsonWriter) writer = NULL;
+	g_autoptr(GOutputStream) stream = NULL;
+
+#ifdef HAVE_GIO_UNIX
+	fflush(stdout);
+	stream = g_unix_output_stream_new(STDOUT_FILENO, FALSE);
+#else
+	stream = g_memory_output_stream_new_resizable();
+#endif
+	writer = fwupd_json_writer_new(stream);
+	if (!func(writer, user_data, error))
+		return FALSE;
+	if (!fwupd_json_writer_finish(writer, error))
+		return FALSE;
+#ifdef HAVE_GIO_UNIX
+	return g_output_stream_write_all(stream, "\n", 1, NULL, NULL, error);
+#else
+	if (!g_output_stream_write_all(stream, "", 1, NULL, NULL, error))
+		return FALSE;
+	if (!g_output_stream_close(stream, NULL, error))
+		return FALSE;
+	fu_console_print_literal(console,
+				 g_memory_output_stream_get_data(G_MEMORY_OUTPUT_STREAM(stream)));
+	return TRUE;
+#endif
+}
+
+typedef struct {
+	const gchar *member_name;
+	GPtrArray *array;
+	FuUtilJsonBuildFunc func;
+	gpointer user_data;
+} FuUtilJsonArrayHelper;
+
+static gboolean
+fu_util_print_json_array_cb(FwupdJsonWriter *writer, gpointer user_data, GError **error)
+{
+	FuUtilJsonArrayHelper *helper = (FuUtilJsonArrayHelper *)user_data;
+
+	if (!fwupd_json_writer_begin_object(writer, NULL, error))
+		return FALSE;
+	if (!fwupd_json_writer_begin_array(writer, helper->member_name, error))
+		return FALSE;
+	for (guint i = 0; i < helper->array->len; i++) {
+		gpointer item = g_ptr_array_index(helper->array, i);
+		g_autoptr(JsonBuilder) builder = json_builder_new();
+		helper->func(item, builder, helper->user_data);
+		if (!fwupd_json_writer_add_builder(writer, NULL, builder, error))
+			return FALSE;
+	}
+	if (!fwupd_json_writer_end_array(writer, error))
+		return FALSE;
+	return fwupd_json_writer_end_object(writer, error);
+}
+
+/* prints an object with one array, where each element is built and written in turn */
+gboolean
+fu_util_print_json_array(FuConsole *console,
+			 const gchar *member_name,
+			 GPtrArray *array,
+			 FuUtilJsonBuildFunc func,
+			 gpointer user_data,
+			 GError **error)
+{
+	FuUtilJsonArrayHelper helper = {
+	    .member_name = member_name,
+	    .array = array,
+	    .func = func,
+	    .user_data = user_data,
+	};
+	return fu_util_print_json_writer(console, fu_util_print_json_array_cb, &helper, error);
+}
+
 void
 fu_util_print_error_as_json(FuConsole *console, const GError *error)
 {
@@ -11,6 +11,7 @@
 #include <json-glib/json-glib.h>
 
 #include "fwupd-bios-setting-private.h"
+#include "fwupd-json-writer-private.h"
 #include "fwupd-security-attr-private.h"
 
 #include "fu-console.h"
@@ -26,6 +27,10 @@ typedef struct {
 	gchar *description;
 	FuUtilCmdFunc callback;
 } FuUtilCmd;
+typedef gboolean (*FuUtilJsonWriteFunc)(FwupdJsonWriter *writer,
+				       gpointer user_data,
+				       GError **error);
+typedef void (*FuUtilJsonBuildFunc)(gpointer item, JsonBuilder *builder, gpointer user_data);
 
 typedef enum {
 	FU_SECURITY_ATTR_TO_STRING_FLAG_NONE = 0,
@@ -132,6 +137,18 @@ gboolean
 fu_util_is_url(const gchar *perhaps_url);
 gboolean
 fu_util_print_builder(FuConsole *console, JsonBuilder *builder, GError **error);
+gboolean
+fu_util_print_json_writer(FuConsole *console,
+			  FuUtilJsonWriteFunc func,
+			  gpointer user_data,
+			  GError **error);
+gboolean
+fu_util_print_json_array(FuConsole *console,
+			 const gchar *member_name,
+			 GPtrArray *array,
+			 FuUtilJsonBuildFunc func,
+			 gpointer user_data,
+			 GError **error);
 void
 fu_util_print_error_as_json(FuConsole *console, const GError *error);
 gchar *
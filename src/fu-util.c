@@ -89,6 +89,9 @@ fu_util_client_notify_cb(GObject *object, GParamSpec *pspec, FuUtilPrivate *priv
 {
 	if (priv->as_json)
 		return;
+	fu_console_set_progress_rate(priv->console,
+				     fwupd_client_get_throughput(priv->client),
+				     fwupd_client_get_time_remaining(priv->client));
 	fu_console_set_progress(priv->console,
 				fwupd_client_get_status(priv->client),
 				fwupd_client_get_percentage(priv->client));
@@ -519,58 +522,60 @@ fu_util_build_device_tree(FuUtilPrivate *priv, GNode *root, GPtrArray *devs, Fwu
 	}
 }
 
-static gboolean
-fu_util_get_releases_as_json(FuUtilPrivate *priv, GPtrArray *rels, GError **error)
+static void
+fu_util_release_build_json_cb(FwupdRelease *rel, JsonBuilder *builder, FuUtilPrivate *priv)
 {
-	g_autoptr(JsonBuilder) builder = json_builder_new();
 	json_builder_begin_object(builder);
-	json_builder_set_member_name(builder, "Releases");
-	json_builder_begin_array(builder);
-	for (guint i = 0; i < rels->len; i++) {
-		FwupdRelease *rel = g_ptr_array_index(rels, i);
-		json_builder_begin_object(builder);
-		fwupd_release_to_json(rel, builder);
-		json_builder_end_object(builder);
-	}
-	json_builder_end_array(builder);
+	fwupd_release_to_json(rel, builder);
 	json_builder_end_object(builder);
-	return fu_util_print_builder(priv->console, builder, error);
 }
 
 static gboolean
-fu_util_get_devices_as_json(FuUtilPrivate *priv, GPtrArray *devs, GError **error)
+fu_util_get_releases_as_json(FuUtilPrivate *priv, GPtrArray *rels, GError **error)
 {
-	g_autoptr(JsonBuilder) builder = json_builder_new();
-	json_builder_begin_object(builder);
-	json_builder_set_member_name(builder, "Devices");
-	json_builder_begin_array(builder);
-	for (guint i = 0; i < devs->len; i++) {
-		FwupdDevice *dev = g_ptr_array_index(devs, i);
-		g_autoptr(GPtrArray) rels = NULL;
-		g_autoptr(GError) error_local = NULL;
+	return fu_util_print_json_array(priv->console,
+					"Releases",
+					rels,
+					(FuUtilJsonBuildFunc)fu_util_release_build_json_cb,
+					priv,
+					error);
+}
 
-		/* add all releases that could be applied */
-		rels = fwupd_client_get_releases(priv->client,
-						 fwupd_device_get_id(dev),
-						 priv->cancellable,
-						 &error_local);
-		if (rels == NULL) {
-			g_debug("not adding releases to device: %s", error_local->message);
-		} else {
-			for (guint j = 0; j < rels->len; j++) {
-				FwupdRelease *rel = g_ptr_array_index(rels, j);
-				fwupd_device_add_release(dev, rel);
-			}
-		}
+static void
+fu_util_device_build_json_cb(FwupdDevice *dev, JsonBuilder *builder, FuUtilPrivate *priv)
+{
+	g_autoptr(GPtrArray) rels = NULL;
+	g_autoptr(GError) error_local = NULL;
 
-		/* add to builder */
-		json_builder_begin_object(builder);
-		fwupd_device_to_json_full(dev, builder, FWUPD_DEVICE_FLAG_TRUSTED);
-		json_builder_end_object(builder);
+	/* add all releases that could be applied */
+	rels = fwupd_client_get_releases(priv->client,
+					 fwupd_device_get_id(dev),
+					 priv->cancellable,
+					 &error_local);
+	if (rels == NULL) {
+		g_debug("not adding releases to device: %s", error_local->message);
+	} else {
+		for (guint j = 0; j < rels->len; j++) {
+			FwupdRelease *rel = g_ptr_array_index(rels, j);
+			fwupd_device_add_release(dev, rel);
+		}
 	}
-	json_builder_end_array(builder);
+
+	/* add to builder */
+	json_builder_begin_object(builder);
+	fwupd_device_to_json_full(dev, builder, FWUPD_DEVICE_FLAG_TRUSTED);
 	json_builder_end_object(builder);
-	return fu_util_print_builder(priv->console, builder, error);
+}
+
+static gboolean
+fu_util_get_devices_as_json(FuUtilPrivate *priv, GPtrArray *devs, GError **error)
+{
+	return fu_util_print_json_array(priv->console,
+					"Devices",
+					devs,
+					(FuUtilJsonBuildFunc)fu_util_device_build_json_cb,
+					priv,
+					error);
 }
 
 static gboolean
@@ -616,23 +621,23 @@ fu_util_get_devices(FuUtilPrivate *priv, gchar **values, GError **error)
 	return TRUE;
 }
 
-static gboolean
-fu_util_get_plugins_as_json(FuUtilPrivate *priv, GPtrArray *plugins, GError **error)
+static void
+fu_util_plugin_build_json_cb(FwupdPlugin *plugin, JsonBuilder *builder, FuUtilPrivate *priv)
 {
-	g_autoptr(JsonBuilder) builder = json_builder_new();
 	json_builder_begin_object(builder);
-
-	json_builder_set_member_name(builder, "Plugins");
-	json_builder_begin_array(builder);
-	for (guint i = 0; i < plugins->len; i++) {
-		FwupdPlugin *plugin = g_ptr_array_index(plugins, i);
-		json_builder_begin_object(builder);
-		fwupd_plugin_to_json(plugin, builder);
-		json_builder_end_object(builder);
-	}
-	json_builder_end_array(builder);
+	fwupd_plugin_to_json(plugin, builder);
 	json_builder_end_object(builder);
-	return fu_util_print_builder(priv->console, builder, error);
+}
+
+static gboolean
+fu_util_get_plugins_as_json(FuUtilPrivate *priv, GPtrArray *plugins, GError **error)
+{
+	return fu_util_print_json_array(priv->console,
+					"Plugins",
+					plugins,
+					(FuUtilJsonBuildFunc)fu_util_plugin_build_json_cb,
+					priv,
+					error);
 }
 
 static gboolean
@@ -1396,22 +1401,23 @@ fu_util_local_install(FuUtilPrivate *priv, gchar **values, GError **error)
 	return fu_util_prompt_complete(priv->console, priv->completion_flags, TRUE, error);
 }
 
-static gboolean
-fu_util_get_details_as_json(FuUtilPrivate *priv, GPtrArray *devs, GError **error)
+static void
+fu_util_details_build_json_cb(FwupdDevice *dev, JsonBuilder *builder, FuUtilPrivate *priv)
 {
-	g_autoptr(JsonBuilder) builder = json_builder_new();
 	json_builder_begin_object(builder);
-	json_builder_set_member_name(builder, "Devices");
-	json_builder_begin_array(builder);
-	for (guint i = 0; i < devs->len; i++) {
-		FwupdDevice *dev = g_ptr_array_index(devs, i);
-		json_builder_begin_object(builder);
-		fwupd_device_to_json_full(dev, builder, FWUPD_DEVICE_FLAG_TRUSTED);
-		json_builder_end_object(builder);
-	}
-	json_builder_end_array(builder);
+	fwupd_device_to_json_full(dev, builder, FWUPD_DEVICE_FLAG_TRUSTED);
 	json_builder_end_object(builder);
-	return fu_util_print_builder(priv->console, builder, error);
+}
+
+static gboolean
+fu_util_get_details_as_json(FuUtilPrivate *priv, GPtrArray *devs, GError **error)
+{
+	return fu_util_print_json_array(priv->console,
+					"Devices",
+					devs,
+					(FuUtilJsonBuildFunc)fu_util_details_build_json_cb,
+					priv,
+					error);
 }
 
 static gboolean
@@ -2213,44 +2219,85 @@ fu_util_perhaps_refresh_remotes(FuUtilPrivate *priv, GError **error)
 	return fu_util_download_metadata(priv, error);
 }
 
-static gboolean
-fu_util_get_updates_as_json(FuUtilPrivate *priv, GPtrArray *devices, GError **error)
+/* adds any upgrades to the device as releases, ignoring any error */
+static void
+fu_util_device_add_upgrades(FuUtilPrivate *priv, FwupdDevice *dev)
 {
-	g_autoptr(JsonBuilder) builder = json_builder_new();
-	json_builder_begin_object(builder);
-	json_builder_set_member_name(builder, "Devices");
-	json_builder_begin_array(builder);
-	for (guint i = 0; i < devices->len; i++) {
-		FwupdDevice *dev = g_ptr_array_index(devices, i);
-		g_autoptr(GPtrArray) rels = NULL;
-		g_autoptr(GError) error_local = NULL;
+	g_autoptr(GError) error_local = NULL;
+	g_autoptr(GPtrArray) rels = NULL;
 
-		/* not going to have results, so save a D-Bus round-trip */
-		if (!fwupd_device_has_flag(dev, FWUPD_DEVICE_FLAG_SUPPORTED))
-			continue;
+	/* not going to have results, so save a D-Bus round-trip */
+	if (!fwupd_device_has_flag(dev, FWUPD_DEVICE_FLAG_UPDATABLE) &&
+	    !fwupd_device_has_flag(dev, FWUPD_DEVICE_FLAG_UPDATABLE_HIDDEN))
+		return;
+	if (!fwupd_device_has_flag(dev, FWUPD_DEVICE_FLAG_SUPPORTED))
+		return;
+	rels = fwupd_client_get_upgrades(priv->client,
+					 fwupd_device_get_id(dev),
+					 priv->cancellable,
+					 &error_local);
+	if (rels == NULL) {
+		/* discard the actual reason from user, but leave for debugging */
+		g_debug("%s", error_local->message);
+		return;
+	}
+	for (guint i = 0; i < rels->len; i++) {
+		FwupdRelease *rel = g_ptr_array_index(rels, i);
+		fwupd_device_add_release(dev, rel);
+	}
+}
 
-		/* get the releases for this device and filter for validity */
-		rels = fwupd_client_get_upgrades(priv->client,
-						 fwupd_device_get_id(dev),
-						 priv->cancellable,
-						 &error_local);
-		if (rels == NULL) {
-			g_debug("no upgrades: %s", error_local->message);
-			continue;
-		}
-		for (guint j = 0; j < rels->len; j++) {
-			FwupdRelease *rel = g_ptr_array_index(rels, j);
-			fwupd_device_add_release(dev, rel);
-		}
+/* gets all the devices with any upgrades added as releases, using one D-Bus call if possible */
+static GPtrArray *
+fu_util_get_devices_with_upgrades(FuUtilPrivate *priv, GError **error)
+{
+	g_autoptr(GError) error_local = NULL;
+	g_autoptr(GPtrArray) devices = NULL;
 
-		/* add to builder */
-		json_builder_begin_object(builder);
-		fwupd_device_to_json_full(dev, builder, FWUPD_DEVICE_FLAG_TRUSTED);
-		json_builder_end_object(builder);
+	devices = fwupd_client_get_upgrades_all(priv->client, priv->cancellable, &error_local);
+	if (devices != NULL)
+		return g_steal_pointer(&devices);
+	if (!g_error_matches(error_local, FWUPD_ERROR, FWUPD_ERROR_NOT_SUPPORTED)) {
+		g_propagate_error(error, g_steal_pointer(&error_local));
+		return NULL;
 	}
-	json_builder_end_array(builder);
+
+	/* the daemon is older than the client */
+	g_debug("falling back to GetUpgrades: %s", error_local->message);
+	devices = fwupd_client_get_devices(priv->client, priv->cancellable, error);
+	if (devices == NULL)
+		return NULL;
+	for (guint i = 0; i < devices->len; i++) {
+		FwupdDevice *dev = g_ptr_array_index(devices, i);
+		fu_util_device_add_upgrades(priv, dev);
+	}
+	return g_steal_pointer(&devices);
+}
+
+static void
+fu_util_update_build_json_cb(FwupdDevice *dev, JsonBuilder *builder, FuUtilPrivate *priv)
+{
+	/* no upgrades */
+	if (!fwupd_device_has_flag(dev, FWUPD_DEVICE_FLAG_SUPPORTED))
+		return;
+	if (fwupd_device_get_releases(dev)->len == 0)
+		return;
+
+	/* add to builder */
+	json_builder_begin_object(builder);
+	fwupd_device_to_json_full(dev, builder, FWUPD_DEVICE_FLAG_TRUSTED);
 	json_builder_end_object(builder);
-	return fu_util_print_builder(priv->console, builder, error);
+}
+
+static gboolean
+fu_util_get_updates_as_json(FuUtilPrivate *priv, GPtrArray *devices, GError **error)
+{
+	return fu_util_print_json_array(priv->console,
+					"Devices",
+					devices,
+					(FuUtilJsonBuildFunc)fu_util_update_build_json_cb,
+					priv,
+					error);
 }
 
 static gboolean
@@ -2268,13 +2315,14 @@ fu_util_get_updates(FuUtilPrivate *priv, gchar **values, GError **error)
 
 	/* handle both forms */
 	if (g_strv_length(values) == 0) {
-		devices = fwupd_client_get_devices(priv->client, priv->cancellable, error);
+		devices = fu_util_get_devices_with_upgrades(priv, error);
 		if (devices == NULL)
 			return FALSE;
 	} else if (g_strv_length(values) == 1) {
 		FwupdDevice *device = fu_util_get_device_by_id(priv, values[0], error);
 		if (device == NULL)
 			return FALSE;
+		fu_util_device_add_upgrades(priv, device);
 		devices = g_ptr_array_new_with_free_func((GDestroyNotify)g_object_unref);
 		g_ptr_array_add(devices, device);
 	} else {
@@ -2292,11 +2340,10 @@ fu_util_get_updates(FuUtilPrivate *priv, gchar **values, GError **error)
 
 	for (guint i = 0; i < devices->len; i++) {
 		FwupdDevice *dev = g_ptr_array_index(devices, i);
-		g_autoptr(GPtrArray) rels = NULL;
-		g_autoptr(GError) error_local = NULL;
+		GPtrArray *rels = fwupd_device_get_releases(dev);
 		GNode *child;
 
-		/* not going to have results, so save a D-Bus round-trip */
+		/* not going to have results */
 		if (!fwupd_device_has_flag(dev, FWUPD_DEVICE_FLAG_UPDATABLE) &&
 		    !fwupd_device_has_flag(dev, FWUPD_DEVICE_FLAG_UPDATABLE_HIDDEN))
 			continue;
@@ -2308,15 +2355,9 @@ fu_util_get_updates(FuUtilPrivate *priv, gchar **values, GError **error)
 		}
 		supported = TRUE;
 
-		/* get the releases for this device and filter for validity */
-		rels = fwupd_client_get_upgrades(priv->client,
-						 fwupd_device_get_id(dev),
-						 priv->cancellable,
-						 &error_local);
-		if (rels == NULL) {
+		/* the releases for this device have already been filtered for validity */
+		if (rels->len == 0) {
 			g_ptr_array_add(devices_no_upgrades, dev);
-			/* discard the actual reason from user, but leave for debugging */
-			g_debug("%s", error_local->message);
 			continue;
 		}
 		child = g_node_append_data(root, dev);
@@ -2379,22 +2420,23 @@ fu_util_get_updates(FuUtilPrivate *priv, gchar **values, GError **error)
 	return TRUE;
 }
 
-static gboolean
-fu_util_get_remotes_as_json(FuUtilPrivate *priv, GPtrArray *remotes, GError **error)
+static void
+fu_util_remote_build_json_cb(FwupdRemote *remote, JsonBuilder *builder, FuUtilPrivate *priv)
 {
-	g_autoptr(JsonBuilder) builder = json_builder_new();
 	json_builder_begin_object(builder);
-	json_builder_set_member_name(builder, "Remotes");
-	json_builder_begin_array(builder);
-	for (guint i = 0; i < remotes->len; i++) {
-		FwupdRemote *remote = g_ptr_array_index(remotes, i);
-		json_builder_begin_object(builder);
-		fwupd_remote_to_json(remote, builder);
-		json_builder_end_object(builder);
-	}
-	json_builder_end_array(builder);
+	fwupd_remote_to_json(remote, builder);
 	json_builder_end_object(builder);
-	return fu_util_print_builder(priv->console, builder, error);
+}
+
+static gboolean
+fu_util_get_remotes_as_json(FuUtilPrivate *priv, GPtrArray *remotes, GError **error)
+{
+	return fu_util_print_json_array(priv->console,
+					"Remotes",
+					remotes,
+					(FuUtilJsonBuildFunc)fu_util_remote_build_json_cb,
+					priv,
+					error);
 }
 
 static gboolean
@@ -2655,6 +2697,7 @@ fu_util_update(FuUtilPrivate *priv, gchar **values, GError **error)
 	gboolean supported = FALSE;
 	gboolean no_updates_header = FALSE;
 	gboolean latest_header = FALSE;
+	gboolean device_updated = FALSE;
 
 	if (priv->flags & FWUPD_INSTALL_FLAG_ALLOW_OLDER) {
 		g_set_error_literal(error,
@@ -2685,7 +2728,7 @@ fu_util_update(FuUtilPrivate *priv, gchar **values, GError **error)
 	}
 
 	/* get devices from daemon */
-	devices = fwupd_client_get_devices(priv->client, priv->cancellable, error);
+	devices = fu_util_get_devices_with_upgrades(priv, error);
 	if (devices == NULL)
 		return FALSE;
 	priv->current_operation = FU_UTIL_OPERATION_UPDATE;
@@ -2698,7 +2741,7 @@ fu_util_update(FuUtilPrivate *priv, gchar **values, GError **error)
 		g_autoptr(GError) error_local = NULL;
 		gboolean dev_skip_byid = TRUE;
 
-		/* not going to have results, so save a D-Bus round-trip */
+		/* not going to have results */
 		if (!fwupd_device_has_flag(dev, FWUPD_DEVICE_FLAG_UPDATABLE) &&
 		    !fwupd_device_has_flag(dev, FWUPD_DEVICE_FLAG_UPDATABLE_HIDDEN))
 			continue;
@@ -2729,11 +2772,20 @@ fu_util_update(FuUtilPrivate *priv, gchar **values, GError **error)
 			continue;
 		supported = TRUE;
 
-		/* get the releases for this device and filter for validity */
-		rels = fwupd_client_get_upgrades(priv->client,
-						 fwupd_device_get_id(dev),
-						 priv->cancellable,
-						 &error_local);
+		/* the upgrades may have changed if another device has just been updated */
+		if (device_updated) {
+			rels = fwupd_client_get_upgrades(priv->client,
+							 fwupd_device_get_id(dev),
+							 priv->cancellable,
+							 &error_local);
+		} else if (fwupd_device_get_releases(dev)->len > 0) {
+			rels = g_ptr_array_ref(fwupd_device_get_releases(dev));
+		} else {
+			g_set_error_literal(&error_local,
+					    FWUPD_ERROR,
+					    FWUPD_ERROR_NOTHING_TO_DO,
+					    "No upgrades available");
+		}
 		if (rels == NULL) {
 			if (!latest_header) {
 				fu_console_print_literal(
@@ -2751,6 +2803,7 @@ fu_util_update(FuUtilPrivate *priv, gchar **values, GError **error)
 		rel = g_ptr_array_index(rels, 0);
 		if (!fu_util_update_device_with_release(priv, dev, rel, error))
 			return FALSE;
+		device_updated = TRUE;
 
 		fu_util_display_current_message(priv);
 
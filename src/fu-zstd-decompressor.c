@@ -0,0 +1,136 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * SPDX-License-Identifier: LGPL-2.1+
+ */
+
+#define G_LOG_DOMAIN "FuZstdDecompressor"
+
+#include "config.h"
+
+#include <zstd.h>
+
+#include "fu-zstd-decompressor.h"
+
+struct _FuZstdDecompressor {
+	GObject parent_instance;
+	ZSTD_DStream *dstream;
+	gboolean frame_done;
+};
+
+static void
+fu_zstd_decompressor_iface_init(GConverterIface *iface);
+
+G_DEFINE_TYPE_WITH_CODE(FuZstdDecompressor,
+			fu_zstd_decompressor,
+			G_TYPE_OBJECT,
+			G_IMPLEMENT_INTERFACE(G_TYPE_CONVERTER, fu_zstd_decompressor_iface_init))
+
+static GConverterResult
+fu_zstd_decompressor_convert(GConverter *converter,
+			     const void *inbuf,
+			     gsize inbuf_size,
+			     void *outbuf,
+			     gsize outbuf_size,
+			     GConverterFlags flags,
+			     gsize *bytes_read,
+			     gsize *bytes_written,
+			     GError **error)
+{
+	FuZstdDecompressor *self = FU_ZSTD_DECOMPRESSOR(converter);
+	ZSTD_inBuffer input = {.src = inbuf, .size = inbuf_size, .pos = 0};
+	ZSTD_outBuffer output = {.dst = outbuf, .size = outbuf_size, .pos = 0};
+	gsize rc;
+
+	/* GConverterInputStream may only set INPUT_AT_END on a later call with no input */
+	if (inbuf_size == 0 && (flags & G_CONVERTER_INPUT_AT_END) > 0 && self->frame_done) {
+		*bytes_read = 0;
+		*bytes_written = 0;
+		return G_CONVERTER_FINISHED;
+	}
+
+	rc = ZSTD_decompressStream(self->dstream, &output, &input);
+	if (ZSTD_isError(rc)) {
+		g_set_error(error,
+			    G_IO_ERROR,
+			    G_IO_ERROR_INVALID_DATA,
+			    "failed to decompress zstd data: %s",
+			    ZSTD_getErrorName(rc));
+		return G_CONVERTER_ERROR;
+	}
+	*bytes_read = input.pos;
+	*bytes_written = output.pos;
+
+	/* a return value of zero means the frame was fully decoded and flushed, but another
+	 * frame may follow in the same stream */
+	self->frame_done = rc == 0;
+	if (self->frame_done && input.pos == inbuf_size && (flags & G_CONVERTER_INPUT_AT_END) > 0)
+		return G_CONVERTER_FINISHED;
+	if (input.pos == 0 && output.pos == 0) {
+		if (outbuf_size == 0) {
+			g_set_error_literal(error,
+					    G_IO_ERROR,
+					    G_IO_ERROR_NO_SPACE,
+					    "no space in output buffer");
+			return G_CONVERTER_ERROR;
+		}
+		if (flags & G_CONVERTER_FLUSH)
+			return G_CONVERTER_FLUSHED;
+		g_set_error_literal(error,
+				    G_IO_ERROR,
+				    G_IO_ERROR_PARTIAL_INPUT,
+				    "need more zstd input");
+		return G_CONVERTER_ERROR;
+	}
+	return G_CONVERTER_CONVERTED;
+}
+
+static void
+fu_zstd_decompressor_reset(GConverter *converter)
+{
+	FuZstdDecompressor *self = FU_ZSTD_DECOMPRESSOR(converter);
+	ZSTD_initDStream(self->dstream);
+	self->frame_done = FALSE;
+}
+
+static void
+fu_zstd_decompressor_iface_init(GConverterIface *iface)
+{
+	iface->convert = fu_zstd_decompressor_convert;
+	iface->reset = fu_zstd_decompressor_reset;
+}
+
+static void
+fu_zstd_decompressor_init(FuZstdDecompressor *self)
+{
+	self->dstream = ZSTD_createDStream();
+	ZSTD_initDStream(self->dstream);
+}
+
+static void
+fu_zstd_decompressor_finalize(GObject *obj)
+{
+	FuZstdDecompressor *self = FU_ZSTD_DECOMPRESSOR(obj);
+	ZSTD_freeDStream(self->dstream);
+	G_OBJECT_CLASS(fu_zstd_decompressor_parent_class)->finalize(obj);
+}
+
+static void
+fu_zstd_decompressor_class_init(FuZstdDecompressorClass *klass)
+{
+	GObjectClass *object_class = G_OBJECT_CLASS(klass);
+	object_class->finalize = fu_zstd_decompressor_finalize;
+}
+
+/**
+ * fu_zstd_decompressor_new:
+ *
+ * Creates a new streaming zstd decompressor for use with g_converter_input_stream_new().
+ *
+ * Returns: (transfer full): a #FuZstdDecompressor
+ **/
+FuZstdDecompressor *
+fu_zstd_decompressor_new(void)
+{
+	return g_object_new(FU_TYPE_ZSTD_DECOMPRESSOR, NULL);
+}